@@ -74,9 +74,29 @@ class Formatter {
 public:
   virtual ~Formatter() {}
 
+  /**
+   * Format a log line.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param request_info supplies additional information about the request.
+   * @return std::string the formatted log line.
+   */
   virtual std::string format(const Http::HeaderMap& request_headers,
                              const Http::HeaderMap& response_headers,
                              const RequestInfo::RequestInfo& request_info) const PURE;
+
+  /**
+   * Format a log line by appending to an existing string. Callers that log repeatedly can reuse
+   * the same output string and avoid allocating for each line.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param request_info supplies additional information about the request.
+   * @param output supplies the string to append the formatted log line to.
+   */
+  virtual void formatTo(const Http::HeaderMap& request_headers,
+                        const Http::HeaderMap& response_headers,
+                        const RequestInfo::RequestInfo& request_info,
+                        std::string& output) const PURE;
 };
 
 typedef std::unique_ptr<Formatter> FormatterPtr;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+
+/**
+ * A monotonic allocator. Memory allocated from an arena is never freed individually; it is all
+ * released in one step when the arena is destroyed. Objects created in the arena are destroyed,
+ * in the reverse order of their creation, before that.
+ */
+class Arena {
+public:
+  virtual ~Arena() {}
+
+  /**
+   * Allocate memory that lives as long as the arena.
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the alignment of the memory. It must be a power of two no larger
+   *        than alignof(std::max_align_t).
+   * @return void* the memory, which is never nullptr.
+   */
+  virtual void* allocate(size_t size, size_t alignment) PURE;
+
+  /**
+   * Register a function to be called when the arena is destroyed, before its memory is released.
+   * Functions are called in the reverse order of their registration.
+   * @param cleanup supplies the function to call.
+   * @param object supplies the argument to call the function with.
+   */
+  virtual void addCleanup(void (*cleanup)(void*), void* object) PURE;
+
+  /**
+   * Create an object in the arena. The object's destructor, if it is not trivial, is called when
+   * the arena is destroyed.
+   * @param args supplies the constructor arguments.
+   * @return T* the object, which is owned by the arena.
+   */
+  template <class T, class... Args> T* create(Args&&... args) {
+    T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value) {
+      addCleanup([](void* object) -> void { static_cast<T*>(object)->~T(); }, object);
+    }
+    return object;
+  }
+};
+
+} // namespace Envoy
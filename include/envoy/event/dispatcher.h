@@ -17,10 +17,48 @@
 #include "envoy/network/listener.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/stats_macros.h"
 
 namespace Envoy {
 namespace Event {
 
+/**
+ * All dispatcher stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
+  HISTOGRAM(loop_duration_us)                                                                      \
+  HISTOGRAM(poll_delay_us)                                                                         \
+  HISTOGRAM(file_event_duration_us)                                                                \
+  HISTOGRAM(timer_duration_us)                                                                     \
+  HISTOGRAM(post_duration_us)                                                                      \
+  HISTOGRAM(deferred_delete_duration_us)
+// clang-format on
+
+/**
+ * Struct definition for all dispatcher stats. @see stats_macros.h
+ */
+struct DispatcherStats {
+  ALL_DISPATCHER_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * Summary of the latencies recorded in the stats of a dispatcher, which any thread can read while
+ * the dispatcher runs.
+ */
+class DispatcherStatsSummary {
+public:
+  virtual ~DispatcherStatsSummary() {}
+
+  /**
+   * @return std::string a line for each of the dispatcher's histograms, with its name, its number
+   *         of samples, and approximations of its 50th, 90th and 99th percentiles and maximum.
+   */
+  virtual std::string format() const PURE;
+};
+
+typedef std::shared_ptr<const DispatcherStatsSummary> DispatcherStatsSummaryConstSharedPtr;
+
 /**
  * Callback invoked when a dispatcher post() runs.
  */
@@ -146,6 +184,17 @@ public:
   enum class RunType { Block, NonBlock };
   virtual void run(RunType type) PURE;
 
+  /**
+   * Start recording DispatcherStats for each iteration of the event loop: how long it waited for
+   * events, how long it took to run their callbacks, and how much of that was spent in each kind
+   * of callback. Must be called before run().
+   * @param scope supplies the scope to create the histograms in.
+   * @param prefix supplies the prefix of the histogram names, e.g. "server.worker_0.dispatcher.".
+   * @return DispatcherStatsSummaryConstSharedPtr a summary of the recorded latencies.
+   */
+  virtual DispatcherStatsSummaryConstSharedPtr initializeStats(Stats::Scope& scope,
+                                                               const std::string& prefix) PURE;
+
   /**
    * Returns a factory which connections may use for watermark buffer creation.
    * @return the watermark buffer factory for this dispatcher.
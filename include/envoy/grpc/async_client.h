@@ -55,6 +55,13 @@ public:
    * stream object and no further callbacks will be invoked.
    */
   virtual void resetStream() PURE;
+
+  /**
+   * @return bool whether the stream has more data buffered for writing than its high watermark. A
+   *         caller that produces messages faster than the remote can accept them can use this to
+   *         hold back or drop messages instead of buffering without bound.
+   */
+  virtual bool isAboveWriteBufferHighWatermark() const PURE;
 };
 
 class AsyncRequestCallbacks {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
 
 #include "envoy/event/dispatcher.h"
@@ -127,6 +128,13 @@ public:
      * Reset the stream.
      */
     virtual void reset() PURE;
+
+    /**
+     * @return bool whether the upstream connection is above its write buffer high watermark. A
+     *         caller that does not want to buffer an unbounded amount of data can use this to stop
+     *         sending on the stream.
+     */
+    virtual bool isAboveWriteBufferHighWatermark() const PURE;
   };
 
   virtual ~AsyncClient() {}
@@ -152,13 +160,16 @@ public:
    *        it can be retried. In general, this should be set to false for a true stream. However,
    *        streaming is also used in certain cases such as gRPC unary calls, where retry can
    *        still be useful.
+   * @param buffer_limit supplies the number of body bytes the stream buffers while it waits for an
+   *        upstream connection before reporting that it is above its write buffer high watermark,
+   *        or 0 for no limit.
    * @return a stream handle or nullptr if no stream could be started. NOTE: In this case
    *         onResetStream() has already been called inline. The client owns the stream and
    *         the handle can be used to send more messages or close the stream.
    */
   virtual Stream* start(StreamCallbacks& callbacks,
                         const absl::optional<std::chrono::milliseconds>& timeout,
-                        bool buffer_body_for_retry) PURE;
+                        bool buffer_body_for_retry, uint32_t buffer_limit) PURE;
 
   /**
    * @return Event::Dispatcher& the dispatcher backing this client.
@@ -6,6 +6,7 @@
 #include <string>
 
 #include "envoy/access_log/access_log.h"
+#include "envoy/common/arena.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/http/codec.h"
 #include "envoy/http/header_map.h"
@@ -138,6 +139,13 @@ public:
    * @return tracing configuration.
    */
   virtual const Tracing::Config& tracingConfig() PURE;
+
+  /**
+   * @return Arena& an arena that lives as long as the stream. Filters can allocate per-stream
+   *         objects from it instead of the heap. They are all released in one step when the
+   *         stream is destroyed, after every filter's onDestroy() has been called.
+   */
+  virtual Arena& arena() PURE;
 };
 
 /**
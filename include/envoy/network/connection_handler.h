@@ -56,6 +56,25 @@ public:
    * Stop all listeners. This will not close any connections and is used for draining.
    */
   virtual void stopListeners() PURE;
+
+  /**
+   * Temporarily stop accepting new connections on all listeners. Unlike stopListeners(), the
+   * listening sockets stay open and acceptance can be resumed with enableListeners().
+   */
+  virtual void disableListeners() PURE;
+
+  /**
+   * Resume accepting new connections on all listeners disabled with disableListeners().
+   */
+  virtual void enableListeners() PURE;
+
+  /**
+   * Cap the per connection buffer limit applied to connections accepted from now on. Existing
+   * connections are not affected.
+   * @param limit supplies the maximum buffer limit in bytes. 0 removes the cap and restores the
+   *        limits configured on each listener.
+   */
+  virtual void setPerConnectionBufferLimitCap(uint32_t limit) PURE;
 };
 
 typedef std::unique_ptr<ConnectionHandler> ConnectionHandlerPtr;
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
 #include "envoy/upstream/host_description.h"
@@ -10,6 +12,7 @@ namespace Network {
 
 class Connection;
 class ConnectionSocket;
+class TransportSocketFactory;
 
 /**
  * Status codes returned by filters that can cause future filters to not get iterated to.
@@ -212,6 +215,54 @@ public:
   virtual void addAcceptFilter(ListenerFilterPtr&& filter) PURE;
 };
 
+/**
+ * This function is used to wrap the creation of a network filter chain for new connections.
+ * Filter factories create the lambda at configuration initialization time, and then they are used
+ * at runtime.
+ * @param filter_manager supplies the filter manager for the connection to install filters to.
+ * Typically the function will install a single filter, but it's technically possibly to install
+ * more than one if desired.
+ */
+typedef std::function<void(FilterManager& filter_manager)> FilterFactoryCb;
+
+/**
+ * A filter chain of a listener: the transport socket and network filters that new connections
+ * matching it are set up with.
+ */
+class FilterChain {
+public:
+  virtual ~FilterChain() {}
+
+  /**
+   * @return const TransportSocketFactory& the transport socket factory for new connections.
+   */
+  virtual const TransportSocketFactory& transportSocketFactory() const PURE;
+
+  /**
+   * @return const std::vector<FilterFactoryCb>& the network filter factories for new connections.
+   */
+  virtual const std::vector<FilterFactoryCb>& networkFilterFactories() const PURE;
+};
+
+typedef std::shared_ptr<FilterChain> FilterChainSharedPtr;
+
+/**
+ * Selects the filter chain of new connections among the filter chains of a listener.
+ */
+class FilterChainManager {
+public:
+  virtual ~FilterChainManager() {}
+
+  /**
+   * Finds the filter chain matching a new connection. This is called once per connection, after
+   * the listener filters have run, so it can match on what they found out about the connection.
+   * @param socket supplies the socket of the new connection.
+   * @return const FilterChain* the filter chain to set up the connection with, or nullptr if no
+   *         filter chain matches and the connection must be closed.
+   */
+  virtual const FilterChain* findFilterChain(const ConnectionSocket& socket) const PURE;
+};
+
 /**
  * Creates a chain of network filters for a new connection.
  */
@@ -222,10 +273,13 @@ public:
   /**
    * Called to create the network filter chain.
    * @param connection supplies the connection to create the chain on.
+   * @param filter_factories supplies the filter factories of the filter chain matching the
+   *        connection.
    * @return true if filter chain was created successfully. Otherwise
    *   false, e.g. filter chain is empty.
    */
-  virtual bool createNetworkFilterChain(Connection& connection) PURE;
+  virtual bool createNetworkFilterChain(Connection& connection,
+                                        const std::vector<FilterFactoryCb>& filter_factories) PURE;
 
   /**
    * Called to create the listener filter chain.
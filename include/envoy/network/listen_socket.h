@@ -1,11 +1,14 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "envoy/common/pure.h"
 #include "envoy/network/address.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Network {
 
@@ -114,6 +117,33 @@ public:
    *         address the socket was initially accepted at.
    */
   virtual bool localAddressRestored() const PURE;
+
+  /**
+   * Set the server name requested by the client, e.g. the SNI of a TLS ClientHello. Set by the
+   * listener filters that inspect the start of the connection.
+   * @param server_name supplies the requested server name.
+   */
+  virtual void setRequestedServerName(absl::string_view server_name) PURE;
+
+  /**
+   * @return absl::string_view the server name requested by the client, or an empty string if the
+   *         client did not request one or it is not known.
+   */
+  virtual absl::string_view requestedServerName() const PURE;
+
+  /**
+   * Set the application protocols requested by the client, e.g. the ALPN protocols of a TLS
+   * ClientHello, in order of preference. Set by the listener filters that inspect the start of
+   * the connection.
+   * @param protocols supplies the requested application protocols.
+   */
+  virtual void setRequestedApplicationProtocols(const std::vector<std::string>& protocols) PURE;
+
+  /**
+   * @return const std::vector<std::string>& the application protocols requested by the client,
+   *         empty if it did not request any or they are not known.
+   */
+  virtual const std::vector<std::string>& requestedApplicationProtocols() const PURE;
 };
 
 typedef std::unique_ptr<ConnectionSocket> ConnectionSocketPtr;
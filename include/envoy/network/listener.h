@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -13,6 +14,68 @@
 namespace Envoy {
 namespace Network {
 
+/**
+ * A worker's view of a listener that a ConnectionBalancer can hand connections to.
+ */
+class BalancedConnectionHandler {
+public:
+  virtual ~BalancedConnectionHandler() {}
+
+  /**
+   * @return uint64_t the number of connections the balancer has assigned to this handler that
+   *         have not been closed yet. May be called from any thread.
+   */
+  virtual uint64_t numConnections() const PURE;
+
+  /**
+   * Count one more connection as assigned to this handler. Called by the balancer, from the
+   * thread that accepted the connection, when it picks this handler.
+   */
+  virtual void incNumConnections() PURE;
+
+  /**
+   * Hand an accepted socket over to this handler. Called by the balancer, from the thread that
+   * accepted the socket, while the handler is registered; the socket is processed later on this
+   * handler's own thread.
+   * @param socket supplies the accepted socket, which was already counted by incNumConnections().
+   */
+  virtual void post(ConnectionSocketPtr&& socket) PURE;
+};
+
+/**
+ * Spreads the connections accepted by a listener across the workers it runs on. Each worker
+ * registers the handler of its copy of the listener. All methods may be called from any worker.
+ */
+class ConnectionBalancer {
+public:
+  virtual ~ConnectionBalancer() {}
+
+  /**
+   * Register a handler that connections can be assigned to.
+   */
+  virtual void registerHandler(BalancedConnectionHandler& handler) PURE;
+
+  /**
+   * Unregister a handler before it is destroyed.
+   */
+  virtual void unregisterHandler(BalancedConnectionHandler& handler) PURE;
+
+  /**
+   * Pick the handler that a connection accepted by current_handler should be processed by, and
+   * count the connection against it with incNumConnections(). If that is another handler, the
+   * socket is handed to it with post() before the balancer lets it be unregistered, as its worker
+   * may destroy it as soon as it is.
+   * @param current_handler supplies the handler of the worker that accepted the connection.
+   * @param socket supplies the accepted socket, which is moved if it is handed to another handler.
+   * @return bool true if the socket was handed to another handler, false if current_handler
+   *         should process it.
+   */
+  virtual bool balanceConnection(BalancedConnectionHandler& current_handler,
+                                 ConnectionSocketPtr& socket) PURE;
+};
+
+typedef std::unique_ptr<ConnectionBalancer> ConnectionBalancerPtr;
+
 /**
  * A configuration for an individual listener.
  */
@@ -33,9 +96,15 @@ public:
   virtual Socket& socket() PURE;
 
   /**
-   * @return TransportSocketFactory& the transport socket factory.
+   * @return FilterChainManager& the manager selecting the filter chain of each new connection.
    */
-  virtual TransportSocketFactory& transportSocketFactory() PURE;
+  virtual FilterChainManager& filterChainManager() PURE;
+
+  /**
+   * @return ConnectionBalancer* the balancer moving accepted connections between workers, or
+   *         nullptr if connections are processed by the worker that accepted them.
+   */
+  virtual ConnectionBalancer* connectionBalancer() PURE;
 
   /**
    * @return bool specifies whether the listener should actually listen on the port.
@@ -58,6 +127,19 @@ public:
    */
   virtual uint32_t perConnectionBufferLimitBytes() PURE;
 
+  /**
+   * @return std::chrono::milliseconds the time the listener filters are given to process an
+   *         accepted socket, or 0 for no limit.
+   */
+  virtual std::chrono::milliseconds listenerFiltersTimeout() const PURE;
+
+  /**
+   * @return bool whether a socket whose listener filters time out still gets a connection,
+   *         matched against the filter chains with what the listener filters found out so far.
+   *         Otherwise the socket is closed.
+   */
+  virtual bool continueOnListenerFiltersTimeout() const PURE;
+
   /**
    * @return Stats::Scope& the stats scope to use for all listener specific stats.
    */
@@ -104,6 +186,17 @@ public:
 class Listener {
 public:
   virtual ~Listener() {}
+
+  /**
+   * Temporarily stop accepting connections. Connections queued in the kernel stay there until the
+   * listener is enabled again.
+   */
+  virtual void disable() PURE;
+
+  /**
+   * Resume accepting connections after disable().
+   */
+  virtual void enable() PURE;
 };
 
 typedef std::unique_ptr<Listener> ListenerPtr;
@@ -154,6 +154,12 @@ public:
    * @return uint32_t a local OR of RETRY_ON values above.
    */
   virtual uint32_t retryOn() const PURE;
+
+  /**
+   * @return std::chrono::milliseconds the delay after which a hedged request is sent to another
+   *         host if no response has been received, or 0 if requests are not hedged.
+   */
+  virtual std::chrono::milliseconds hedgeDelay() const PURE;
 };
 
 /**
@@ -326,6 +332,12 @@ public:
    */
   virtual const std::vector<MetadataMatchCriterionConstSharedPtr>&
   metadataMatchCriteria() const PURE;
+
+  /**
+   * @return uint64_t an identifier that is unique to this set of criteria for the lifetime of the
+   * process. Load balancers may use it to cache the resolution of the criteria.
+   */
+  virtual uint64_t id() const PURE;
 };
 
 /**
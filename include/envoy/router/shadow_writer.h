@@ -1,31 +1,67 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 
-#include "envoy/http/message.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/http/header_map.h"
 
 namespace Envoy {
 namespace Router {
 
 /**
- * Interface used to shadow complete requests to an alternate upstream cluster in a "fire and
- * forget" fashion. Right now this interface takes a fully buffered request and cannot be used for
- * streaming. This is sufficient for current use cases.
+ * A request that is being streamed to a shadow cluster as it is received. The shadow request is
+ * best effort: once abandoned, the remainder of the request is silently discarded.
+ */
+class ShadowStream {
+public:
+  virtual ~ShadowStream() {}
+
+  /**
+   * Send request body data to the shadow cluster. The data is copied, so that the caller can still
+   * send it on to the primary upstream.
+   * @param data supplies the data to send.
+   * @param end_stream supplies whether this is the end of the request.
+   */
+  virtual void sendData(const Buffer::Instance& data, bool end_stream) PURE;
+
+  /**
+   * Send request trailers to the shadow cluster, completing the request.
+   * @param trailers supplies the trailers to send.
+   */
+  virtual void sendTrailers(const Http::HeaderMap& trailers) PURE;
+};
+
+typedef std::unique_ptr<ShadowStream> ShadowStreamPtr;
+
+/**
+ * Interface used to shadow requests to an alternate upstream cluster in a "fire and forget"
+ * fashion. Requests are streamed to the shadow cluster as they are received, so they never need
+ * to be buffered in full.
  */
 class ShadowWriter {
 public:
   virtual ~ShadowWriter() {}
 
   /**
-   * Shadow a request.
+   * Start shadowing a request. Destroying the returned stream before the request is complete
+   * abandons the shadow request. Once the request is complete, the shadow request carries on by
+   * itself and its response is discarded.
    * @param cluster supplies the cluster name to shadow to.
-   * @param message supplies the complete request to shadow.
+   * @param headers supplies the request headers, which are copied.
+   * @param end_stream supplies whether the request consists of headers only.
    * @param timeout supplies the shadowed request timeout.
+   * @param buffer_limit supplies the number of body bytes that may be queued for the shadow
+   *        cluster, e.g. while it is connecting, before the shadow request is abandoned. 0 means no
+   *        limit.
+   * @return ShadowStreamPtr the stream to send the rest of the request on, or nullptr if the
+   *         request could not be shadowed.
    */
-  virtual void shadow(const std::string& cluster, Http::MessagePtr&& request,
-                      std::chrono::milliseconds timeout) PURE;
+  virtual ShadowStreamPtr streamShadow(const std::string& cluster, const Http::HeaderMap& headers,
+                                       bool end_stream, std::chrono::milliseconds timeout,
+                                       uint32_t buffer_limit) PURE;
 };
 
 typedef std::unique_ptr<ShadowWriter> ShadowWriterPtr;
@@ -12,6 +12,7 @@
 #include "envoy/ratelimit/ratelimit.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/server/admin.h"
+#include "envoy/server/overload_manager.h"
 #include "envoy/singleton/manager.h"
 #include "envoy/thread_local/thread_local.h"
 #include "envoy/tracing/http_tracer.h"
@@ -81,6 +82,12 @@ public:
    */
   virtual const LocalInfo::LocalInfo& localInfo() PURE;
 
+  /**
+   * @return OverloadManager& the server's overload manager. Filters can use it to react to
+   *         resource pressure.
+   */
+  virtual OverloadManager& overloadManager() PURE;
+
   /**
    * @return RandomGenerator& the random generator for the server.
    */
@@ -185,14 +192,10 @@ public:
 };
 
 /**
- * This function is used to wrap the creation of a network filter chain for new connections as
- * they come in. Filter factories create the lambda at configuration initialization time, and then
- * they are used at runtime.
- * @param filter_manager supplies the filter manager for the connection to install filters
- * to. Typically the function will install a single filter, but it's technically possibly to
- * install more than one if desired.
+ * The network filter factory callback of Network::FilterChain, under the name network filters
+ * have always used for it.
  */
-typedef std::function<void(Network::FilterManager& filter_manager)> NetworkFilterFactoryCb;
+typedef Network::FilterFactoryCb NetworkFilterFactoryCb;
 
 /**
  * Implemented by each network filter and registered via Registry::registerFactory()
@@ -7,6 +7,7 @@
 #include "envoy/event/dispatcher.h"
 #include "envoy/stats/stats.h"
 #include "envoy/thread/thread.h"
+#include "envoy/upstream/cluster_manager.h"
 
 namespace Envoy {
 namespace Server {
@@ -51,6 +52,15 @@ public:
    */
   virtual void getParentStats(GetParentStatsInfo& info) PURE;
 
+  /**
+   * Retrieve the hosts of our parent's DNS and EDS clusters, so that our clusters can serve
+   * traffic with the parent's hosts while their first DNS resolutions and EDS updates are in
+   * flight.
+   * @param cluster_hosts will be filled with the hosts of each of the parent's clusters, and is
+   *        left empty if there is no parent.
+   */
+  virtual void getParentClusterHosts(Upstream::ClusterHostsMap& cluster_hosts) PURE;
+
   /**
    * Initialize the restarter after primary server initialization begins. The hot restart
    * implementation needs to be created early to deal with shared memory, logging, etc. so
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "envoy/common/pure.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/macros.h"
+#include "common/singleton/const_singleton.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * The state of an overload action.
+ */
+enum class OverloadActionState {
+  /**
+   * None of the triggers of the action have fired.
+   */
+  Inactive,
+  /**
+   * At least one trigger of the action has fired.
+   */
+  Active,
+};
+
+/**
+ * Callback invoked when an overload action changes state.
+ */
+typedef std::function<void(OverloadActionState)> OverloadActionCb;
+
+/**
+ * Thread-local copy of the state of all configured overload actions. Filters and connection
+ * managers can hold on to the references returned by getState() for the lifetime of the server.
+ */
+class ThreadLocalOverloadState : public ThreadLocal::ThreadLocalObject {
+public:
+  /**
+   * @param action supplies the name of an overload action.
+   * @return const OverloadActionState& the current state of the action on this thread. Actions
+   *         which are not configured are always inactive.
+   */
+  virtual const OverloadActionState& getState(const std::string& action) PURE;
+};
+
+/**
+ * Well known overload action names.
+ */
+class OverloadActionNameValues {
+public:
+  // Cap the buffer limits of newly accepted downstream connections.
+  const std::string ShrinkBufferLimits = "envoy.overload_actions.shrink_buffer_limits";
+
+  // Close HTTP/1.x downstream connections after the in flight response completes.
+  const std::string DisableHttpKeepAlive = "envoy.overload_actions.disable_http_keepalive";
+
+  // Reject new HTTP streams with a 503.
+  const std::string StopAcceptingRequests = "envoy.overload_actions.stop_accepting_requests";
+
+  // Stop accepting new downstream connections on all listeners.
+  const std::string StopAcceptingConnections = "envoy.overload_actions.stop_accepting_connections";
+};
+
+typedef ConstSingleton<OverloadActionNameValues> OverloadActionNames;
+
+/**
+ * The overload manager periodically samples the configured resource monitors and activates
+ * overload actions when their triggers fire. Components react to actions either by registering a
+ * callback, or by polling the thread-local state on the hot path.
+ */
+class OverloadManager {
+public:
+  virtual ~OverloadManager() {}
+
+  /**
+   * Start sampling the resource monitors. Must be called on the main thread after all workers
+   * have been created and all callbacks have been registered.
+   */
+  virtual void start() PURE;
+
+  /**
+   * Register a callback to be invoked when the named action changes state. The callback is posted
+   * to the supplied dispatcher, so it runs on the thread owning that dispatcher. Must be called
+   * before start().
+   * @param action supplies the name of the overload action.
+   * @param dispatcher supplies the dispatcher the callback is run on.
+   * @param callback supplies the callback.
+   * @return bool true if the action is configured and the callback was registered, false if the
+   *         action is not configured and the callback will never be invoked.
+   */
+  virtual bool registerForAction(const std::string& action, Event::Dispatcher& dispatcher,
+                                 OverloadActionCb callback) PURE;
+
+  /**
+   * @return ThreadLocalOverloadState& the overload state of the calling thread.
+   */
+  virtual ThreadLocalOverloadState& getThreadLocalOverloadState() PURE;
+
+  /**
+   * @return const OverloadActionState& a state which is always inactive, for use by components
+   *         running without an overload manager.
+   */
+  static const OverloadActionState& getInactiveState() {
+    CONSTRUCT_ON_FIRST_USE(OverloadActionState, OverloadActionState::Inactive);
+  }
+};
+
+} // namespace Server
+} // namespace Envoy
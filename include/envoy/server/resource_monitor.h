@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * A resource monitor tracks the usage of a single process wide resource (heap, connections, file
+ * descriptors, ...) and reports it as a pressure relative to a configured maximum. Monitors are
+ * only ever queried from the main thread.
+ */
+class ResourceMonitor {
+public:
+  virtual ~ResourceMonitor() {}
+
+  /**
+   * Sample the resource.
+   * @return double the current usage as a fraction of the configured maximum. 0 means the resource
+   *         is unused and 1 means it is exhausted. Values above 1 are possible if the maximum is
+   *         lower than the hard limit of the resource.
+   * @throw EnvoyException if the resource could not be sampled.
+   */
+  virtual double pressure() PURE;
+};
+
+typedef std::unique_ptr<ResourceMonitor> ResourceMonitorPtr;
+
+} // namespace Server
+} // namespace Envoy
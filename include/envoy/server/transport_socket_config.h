@@ -77,14 +77,9 @@ class DownstreamTransportSocketConfigFactory : public virtual TransportSocketCon
 public:
   /**
    * Create a particular downstream transport socket factory implementation.
-   * TODO(lizan): Revisit the parameters for SNI below when TLS sniffing and filter chain match are
-   * implemented.
-   * @param listener_name const std::string& the name of the listener.
-   * @param server_names const std::vector<std::string>& the names of the server. This parameter is
-   *        currently used by SNI implementation to know the expected server names.
-   * @param skip_ssl_context_update bool indicates whether the ssl context update should be skipped.
-   *        This parameter is currently used by SNI implementation to know whether it should perform
-   *        certificate selection.
+   * @param server_names const std::vector<std::string>& the server names of the filter chain the
+   *        transport socket is used by. The filter chain is already selected by server name when
+   *        the transport socket is created.
    * @param config const Protobuf::Message& supplies the config message for the transport socket
    *        implementation.
    * @param context TransportSocketFactoryContext& supplies the transport socket's context.
@@ -95,9 +90,8 @@ public:
    *        parameters.
    */
   virtual Network::TransportSocketFactoryPtr
-  createTransportSocketFactory(const std::string& listener_name,
-                               const std::vector<std::string>& server_names,
-                               bool skip_ssl_context_update, const Protobuf::Message& config,
+  createTransportSocketFactory(const std::vector<std::string>& server_names,
+                               const Protobuf::Message& config,
                                TransportSocketFactoryContext& context) PURE;
 };
 
@@ -3,6 +3,7 @@
 #include <functional>
 
 #include "envoy/server/guarddog.h"
+#include "envoy/server/overload_manager.h"
 
 namespace Envoy {
 namespace Server {
@@ -82,9 +83,11 @@ public:
   virtual ~WorkerFactory() {}
 
   /**
+   * @param overload_manager supplies the server's overload manager. The worker registers for the
+   *        overload actions it implements.
    * @return WorkerPtr a new worker.
    */
-  virtual WorkerPtr createWorker() PURE;
+  virtual WorkerPtr createWorker(OverloadManager& overload_manager) PURE;
 };
 
 } // namespace Server
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <vector>
 
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
@@ -24,21 +26,10 @@ public:
 
   /**
    * Builds a ServerContext from a ServerContextConfig.
-   * The skip_context_update parameter is used for fast-path (avoiding lock & context lookup)
-   * on listeners with a single filter chain and no SNI restrictions.
    */
-  virtual ServerContextPtr createSslServerContext(const std::string& listener_name,
-                                                  const std::vector<std::string>& server_names,
+  virtual ServerContextPtr createSslServerContext(const std::vector<std::string>& server_names,
                                                   Stats::Scope& scope,
-                                                  const ServerContextConfig& config,
-                                                  bool skip_context_update) PURE;
-
-  /**
-   * Find ServerContext for a given listener and server_name.
-   * @return ServerContext or nullptr in case there is no match.
-   */
-  virtual ServerContext* findSslServerContext(const std::string& listener_name,
-                                              const std::string& server_name) const PURE;
+                                                  const ServerContextConfig& config) PURE;
 
   /**
    * @return the number of days until the next certificate being managed will expire.
@@ -5,6 +5,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "envoy/common/interval_set.h"
@@ -204,6 +205,13 @@ public:
    * Flush a histogram value.
    */
   virtual void onHistogramComplete(const Histogram& histogram, uint64_t value) PURE;
+
+  /**
+   * @return bool whether the sink only needs the counters and gauges that changed since the
+   *         previous flush. Otherwise every flush is a snapshot of all counters and gauges in use,
+   *         with a delta of 0 for the counters that were not incremented.
+   */
+  virtual bool wantsChangedOnly() const PURE;
 };
 
 typedef std::unique_ptr<Sink> SinkPtr;
@@ -267,6 +275,20 @@ public:
 
 typedef std::unique_ptr<Store> StorePtr;
 
+/**
+ * The counters and gauges that changed between two flushes, see StoreRoot::latchChangedMetrics().
+ */
+struct ChangedMetrics {
+  void clear() {
+    counters_.clear();
+    gauges_.clear();
+  }
+
+  // Counters paired with the amount they were incremented by since the previous flush.
+  std::vector<std::pair<CounterSharedPtr, uint64_t>> counters_;
+  std::vector<GaugeSharedPtr> gauges_;
+};
+
 /**
  * The root of the stat store.
  */
@@ -282,6 +304,16 @@ public:
    */
   virtual void setTagProducer(TagProducerPtr&& tag_producer) PURE;
 
+  /**
+   * Latch the counters that were incremented and collect the gauges that were changed since the
+   * previous call. Only changed metrics are visited. The vectors of changed are reused, so once
+   * they have grown to the number of metrics that change per flush, flushing does not allocate.
+   * This must only be called from the main thread.
+   * @param changed supplies the metrics to fill in. It is cleared first. Callers should clear it
+   *        once they are done with it, so that it does not keep freed metrics alive.
+   */
+  virtual void latchChangedMetrics(ChangedMetrics& changed) PURE;
+
   /**
    * Initialize the store for threading. This will be called once after all worker threads have
    * been initialized. At this point the store can initialize itself for multi-threaded operation.
@@ -8,6 +8,7 @@
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/v2/cds.pb.h"
+#include "envoy/api/v2/eds.pb.h"
 #include "envoy/config/bootstrap/v2/bootstrap.pb.h"
 #include "envoy/config/grpc_mux.h"
 #include "envoy/grpc/async_client_manager.h"
@@ -22,6 +23,12 @@
 namespace Envoy {
 namespace Upstream {
 
+/**
+ * The last known hosts of clusters, keyed by cluster name. A hot restarted process starts its
+ * clusters out with the hosts its parent had, see HotRestart::getParentClusterHosts().
+ */
+typedef std::unordered_map<std::string, envoy::api::v2::ClusterLoadAssignment> ClusterHostsMap;
+
 /**
  * ClusterUpdateCallbacks provide a way to exposes Cluster lifecycle events in the
  * ClusterManager.
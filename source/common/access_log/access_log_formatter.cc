@@ -33,14 +33,27 @@ FormatterPtr AccessLogFormatUtils::defaultAccessLogFormatter() {
 
 std::string
 AccessLogFormatUtils::durationToString(const absl::optional<std::chrono::nanoseconds>& time) {
+  std::string output;
+  appendDuration(time, output);
+  return output;
+}
+
+void AccessLogFormatUtils::appendDuration(const absl::optional<std::chrono::nanoseconds>& time,
+                                          std::string& output) {
   if (time) {
-    return std::to_string(
-        std::chrono::duration_cast<std::chrono::milliseconds>(time.value()).count());
+    appendInteger(std::chrono::duration_cast<std::chrono::milliseconds>(time.value()).count(),
+                  output);
   } else {
-    return UnspecifiedValueString;
+    output.append(UnspecifiedValueString);
   }
 }
 
+void AccessLogFormatUtils::appendInteger(uint64_t value, std::string& output) {
+  char buffer[StringUtil::MIN_ITOA_OUT_LEN];
+  const uint32_t length = StringUtil::itoa(buffer, sizeof(buffer), value);
+  output.append(buffer, length);
+}
+
 const std::string&
 AccessLogFormatUtils::protocolToString(const absl::optional<Http::Protocol>& protocol) {
   if (protocol) {
@@ -58,12 +71,17 @@ std::string FormatterImpl::format(const Http::HeaderMap& request_headers,
                                   const RequestInfo::RequestInfo& request_info) const {
   std::string log_line;
   log_line.reserve(256);
+  formatTo(request_headers, response_headers, request_info, log_line);
+  return log_line;
+}
 
+void FormatterImpl::formatTo(const Http::HeaderMap& request_headers,
+                             const Http::HeaderMap& response_headers,
+                             const RequestInfo::RequestInfo& request_info,
+                             std::string& output) const {
   for (const FormatterPtr& formatter : formatters_) {
-    log_line += formatter->format(request_headers, response_headers, request_info);
+    formatter->formatTo(request_headers, response_headers, request_info, output);
   }
-
-  return log_line;
 }
 
 void AccessLogFormatParser::parseCommandHeader(const std::string& token, const size_t start,
@@ -202,80 +220,81 @@ std::vector<FormatterPtr> AccessLogFormatParser::parse(const std::string& format
 RequestInfoFormatter::RequestInfoFormatter(const std::string& field_name) {
 
   if (field_name == "REQUEST_DURATION") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return AccessLogFormatUtils::durationToString(request_info.lastDownstreamRxByteReceived());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      AccessLogFormatUtils::appendDuration(request_info.lastDownstreamRxByteReceived(), output);
     };
   } else if (field_name == "RESPONSE_DURATION") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return AccessLogFormatUtils::durationToString(request_info.firstUpstreamRxByteReceived());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      AccessLogFormatUtils::appendDuration(request_info.firstUpstreamRxByteReceived(), output);
     };
   } else if (field_name == "BYTES_RECEIVED") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return std::to_string(request_info.bytesReceived());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      AccessLogFormatUtils::appendInteger(request_info.bytesReceived(), output);
     };
   } else if (field_name == "PROTOCOL") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return AccessLogFormatUtils::protocolToString(request_info.protocol());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output.append(AccessLogFormatUtils::protocolToString(request_info.protocol()));
     };
   } else if (field_name == "RESPONSE_CODE") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.responseCode() ? std::to_string(request_info.responseCode().value())
-                                         : "0";
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      AccessLogFormatUtils::appendInteger(
+          request_info.responseCode() ? request_info.responseCode().value() : 0, output);
     };
   } else if (field_name == "BYTES_SENT") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return std::to_string(request_info.bytesSent());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      AccessLogFormatUtils::appendInteger(request_info.bytesSent(), output);
     };
   } else if (field_name == "DURATION") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return AccessLogFormatUtils::durationToString(request_info.requestComplete());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      AccessLogFormatUtils::appendDuration(request_info.requestComplete(), output);
     };
   } else if (field_name == "RESPONSE_FLAGS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return RequestInfo::ResponseFlagUtils::toShortString(request_info);
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output.append(RequestInfo::ResponseFlagUtils::toShortString(request_info));
     };
   } else if (field_name == "UPSTREAM_HOST") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
       if (request_info.upstreamHost()) {
-        return request_info.upstreamHost()->address()->asString();
+        output.append(request_info.upstreamHost()->address()->asString());
       } else {
-        return UnspecifiedValueString;
+        output.append(UnspecifiedValueString);
       }
     };
   } else if (field_name == "UPSTREAM_CLUSTER") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      std::string upstream_cluster_name;
-      if (nullptr != request_info.upstreamHost()) {
-        upstream_cluster_name = request_info.upstreamHost()->cluster().name();
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      if (nullptr != request_info.upstreamHost() &&
+          !request_info.upstreamHost()->cluster().name().empty()) {
+        output.append(request_info.upstreamHost()->cluster().name());
+      } else {
+        output.append(UnspecifiedValueString);
       }
-
-      return upstream_cluster_name.empty() ? UnspecifiedValueString : upstream_cluster_name;
     };
   } else if (field_name == "UPSTREAM_LOCAL_ADDRESS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.upstreamLocalAddress() != nullptr
-                 ? request_info.upstreamLocalAddress()->asString()
-                 : UnspecifiedValueString;
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output.append(request_info.upstreamLocalAddress() != nullptr
+                        ? request_info.upstreamLocalAddress()->asString()
+                        : UnspecifiedValueString);
     };
   } else if (field_name == "DOWNSTREAM_LOCAL_ADDRESS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.downstreamLocalAddress()->asString();
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output.append(request_info.downstreamLocalAddress()->asString());
     };
   } else if (field_name == "DOWNSTREAM_LOCAL_ADDRESS_WITHOUT_PORT") {
-    field_extractor_ = [](const Envoy::RequestInfo::RequestInfo& request_info) {
-      return RequestInfo::Utility::formatDownstreamAddressNoPort(
-          *request_info.downstreamLocalAddress());
+    field_extractor_ = [](const Envoy::RequestInfo::RequestInfo& request_info,
+                          std::string& output) {
+      output.append(RequestInfo::Utility::formatDownstreamAddressNoPort(
+          *request_info.downstreamLocalAddress()));
     };
   } else if (field_name == "DOWNSTREAM_REMOTE_ADDRESS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.downstreamRemoteAddress()->asString();
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output.append(request_info.downstreamRemoteAddress()->asString());
     };
   } else if (field_name == "DOWNSTREAM_ADDRESS" ||
              field_name == "DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT") {
     // DEPRECATED: "DOWNSTREAM_ADDRESS" will be removed post 1.6.0.
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return RequestInfo::Utility::formatDownstreamAddressNoPort(
-          *request_info.downstreamRemoteAddress());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output.append(RequestInfo::Utility::formatDownstreamAddressNoPort(
+          *request_info.downstreamRemoteAddress()));
     };
   } else {
     throw EnvoyException(fmt::format("Not supported field in RequestInfo: {}", field_name));
@@ -284,7 +303,15 @@ RequestInfoFormatter::RequestInfoFormatter(const std::string& field_name) {
 
 std::string RequestInfoFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
                                          const RequestInfo::RequestInfo& request_info) const {
-  return field_extractor_(request_info);
+  std::string output;
+  field_extractor_(request_info, output);
+  return output;
+}
+
+void RequestInfoFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                    const RequestInfo::RequestInfo& request_info,
+                                    std::string& output) const {
+  field_extractor_(request_info, output);
 }
 
 PlainStringFormatter::PlainStringFormatter(const std::string& str) : str_(str) {}
@@ -294,30 +321,41 @@ std::string PlainStringFormatter::format(const Http::HeaderMap&, const Http::Hea
   return str_;
 }
 
+void PlainStringFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                    const RequestInfo::RequestInfo&, std::string& output) const {
+  output.append(str_);
+}
+
 HeaderFormatter::HeaderFormatter(const std::string& main_header,
                                  const std::string& alternative_header,
                                  absl::optional<size_t> max_length)
     : main_header_(main_header), alternative_header_(alternative_header), max_length_(max_length) {}
 
 std::string HeaderFormatter::format(const Http::HeaderMap& headers) const {
+  std::string output;
+  formatTo(headers, output);
+  return output;
+}
+
+void HeaderFormatter::formatTo(const Http::HeaderMap& headers, std::string& output) const {
   const Http::HeaderEntry* header = headers.get(main_header_);
 
   if (!header && !alternative_header_.get().empty()) {
     header = headers.get(alternative_header_);
   }
 
-  std::string header_value_string;
+  absl::string_view header_value;
   if (!header) {
-    header_value_string = UnspecifiedValueString;
+    header_value = UnspecifiedValueString;
   } else {
-    header_value_string = header->value().c_str();
+    header_value = header->value().getStringView();
   }
 
-  if (max_length_ && header_value_string.length() > max_length_.value()) {
-    return header_value_string.substr(0, max_length_.value());
+  if (max_length_ && header_value.length() > max_length_.value()) {
+    header_value = header_value.substr(0, max_length_.value());
   }
 
-  return header_value_string;
+  output.append(header_value.data(), header_value.size());
 }
 
 ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
@@ -331,6 +369,12 @@ std::string ResponseHeaderFormatter::format(const Http::HeaderMap&,
   return HeaderFormatter::format(response_headers);
 }
 
+void ResponseHeaderFormatter::formatTo(const Http::HeaderMap&,
+                                       const Http::HeaderMap& response_headers,
+                                       const RequestInfo::RequestInfo&, std::string& output) const {
+  HeaderFormatter::formatTo(response_headers, output);
+}
+
 RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
                                                const std::string& alternative_header,
                                                absl::optional<size_t> max_length)
@@ -342,6 +386,12 @@ std::string RequestHeaderFormatter::format(const Http::HeaderMap& request_header
   return HeaderFormatter::format(request_headers);
 }
 
+void RequestHeaderFormatter::formatTo(const Http::HeaderMap& request_headers,
+                                      const Http::HeaderMap&, const RequestInfo::RequestInfo&,
+                                      std::string& output) const {
+  HeaderFormatter::formatTo(request_headers, output);
+}
+
 MetadataFormatter::MetadataFormatter(const std::string& filter_namespace,
                                      const std::vector<std::string>& path,
                                      absl::optional<size_t> max_length)
@@ -383,6 +433,12 @@ std::string DynamicMetadataFormatter::format(const Http::HeaderMap&, const Http:
   return MetadataFormatter::format(request_info.dynamicMetadata());
 }
 
+void DynamicMetadataFormatter::formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                        const RequestInfo::RequestInfo& request_info,
+                                        std::string& output) const {
+  output.append(MetadataFormatter::format(request_info.dynamicMetadata()));
+}
+
 StartTimeFormatter::StartTimeFormatter(const std::string& format) : date_formatter_(format) {}
 
 std::string StartTimeFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
@@ -394,5 +450,12 @@ std::string StartTimeFormatter::format(const Http::HeaderMap&, const Http::Heade
   }
 }
 
+void StartTimeFormatter::formatTo(const Http::HeaderMap& request_headers,
+                                  const Http::HeaderMap& response_headers,
+                                  const RequestInfo::RequestInfo& request_info,
+                                  std::string& output) const {
+  output.append(format(request_headers, response_headers, request_info));
+}
+
 } // namespace AccessLog
 } // namespace Envoy
@@ -73,6 +73,17 @@ public:
   static const std::string& protocolToString(const absl::optional<Http::Protocol>& protocol);
   static std::string durationToString(const absl::optional<std::chrono::nanoseconds>& time);
 
+  /**
+   * Append a duration in milliseconds, or "-" if it is not set, without allocating.
+   */
+  static void appendDuration(const absl::optional<std::chrono::nanoseconds>& time,
+                             std::string& output);
+
+  /**
+   * Append an unsigned integer in base 10 without allocating.
+   */
+  static void appendInteger(uint64_t value, std::string& output);
+
 private:
   AccessLogFormatUtils();
 
@@ -80,7 +91,8 @@ private:
 };
 
 /**
- * Composite formatter implementation.
+ * Composite formatter implementation. The format string is parsed once into a list of formatters
+ * that each append their field to the output.
  */
 class FormatterImpl : public Formatter {
 public:
@@ -90,6 +102,8 @@ public:
   std::string format(const Http::HeaderMap& request_headers,
                      const Http::HeaderMap& response_headers,
                      const RequestInfo::RequestInfo& request_info) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const RequestInfo::RequestInfo& request_info, std::string& output) const override;
 
 private:
   std::vector<FormatterPtr> formatters_;
@@ -106,6 +120,8 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
                      const RequestInfo::RequestInfo&) const override;
+  void formatTo(const Http::HeaderMap&, const Http::HeaderMap&, const RequestInfo::RequestInfo&,
+                std::string& output) const override;
 
 private:
   std::string str_;
@@ -117,6 +133,7 @@ public:
                   absl::optional<size_t> max_length);
 
   std::string format(const Http::HeaderMap& headers) const;
+  void formatTo(const Http::HeaderMap& headers, std::string& output) const;
 
 private:
   Http::LowerCaseString main_header_;
@@ -135,6 +152,8 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
                      const RequestInfo::RequestInfo&) const override;
+  void formatTo(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
+                const RequestInfo::RequestInfo&, std::string& output) const override;
 };
 
 /**
@@ -148,6 +167,8 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
                      const RequestInfo::RequestInfo&) const override;
+  void formatTo(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
+                const RequestInfo::RequestInfo&, std::string& output) const override;
 };
 
 /**
@@ -160,9 +181,11 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
                      const RequestInfo::RequestInfo& request_info) const override;
+  void formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                const RequestInfo::RequestInfo& request_info, std::string& output) const override;
 
 private:
-  std::function<std::string(const RequestInfo::RequestInfo&)> field_extractor_;
+  std::function<void(const RequestInfo::RequestInfo&, std::string&)> field_extractor_;
 };
 
 /**
@@ -192,6 +215,8 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
                      const RequestInfo::RequestInfo& request_info) const override;
+  void formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                const RequestInfo::RequestInfo& request_info, std::string& output) const override;
 };
 
 /**
@@ -202,6 +227,8 @@ public:
   StartTimeFormatter(const std::string& format);
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
                      const RequestInfo::RequestInfo&) const override;
+  void formatTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                const RequestInfo::RequestInfo& request_info, std::string& output) const override;
 
 private:
   const Envoy::DateFormatter date_formatter_;
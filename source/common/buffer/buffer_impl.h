@@ -7,6 +7,7 @@
 
 #include "common/common/non_copyable.h"
 #include "common/event/libevent.h"
+#include "common/memory/tagged_allocation.h"
 
 namespace Envoy {
 namespace Buffer {
@@ -60,7 +61,8 @@ public:
  * Note that due to the internals of move() accessing buffer(), OwnedImpl is not
  * compatible with non-LibEventInstance buffers.
  */
-class OwnedImpl : public LibEventInstance {
+class OwnedImpl : public LibEventInstance,
+                  public Memory::Tagged<Memory::AllocationTag::Buffer> {
 public:
   OwnedImpl();
   OwnedImpl(const std::string& data);
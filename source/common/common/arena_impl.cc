@@ -0,0 +1,77 @@
+#include "common/common/arena_impl.h"
+
+#include <algorithm>
+#include <new>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+
+namespace {
+
+// Block headers are padded so that the memory after them is suitably aligned for anything.
+constexpr size_t kBlockHeaderSize =
+    (sizeof(void*) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+} // namespace
+
+const size_t ArenaImpl::kMaxBlockSize;
+
+ArenaImpl::ArenaImpl(size_t initial_block_size)
+    : next_block_size_(std::min(std::max<size_t>(initial_block_size, 64), kMaxBlockSize)) {}
+
+ArenaImpl::~ArenaImpl() {
+  while (cleanups_ != nullptr) {
+    cleanups_->cleanup_(cleanups_->object_);
+    cleanups_ = cleanups_->next_;
+  }
+
+  while (blocks_ != nullptr) {
+    Block* next = blocks_->next_;
+    ::operator delete(blocks_);
+    blocks_ = next;
+  }
+}
+
+void* ArenaImpl::allocate(size_t size, size_t alignment) {
+  ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  ASSERT(alignment <= alignof(std::max_align_t));
+
+  if (ptr_ != nullptr) {
+    const uintptr_t start = (reinterpret_cast<uintptr_t>(ptr_) + alignment - 1) & ~(alignment - 1);
+    if (start + size <= reinterpret_cast<uintptr_t>(end_)) {
+      ptr_ = reinterpret_cast<char*>(start + size);
+      return reinterpret_cast<void*>(start);
+    }
+  }
+
+  if (size > next_block_size_ / 2) {
+    // Keep the space left in the current block for the allocations that follow. Block memory is
+    // aligned for anything, so the alignment is satisfied.
+    return newBlock(size);
+  }
+
+  char* start = newBlock(next_block_size_);
+  ptr_ = start + size;
+  end_ = start + next_block_size_;
+  next_block_size_ = std::min(next_block_size_ * 2, kMaxBlockSize);
+  return start;
+}
+
+void ArenaImpl::addCleanup(void (*cleanup)(void*), void* object) {
+  Cleanup* node = static_cast<Cleanup*>(allocate(sizeof(Cleanup), alignof(Cleanup)));
+  node->cleanup_ = cleanup;
+  node->object_ = object;
+  node->next_ = cleanups_;
+  cleanups_ = node;
+}
+
+char* ArenaImpl::newBlock(size_t size) {
+  Block* block = static_cast<Block*>(::operator new(kBlockHeaderSize + size));
+  block->next_ = blocks_;
+  blocks_ = block;
+  heap_bytes_ += kBlockHeaderSize + size;
+  return reinterpret_cast<char*>(block) + kBlockHeaderSize;
+}
+
+} // namespace Envoy
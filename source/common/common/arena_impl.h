@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "envoy/common/arena.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * An arena that allocates from blocks of memory obtained from the heap. No memory is obtained until
+ * the first allocation, so an arena that is never used costs nothing beyond its own size. Blocks
+ * double in size, up to a limit, as the arena grows. Not thread-safe.
+ */
+class ArenaImpl : public Arena, NonCopyable {
+public:
+  /**
+   * @param initial_block_size supplies the size of the first block obtained from the heap.
+   */
+  explicit ArenaImpl(size_t initial_block_size = 1024);
+  ~ArenaImpl();
+
+  // Arena
+  void* allocate(size_t size, size_t alignment) override;
+  void addCleanup(void (*cleanup)(void*), void* object) override;
+
+  /**
+   * @return size_t the number of bytes obtained from the heap, including block headers.
+   */
+  size_t heapBytes() const { return heap_bytes_; }
+
+  // Blocks never grow beyond this size. Larger allocations get a block of their own.
+  static const size_t kMaxBlockSize = 64 * 1024;
+
+private:
+  struct Block {
+    Block* next_;
+  };
+
+  struct Cleanup {
+    void (*cleanup_)(void*);
+    void* object_;
+    Cleanup* next_;
+  };
+
+  char* newBlock(size_t size);
+
+  size_t next_block_size_;
+  Block* blocks_{};
+  // The free space left in the most recent block that is not dedicated to one large allocation.
+  char* ptr_{};
+  char* end_{};
+  Cleanup* cleanups_{};
+  size_t heap_bytes_{};
+};
+
+} // namespace Envoy
@@ -6,7 +6,12 @@
 #include <pthread.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <functional>
+#include <mutex>
+#include <vector>
 
 #include "common/common/assert.h"
 #include "common/common/logger.h"
@@ -43,5 +48,44 @@ void Thread::join() {
   RELEASE_ASSERT(rc == 0);
 }
 
+void parallelFor(uint32_t concurrency, size_t count, size_t min_per_thread,
+                 const std::function<void(size_t)>& cb) {
+  const size_t max_threads = count / std::max<size_t>(min_per_thread, 1);
+  const size_t num_threads = std::max<size_t>(1, std::min<size_t>(concurrency, max_threads));
+
+  // Indices are handed out in increasing order, so once a call has thrown, the calls for higher
+  // indices can't change which exception is rethrown and are skipped.
+  std::atomic<size_t> next_index{0};
+  std::atomic<size_t> error_index{count};
+  std::mutex error_lock;
+  std::exception_ptr error;
+  auto run = [&]() -> void {
+    for (size_t i = next_index++; i < count && i < error_index; i = next_index++) {
+      try {
+        cb(i);
+      } catch (...) {
+        std::unique_lock<std::mutex> lock(error_lock);
+        if (i < error_index) {
+          error_index = i;
+          error = std::current_exception();
+        }
+      }
+    }
+  };
+
+  std::vector<ThreadPtr> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(new Thread(run));
+  }
+  run();
+  for (ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 } // namespace Thread
 } // namespace Envoy
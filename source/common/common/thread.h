@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -36,6 +37,23 @@ private:
 
 typedef std::unique_ptr<Thread> ThreadPtr;
 
+/**
+ * Calls cb(i) for each i in [0, count), spread over up to concurrency threads, one of which is the
+ * calling thread, and returns once all the calls have returned. cb must be safe to call
+ * concurrently, so it must not use thread local or dispatcher state.
+ *
+ * If calls throw, the exception thrown for the lowest i is rethrown on the calling thread once all
+ * threads are done, as a serial loop would have thrown it. Calls for higher i may be skipped.
+ *
+ * @param concurrency supplies the maximum number of threads to call cb on.
+ * @param count supplies the number of calls to make.
+ * @param min_per_thread supplies the minimum number of calls that justify starting a thread, so
+ *        that short loops are run on the calling thread only.
+ * @param cb supplies the callback to call.
+ */
+void parallelFor(uint32_t concurrency, size_t count, size_t min_per_thread,
+                 const std::function<void(size_t)>& cb);
+
 /**
  * Implementation of BasicLockable
  */
@@ -32,8 +32,10 @@ DispatcherImpl::DispatcherImpl()
 
 DispatcherImpl::DispatcherImpl(Buffer::WatermarkFactoryPtr&& factory)
     : buffer_factory_(std::move(factory)), base_(event_base_new()),
-      deferred_delete_timer_(createTimer([this]() -> void { clearDeferredDeleteList(); })),
-      post_timer_(createTimer([this]() -> void { runPostCallbacks(); })),
+      deferred_delete_timer_(new TimerImpl(*this, [this]() -> void { clearDeferredDeleteList(); },
+                                           CallbackType::DeferredDelete)),
+      post_timer_(new TimerImpl(*this, [this]() -> void { runPostCallbacks(); },
+                                CallbackType::Post)),
       current_to_delete_(&to_delete_1_) {
   RELEASE_ASSERT(Libevent::Global::initialized());
 }
@@ -117,7 +119,7 @@ DispatcherImpl::createListener(Network::Socket& socket, Network::ListenerCallbac
 
 TimerPtr DispatcherImpl::createTimer(TimerCb cb) {
   ASSERT(isThreadSafe());
-  return TimerPtr{new TimerImpl(*this, cb)};
+  return TimerPtr{new TimerImpl(*this, cb, CallbackType::Timer)};
 }
 
 void DispatcherImpl::deferredDelete(DeferredDeletablePtr&& to_delete) {
@@ -158,7 +160,62 @@ void DispatcherImpl::run(RunType type) {
   // event_base_once() before some other event, the other event might get called first.
   runPostCallbacks();
 
-  event_base_loop(base_.get(), type == RunType::NonBlock ? EVLOOP_NONBLOCK : 0);
+  if (stats_ != nullptr && type == RunType::Block) {
+    runTimedLoop();
+  } else {
+    event_base_loop(base_.get(), type == RunType::NonBlock ? EVLOOP_NONBLOCK : 0);
+  }
+}
+
+DispatcherStatsSummaryConstSharedPtr DispatcherImpl::initializeStats(Stats::Scope& scope,
+                                                                     const std::string& prefix) {
+  ASSERT(stats_ == nullptr);
+  DispatcherStats stats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, prefix))};
+  std::shared_ptr<DispatcherStatsSummaryImpl> summary =
+      std::make_shared<DispatcherStatsSummaryImpl>();
+  auto latency_stat = [&summary](Stats::Histogram& histogram) -> LatencyStat {
+    return {histogram, summary->add(histogram.name())};
+  };
+  stats_.reset(new LoopStats{latency_stat(stats.loop_duration_us_),
+                             latency_stat(stats.poll_delay_us_),
+                             {latency_stat(stats.file_event_duration_us_),
+                              latency_stat(stats.timer_duration_us_),
+                              latency_stat(stats.post_duration_us_),
+                              latency_stat(stats.deferred_delete_duration_us_)}});
+  return summary;
+}
+
+void DispatcherImpl::runTimedLoop() {
+  // libevent 2.1 has no hooks around polling, so the loop is run an iteration at a time to time
+  // each one. An iteration polls until events are ready, which is until its first callback runs,
+  // and then runs the callbacks of all the ready events.
+  int result;
+  do {
+    const MonotonicTime poll_start = std::chrono::steady_clock::now();
+    poll_end_.reset();
+    result = event_base_loop(base_.get(), EVLOOP_ONCE);
+    const MonotonicTime loop_end = std::chrono::steady_clock::now();
+
+    // Iterations that only ran untimed callbacks, such as signal handlers, count as polling.
+    const MonotonicTime poll_end = poll_end_.value_or(loop_end);
+    stats_->poll_delay_.record(poll_end - poll_start);
+    stats_->loop_duration_.record(loop_end - poll_end);
+    for (size_t i = 0; i < NUM_CALLBACK_TYPES; i++) {
+      if (callback_types_run_ & (1 << i)) {
+        stats_->callback_durations_[i].record(callback_durations_[i]);
+        callback_durations_[i] = std::chrono::nanoseconds(0);
+      }
+    }
+    callback_types_run_ = 0;
+  } while (result == 0 && !event_base_got_exit(base_.get()) &&
+           !event_base_got_break(base_.get()));
+}
+
+void DispatcherImpl::LatencyStat::record(std::chrono::nanoseconds latency) {
+  const uint64_t latency_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  histogram_.recordValue(latency_us);
+  buckets_.record(latency_us);
 }
 
 void DispatcherImpl::runPostCallbacks() {
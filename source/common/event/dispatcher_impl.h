@@ -1,19 +1,27 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <list>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/connection_handler.h"
 
 #include "common/common/logger.h"
 #include "common/common/thread.h"
+#include "common/event/dispatcher_stats_summary_impl.h"
 #include "common/event/libevent.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Event {
 
@@ -31,6 +39,33 @@ public:
    */
   event_base& base() { return *base_; }
 
+  /**
+   * Kinds of event loop callbacks, the time spent in which is recorded separately.
+   */
+  enum class CallbackType { FileEvent, Timer, Post, DeferredDelete };
+
+  /**
+   * Run a callback of the event loop, adding the time it takes to the time spent in callbacks of
+   * its type during the current iteration of the loop if stats are recorded.
+   * @param type supplies the type of the callback.
+   * @param callback supplies the callback, which may destroy the event it belongs to.
+   */
+  template <class Callback> void runCallback(CallbackType type, const Callback& callback) {
+    if (stats_ == nullptr) {
+      callback();
+      return;
+    }
+
+    const MonotonicTime start = std::chrono::steady_clock::now();
+    if (!poll_end_) {
+      poll_end_ = start;
+    }
+    callback();
+    const size_t index = static_cast<size_t>(type);
+    callback_durations_[index] += std::chrono::steady_clock::now() - start;
+    callback_types_run_ |= 1 << index;
+  }
+
   // Event::Dispatcher
   void clearDeferredDeleteList() override;
   Network::ConnectionPtr
@@ -55,10 +90,35 @@ public:
   SignalEventPtr listenForSignal(int signal_num, SignalCb cb) override;
   void post(std::function<void()> callback) override;
   void run(RunType type) override;
+  DispatcherStatsSummaryConstSharedPtr initializeStats(Stats::Scope& scope,
+                                                       const std::string& prefix) override;
   Buffer::WatermarkFactory& getWatermarkFactory() override { return *buffer_factory_; }
 
 private:
+  static const size_t NUM_CALLBACK_TYPES = 4;
+
+  /**
+   * A histogram of latencies, together with its summary.
+   */
+  struct LatencyStat {
+    void record(std::chrono::nanoseconds latency);
+
+    Stats::Histogram& histogram_;
+    LatencyBuckets& buckets_;
+  };
+
+  /**
+   * The stats of the event loop, set by initializeStats().
+   */
+  struct LoopStats {
+    LatencyStat loop_duration_;
+    LatencyStat poll_delay_;
+    // Indexed by CallbackType.
+    std::vector<LatencyStat> callback_durations_;
+  };
+
   void runPostCallbacks();
+  void runTimedLoop();
 
   // Validate that an operation is thread safe, i.e. it's invoked on the same thread that the
   // dispatcher run loop is executing on. We allow run_tid_ == 0 for tests where we don't invoke
@@ -78,6 +138,13 @@ private:
   std::mutex post_lock_;
   std::list<std::function<void()>> post_callbacks_;
   bool deferred_deleting_{};
+  std::unique_ptr<LoopStats> stats_;
+  // The time at which the current loop iteration stopped polling, once a callback has run.
+  absl::optional<MonotonicTime> poll_end_;
+  // The time spent in each type of callback during the current loop iteration, and a bit for each
+  // type of callback that has run.
+  std::array<std::chrono::nanoseconds, NUM_CALLBACK_TYPES> callback_durations_{};
+  uint32_t callback_types_run_{};
 };
 
 } // namespace Event
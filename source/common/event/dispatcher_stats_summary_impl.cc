@@ -0,0 +1,76 @@
+#include "common/event/dispatcher_stats_summary_impl.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+
+#include "common/common/fmt.h"
+
+namespace Envoy {
+namespace Event {
+
+void LatencyBuckets::record(uint64_t latency_us) {
+  size_t bucket = 0;
+  for (uint64_t value = latency_us; value != 0 && bucket < NUM_BUCKETS - 1; value >>= 1) {
+    bucket++;
+  }
+  // There is a single writer, so there is no need for atomic read-modify-writes.
+  buckets_[bucket].store(buckets_[bucket].load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+  if (latency_us > max_.load(std::memory_order_relaxed)) {
+    max_.store(latency_us, std::memory_order_relaxed);
+  }
+}
+
+uint64_t LatencyBuckets::count() const {
+  uint64_t count = 0;
+  for (const std::atomic<uint64_t>& bucket : buckets_) {
+    count += bucket.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+uint64_t LatencyBuckets::quantile(double quantile) const {
+  // Buckets may be counted into while they are summed up, so the result is approximate in more
+  // ways than one.
+  std::array<uint64_t, NUM_BUCKETS> counts;
+  uint64_t total = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  const uint64_t rank = std::max<uint64_t>(1, std::ceil(quantile * total));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return std::min(upperBound(i), max());
+    }
+  }
+  return max();
+}
+
+LatencyBuckets& DispatcherStatsSummaryImpl::add(const std::string& name) {
+  latencies_.emplace_back(std::piecewise_construct, std::forward_as_tuple(name),
+                          std::forward_as_tuple());
+  return latencies_.back().second;
+}
+
+std::string DispatcherStatsSummaryImpl::format() const {
+  std::string output;
+  for (const auto& latency : latencies_) {
+    const LatencyBuckets& buckets = latency.second;
+    output += fmt::format("{}: count={} P50={} P90={} P99={} max={}\n", latency.first,
+                          buckets.count(), buckets.quantile(0.5), buckets.quantile(0.9),
+                          buckets.quantile(0.99), buckets.max());
+  }
+  return output;
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <string>
+
+#include "envoy/event/dispatcher.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Counts of latencies in buckets of powers of two microseconds. It is written by a single thread
+ * and can be read by any thread, without locks.
+ */
+class LatencyBuckets : NonCopyable {
+public:
+  // Bucket 0 counts latencies of 0us, and bucket i > 0 counts latencies in [2^(i-1), 2^i)us. The
+  // last bucket also counts all longer latencies, from about 35 minutes.
+  static const size_t NUM_BUCKETS = 33;
+
+  /**
+   * Count a latency. Must only be called by one thread.
+   */
+  void record(uint64_t latency_us);
+
+  /**
+   * @return uint64_t the number of latencies counted.
+   */
+  uint64_t count() const;
+
+  /**
+   * @return uint64_t the upper bound of the bucket holding the latency below which the given
+   *         fraction of the latencies fall, or 0 if no latency was counted.
+   * @param quantile supplies the fraction, in [0, 1].
+   */
+  uint64_t quantile(double quantile) const;
+
+  /**
+   * @return uint64_t the largest latency counted.
+   */
+  uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+private:
+  static uint64_t upperBound(size_t bucket) { return bucket == 0 ? 0 : (1ULL << bucket) - 1; }
+
+  std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_{};
+  std::atomic<uint64_t> max_{};
+};
+
+/**
+ * DispatcherStatsSummary made of a LatencyBuckets per histogram.
+ */
+class DispatcherStatsSummaryImpl : public DispatcherStatsSummary {
+public:
+  /**
+   * Add the latencies of a histogram to the summary. Must be called before the summary is shared
+   * with other threads.
+   * @param name supplies the name of the histogram.
+   * @return LatencyBuckets& the latencies, which live as long as the summary.
+   */
+  LatencyBuckets& add(const std::string& name);
+
+  // Event::DispatcherStatsSummary
+  std::string format() const override;
+
+private:
+  // A list, so that adding to it does not move the buckets.
+  std::list<std::pair<std::string, LatencyBuckets>> latencies_;
+};
+
+} // namespace Event
+} // namespace Envoy
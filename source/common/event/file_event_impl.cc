@@ -12,7 +12,7 @@ namespace Event {
 
 FileEventImpl::FileEventImpl(DispatcherImpl& dispatcher, int fd, FileReadyCb cb,
                              FileTriggerType trigger, uint32_t events)
-    : cb_(cb), base_(&dispatcher.base()), fd_(fd), trigger_(trigger) {
+    : dispatcher_(dispatcher), cb_(cb), base_(&dispatcher.base()), fd_(fd), trigger_(trigger) {
   assignEvents(events);
   event_add(&raw_event_, nullptr);
 }
@@ -57,7 +57,9 @@ void FileEventImpl::assignEvents(uint32_t events) {
                  }
 
                  ASSERT(events);
-                 event->cb_(events);
+                 // The callback may destroy the event, so it is not used afterwards.
+                 event->dispatcher_.runCallback(DispatcherImpl::CallbackType::FileEvent,
+                                                [event, events]() { event->cb_(events); });
                },
                this);
 }
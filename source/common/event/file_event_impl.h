@@ -26,6 +26,7 @@ public:
 private:
   void assignEvents(uint32_t events);
 
+  DispatcherImpl& dispatcher_;
   FileReadyCb cb_;
   event_base* base_;
   int fd_;
@@ -15,14 +15,17 @@ namespace Event {
  */
 class TimerImpl : public Timer, ImplBase {
 public:
-  TimerImpl(DispatcherImpl& dispatcher, TimerCb cb);
+  TimerImpl(DispatcherImpl& dispatcher, TimerCb cb, DispatcherImpl::CallbackType type);
 
   // Event::Timer
   void disableTimer() override;
   void enableTimer(const std::chrono::milliseconds& d) override;
 
 private:
+  DispatcherImpl& dispatcher_;
   TimerCb cb_;
+  // The type of callback the time spent in cb_ is recorded as.
+  const DispatcherImpl::CallbackType type_;
 };
 
 } // namespace Event
@@ -200,6 +200,7 @@ void GoogleAsyncStreamImpl::notifyRemoteClose(Status::GrpcStatus grpc_status,
 
 void GoogleAsyncStreamImpl::sendMessage(const Protobuf::Message& request, bool end_stream) {
   write_pending_queue_.emplace(request, end_stream);
+  write_pending_queue_bytes_ += write_pending_queue_.back().buf_.value().Length();
   ENVOY_LOG(trace, "Queued message to write ({} bytes)",
             write_pending_queue_.back().buf_.value().Length());
   writeQueued();
@@ -303,6 +304,7 @@ void GoogleAsyncStreamImpl::handleOpCompletion(GoogleAsyncTag::Operation op, boo
   case GoogleAsyncTag::Operation::Write: {
     ASSERT(ok);
     write_pending_ = false;
+    write_pending_queue_bytes_ -= write_pending_queue_.front().buf_.value().Length();
     write_pending_queue_.pop();
     writeQueued();
     break;
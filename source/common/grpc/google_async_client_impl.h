@@ -201,6 +201,9 @@ public:
   void sendMessage(const Protobuf::Message& request, bool end_stream) override;
   void closeStream() override;
   void resetStream() override;
+  bool isAboveWriteBufferHighWatermark() const override {
+    return write_pending_queue_bytes_ > WRITE_BUFFER_HIGH_WATERMARK;
+  }
 
 protected:
   bool call_failed() const { return call_failed_; }
@@ -250,6 +253,10 @@ private:
     const bool end_stream_;
   };
 
+  // Bytes queued for writing above which isAboveWriteBufferHighWatermark() returns true. Google
+  // gRPC does not expose its own flow control window, so this bounds our queue instead.
+  static constexpr uint64_t WRITE_BUFFER_HIGH_WATERMARK = 1024 * 1024;
+
   GoogleAsyncTag init_tag_{*this, GoogleAsyncTag::Operation::Init};
   GoogleAsyncTag read_initial_metadata_tag_{*this, GoogleAsyncTag::Operation::ReadInitialMetadata};
   GoogleAsyncTag read_tag_{*this, GoogleAsyncTag::Operation::Read};
@@ -273,6 +280,8 @@ private:
   grpc::ClientContext ctxt_;
   std::unique_ptr<grpc::GenericClientAsyncReaderWriter> rw_;
   std::queue<PendingMessage> write_pending_queue_;
+  // Serialized bytes of the messages in write_pending_queue_.
+  uint64_t write_pending_queue_bytes_{};
   grpc::ByteBuffer read_buf_;
   grpc::Status status_;
   // Has Operation::Init completed?
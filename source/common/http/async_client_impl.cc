@@ -64,18 +64,18 @@ AsyncClientImpl::send(MessagePtr&& request, AsyncClient::Callbacks& callbacks,
 AsyncClient::Stream*
 AsyncClientImpl::start(AsyncClient::StreamCallbacks& callbacks,
                        const absl::optional<std::chrono::milliseconds>& timeout,
-                       bool buffer_body_for_retry) {
+                       bool buffer_body_for_retry, uint32_t buffer_limit) {
   std::unique_ptr<AsyncStreamImpl> new_stream{
-      new AsyncStreamImpl(*this, callbacks, timeout, buffer_body_for_retry)};
+      new AsyncStreamImpl(*this, callbacks, timeout, buffer_body_for_retry, buffer_limit)};
   new_stream->moveIntoList(std::move(new_stream), active_streams_);
   return active_streams_.front().get();
 }
 
 AsyncStreamImpl::AsyncStreamImpl(AsyncClientImpl& parent, AsyncClient::StreamCallbacks& callbacks,
                                  const absl::optional<std::chrono::milliseconds>& timeout,
-                                 bool buffer_body_for_retry)
+                                 bool buffer_body_for_retry, uint32_t buffer_limit)
     : parent_(parent), stream_callbacks_(callbacks), stream_id_(parent.config_.random_.random()),
-      router_(parent.config_), request_info_(Protocol::Http11),
+      buffer_limit_(buffer_limit), router_(parent.config_), request_info_(Protocol::Http11),
       tracing_config_(Tracing::EgressConfig::get()),
       route_(std::make_shared<RouteImpl>(parent_.cluster_.name(), timeout)) {
   if (buffer_body_for_retry) {
@@ -189,7 +189,7 @@ AsyncRequestImpl::AsyncRequestImpl(MessagePtr&& request, AsyncClientImpl& parent
                                    const absl::optional<std::chrono::milliseconds>& timeout)
     // We tell the underlying stream to not buffer because we already have the full request and
     // and can handle any buffered body requests.
-    : AsyncStreamImpl(parent, *this, timeout, false), request_(std::move(request)),
+    : AsyncStreamImpl(parent, *this, timeout, false, 0), request_(std::move(request)),
       callbacks_(callbacks) {}
 
 void AsyncRequestImpl::initialize() {
@@ -20,6 +20,8 @@
 #include "envoy/ssl/connection.h"
 #include "envoy/tracing/http_tracer.h"
 
+#include "common/common/arena_impl.h"
+#include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/linked_object.h"
 #include "common/http/message_impl.h"
@@ -47,7 +49,7 @@ public:
 
   Stream* start(StreamCallbacks& callbacks,
                 const absl::optional<std::chrono::milliseconds>& timeout,
-                bool buffer_body_for_retry) override;
+                bool buffer_body_for_retry, uint32_t buffer_limit) override;
 
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
 
@@ -73,13 +75,14 @@ class AsyncStreamImpl : public AsyncClient::Stream,
 public:
   AsyncStreamImpl(AsyncClientImpl& parent, AsyncClient::StreamCallbacks& callbacks,
                   const absl::optional<std::chrono::milliseconds>& timeout,
-                  bool buffer_body_for_retry);
+                  bool buffer_body_for_retry, uint32_t buffer_limit);
 
   // Http::AsyncClient::Stream
   void sendHeaders(HeaderMap& headers, bool end_stream) override;
   void sendData(Buffer::Instance& data, bool end_stream) override;
   void sendTrailers(HeaderMap& trailers) override;
   void reset() override;
+  bool isAboveWriteBufferHighWatermark() const override { return high_watermark_calls_ > 0; }
 
 protected:
   bool remoteClosed() { return remote_closed_; }
@@ -120,6 +123,7 @@ private:
     }
     uint32_t numRetries() const override { return 0; }
     uint32_t retryOn() const override { return 0; }
+    std::chrono::milliseconds hedgeDelay() const override { return std::chrono::milliseconds(0); }
   };
 
   struct NullShadowPolicy : public Router::ShadowPolicy {
@@ -246,6 +250,7 @@ private:
   RequestInfo::RequestInfo& requestInfo() override { return request_info_; }
   Tracing::Span& activeSpan() override { return active_span_; }
   const Tracing::Config& tracingConfig() override { return tracing_config_; }
+  Arena& arena() override { return arena_; }
   void continueDecoding() override { NOT_IMPLEMENTED; }
   void addDecodedData(Buffer::Instance&, bool) override { NOT_IMPLEMENTED; }
   const Buffer::Instance* decodingBuffer() override { return buffered_body_.get(); }
@@ -255,15 +260,22 @@ private:
   void encodeHeaders(HeaderMapPtr&& headers, bool end_stream) override;
   void encodeData(Buffer::Instance& data, bool end_stream) override;
   void encodeTrailers(HeaderMapPtr&& trailers) override;
-  void onDecoderFilterAboveWriteBufferHighWatermark() override {}
-  void onDecoderFilterBelowWriteBufferLowWatermark() override {}
+  void onDecoderFilterAboveWriteBufferHighWatermark() override { ++high_watermark_calls_; }
+  void onDecoderFilterBelowWriteBufferLowWatermark() override {
+    ASSERT(high_watermark_calls_ > 0);
+    --high_watermark_calls_;
+  }
   void addDownstreamWatermarkCallbacks(DownstreamWatermarkCallbacks&) override {}
   void removeDownstreamWatermarkCallbacks(DownstreamWatermarkCallbacks&) override {}
   void setDecoderBufferLimit(uint32_t) override {}
-  uint32_t decoderBufferLimit() override { return 0; }
+  uint32_t decoderBufferLimit() override { return buffer_limit_; }
 
   AsyncClient::StreamCallbacks& stream_callbacks_;
   const uint64_t stream_id_;
+  // Latched by the router when it is given its callbacks, so it must be initialized before it.
+  const uint32_t buffer_limit_;
+  // Declared before the router, so that it outlives anything the router allocates from it.
+  ArenaImpl arena_;
   Router::ProdFilter router_;
   RequestInfo::RequestInfoImpl request_info_;
   Tracing::NullSpan active_span_;
@@ -271,6 +283,9 @@ private:
   std::shared_ptr<RouteImpl> route_;
   bool local_closed_{};
   bool remote_closed_{};
+  // The number of times the router has reported the upstream connection to be above its high
+  // watermark, less the number of times it reported it being below its low watermark.
+  uint32_t high_watermark_calls_{};
   Buffer::InstancePtr buffered_body_;
   friend class AsyncClientImpl;
 };
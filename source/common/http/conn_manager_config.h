@@ -36,6 +36,7 @@ namespace Http {
   GAUGE    (downstream_cx_tx_bytes_buffered)                                                       \
   COUNTER  (downstream_cx_drain_close)                                                             \
   COUNTER  (downstream_cx_idle_timeout)                                                            \
+  COUNTER  (downstream_cx_overload_disable_keepalive)                                              \
   COUNTER  (downstream_flow_control_paused_reading_total)                                          \
   COUNTER  (downstream_flow_control_resumed_reading_total)                                         \
   COUNTER  (downstream_rq_total)                                                                   \
@@ -46,6 +47,7 @@ namespace Http {
   COUNTER  (downstream_rq_rx_reset)                                                                \
   COUNTER  (downstream_rq_tx_reset)                                                                \
   COUNTER  (downstream_rq_non_relative_path)                                                       \
+  COUNTER  (downstream_rq_overload_close)                                                          \
   COUNTER  (downstream_rq_ws_on_non_ws_route)                                                      \
   COUNTER  (downstream_rq_too_large)                                                               \
   COUNTER  (downstream_rq_1xx)                                                                     \
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -18,16 +19,19 @@
 #include "envoy/network/filter.h"
 #include "envoy/router/rds.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/server/overload_manager.h"
 #include "envoy/ssl/connection.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/tracing/http_tracer.h"
 #include "envoy/upstream/upstream.h"
 
 #include "common/buffer/watermark_buffer.h"
+#include "common/common/arena_impl.h"
 #include "common/common/linked_object.h"
 #include "common/http/conn_manager_config.h"
 #include "common/http/user_agent.h"
 #include "common/http/websocket/ws_handler_impl.h"
+#include "common/memory/pooled_allocation.h"
 #include "common/request_info/request_info_impl.h"
 #include "common/tracing/http_tracer_impl.h"
 
@@ -47,7 +51,8 @@ public:
   ConnectionManagerImpl(ConnectionManagerConfig& config, const Network::DrainDecision& drain_close,
                         Runtime::RandomGenerator& random_generator, Tracing::HttpTracer& tracer,
                         Runtime::Loader& runtime, const LocalInfo::LocalInfo& local_info,
-                        Upstream::ClusterManager& cluster_manager);
+                        Upstream::ClusterManager& cluster_manager,
+                        Server::OverloadManager* overload_manager);
   ~ConnectionManagerImpl();
 
   static ConnectionManagerStats generateStats(const std::string& prefix, Stats::Scope& scope);
@@ -91,6 +96,15 @@ private:
         : parent_(parent), headers_continued_(false), continue_headers_continued_(false),
           stopped_(false), dual_filter_(dual_filter) {}
 
+    // Filter wrappers are allocated from the stream's arena, since they all live exactly as long
+    // as the stream. Deleting a wrapper runs its destructor, and its memory is released along with
+    // the arena.
+    static void* operator new(size_t size, Arena& arena) {
+      return arena.allocate(size, alignof(std::max_align_t));
+    }
+    static void operator delete(void*, Arena&) {}
+    static void operator delete(void*) {}
+
     bool commonHandleAfter100ContinueHeadersCallback(FilterHeadersStatus status);
     bool commonHandleAfterHeadersCallback(FilterHeadersStatus status);
     void commonHandleBufferData(Buffer::Instance& provided_data);
@@ -119,6 +133,7 @@ private:
     RequestInfo::RequestInfo& requestInfo() override;
     Tracing::Span& activeSpan() override;
     Tracing::Config& tracingConfig() override;
+    Arena& arena() override;
 
     ActiveStream& parent_;
     bool headers_continued_ : 1;
@@ -242,7 +257,8 @@ private:
                         public StreamDecoder,
                         public FilterChainFactoryCallbacks,
                         public WsHandlerCallbacks,
-                        public Tracing::Config {
+                        public Tracing::Config,
+                        public Memory::Pooled<Memory::AllocationTag::Stream> {
     ActiveStream(ConnectionManagerImpl& connection_manager);
     ~ActiveStream();
 
@@ -346,6 +362,8 @@ private:
     void setBufferLimit(uint32_t limit);
 
     ConnectionManagerImpl& connection_manager_;
+    // Declared before everything that may allocate from it, so that it is destroyed last.
+    ArenaImpl arena_;
     Router::ConfigConstSharedPtr snapped_route_config_;
     Tracing::SpanPtr active_span_;
     const uint64_t stream_id_;
@@ -417,6 +435,9 @@ private:
   Runtime::Loader& runtime_;
   const LocalInfo::LocalInfo& local_info_;
   Upstream::ClusterManager& cluster_manager_;
+  // Overload action states of the thread the connection lives on.
+  const Server::OverloadActionState& overload_stop_accepting_requests_ref_;
+  const Server::OverloadActionState& overload_disable_keepalive_ref_;
   WebSocket::WsHandlerImplPtr ws_connection_{};
   Network::ReadFilterCallbacks* read_callbacks_{};
   ConnectionManagerListenerStats& listener_stats_;
@@ -10,6 +10,7 @@
 
 #include "common/common/non_copyable.h"
 #include "common/http/headers.h"
+#include "common/memory/tagged_allocation.h"
 
 namespace Envoy {
 namespace Http {
@@ -35,7 +36,8 @@ public:
  * paths use O(1) direct access. In general, we try to copy as little as possible and allocate as
  * little as possible in any of the paths.
  */
-class HeaderMapImpl : public HeaderMap {
+class HeaderMapImpl : public HeaderMap,
+                      public Memory::Tagged<Memory::AllocationTag::HeaderMap> {
 public:
   HeaderMapImpl();
   HeaderMapImpl(const std::initializer_list<std::pair<LowerCaseString, std::string>>& values);
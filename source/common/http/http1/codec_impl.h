@@ -17,6 +17,7 @@
 #include "common/http/codec_helper.h"
 #include "common/http/codes.h"
 #include "common/http/header_map_impl.h"
+#include "common/memory/pooled_allocation.h"
 
 namespace Envoy {
 namespace Http {
@@ -108,7 +109,9 @@ private:
 /**
  * Base class for HTTP/1.1 client and server connections.
  */
-class ConnectionImpl : public virtual Connection, protected Logger::Loggable<Logger::Id::http> {
+class ConnectionImpl : public virtual Connection,
+                       public Memory::Pooled<Memory::AllocationTag::HttpCodec>,
+                       protected Logger::Loggable<Logger::Id::http> {
 public:
   /**
    * @return Network::Connection& the backing network connection.
@@ -275,7 +278,7 @@ private:
   /**
    * An active HTTP/1.1 request.
    */
-  struct ActiveRequest {
+  struct ActiveRequest : public Memory::Pooled<Memory::AllocationTag::HttpCodec> {
     ActiveRequest(ConnectionImpl& connection) : response_encoder_(connection) {}
 
     HeaderString request_url_;
@@ -14,6 +14,7 @@
 #include "common/common/linked_object.h"
 #include "common/http/codec_client.h"
 #include "common/http/codec_wrappers.h"
+#include "common/memory/pooled_allocation.h"
 
 #include "absl/types/optional.h"
 
@@ -48,7 +49,8 @@ protected:
 
   struct StreamWrapper : public StreamEncoderWrapper,
                          public StreamDecoderWrapper,
-                         public StreamCallbacks {
+                         public StreamCallbacks,
+                         public Memory::Pooled<Memory::AllocationTag::ConnPool> {
     StreamWrapper(StreamDecoder& response_decoder, ActiveClient& parent);
     ~StreamWrapper();
 
@@ -75,7 +77,8 @@ protected:
 
   struct ActiveClient : LinkedObject<ActiveClient>,
                         public Network::ConnectionCallbacks,
-                        public Event::DeferredDeletable {
+                        public Event::DeferredDeletable,
+                        public Memory::Pooled<Memory::AllocationTag::ConnPool> {
     ActiveClient(ConnPoolImpl& parent);
     ~ActiveClient();
 
@@ -99,7 +102,9 @@ protected:
 
   typedef std::unique_ptr<ActiveClient> ActiveClientPtr;
 
-  struct PendingRequest : LinkedObject<PendingRequest>, public ConnectionPool::Cancellable {
+  struct PendingRequest : LinkedObject<PendingRequest>,
+                          public ConnectionPool::Cancellable,
+                          public Memory::Pooled<Memory::AllocationTag::ConnPool> {
     PendingRequest(ConnPoolImpl& parent, StreamDecoder& decoder,
                    ConnectionPool::Callbacks& callbacks);
     ~PendingRequest();
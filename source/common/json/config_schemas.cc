@@ -1261,7 +1261,8 @@ const std::string Json::Schema::TOP_LEVEL_CONFIG_SCHEMA(R"EOF(
             "type" : "object",
             "properties" : {
               "collector_cluster" : {"type" : "string"},
-              "collector_endpoint": {"type": "string"}
+              "collector_endpoint": {"type": "string"},
+              "collector_encoding": {"type": "string", "enum": ["JSON", "THRIFT"]}
             },
             "required": ["collector_cluster"],
             "additionalProperties" : false
@@ -0,0 +1,158 @@
+#include "common/memory/pooled_allocation.h"
+
+#include <atomic>
+#include <new>
+
+namespace Envoy {
+namespace Memory {
+
+namespace {
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ENVOY_POOLED_ALLOCATION_DISABLED /* Sanitized by Clang */
+#endif
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define ENVOY_POOLED_ALLOCATION_DISABLED /* Sanitized by GCC */
+#endif
+
+#ifdef ENVOY_POOLED_ALLOCATION_DISABLED
+const bool PoolingEnabled = false;
+#else
+const bool PoolingEnabled = true;
+#endif
+
+struct FreeBlock {
+  FreeBlock* next_;
+};
+
+struct FreeList {
+  size_t size_; // Size of the blocks in the list, or 0 if the list is unused.
+  FreeBlock* head_;
+  size_t length_;
+};
+
+// Trivially destructible, so that it stays usable while thread locals and statics destroyed after
+// the ThreadPoolsReleaser free pooled objects.
+struct ThreadPools {
+  FreeList lists_[TaggedAllocationStats::NumTags][AllocationPools::SizesPerTag];
+  bool released_; // Set once the thread has returned its blocks to the heap on exit.
+};
+
+thread_local ThreadPools thread_pools;
+
+// Counters are sharded like those of TaggedAllocationStats, as each thread updates them for its own
+// pools while the admin thread reads them.
+const size_t NumShards = 16;
+
+struct alignas(64) Shard {
+  std::atomic<int64_t> reused_[TaggedAllocationStats::NumTags];
+  std::atomic<int64_t> blocks_[TaggedAllocationStats::NumTags];
+  std::atomic<int64_t> bytes_[TaggedAllocationStats::NumTags];
+};
+
+Shard shards[NumShards];
+std::atomic<size_t> next_shard;
+
+Shard& localShard() {
+  static thread_local Shard& shard = shards[next_shard++ % NumShards];
+  return shard;
+}
+
+typedef std::atomic<int64_t> ShardCounters[TaggedAllocationStats::NumTags];
+
+uint64_t sum(ShardCounters Shard::*counters, AllocationTag tag) {
+  int64_t total = 0;
+  for (const Shard& shard : shards) {
+    total += (shard.*counters)[static_cast<size_t>(tag)].load(std::memory_order_relaxed);
+  }
+  return total > 0 ? total : 0;
+}
+
+void onPooled(AllocationTag tag, size_t size, int64_t blocks) {
+  Shard& shard = localShard();
+  shard.blocks_[static_cast<size_t>(tag)].fetch_add(blocks, std::memory_order_relaxed);
+  shard.bytes_[static_cast<size_t>(tag)].fetch_add(blocks * static_cast<int64_t>(size),
+                                                   std::memory_order_relaxed);
+}
+
+// Returns the blocks of its thread's pools to the heap when the thread exits.
+class ThreadPoolsReleaser {
+public:
+  ~ThreadPoolsReleaser() {
+    thread_pools.released_ = true;
+    for (size_t tag = 0; tag < TaggedAllocationStats::NumTags; tag++) {
+      for (FreeList& list : thread_pools.lists_[tag]) {
+        onPooled(static_cast<AllocationTag>(tag), list.size_, -static_cast<int64_t>(list.length_));
+        while (list.head_ != nullptr) {
+          FreeBlock* block = list.head_;
+          list.head_ = block->next_;
+          ::operator delete(block);
+        }
+        list.length_ = 0;
+      }
+    }
+  }
+};
+
+// Called before a thread first pools a block, so that its blocks are released when it exits.
+void registerThreadPoolsReleaser() { static thread_local ThreadPoolsReleaser releaser; }
+
+// Returns the list of the thread's pool for the tag and size, claiming an unused one if claim is
+// true, or nullptr if there is none.
+FreeList* findList(AllocationTag tag, size_t size, bool claim) {
+  for (FreeList& list : thread_pools.lists_[static_cast<size_t>(tag)]) {
+    if (list.size_ == size) {
+      return &list;
+    }
+    if (list.size_ == 0 && claim) {
+      registerThreadPoolsReleaser();
+      list.size_ = size;
+      return &list;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+void* AllocationPools::allocate(AllocationTag tag, size_t size) {
+  FreeList* list = findList(tag, size, false);
+  if (list != nullptr && list->head_ != nullptr) {
+    FreeBlock* block = list->head_;
+    list->head_ = block->next_;
+    list->length_--;
+    onPooled(tag, size, -1);
+    localShard().reused_[static_cast<size_t>(tag)].fetch_add(1, std::memory_order_relaxed);
+    return block;
+  }
+  return ::operator new(size);
+}
+
+void AllocationPools::deallocate(AllocationTag tag, void* ptr, size_t size) {
+  if (PoolingEnabled && !thread_pools.released_ && size >= sizeof(FreeBlock)) {
+    FreeList* list = findList(tag, size, true);
+    if (list != nullptr && list->length_ < MaxBlocksPerSize) {
+      FreeBlock* block = static_cast<FreeBlock*>(ptr);
+      block->next_ = list->head_;
+      list->head_ = block;
+      list->length_++;
+      onPooled(tag, size, 1);
+      return;
+    }
+  }
+  ::operator delete(ptr);
+}
+
+bool AllocationPools::enabled() { return PoolingEnabled; }
+
+uint64_t AllocationPools::reusedAllocations(AllocationTag tag) { return sum(&Shard::reused_, tag); }
+
+uint64_t AllocationPools::pooledBlocks(AllocationTag tag) { return sum(&Shard::blocks_, tag); }
+
+uint64_t AllocationPools::pooledBytes(AllocationTag tag) { return sum(&Shard::bytes_, tag); }
+
+} // namespace Memory
+} // namespace Envoy
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/memory/tagged_allocation.h"
+
+namespace Envoy {
+namespace Memory {
+
+/**
+ * Per thread free lists of the memory of the objects created and destroyed at the highest rates,
+ * such as connections and streams. A block freed on a thread is kept for the next allocation of the
+ * same tag and size on that thread instead of being returned to the heap. These objects are
+ * destroyed by deferred deletion on the thread running their event loop, which is also the thread
+ * creating their replacements, so under churn their memory cycles through the free lists without
+ * taking any lock.
+ *
+ * Free lists are bounded, and their blocks are returned to the heap when their thread exits.
+ * Pooling is disabled under address sanitizer so that it does not hide use after free errors.
+ */
+class AllocationPools {
+public:
+  /**
+   * Number of distinct block sizes pooled per tag and thread, for example for a class and its
+   * subclasses. Blocks of other sizes are allocated from and freed to the heap.
+   */
+  static const size_t SizesPerTag = 4;
+
+  /**
+   * Maximum number of blocks kept per tag, size and thread. Further blocks are freed to the heap.
+   */
+  static const size_t MaxBlocksPerSize = 1024;
+
+  /**
+   * Allocate a block, reusing a pooled block of the same tag and size if the thread has one.
+   * @param tag supplies the subsystem the allocation belongs to.
+   * @param size supplies the size of the allocation in bytes.
+   * @return void* the block.
+   */
+  static void* allocate(AllocationTag tag, size_t size);
+
+  /**
+   * Free a block allocated by allocate(), keeping it in the thread's pool if there is room.
+   * @param tag supplies the subsystem the allocation belongs to.
+   * @param ptr supplies the block.
+   * @param size supplies the size of the allocation in bytes.
+   */
+  static void deallocate(AllocationTag tag, void* ptr, size_t size);
+
+  /**
+   * @return bool whether blocks are pooled, which they are not under address sanitizer.
+   */
+  static bool enabled();
+
+  /**
+   * @return uint64_t the number of allocations for a tag that reused a pooled block.
+   */
+  static uint64_t reusedAllocations(AllocationTag tag);
+
+  /**
+   * @return uint64_t the number of blocks currently pooled for a tag, across threads.
+   */
+  static uint64_t pooledBlocks(AllocationTag tag);
+
+  /**
+   * @return uint64_t the number of bytes currently pooled for a tag, across threads.
+   */
+  static uint64_t pooledBytes(AllocationTag tag);
+};
+
+/**
+ * Mixin that attributes heap allocations of the deriving class (and its subclasses) to a tag like
+ * Tagged, and recycles their memory through the AllocationPools. The same requirement of a virtual
+ * destructor applies.
+ */
+template <AllocationTag tag> class Pooled {
+public:
+  static void* operator new(size_t size) {
+    void* ptr = AllocationPools::allocate(tag, size);
+    TaggedAllocationStats::onAllocate(tag, size);
+    return ptr;
+  }
+
+  static void operator delete(void* ptr, size_t size) {
+    TaggedAllocationStats::onFree(tag, size);
+    AllocationPools::deallocate(tag, ptr, size);
+  }
+};
+
+} // namespace Memory
+} // namespace Envoy
@@ -9,6 +9,8 @@
 namespace Envoy {
 namespace Memory {
 
+bool Stats::available() { return true; }
+
 uint64_t Stats::totalCurrentlyAllocated() {
   size_t value = 0;
   MallocExtension::instance()->GetNumericProperty("generic.current_allocated_bytes", &value);
@@ -29,6 +31,8 @@ uint64_t Stats::totalCurrentlyReserved() {
 namespace Envoy {
 namespace Memory {
 
+bool Stats::available() { return false; }
+
 uint64_t Stats::totalCurrentlyAllocated() { return 0; }
 uint64_t Stats::totalCurrentlyReserved() { return 0; }
 
@@ -10,6 +10,12 @@ namespace Memory {
  */
 class Stats {
 public:
+  /**
+   * @return bool whether the stats are available. They are only reported in builds with tcmalloc,
+   *              and are always 0 otherwise.
+   */
+  static bool available();
+
   /**
    * @return uint64_t the total memory currently allocated.
    */
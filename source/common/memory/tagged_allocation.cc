@@ -0,0 +1,94 @@
+#include "common/memory/tagged_allocation.h"
+
+#include <atomic>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+namespace Envoy {
+namespace Memory {
+
+namespace {
+
+// Enough shards for typical worker counts. Additional threads share shards, which is still
+// correct but may contend.
+const size_t NumShards = 16;
+
+struct alignas(64) Shard {
+  // Signed, since a buffer allocated on one thread may be freed on another.
+  std::atomic<int64_t> bytes_[TaggedAllocationStats::NumTags];
+  std::atomic<int64_t> allocations_[TaggedAllocationStats::NumTags];
+};
+
+// Zero initialized static storage, so it is usable before any dynamic initialization runs.
+Shard shards[NumShards];
+std::atomic<size_t> next_shard;
+
+Shard& localShard() {
+  static thread_local Shard& shard = shards[next_shard++ % NumShards];
+  return shard;
+}
+
+typedef std::atomic<int64_t> ShardCounters[TaggedAllocationStats::NumTags];
+
+int64_t sum(ShardCounters Shard::*counters, AllocationTag tag) {
+  int64_t total = 0;
+  for (const Shard& shard : shards) {
+    total += (shard.*counters)[static_cast<size_t>(tag)].load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+} // namespace
+
+void TaggedAllocationStats::onAllocate(AllocationTag tag, size_t size) {
+  Shard& shard = localShard();
+  shard.bytes_[static_cast<size_t>(tag)].fetch_add(size, std::memory_order_relaxed);
+  shard.allocations_[static_cast<size_t>(tag)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void TaggedAllocationStats::onFree(AllocationTag tag, size_t size) {
+  Shard& shard = localShard();
+  shard.bytes_[static_cast<size_t>(tag)].fetch_sub(size, std::memory_order_relaxed);
+  shard.allocations_[static_cast<size_t>(tag)].fetch_sub(1, std::memory_order_relaxed);
+}
+
+uint64_t TaggedAllocationStats::allocatedBytes(AllocationTag tag) {
+  const int64_t total = sum(&Shard::bytes_, tag);
+  return total > 0 ? total : 0;
+}
+
+uint64_t TaggedAllocationStats::allocations(AllocationTag tag) {
+  const int64_t total = sum(&Shard::allocations_, tag);
+  return total > 0 ? total : 0;
+}
+
+const std::string& TaggedAllocationStats::tagName(AllocationTag tag) {
+  switch (tag) {
+  case AllocationTag::Buffer: {
+    CONSTRUCT_ON_FIRST_USE(std::string, "buffer");
+  }
+  case AllocationTag::Connection: {
+    CONSTRUCT_ON_FIRST_USE(std::string, "connection");
+  }
+  case AllocationTag::ConnPool: {
+    CONSTRUCT_ON_FIRST_USE(std::string, "conn_pool");
+  }
+  case AllocationTag::HeaderMap: {
+    CONSTRUCT_ON_FIRST_USE(std::string, "header_map");
+  }
+  case AllocationTag::HttpCodec: {
+    CONSTRUCT_ON_FIRST_USE(std::string, "http_codec");
+  }
+  case AllocationTag::Stats: {
+    CONSTRUCT_ON_FIRST_USE(std::string, "stats");
+  }
+  case AllocationTag::Stream: {
+    CONSTRUCT_ON_FIRST_USE(std::string, "stream");
+  }
+  }
+  NOT_REACHED;
+}
+
+} // namespace Memory
+} // namespace Envoy
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+
+namespace Envoy {
+namespace Memory {
+
+/**
+ * Subsystems whose live allocations are tracked individually.
+ */
+enum class AllocationTag { Buffer, Connection, ConnPool, HeaderMap, HttpCodec, Stats, Stream };
+
+/**
+ * Process wide counters of live allocations per tag. Updates are sharded across cache lines by
+ * thread so that workers allocating concurrently do not contend on the same counters; the totals
+ * are only exact when read while no allocations are in progress.
+ */
+class TaggedAllocationStats {
+public:
+  static const size_t NumTags = static_cast<size_t>(AllocationTag::Stream) + 1;
+
+  /**
+   * Record an allocation.
+   * @param tag supplies the subsystem the allocation belongs to.
+   * @param size supplies the size of the allocation in bytes.
+   */
+  static void onAllocate(AllocationTag tag, size_t size);
+
+  /**
+   * Record a deallocation.
+   * @param tag supplies the subsystem the allocation belongs to.
+   * @param size supplies the size of the allocation in bytes.
+   */
+  static void onFree(AllocationTag tag, size_t size);
+
+  /**
+   * @return uint64_t the number of bytes currently allocated for a tag.
+   */
+  static uint64_t allocatedBytes(AllocationTag tag);
+
+  /**
+   * @return uint64_t the number of live allocations for a tag.
+   */
+  static uint64_t allocations(AllocationTag tag);
+
+  /**
+   * @return const std::string& the name a tag is reported under.
+   */
+  static const std::string& tagName(AllocationTag tag);
+};
+
+/**
+ * Mixin that attributes heap allocations of the deriving class (and its subclasses) to a tag. The
+ * deriving class must have a virtual destructor if it is deleted through a base pointer, so that
+ * the sized delete below sees the size of the most derived type.
+ */
+template <AllocationTag tag> class Tagged {
+public:
+  static void* operator new(size_t size) {
+    void* ptr = ::operator new(size);
+    TaggedAllocationStats::onAllocate(tag, size);
+    return ptr;
+  }
+
+  static void operator delete(void* ptr, size_t size) {
+    TaggedAllocationStats::onFree(tag, size);
+    ::operator delete(ptr);
+  }
+};
+
+} // namespace Memory
+} // namespace Envoy
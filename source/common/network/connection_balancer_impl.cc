@@ -0,0 +1,48 @@
+#include "common/network/connection_balancer_impl.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+void ExactConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  std::unique_lock<std::mutex> lock(lock_);
+  handlers_.push_back(&handler);
+}
+
+void ExactConnectionBalancerImpl::unregisterHandler(BalancedConnectionHandler& handler) {
+  std::unique_lock<std::mutex> lock(lock_);
+  auto it = std::find(handlers_.begin(), handlers_.end(), &handler);
+  ASSERT(it != handlers_.end());
+  handlers_.erase(it);
+}
+
+bool ExactConnectionBalancerImpl::balanceConnection(BalancedConnectionHandler& current_handler,
+                                                    ConnectionSocketPtr& socket) {
+  std::unique_lock<std::mutex> lock(lock_);
+  // The count is incremented under the lock, so that connections accepted at the same time on
+  // several workers are not all sent to the same one.
+  BalancedConnectionHandler* target = &current_handler;
+  uint64_t target_connections = current_handler.numConnections();
+  for (BalancedConnectionHandler* handler : handlers_) {
+    const uint64_t connections = handler->numConnections();
+    if (connections < target_connections) {
+      target = handler;
+      target_connections = connections;
+    }
+  }
+  target->incNumConnections();
+  if (target == &current_handler) {
+    return false;
+  }
+
+  // Another worker can only unregister and destroy the target once the lock is released.
+  target->post(std::move(socket));
+  return true;
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "envoy/network/listener.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Balancer that hands each accepted connection to the registered handler with the fewest
+ * connections, preferring the accepting handler on ties so that connections only move between
+ * workers when that evens out the load. Picking takes a lock shared by all the workers running the
+ * listener, which is held for a scan over one entry per worker.
+ */
+class ExactConnectionBalancerImpl : public ConnectionBalancer, NonCopyable {
+public:
+  // Network::ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  bool balanceConnection(BalancedConnectionHandler& current_handler,
+                         ConnectionSocketPtr& socket) override;
+
+private:
+  std::mutex lock_;
+  std::vector<BalancedConnectionHandler*> handlers_;
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -13,6 +13,7 @@
 #include "common/buffer/watermark_buffer.h"
 #include "common/common/logger.h"
 #include "common/event/libevent.h"
+#include "common/memory/pooled_allocation.h"
 #include "common/network/filter_manager_impl.h"
 #include "common/ssl/ssl_socket.h"
 
@@ -46,6 +47,7 @@ public:
 class ConnectionImpl : public virtual Connection,
                        public BufferSource,
                        public TransportSocketCallbacks,
+                       public Memory::Pooled<Memory::AllocationTag::Connection>,
                        protected Logger::Loggable<Logger::Id::connection> {
 public:
   ConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPtr&& socket,
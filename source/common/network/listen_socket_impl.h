@@ -4,6 +4,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/network/connection.h"
 #include "envoy/network/listen_socket.h"
@@ -88,10 +89,22 @@ public:
     remote_address_ = remote_address;
   }
   bool localAddressRestored() const override { return local_address_restored_; }
+  void setRequestedServerName(absl::string_view server_name) override {
+    server_name_ = std::string(server_name);
+  }
+  absl::string_view requestedServerName() const override { return server_name_; }
+  void setRequestedApplicationProtocols(const std::vector<std::string>& protocols) override {
+    application_protocols_ = protocols;
+  }
+  const std::vector<std::string>& requestedApplicationProtocols() const override {
+    return application_protocols_;
+  }
 
 protected:
   Address::InstanceConstSharedPtr remote_address_;
   bool local_address_restored_{false};
+  std::string server_name_;
+  std::vector<std::string> application_protocols_;
 };
 
 // ConnectionSocket used with server connections.
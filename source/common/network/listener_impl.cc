@@ -70,6 +70,18 @@ ListenerImpl::ListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, Li
   }
 }
 
+void ListenerImpl::disable() {
+  if (listener_) {
+    evconnlistener_disable(listener_.get());
+  }
+}
+
+void ListenerImpl::enable() {
+  if (listener_) {
+    evconnlistener_enable(listener_.get());
+  }
+}
+
 void ListenerImpl::errorCallback(evconnlistener*, void*) {
   // We should never get an error callback. This can happen if we run out of FDs or memory. In those
   // cases just crash.
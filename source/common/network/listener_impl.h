@@ -19,6 +19,10 @@ public:
   ListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, ListenerCallbacks& cb,
                bool bind_to_port, bool hand_off_restored_destination_connections);
 
+  // Network::Listener
+  void disable() override;
+  void enable() override;
+
 protected:
   virtual Address::InstanceConstSharedPtr getLocalAddress(int fd);
 
@@ -5,6 +5,7 @@
 #ifdef TCMALLOC
 
 #include "gperftools/heap-profiler.h"
+#include "gperftools/malloc_extension.h"
 #include "gperftools/profiler.h"
 
 namespace Envoy {
@@ -18,11 +19,26 @@ bool Cpu::startProfiler(const std::string& output_path) {
 
 void Cpu::stopProfiler() { ProfilerStop(); }
 
-void Heap::forceLink() {
-  // Currently this is here to force the inclusion of the heap profiler during static linking.
-  // Without this call the heap profiler will not be included and cannot be started via env
-  // variable. In the future we can add admin support.
-  HeapProfilerDump("");
+bool Heap::profilerEnabled() { return IsHeapProfilerRunning(); }
+
+bool Heap::startProfiler(const std::string& output_path_prefix) {
+  if (IsHeapProfilerRunning()) {
+    return false;
+  }
+  HeapProfilerStart(output_path_prefix.c_str());
+  return IsHeapProfilerRunning();
+}
+
+void Heap::stopProfiler() {
+  if (IsHeapProfilerRunning()) {
+    HeapProfilerDump("admin");
+    HeapProfilerStop();
+  }
+}
+
+bool Heap::sampledAllocations(std::string& output) {
+  MallocExtension::instance()->GetHeapSample(&output);
+  return !output.empty();
 }
 
 } // namespace Profiler
@@ -37,6 +53,11 @@ bool Cpu::profilerEnabled() { return false; }
 bool Cpu::startProfiler(const std::string&) { return false; }
 void Cpu::stopProfiler() {}
 
+bool Heap::profilerEnabled() { return false; }
+bool Heap::startProfiler(const std::string&) { return false; }
+void Heap::stopProfiler() {}
+bool Heap::sampledAllocations(std::string&) { return false; }
+
 } // namespace Profiler
 } // namespace Envoy
 
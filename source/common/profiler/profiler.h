@@ -31,8 +31,30 @@ public:
  * Process wide heap profiling
  */
 class Heap {
-private:
-  static void forceLink();
+public:
+  /**
+   * @return whether the heap profiler is running or not.
+   */
+  static bool profilerEnabled();
+
+  /**
+   * Start the heap profiler. Profiles are written to files prefixed with the specified path.
+   * @return bool whether the call to start the profiler succeeded.
+   */
+  static bool startProfiler(const std::string& output_path_prefix);
+
+  /**
+   * Dump a final profile and stop the heap profiler.
+   */
+  static void stopProfiler();
+
+  /**
+   * Fill in a pprof compatible text description of the currently sampled allocation sites.
+   * Sampling is controlled by the TCMALLOC_SAMPLE_PARAMETER environment variable.
+   * @param output supplies the string to write the sample to.
+   * @return bool whether a sample was available.
+   */
+  static bool sampledAllocations(std::string& output);
 };
 
 } // namespace Profiler
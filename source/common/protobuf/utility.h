@@ -1,11 +1,13 @@
 #pragma once
 
 #include <numeric>
+#include <thread>
 
 #include "envoy/common/exception.h"
 #include "envoy/json/json_object.h"
 
 #include "common/common/hash.h"
+#include "common/common/thread.h"
 #include "common/common/utility.h"
 #include "common/json/json_loader.h"
 #include "common/protobuf/protobuf.h"
@@ -157,6 +159,20 @@ public:
     }
   }
 
+  /**
+   * Validate protoc-gen-validate constraints on each of a list of protobufs. Long lists, such as
+   * large CDS or LDS updates, are validated across threads.
+   * @param messages messages to validate.
+   * @throw ProtoValidationException for the first message that does not satisfy its type
+   *        constraints.
+   */
+  template <class MessageType>
+  static void validate(const Protobuf::RepeatedPtrField<MessageType>& messages) {
+    // Validating a message takes a few microseconds, so only hundreds of them are worth a thread.
+    Thread::parallelFor(std::thread::hardware_concurrency(), messages.size(), 256,
+                        [&messages](size_t i) { validate(messages[i]); });
+  }
+
   template <class MessageType>
   static void loadFromFileAndValidate(const std::string& path, MessageType& message) {
     loadFromFile(path, message);
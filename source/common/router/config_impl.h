@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <list>
@@ -182,11 +183,13 @@ public:
   std::chrono::milliseconds perTryTimeout() const override { return per_try_timeout_; }
   uint32_t numRetries() const override { return num_retries_; }
   uint32_t retryOn() const override { return retry_on_; }
+  std::chrono::milliseconds hedgeDelay() const override { return hedge_delay_; }
 
 private:
   std::chrono::milliseconds per_try_timeout_{0};
   uint32_t num_retries_{};
   uint32_t retry_on_{};
+  std::chrono::milliseconds hedge_delay_{0};
 };
 
 /**
@@ -270,6 +273,7 @@ public:
   const std::vector<MetadataMatchCriterionConstSharedPtr>& metadataMatchCriteria() const override {
     return metadata_match_criteria_;
   }
+  uint64_t id() const override { return id_; }
 
 private:
   MetadataMatchCriteriaImpl(const std::vector<MetadataMatchCriterionConstSharedPtr>& criteria)
@@ -279,7 +283,13 @@ private:
   extractMetadataMatchCriteria(const MetadataMatchCriteriaImpl* parent,
                                const ProtobufWkt::Struct& metadata_matches);
 
+  static uint64_t nextId() {
+    static std::atomic<uint64_t> next_id{0};
+    return ++next_id;
+  }
+
   const std::vector<MetadataMatchCriterionConstSharedPtr> metadata_match_criteria_;
+  const uint64_t id_{nextId()};
 };
 
 /**
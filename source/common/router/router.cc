@@ -22,7 +22,6 @@
 #include "common/http/codes.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
-#include "common/http/message_impl.h"
 #include "common/http/utility.h"
 #include "common/router/config_impl.h"
 #include "common/router/retry_state_impl.h"
@@ -102,6 +101,7 @@ FilterUtility::TimeoutData FilterUtility::finalTimeout(const RouteEntry& route,
 Filter::~Filter() {
   // Upstream resources should already have been cleaned.
   ASSERT(!upstream_request_);
+  ASSERT(!hedged_request_);
   ASSERT(!retry_state_);
 }
 
@@ -287,8 +287,7 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool e
   retry_state_ =
       createRetryState(route_entry_->retryPolicy(), headers, *cluster_, config_.runtime_,
                        config_.random_, callbacks_->dispatcher(), route_entry_->priority());
-  do_shadowing_ = FilterUtility::shouldShadow(route_entry_->shadowPolicy(), config_.runtime_,
-                                              callbacks_->streamId());
+  do_hedging_ = route_entry_->retryPolicy().hedgeDelay().count() > 0;
 
   if (ENVOY_LOG_CHECK_LEVEL(debug)) {
     headers.iterate(
@@ -311,6 +310,11 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool e
   grpc_request_ = Grpc::Common::hasGrpcContentType(headers);
   upstream_request_.reset(new UpstreamRequest(*this, *conn_pool));
   upstream_request_->encodeHeaders(end_stream);
+  // Possible that we got an immediate reset. Even then we could still shadow, but that is a riskier
+  // change and seems unnecessary right now.
+  if (upstream_request_) {
+    maybeStartShadowing(end_stream);
+  }
   if (end_stream) {
     onRequestComplete();
   }
@@ -341,18 +345,23 @@ void Filter::sendNoHealthyUpstreamResponse() {
 }
 
 Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_stream) {
-  bool buffering = (retry_state_ && retry_state_->enabled()) || do_shadowing_;
+  // The shadow stream copies what it sends, so it never needs the request to be buffered.
+  if (shadow_stream_) {
+    shadow_stream_->sendData(data, end_stream);
+  }
+
+  bool buffering = (retry_state_ && retry_state_->enabled()) || do_hedging_;
   if (buffering && buffer_limit_ > 0 &&
       getLength(callbacks_->decodingBuffer()) + data.length() > buffer_limit_) {
-    // The request is larger than we should buffer. Give up on the retry/shadow
+    // The request is larger than we should buffer. Give up on the retry/hedge
     cluster_->stats().retry_or_shadow_abandoned_.inc();
     retry_state_.reset();
     buffering = false;
-    do_shadowing_ = false;
+    do_hedging_ = false;
   }
 
-  // If we are going to buffer for retries or shadowing, we need to make a copy before encoding
-  // since it's all moves from here on.
+  // If we are going to buffer for retries or hedging, we need to make a copy before encoding since
+  // it's all moves from here on.
   if (buffering) {
     Buffer::OwnedImpl copy(data);
     upstream_request_->encodeData(copy, end_stream);
@@ -364,7 +373,7 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
     onRequestComplete();
   }
 
-  // If we are potentially going to retry or shadow this request we need to buffer.
+  // If we are potentially going to retry or hedge this request we need to buffer.
   // This will not cause the connection manager to 413 because before we hit the
   // buffer limit we give up on retries and buffering.
   return buffering ? Http::FilterDataStatus::StopIterationAndBuffer
@@ -373,6 +382,9 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
 
 Http::FilterTrailersStatus Filter::decodeTrailers(Http::HeaderMap& trailers) {
   downstream_trailers_ = &trailers;
+  if (shadow_stream_) {
+    shadow_stream_->sendTrailers(trailers);
+  }
   upstream_request_->encodeTrailers(trailers);
   onRequestComplete();
   return Http::FilterTrailersStatus::StopIteration;
@@ -387,49 +399,57 @@ void Filter::setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks& callb
 }
 
 void Filter::cleanup() {
+  // A shadow request that has not been sent in full by now never will be, so this abandons it.
+  shadow_stream_.reset();
   upstream_request_.reset();
+  if (hedged_request_) {
+    cluster_->resourceManager(route_entry_->priority()).retries().dec();
+    hedged_request_.reset();
+  }
   retry_state_.reset();
   if (response_timeout_) {
     response_timeout_->disableTimer();
     response_timeout_.reset();
   }
+  if (hedge_timer_) {
+    hedge_timer_->disableTimer();
+    hedge_timer_.reset();
+  }
 }
 
-void Filter::maybeDoShadowing() {
-  if (!do_shadowing_) {
+void Filter::maybeStartShadowing(bool end_stream) {
+  if (!FilterUtility::shouldShadow(route_entry_->shadowPolicy(), config_.runtime_,
+                                   callbacks_->streamId())) {
     return;
   }
 
   ASSERT(!route_entry_->shadowPolicy().cluster().empty());
-  Http::MessagePtr request(new Http::RequestMessageImpl(
-      Http::HeaderMapPtr{new Http::HeaderMapImpl(*downstream_headers_)}));
-  if (callbacks_->decodingBuffer()) {
-    request->body().reset(new Buffer::OwnedImpl(*callbacks_->decodingBuffer()));
-  }
-  if (downstream_trailers_) {
-    request->trailers(Http::HeaderMapPtr{new Http::HeaderMapImpl(*downstream_trailers_)});
-  }
-
-  config_.shadowWriter().shadow(route_entry_->shadowPolicy().cluster(), std::move(request),
-                                timeout_.global_timeout_);
+  // The shadow may queue no more of the request than the primary request may buffer.
+  shadow_stream_ = config_.shadowWriter().streamShadow(route_entry_->shadowPolicy().cluster(),
+                                                       *downstream_headers_, end_stream,
+                                                       timeout_.global_timeout_, buffer_limit_);
 }
 
 void Filter::onRequestComplete() {
   downstream_end_stream_ = true;
   downstream_request_complete_time_ = std::chrono::steady_clock::now();
 
+  // The shadow request has been sent in full, and finishes by itself.
+  shadow_stream_.reset();
+
   // Possible that we got an immediate reset.
   if (upstream_request_) {
-    // Even if we got an immediate reset, we could still shadow, but that is a riskier change and
-    // seems unnecessary right now.
-    maybeDoShadowing();
-
     upstream_request_->setupPerTryTimeout();
     if (timeout_.global_timeout_.count() > 0) {
       response_timeout_ =
           callbacks_->dispatcher().createTimer([this]() -> void { onResponseTimeout(); });
       response_timeout_->enableTimer(timeout_.global_timeout_);
     }
+
+    if (do_hedging_) {
+      hedge_timer_ = callbacks_->dispatcher().createTimer([this]() -> void { onHedgeTimeout(); });
+      hedge_timer_->enableTimer(route_entry_->retryPolicy().hedgeDelay());
+    }
   }
 }
 
@@ -437,6 +457,9 @@ void Filter::onDestroy() {
   if (upstream_request_) {
     upstream_request_->resetStream();
   }
+  if (hedged_request_) {
+    hedged_request_->resetStream();
+  }
   stream_destroyed_ = true;
   cleanup();
 }
@@ -453,10 +476,102 @@ void Filter::onResponseTimeout() {
     }
     upstream_request_->resetStream();
   }
+  if (hedged_request_) {
+    hedged_request_->resetStream();
+  }
 
   onUpstreamReset(UpstreamResetType::GlobalTimeout, absl::optional<Http::StreamResetReason>());
 }
 
+void Filter::onHedgeTimeout() {
+  // Nothing to hedge while waiting to retry, and only one hedged request is sent at a time.
+  if (!upstream_request_ || hedged_request_ || downstream_response_started_) {
+    return;
+  }
+
+  Upstream::ResourceManager& resource_manager = cluster_->resourceManager(route_entry_->priority());
+  if (!resource_manager.retries().canCreate()) {
+    cluster_->stats().upstream_rq_hedge_overflow_.inc();
+    return;
+  }
+
+  // Connection pools are per host, so getting the pool of the outstanding request back means that
+  // the load balancer picked the host that is already being waited on.
+  Http::ConnectionPool::Instance* conn_pool = getConnPool();
+  if (!conn_pool || conn_pool == &upstream_request_->conn_pool_) {
+    return;
+  }
+
+  ENVOY_STREAM_LOG(debug, "hedging request", *callbacks_);
+  resource_manager.retries().inc();
+  cluster_->stats().upstream_rq_hedged_.inc();
+  hedged_request_.reset(new UpstreamRequest(*this, *conn_pool));
+  hedged_request_->encodeHeaders(!callbacks_->decodingBuffer() && !downstream_trailers_);
+  // It's possible we got immediately reset.
+  if (hedged_request_) {
+    if (callbacks_->decodingBuffer()) {
+      Buffer::OwnedImpl copy(*callbacks_->decodingBuffer());
+      hedged_request_->encodeData(copy, !downstream_trailers_);
+    }
+
+    if (downstream_trailers_) {
+      hedged_request_->encodeTrailers(*downstream_trailers_);
+    }
+
+    hedged_request_->setupPerTryTimeout();
+  }
+}
+
+void Filter::onHedgedResponse(UpstreamRequest& upstream_request) {
+  if (!hedged_request_) {
+    return;
+  }
+
+  if (&upstream_request == hedged_request_.get()) {
+    cluster_->stats().upstream_rq_hedge_won_.inc();
+  }
+  resolveHedge(upstream_request, true);
+}
+
+bool Filter::onHedgedReset(UpstreamRequest& upstream_request, UpstreamResetType type) {
+  if (!hedged_request_) {
+    return false;
+  }
+
+  ENVOY_STREAM_LOG(debug, "hedged upstream reset, waiting on the other request", *callbacks_);
+  if (upstream_request.upstream_host_) {
+    upstream_request.upstream_host_->outlierDetector().putHttpResponseCode(
+        enumToInt(type == UpstreamResetType::Reset ? Http::Code::ServiceUnavailable
+                                                   : timeout_response_code_));
+    upstream_request.upstream_host_->stats().rq_error_.inc();
+  }
+  resolveHedge(&upstream_request == hedged_request_.get() ? *upstream_request_ : *hedged_request_,
+               false);
+  return true;
+}
+
+void Filter::resolveHedge(UpstreamRequest& survivor, bool reset_other) {
+  ASSERT(hedged_request_);
+  cluster_->resourceManager(route_entry_->priority()).retries().dec();
+
+  UpstreamRequestPtr other;
+  if (&survivor == hedged_request_.get()) {
+    other = std::move(upstream_request_);
+    upstream_request_ = std::move(hedged_request_);
+  } else {
+    other = std::move(hedged_request_);
+  }
+
+  if (reset_other) {
+    other->resetStream();
+  }
+
+  // Either request may have been the last to select a host.
+  if (upstream_request_->upstream_host_) {
+    callbacks_->requestInfo().onUpstreamHostSelected(upstream_request_->upstream_host_);
+  }
+}
+
 void Filter::onUpstreamReset(UpstreamResetType type,
                              const absl::optional<Http::StreamResetReason>& reset_reason) {
   ASSERT(type == UpstreamResetType::GlobalTimeout || upstream_request_);
@@ -810,10 +925,12 @@ Filter::UpstreamRequest::~UpstreamRequest() {
 
 void Filter::UpstreamRequest::decode100ContinueHeaders(Http::HeaderMapPtr&& headers) {
   ASSERT(100 == Http::Utility::getResponseStatus(*headers));
+  parent_.onHedgedResponse(*this);
   parent_.onUpstream100ContinueHeaders(std::move(headers));
 }
 
 void Filter::UpstreamRequest::decodeHeaders(Http::HeaderMapPtr&& headers, bool end_stream) {
+  parent_.onHedgedResponse(*this);
   // TODO(rodaine): This is actually measuring after the headers are parsed and not the first byte.
   request_info_.onFirstUpstreamRxByteReceived();
   parent_.callbacks_->requestInfo().onFirstUpstreamRxByteReceived();
@@ -900,6 +1017,10 @@ void Filter::UpstreamRequest::onResetStream(Http::StreamResetReason reason) {
   clearRequestEncoder();
   if (!calling_encode_headers_) {
     request_info_.setResponseFlag(parent_.streamResetReasonToResponseFlag(reason));
+    // If a hedged request is racing this one, this request has now been destroyed.
+    if (parent_.onHedgedReset(*this, UpstreamResetType::Reset)) {
+      return;
+    }
     parent_.onUpstreamReset(UpstreamResetType::Reset,
                             absl::optional<Http::StreamResetReason>(reason));
   } else {
@@ -939,6 +1060,10 @@ void Filter::UpstreamRequest::onPerTryTimeout() {
   }
   resetStream();
   request_info_.setResponseFlag(RequestInfo::ResponseFlag::UpstreamRequestTimeout);
+  // If a hedged request is racing this one, this request has now been destroyed.
+  if (parent_.onHedgedReset(*this, UpstreamResetType::PerTryTimeout)) {
+    return;
+  }
   parent_.onUpstreamReset(
       UpstreamResetType::PerTryTimeout,
       absl::optional<Http::StreamResetReason>(Http::StreamResetReason::LocalReset));
@@ -134,7 +134,7 @@ class Filter : Logger::Loggable<Logger::Id::router>,
 public:
   Filter(FilterConfig& config)
       : config_(config), downstream_response_started_(false), downstream_end_stream_(false),
-        do_shadowing_(false) {}
+        do_hedging_(false) {}
 
   ~Filter();
 
@@ -298,9 +298,18 @@ private:
                                          Event::Dispatcher& dispatcher,
                                          Upstream::ResourcePriority priority) PURE;
   Http::ConnectionPool::Instance* getConnPool();
-  void maybeDoShadowing();
+  void maybeStartShadowing(bool end_stream);
   void onRequestComplete();
   void onResponseTimeout();
+  void onHedgeTimeout();
+  // Called when either of two racing requests receives the first part of a response. The other
+  // request is cancelled.
+  void onHedgedResponse(UpstreamRequest& upstream_request);
+  // Called when either of two racing requests fails. Returns true if the other request is still
+  // outstanding and is used instead, in which case the failed request has been destroyed.
+  bool onHedgedReset(UpstreamRequest& upstream_request, UpstreamResetType type);
+  // Makes the surviving request of a race the only upstream request, destroying the other.
+  void resolveHedge(UpstreamRequest& survivor, bool reset_other);
   void onUpstream100ContinueHeaders(Http::HeaderMapPtr&& headers);
   void onUpstreamHeaders(uint64_t response_code, Http::HeaderMapPtr&& headers, bool end_stream);
   void onUpstreamData(Buffer::Instance& data, bool end_stream);
@@ -336,6 +345,11 @@ private:
   FilterUtility::TimeoutData timeout_;
   Http::Code timeout_response_code_ = Http::Code::GatewayTimeout;
   UpstreamRequestPtr upstream_request_;
+  // A second request racing upstream_request_ after the hedge delay elapsed.
+  UpstreamRequestPtr hedged_request_;
+  Event::TimerPtr hedge_timer_;
+  // The request being streamed to the shadow cluster, until it has been sent in full.
+  ShadowStreamPtr shadow_stream_;
   bool grpc_request_{};
   Http::HeaderMap* downstream_headers_{};
   Http::HeaderMap* downstream_trailers_{};
@@ -348,7 +362,7 @@ private:
 
   bool downstream_response_started_ : 1;
   bool downstream_end_stream_ : 1;
-  bool do_shadowing_ : 1;
+  bool do_hedging_ : 1;
 };
 
 class ProdFilter : public Filter {
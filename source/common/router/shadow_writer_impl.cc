@@ -3,6 +3,9 @@
 #include <chrono>
 #include <string>
 
+#include "envoy/event/dispatcher.h"
+
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/http/headers.h"
 
@@ -11,19 +14,140 @@
 namespace Envoy {
 namespace Router {
 
-void ShadowWriterImpl::shadow(const std::string& cluster, Http::MessagePtr&& request,
-                              std::chrono::milliseconds timeout) {
-  ASSERT(!request->headers().Host()->value().empty());
+ShadowStreamPtr ShadowWriterImpl::streamShadow(const std::string& cluster,
+                                               const Http::HeaderMap& headers, bool end_stream,
+                                               std::chrono::milliseconds timeout,
+                                               uint32_t buffer_limit) {
+  // Configuration should guarantee that the cluster exists, but it may have been removed by CDS
+  // since.
+  Upstream::ThreadLocalCluster* thread_local_cluster = cm_.get(cluster);
+  if (thread_local_cluster == nullptr) {
+    return nullptr;
+  }
+
+  ActiveShadow* shadow = new ActiveShadow(cm_.httpAsyncClientForCluster(cluster), headers);
+  ShadowStreamPtr stream(new ShadowStreamImpl(thread_local_cluster->info(), *shadow));
+  if (!shadow->start(end_stream, timeout, buffer_limit)) {
+    return nullptr;
+  }
+  return stream;
+}
+
+ShadowWriterImpl::ActiveShadow::ActiveShadow(Http::AsyncClient& client,
+                                             const Http::HeaderMap& headers)
+    : client_(client), headers_(headers) {
+  ASSERT(!headers_.Host()->value().empty());
   // Switch authority to add a shadow postfix. This allows upstream logging to make more sense.
-  auto parts = StringUtil::splitToken(request->headers().Host()->value().c_str(), ":");
+  auto parts = StringUtil::splitToken(headers_.Host()->value().c_str(), ":");
   ASSERT(parts.size() > 0 && parts.size() <= 2);
-  request->headers().Host()->value(
-      parts.size() == 2 ? absl::StrJoin(parts, "-shadow:")
-                        : absl::StrCat(request->headers().Host()->value().c_str(), "-shadow"));
-  // Configuration should guarantee that cluster exists before calling here. This is basically
-  // fire and forget. We don't handle cancelling.
-  cm_.httpAsyncClientForCluster(cluster).send(std::move(request), *this,
-                                              absl::optional<std::chrono::milliseconds>(timeout));
+  headers_.Host()->value(parts.size() == 2
+                             ? absl::StrJoin(parts, "-shadow:")
+                             : absl::StrCat(headers_.Host()->value().c_str(), "-shadow"));
+}
+
+bool ShadowWriterImpl::ActiveShadow::start(bool end_stream, std::chrono::milliseconds timeout,
+                                           uint32_t buffer_limit) {
+  // The stream reports being above its high watermark once more than buffer_limit bytes are queued
+  // for the shadow cluster, so that the handle abandons it rather than buffering without bound.
+  Http::AsyncClient::Stream* stream = client_.start(
+      *this, absl::optional<std::chrono::milliseconds>(timeout), false, buffer_limit);
+  if (stream == nullptr) {
+    // onReset() has already been called inline.
+    return false;
+  }
+
+  stream_ = stream;
+  local_complete_ = end_stream;
+  stream_->sendHeaders(headers_, end_stream);
+  return true;
+}
+
+void ShadowWriterImpl::ActiveShadow::sendData(Buffer::Instance& data, bool end_stream) {
+  ASSERT(stream_ != nullptr && !local_complete_);
+  local_complete_ = end_stream;
+  stream_->sendData(data, end_stream);
+}
+
+void ShadowWriterImpl::ActiveShadow::sendTrailers(const Http::HeaderMap& trailers) {
+  ASSERT(stream_ != nullptr && !local_complete_);
+  local_complete_ = true;
+  trailers_.reset(new Http::HeaderMapImpl(trailers));
+  stream_->sendTrailers(*trailers_);
+}
+
+void ShadowWriterImpl::ActiveShadow::abandon() {
+  ASSERT(stream_ != nullptr);
+  // This calls onReset() inline.
+  stream_->reset();
+}
+
+void ShadowWriterImpl::ActiveShadow::onRemoteData(bool end_stream) {
+  remote_complete_ = end_stream;
+  // If the request has not been sent in full, the stream is reset by the handle the next time the
+  // router uses it.
+  if (remote_complete_ && local_complete_) {
+    finish();
+  }
+}
+
+void ShadowWriterImpl::ActiveShadow::finish() {
+  // The async client cleans up the stream itself once it is complete or reset.
+  stream_ = nullptr;
+  if (handle_ != nullptr) {
+    handle_->shadow_ = nullptr;
+    handle_ = nullptr;
+  }
+  client_.dispatcher().deferredDelete(Event::DeferredDeletablePtr{this});
+}
+
+ShadowWriterImpl::ShadowStreamImpl::~ShadowStreamImpl() {
+  if (shadow_ == nullptr) {
+    return;
+  }
+
+  if (shadow_->local_complete_) {
+    // The request has been sent in full. Let the shadow finish by itself.
+    shadow_->handle_ = nullptr;
+  } else {
+    shadow_->abandon();
+  }
+}
+
+void ShadowWriterImpl::ShadowStreamImpl::sendData(const Buffer::Instance& data, bool end_stream) {
+  if (!canSend()) {
+    return;
+  }
+
+  // The primary request still needs the data, and the async stream drains what it is sent.
+  Buffer::OwnedImpl copy(data);
+  shadow_->sendData(copy, end_stream);
+}
+
+void ShadowWriterImpl::ShadowStreamImpl::sendTrailers(const Http::HeaderMap& trailers) {
+  if (canSend()) {
+    shadow_->sendTrailers(trailers);
+  }
+}
+
+bool ShadowWriterImpl::ShadowStreamImpl::canSend() {
+  if (shadow_ == nullptr) {
+    return false;
+  }
+
+  // A shadow that has already been responded to, e.g. with a local reply when there is no healthy
+  // upstream, has no use for the rest of the request. A shadow whose upstream connection cannot
+  // keep up would have to buffer the rest of the request, so it is dropped instead.
+  if (shadow_->remote_complete_) {
+    shadow_->abandon();
+    return false;
+  }
+  if (shadow_->stream_->isAboveWriteBufferHighWatermark()) {
+    cluster_->stats().retry_or_shadow_abandoned_.inc();
+    shadow_->abandon();
+    return false;
+  }
+
+  return true;
 }
 
 } // namespace Router
@@ -3,29 +3,96 @@
 #include <chrono>
 #include <string>
 
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/http/async_client.h"
 #include "envoy/router/shadow_writer.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/http/header_map_impl.h"
+
 namespace Envoy {
 namespace Router {
 
 /**
- * Implementation of ShadowWriter that takes incoming requests to shadow and implements "fire and
- * forget" behavior using an async client.
+ * Implementation of ShadowWriter that streams requests to shadow through an async client and
+ * implements "fire and forget" behavior for their responses. A shadow request that cannot keep up
+ * with the primary request is abandoned rather than buffered.
  */
-class ShadowWriterImpl : public ShadowWriter, public Http::AsyncClient::Callbacks {
+class ShadowWriterImpl : public ShadowWriter {
 public:
   ShadowWriterImpl(Upstream::ClusterManager& cm) : cm_(cm) {}
 
   // Router::ShadowWriter
-  void shadow(const std::string& cluster, Http::MessagePtr&& request,
-              std::chrono::milliseconds timeout) override;
-
-  // Http::AsyncClient::Callbacks
-  void onSuccess(Http::MessagePtr&&) override {}
-  void onFailure(Http::AsyncClient::FailureReason) override {}
+  ShadowStreamPtr streamShadow(const std::string& cluster, const Http::HeaderMap& headers,
+                               bool end_stream, std::chrono::milliseconds timeout,
+                               uint32_t buffer_limit) override;
 
 private:
+  class ShadowStreamImpl;
+
+  /**
+   * A shadow request in flight. Owns itself, so that a request that has been sent in full outlives
+   * the primary request while its response is discarded.
+   */
+  class ActiveShadow : public Http::AsyncClient::StreamCallbacks,
+                       public Event::DeferredDeletable {
+  public:
+    ActiveShadow(Http::AsyncClient& client, const Http::HeaderMap& headers);
+
+    /**
+     * Start the shadow request by sending its headers.
+     * @return bool whether the request was started. If not, the shadow has already been scheduled
+     *         for deletion.
+     */
+    bool start(bool end_stream, std::chrono::milliseconds timeout, uint32_t buffer_limit);
+    void sendData(Buffer::Instance& data, bool end_stream);
+    void sendTrailers(const Http::HeaderMap& trailers);
+    void abandon();
+
+    // Http::AsyncClient::StreamCallbacks
+    void onHeaders(Http::HeaderMapPtr&&, bool end_stream) override { onRemoteData(end_stream); }
+    void onData(Buffer::Instance&, bool end_stream) override { onRemoteData(end_stream); }
+    void onTrailers(Http::HeaderMapPtr&&) override { onRemoteData(true); }
+    void onReset() override { finish(); }
+
+    Http::AsyncClient::Stream* stream_{};
+    ShadowStreamImpl* handle_{};
+    bool local_complete_{};
+    bool remote_complete_{};
+
+  private:
+    void onRemoteData(bool end_stream);
+    void finish();
+
+    Http::AsyncClient& client_;
+    // The async stream refers to the headers and trailers it was sent until it is done with them.
+    Http::HeaderMapImpl headers_;
+    Http::HeaderMapPtr trailers_;
+  };
+
+  /**
+   * The handle used by the router to send the rest of a request to the shadow cluster.
+   */
+  class ShadowStreamImpl : public ShadowStream {
+  public:
+    ShadowStreamImpl(Upstream::ClusterInfoConstSharedPtr cluster, ActiveShadow& shadow)
+        : cluster_(cluster), shadow_(&shadow) {
+      shadow.handle_ = this;
+    }
+    ~ShadowStreamImpl();
+
+    // Router::ShadowStream
+    void sendData(const Buffer::Instance& data, bool end_stream) override;
+    void sendTrailers(const Http::HeaderMap& trailers) override;
+
+    ActiveShadow* shadow_;
+
+  private:
+    bool canSend();
+
+    Upstream::ClusterInfoConstSharedPtr cluster_;
+  };
+
   Upstream::ClusterManager& cm_;
 };
 
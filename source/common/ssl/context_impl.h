@@ -27,7 +27,6 @@ namespace Ssl {
   COUNTER(handshake)                                                                               \
   COUNTER(session_reused)                                                                          \
   COUNTER(no_certificate)                                                                          \
-  COUNTER(fail_no_sni_match)                                                                       \
   COUNTER(fail_verify_no_cert)                                                                     \
   COUNTER(fail_verify_error)                                                                       \
   COUNTER(fail_verify_san)                                                                         \
@@ -136,24 +135,18 @@ private:
 
 class ServerContextImpl : public ContextImpl, public ServerContext {
 public:
-  ServerContextImpl(ContextManagerImpl& parent, const std::string& listener_name,
-                    const std::vector<std::string>& server_names, Stats::Scope& scope,
-                    const ServerContextConfig& config, bool skip_context_update,
+  ServerContextImpl(ContextManagerImpl& parent, const std::vector<std::string>& server_names,
+                    Stats::Scope& scope, const ServerContextConfig& config,
                     Runtime::Loader& runtime);
-  ~ServerContextImpl() { parent_.releaseServerContext(this, listener_name_, server_names_); }
+  ~ServerContextImpl() { parent_.releaseServerContext(this); }
 
 private:
-  ssl_select_cert_result_t processClientHello(const SSL_CLIENT_HELLO* client_hello);
-  void updateConnectionContext(SSL* ssl);
-
   int alpnSelectCallback(const unsigned char** out, unsigned char* outlen, const unsigned char* in,
                          unsigned int inlen);
   int sessionTicketProcess(SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx,
                            HMAC_CTX* hmac_ctx, int encrypt);
 
-  const std::string listener_name_;
   const std::vector<std::string> server_names_;
-  const bool skip_context_update_;
   Runtime::Loader& runtime_;
   std::vector<uint8_t> parsed_alt_alpn_protocols_;
   const std::vector<ServerContextConfig::SessionTicketKey> session_ticket_keys_;
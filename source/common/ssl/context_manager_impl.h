@@ -3,7 +3,8 @@
 #include <functional>
 #include <list>
 #include <shared_mutex>
-#include <unordered_map>
+#include <string>
+#include <vector>
 
 #include "envoy/runtime/runtime.h"
 #include "envoy/ssl/context_manager.h"
@@ -17,6 +18,9 @@ namespace Ssl {
  * thread). They can be released from any thread (and in practice are since cluster information can
  * be released from any thread). Context allocation/free is a very uncommon thing so we just do a
  * global lock to protect it all.
+ *
+ * Server contexts are never looked up on the handshake path: the listener picks the filter chain,
+ * and so the server context, from the requested server name before the connection is created.
  */
 class ContextManagerImpl final : public ContextManager {
 public:
@@ -29,30 +33,21 @@ public:
    * of contexts.
    */
   void releaseClientContext(ClientContext* context);
-  void releaseServerContext(ServerContext* context, const std::string& listener_name,
-                            const std::vector<std::string>& server_names);
+  void releaseServerContext(ServerContext* context);
 
   // Ssl::ContextManager
   Ssl::ClientContextPtr createSslClientContext(Stats::Scope& scope,
                                                const ClientContextConfig& config) override;
-  Ssl::ServerContextPtr createSslServerContext(const std::string& listener_name,
-                                               const std::vector<std::string>& server_names,
-                                               Stats::Scope& scope,
-                                               const ServerContextConfig& config,
-                                               bool skip_context_update) override;
-  Ssl::ServerContext* findSslServerContext(const std::string& listener_name,
-                                           const std::string& server_name) const override;
+  Ssl::ServerContextPtr
+  createSslServerContext(const std::vector<std::string>& server_names, Stats::Scope& scope,
+                         const ServerContextConfig& config) override;
   size_t daysUntilFirstCertExpires() const override;
   void iterateContexts(std::function<void(const Context&)> callback) override;
 
 private:
-  static bool isWildcardServerName(const std::string& name);
-
   Runtime::Loader& runtime_;
   std::list<Context*> contexts_;
   mutable std::shared_timed_mutex contexts_lock_;
-  std::unordered_map<std::string, std::unordered_map<std::string, ServerContext*>> map_exact_;
-  std::unordered_map<std::string, std::unordered_map<std::string, ServerContext*>> map_wildcard_;
 };
 
 } // namespace Ssl
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/network/transport_socket.h"
 
@@ -76,9 +77,9 @@ private:
 
 class ServerSslSocketFactory : public Network::TransportSocketFactory {
 public:
-  ServerSslSocketFactory(const ServerContextConfig& config, const std::string& listener_name,
-                         const std::vector<std::string>& server_names, bool skip_context_update,
-                         Ssl::ContextManager& manager, Stats::Scope& stats_scope);
+  ServerSslSocketFactory(const ServerContextConfig& config,
+                         const std::vector<std::string>& server_names, Ssl::ContextManager& manager,
+                         Stats::Scope& stats_scope);
   Network::TransportSocketPtr createTransportSocket() const override;
   bool implementsSecureTransport() const override;
 
@@ -0,0 +1,248 @@
+#include "common/stats/segmented_raw_stat_data_set.h"
+
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+namespace Envoy {
+namespace Stats {
+
+SegmentedRawStatDataSet::SegmentedRawStatDataSet(Control& control,
+                                                 const SegmentedRawStatDataSetOptions& options,
+                                                 bool init, MapMemoryCb map_memory)
+    : control_(control), map_memory_(map_memory) {
+  if (init) {
+    initialize(options);
+  } else if (!attach()) {
+    throw EnvoyException("SegmentedRawStatDataSet: Incompatible memory block");
+  }
+}
+
+SegmentedRawStatDataSet::ValueCreatedPair
+SegmentedRawStatDataSet::insert(absl::string_view key) {
+  RawStatData* value = get(key);
+  if (value != nullptr) {
+    return ValueCreatedPair(value, false);
+  }
+
+  const uint64_t size = blockSize(key);
+  const uint64_t ref = allocateBlock(size);
+  if (ref == NullRef) {
+    return ValueCreatedPair(nullptr, false);
+  }
+
+  const uint64_t slot = computeSlot(key);
+  Block& block = getBlock(ref);
+  block.size_ = size;
+  block.next_ = slots_[slot];
+  slots_[slot] = ref;
+  value = &blockData(block);
+  value->initialize(key);
+  ++control_.size_;
+  return ValueCreatedPair(value, true);
+}
+
+bool SegmentedRawStatDataSet::remove(absl::string_view key) {
+  const bool mapped = mapNewSegments();
+  RELEASE_ASSERT(mapped);
+  uint64_t* next = &slots_[computeSlot(key)];
+  while (*next != NullRef) {
+    const uint64_t ref = *next;
+    Block& block = getBlock(ref);
+    if (blockKey(block) == key) {
+      // Splice the block out of the slot chain.
+      *next = block.next_;
+      freeBlock(ref, block);
+      --control_.size_;
+      return true;
+    }
+    next = &block.next_;
+  }
+  return false;
+}
+
+RawStatData* SegmentedRawStatDataSet::get(absl::string_view key) {
+  // Other users of the set may have added segments holding stats in the chains.
+  const bool mapped = mapNewSegments();
+  RELEASE_ASSERT(mapped);
+  for (uint64_t ref = slots_[computeSlot(key)]; ref != NullRef;) {
+    Block& block = getBlock(ref);
+    if (blockKey(block) == key) {
+      return &blockData(block);
+    }
+    ref = block.next_;
+  }
+  return nullptr;
+}
+
+void SegmentedRawStatDataSet::sanityCheck() {
+  RELEASE_ASSERT(control_.num_segments_ <= control_.max_segments_);
+  RELEASE_ASSERT(segments_.size() == control_.num_segments_);
+  RELEASE_ASSERT(control_.last_segment_used_ <= control_.segment_size_);
+
+  // Make sure there are control_.size_ values reachable from the slots, each in a mapped segment
+  // and in the right chain. Avoid infinite loops if there is a cycle within a chain.
+  uint64_t num_values = 0;
+  for (uint64_t slot = 0; slot < control_.num_slots_; ++slot) {
+    uint64_t next = NullRef; // initialized to silence compilers.
+    for (uint64_t ref = slots_[slot]; (ref != NullRef) && (num_values <= control_.size_);
+         ref = next) {
+      Block& block = getBlock(ref);
+      const absl::string_view key = blockKey(block);
+      RELEASE_ASSERT(block.size_ == blockSize(key));
+      RELEASE_ASSERT(computeSlot(key) == slot);
+      next = block.next_;
+      ++num_values;
+    }
+  }
+  RELEASE_ASSERT(num_values == control_.size_);
+}
+
+std::string SegmentedRawStatDataSet::segmentName(uint64_t index) {
+  return fmt::format("segment_{}", index);
+}
+
+std::string SegmentedRawStatDataSet::version() {
+  return fmt::format("segmented block_header={} hash={}", sizeof(Block) + sizeof(RawStatData),
+                     RawStatData::hash(signatureStringToHash()));
+}
+
+uint64_t SegmentedRawStatDataSet::blockSize(absl::string_view key) {
+  // The name is stored with its nul terminator, and blocks are laid out back to back, so each one
+  // is padded to keep the next RawStatData naturally aligned for its atomics.
+  const uint64_t alignment = alignof(RawStatData);
+  const uint64_t size = sizeof(Block) + sizeof(RawStatData) + key.size() + 1;
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+RawStatData& SegmentedRawStatDataSet::blockData(Block& block) {
+  return *reinterpret_cast<RawStatData*>(reinterpret_cast<uint8_t*>(&block) + sizeof(Block));
+}
+
+absl::string_view SegmentedRawStatDataSet::blockKey(Block& block) {
+  // Bound the name by the block rather than by RawStatData::maxNameLength(), as the block may have
+  // been allocated by a process configured with a longer maximum.
+  const RawStatData& data = blockData(block);
+  return absl::string_view(data.name_,
+                           strnlen(data.name_, block.size_ - sizeof(Block) - sizeof(RawStatData)));
+}
+
+std::string SegmentedRawStatDataSet::signatureStringToHash() {
+  // A string composed of all the non-zero 8-bit characters. This is used for detecting if the
+  // hash algorithm changes, which invalidates any saved stats-set.
+  std::string signature_string;
+  signature_string.resize(255);
+  for (int i = 1; i <= 255; ++i) {
+    signature_string[i - 1] = i;
+  }
+  return signature_string;
+}
+
+void SegmentedRawStatDataSet::initialize(const SegmentedRawStatDataSetOptions& options) {
+  RELEASE_ASSERT(options.num_slots > 0);
+  // Offsets into a segment are kept in the low 32 bits of a ref.
+  RELEASE_ASSERT(options.segment_size > 0 &&
+                 options.segment_size <= std::numeric_limits<uint32_t>::max());
+
+  memset(&control_, 0, sizeof(control_));
+  control_.hash_signature_ = RawStatData::hash(signatureStringToHash());
+  control_.num_slots_ = options.num_slots;
+  control_.segment_size_ = options.segment_size;
+  control_.max_segments_ = options.max_segments;
+
+  // Created memory is zero filled, so every slot starts out as an empty chain.
+  static_assert(NullRef == 0, "slots must be initialized to NullRef");
+  slots_ =
+      reinterpret_cast<uint64_t*>(map_memory_("slots", options.num_slots * sizeof(uint64_t), true));
+  if (slots_ == nullptr) {
+    throw EnvoyException("SegmentedRawStatDataSet: unable to create hash slots");
+  }
+}
+
+bool SegmentedRawStatDataSet::attach() {
+  if (RawStatData::hash(signatureStringToHash()) != control_.hash_signature_) {
+    ENVOY_LOG(error, "SegmentedRawStatDataSet hash signature mismatch.");
+    return false;
+  }
+  slots_ = reinterpret_cast<uint64_t*>(
+      map_memory_("slots", control_.num_slots_ * sizeof(uint64_t), false));
+  if (slots_ == nullptr || !mapNewSegments()) {
+    ENVOY_LOG(error, "SegmentedRawStatDataSet unable to map existing memory.");
+    return false;
+  }
+  sanityCheck();
+  return true;
+}
+
+bool SegmentedRawStatDataSet::mapNewSegments() {
+  while (segments_.size() < control_.num_segments_) {
+    uint8_t* segment = map_memory_(segmentName(segments_.size()), control_.segment_size_, false);
+    if (segment == nullptr) {
+      return false;
+    }
+    segments_.push_back(segment);
+  }
+  return true;
+}
+
+uint64_t SegmentedRawStatDataSet::allocateBlock(uint64_t size) {
+  const uint64_t free_list = size / alignof(RawStatData);
+  if (free_list < NUM_FREE_LISTS && control_.free_lists_[free_list] != NullRef) {
+    const uint64_t ref = control_.free_lists_[free_list];
+    control_.free_lists_[free_list] = getBlock(ref).next_;
+    return ref;
+  }
+
+  if (control_.num_segments_ == 0 ||
+      control_.last_segment_used_ + size > control_.segment_size_) {
+    // The rest of the current segment is left unused.
+    if (size > control_.segment_size_ || control_.num_segments_ >= control_.max_segments_) {
+      return NullRef;
+    }
+    uint8_t* segment = map_memory_(segmentName(control_.num_segments_),
+                                   control_.segment_size_, true);
+    if (segment == nullptr) {
+      return NullRef;
+    }
+    ASSERT(segments_.size() == control_.num_segments_);
+    segments_.push_back(segment);
+    ++control_.num_segments_;
+    control_.last_segment_used_ = 0;
+  }
+
+  const uint64_t ref = makeRef(control_.num_segments_ - 1, control_.last_segment_used_);
+  control_.last_segment_used_ += size;
+  return ref;
+}
+
+void SegmentedRawStatDataSet::freeBlock(uint64_t ref, Block& block) {
+  // Zero the value so that the block can be initialized again.
+  memset(reinterpret_cast<uint8_t*>(&block) + sizeof(Block), 0, block.size_ - sizeof(Block));
+
+  // Blocks too large for a free list are only used by very long names, and are not reused.
+  const uint64_t free_list = block.size_ / alignof(RawStatData);
+  if (free_list < NUM_FREE_LISTS) {
+    block.next_ = control_.free_lists_[free_list];
+    control_.free_lists_[free_list] = ref;
+  }
+}
+
+SegmentedRawStatDataSet::Block& SegmentedRawStatDataSet::getBlock(uint64_t ref) {
+  const uint64_t segment = (ref >> 32) - 1;
+  const uint64_t offset = ref & std::numeric_limits<uint32_t>::max();
+  RELEASE_ASSERT(segment < segments_.size());
+  RELEASE_ASSERT(offset + sizeof(Block) <= control_.segment_size_);
+  return *reinterpret_cast<Block*>(segments_[segment] + offset);
+}
+
+uint64_t SegmentedRawStatDataSet::computeSlot(absl::string_view key) const {
+  return RawStatData::hash(key) % control_.num_slots_;
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/common/logger.h"
+#include "common/stats/stats_impl.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Sizing parameters for a SegmentedRawStatDataSet. They are only used when the set is first
+ * initialized: they are then copied to the control block, and processes attaching to the set
+ * later use the copied values, so they may be configured differently.
+ */
+struct SegmentedRawStatDataSetOptions {
+  uint64_t num_slots;    // number of hash chains. Stats beyond this just make the chains longer.
+  uint64_t segment_size; // bytes in each memory segment holding stats, less than 4GiB.
+  uint64_t max_segments; // limit on the number of segments the set will grow to.
+};
+
+/**
+ * Implements hash_set<RawStatData> without using pointers, suitable for use in shared memory.
+ * Unlike SharedMemoryHashSet the set has no fixed capacity: stats are stored in memory segments
+ * which are added as they fill up, and each stat only takes as much memory as its name needs.
+ *
+ * The set is made up of
+ * - a fixed size Control block, which the caller places in memory shared by all users of the set,
+ * - an array of hash slots, mapped once when the set is created or attached to,
+ * - up to max_segments segments holding the stats, each mapped when first seen.
+ * The slots and segments are named memory regions mapped through a callback, so that a process
+ * attaching to the set can map the regions created by other processes.
+ *
+ * Note that no locking of any kind is done by this class; this must be done at the call-site to
+ * support concurrent access.
+ */
+class SegmentedRawStatDataSet : public Logger::Loggable<Logger::Id::config> {
+public:
+  /**
+   * Number of distinct block sizes that freed blocks are kept for, so they can be reused by stats
+   * with names of a similar length. Blocks larger than this many multiples of alignof(RawStatData)
+   * are not reused.
+   */
+  static const uint64_t NUM_FREE_LISTS = 128;
+
+  /**
+   * Represents control-values for the set. This is laid directly into shared memory, so it only
+   * holds fixed size fields.
+   */
+  struct Control {
+    uint64_t hash_signature_;             // Hash of a constant signature string.
+    uint64_t num_slots_;                  // Number of hash slots.
+    uint64_t segment_size_;               // Size in bytes of each segment.
+    uint64_t max_segments_;               // Limit on the number of segments.
+    uint64_t size_;                       // Number of values currently stored.
+    uint64_t num_segments_;               // Number of segments created so far.
+    uint64_t last_segment_used_;          // Bytes used in the newest segment.
+    uint64_t free_lists_[NUM_FREE_LISTS]; // Freed blocks, indexed by block size.
+  };
+
+  /**
+   * Maps a named memory region into the calling process.
+   * @param name supplies the name of the region, unique within the set.
+   * @param size supplies the size of the region in bytes.
+   * @param create supplies whether the region should be created, in which case it must be zero
+   *        filled. Otherwise it has already been created by a user of the set.
+   * @return uint8_t* the mapped memory, or nullptr if it could not be mapped.
+   */
+  typedef std::function<uint8_t*(const std::string& name, uint64_t size, bool create)> MapMemoryCb;
+
+  /** Type used by insert() to indicate the value at a key, and whether it was created */
+  typedef std::pair<RawStatData*, bool> ValueCreatedPair;
+
+  /**
+   * @param control supplies the control block of the set.
+   * @param options supplies the set parameters, used if init is true.
+   * @param init true if the set should be initialized. If false, the set in control is sanity
+   *        checked, and an exception thrown if it is incoherent.
+   * @param map_memory supplies the callback used to map the slots and segments of the set.
+   */
+  SegmentedRawStatDataSet(Control& control, const SegmentedRawStatDataSetOptions& options,
+                          bool init, MapMemoryCb map_memory);
+
+  /**
+   * Inserts a value into the set, adding a segment if the current one is full. If the value was
+   * already present, {value, false} is returned. If it is newly allocated, {value, true} is
+   * returned. {nullptr, false} is returned if the set has reached max_segments, or a new segment
+   * could not be mapped.
+   * @param key supplies the key, which must be at most RawStatData::maxNameLength() long.
+   */
+  ValueCreatedPair insert(absl::string_view key);
+
+  /**
+   * Removes the specified key from the set and zeroes its value, returning true if the key was
+   * found.
+   * @param key the key to remove.
+   */
+  bool remove(absl::string_view key);
+
+  /**
+   * Gets the value associated with a key, returning nullptr if the value was not found.
+   * @param key supplies the key.
+   */
+  RawStatData* get(absl::string_view key);
+
+  /** Returns the number of values stored in the set. */
+  uint64_t size() const { return control_.size_; }
+
+  /** Returns the number of segments created so far. */
+  uint64_t numSegments() const { return control_.num_segments_; }
+
+  /** Examines the data structures to see if they are sane, assert-failing on any trouble. */
+  void sanityCheck();
+
+  /**
+   * Computes a version signature based on the memory layout and the hash function. It does not
+   * depend on the options, which a process attaching to the set takes from the control block.
+   */
+  static std::string version();
+
+  /**
+   * @return std::string the name under which a segment is mapped.
+   * @param index supplies the index of the segment.
+   */
+  static std::string segmentName(uint64_t index);
+
+private:
+  friend class SegmentedRawStatDataSetTest;
+
+  /**
+   * Header of each block of a segment. The RawStatData follows it directly.
+   */
+  struct Block {
+    uint64_t next_; // Ref of the next block in a hash chain or free list, or NullRef.
+    uint64_t size_; // Size of the block in bytes, including this header.
+  };
+
+  // Blocks are referred to by a ref combining their segment index plus one and their offset in
+  // the segment, so that zero means no block.
+  static const uint64_t NullRef = 0;
+
+  static uint64_t makeRef(uint64_t segment, uint64_t offset) {
+    return ((segment + 1) << 32) | offset;
+  }
+  static uint64_t blockSize(absl::string_view key);
+  static RawStatData& blockData(Block& block);
+  static absl::string_view blockKey(Block& block);
+  static std::string signatureStringToHash();
+
+  void initialize(const SegmentedRawStatDataSetOptions& options);
+  bool attach();
+  bool mapNewSegments();
+  uint64_t allocateBlock(uint64_t size);
+  void freeBlock(uint64_t ref, Block& block);
+  Block& getBlock(uint64_t ref);
+  uint64_t computeSlot(absl::string_view key) const;
+
+  Control& control_;
+  MapMemoryCb map_memory_;
+  uint64_t* slots_{};
+  // Segments mapped by this process so far.
+  std::vector<uint8_t*> segments_;
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -11,9 +11,11 @@
 #include "common/common/perf_annotation.h"
 #include "common/common/utility.h"
 #include "common/config/well_known_names.h"
+#include "common/memory/tagged_allocation.h"
 
 #include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
+#include "absl/strings/strip.h"
 
 namespace Envoy {
 namespace Stats {
@@ -33,6 +35,45 @@ bool regexStartsWithDot(absl::string_view regex) {
   return absl::StartsWith(regex, "\\.") || absl::StartsWith(regex, "(?=\\.)");
 }
 
+bool isWordChar(char c) { return absl::ascii_isalnum(c) || c == '_'; }
+
+// Consumes a literal made up of word characters and escaped dots from the front of regex, appending
+// the characters it matches to literal. Returns whether anything was consumed.
+bool consumeLiteral(absl::string_view& regex, std::string& literal) {
+  const size_t size = literal.size();
+  while (!regex.empty()) {
+    if (isWordChar(regex[0])) {
+      literal.push_back(regex[0]);
+      regex.remove_prefix(1);
+    } else if (absl::ConsumePrefix(&regex, "\\.")) {
+      literal.push_back('.');
+    } else {
+      break;
+    }
+  }
+  return literal.size() > size;
+}
+
+// Consumes \d or \d{n} from the front of regex, setting num_digits to the number of digits matched.
+bool consumeDigits(absl::string_view& regex, size_t& num_digits) {
+  if (!absl::ConsumePrefix(&regex, "\\d")) {
+    return false;
+  }
+  if (!absl::ConsumePrefix(&regex, "{")) {
+    num_digits = 1;
+    return true;
+  }
+  const size_t close = regex.find('}');
+  uint64_t n;
+  if (close == absl::string_view::npos ||
+      !StringUtil::atoul(std::string(regex.substr(0, close)).c_str(), n) || n == 0) {
+    return false;
+  }
+  num_digits = n;
+  regex.remove_prefix(close + 1);
+  return true;
+}
+
 } // namespace
 
 size_t RawStatData::size() {
@@ -69,10 +110,142 @@ std::string Utility::sanitizeStatsName(const std::string& name) {
   return stats_name;
 }
 
+std::unique_ptr<const TokenTagMatcher> TokenTagMatcher::create(absl::string_view regex) {
+  if (absl::StartsWith(regex, "^")) {
+    return createToken(regex);
+  }
+  return createDigitsSuffix(regex);
+}
+
+std::unique_ptr<TokenTagMatcher> TokenTagMatcher::createToken(absl::string_view regex) {
+  std::unique_ptr<TokenTagMatcher> matcher(new TokenTagMatcher(Type::Token));
+  absl::ConsumePrefix(&regex, "^");
+  if (!consumeLiteral(regex, matcher->prefix_)) {
+    return nullptr;
+  }
+
+  if (absl::ConsumePrefix(&regex, "(?=\\.).*?")) {
+    const std::string& infix = matcher->infix_;
+    if (!consumeLiteral(regex, matcher->infix_) || infix.size() < 2 || infix.front() != '.' ||
+        infix.back() != '.') {
+      return nullptr;
+    }
+  } else if (matcher->prefix_.back() != '.') {
+    return nullptr;
+  }
+
+  if (!absl::ConsumePrefix(&regex, "((.*?)\\.)")) {
+    return nullptr;
+  }
+  matcher->word_suffix_ = absl::ConsumePrefix(&regex, "\\w+?$");
+  if (!regex.empty()) {
+    return nullptr;
+  }
+  return matcher;
+}
+
+std::unique_ptr<TokenTagMatcher> TokenTagMatcher::createDigitsSuffix(absl::string_view regex) {
+  std::unique_ptr<TokenTagMatcher> matcher(new TokenTagMatcher(Type::DigitsSuffix));
+  if (!consumeLiteral(regex, matcher->lead_) || !absl::ConsumePrefix(&regex, "(")) {
+    return nullptr;
+  }
+
+  if (consumeLiteral(regex, matcher->sep_)) {
+    if (!absl::ConsumePrefix(&regex, "(") || !consumeDigits(regex, matcher->num_digits_) ||
+        !absl::ConsumePrefix(&regex, "))")) {
+      return nullptr;
+    }
+  } else if (!consumeDigits(regex, matcher->num_digits_) || !absl::ConsumePrefix(&regex, ")")) {
+    return nullptr;
+  }
+
+  consumeLiteral(regex, matcher->trailer_);
+  if (regex != "$") {
+    return nullptr;
+  }
+  return matcher;
+}
+
+bool TokenTagMatcher::match(absl::string_view stat_name, size_t& remove_start, size_t& remove_end,
+                            absl::string_view& value) const {
+  switch (type_) {
+  case Type::Token:
+    return matchToken(stat_name, remove_start, remove_end, value);
+  case Type::DigitsSuffix:
+    return matchDigitsSuffix(stat_name, remove_start, remove_end, value);
+  }
+  NOT_REACHED;
+}
+
+bool TokenTagMatcher::matchToken(absl::string_view stat_name, size_t& remove_start,
+                                 size_t& remove_end, absl::string_view& value) const {
+  if (!absl::StartsWith(stat_name, prefix_)) {
+    return false;
+  }
+
+  size_t start = prefix_.size();
+  if (!infix_.empty()) {
+    // The lazy .*? before the infix means the first occurrence is the one that matches: any later
+    // occurrence would itself supply the '.' that the first occurrence needs to match.
+    if (start == stat_name.size() || stat_name[start] != '.') {
+      return false;
+    }
+    const size_t infix = stat_name.find(infix_, start);
+    if (infix == absl::string_view::npos) {
+      return false;
+    }
+    start = infix + infix_.size();
+  }
+
+  size_t end;
+  if (word_suffix_) {
+    end = stat_name.rfind('.');
+    if (end == absl::string_view::npos || end < start || end + 1 == stat_name.size() ||
+        !std::all_of(stat_name.begin() + end + 1, stat_name.end(), isWordChar)) {
+      return false;
+    }
+  } else {
+    end = stat_name.find('.', start);
+    if (end == absl::string_view::npos) {
+      return false;
+    }
+  }
+
+  remove_start = start;
+  remove_end = end + 1;
+  value = stat_name.substr(start, end - start);
+  return true;
+}
+
+bool TokenTagMatcher::matchDigitsSuffix(absl::string_view stat_name, size_t& remove_start,
+                                        size_t& remove_end, absl::string_view& value) const {
+  const size_t size = lead_.size() + sep_.size() + num_digits_ + trailer_.size();
+  if (stat_name.size() < size) {
+    return false;
+  }
+
+  absl::string_view suffix = stat_name.substr(stat_name.size() - size);
+  if (!absl::ConsumePrefix(&suffix, lead_)) {
+    return false;
+  }
+  remove_start = stat_name.size() - suffix.size();
+  if (!absl::ConsumePrefix(&suffix, sep_)) {
+    return false;
+  }
+  value = suffix.substr(0, num_digits_);
+  if (!std::all_of(value.begin(), value.end(), absl::ascii_isdigit) ||
+      suffix.substr(num_digits_) != trailer_) {
+    return false;
+  }
+  remove_end = stat_name.size() - trailer_.size();
+  return true;
+}
+
 TagExtractorImpl::TagExtractorImpl(const std::string& name, const std::string& regex,
                                    const std::string& substr)
     : name_(name), prefix_(std::string(extractRegexPrefix(regex))), substr_(substr),
-      regex_(RegexUtil::parseRegex(regex)) {}
+      matcher_(TokenTagMatcher::create(regex)),
+      regex_(matcher_ != nullptr ? std::regex() : RegexUtil::parseRegex(regex)) {}
 
 std::string TagExtractorImpl::extractRegexPrefix(absl::string_view regex) {
   std::string prefix;
@@ -121,6 +294,19 @@ bool TagExtractorImpl::extractTag(const std::string& stat_name, std::vector<Tag>
     return false;
   }
 
+  if (matcher_ != nullptr) {
+    size_t remove_start;
+    size_t remove_end;
+    absl::string_view value;
+    if (matcher_->match(stat_name, remove_start, remove_end, value)) {
+      addTag(std::string(value), remove_start, remove_end, tags, remove_characters);
+      PERF_RECORD(perf, "token-match", name_);
+      return true;
+    }
+    PERF_RECORD(perf, "token-miss", name_);
+    return false;
+  }
+
   std::smatch match;
   // The regex must match and contain one or more subexpressions (all after the first are ignored).
   if (std::regex_search(stat_name, match, regex_) && match.size() > 1) {
@@ -133,15 +319,9 @@ bool TagExtractorImpl::extractTag(const std::string& stat_name, std::vector<Tag>
     // second submatch, then the value_subexpr is the same as the remove_subexpr.
     const auto& value_subexpr = match.size() > 2 ? match[2] : remove_subexpr;
 
-    tags.emplace_back();
-    Tag& tag = tags.back();
-    tag.name_ = name_;
-    tag.value_ = value_subexpr.str();
-
     // Determines which characters to remove from stat_name to elide remove_subexpr.
-    std::string::size_type start = remove_subexpr.first - stat_name.begin();
-    std::string::size_type end = remove_subexpr.second - stat_name.begin();
-    remove_characters.insert(start, end);
+    addTag(value_subexpr.str(), remove_subexpr.first - stat_name.begin(),
+           remove_subexpr.second - stat_name.begin(), tags, remove_characters);
     PERF_RECORD(perf, "re-match", name_);
     return true;
   }
@@ -149,9 +329,20 @@ bool TagExtractorImpl::extractTag(const std::string& stat_name, std::vector<Tag>
   return false;
 }
 
+void TagExtractorImpl::addTag(std::string&& value, size_t remove_start, size_t remove_end,
+                              std::vector<Tag>& tags,
+                              IntervalSet<size_t>& remove_characters) const {
+  tags.emplace_back();
+  Tag& tag = tags.back();
+  tag.name_ = name_;
+  tag.value_ = std::move(value);
+  remove_characters.insert(remove_start, remove_end);
+}
+
 RawStatData* HeapRawStatDataAllocator::alloc(const std::string& name) {
   // This must be zero-initialized
   RawStatData* data = static_cast<RawStatData*>(::calloc(RawStatData::size(), 1));
+  Memory::TaggedAllocationStats::onAllocate(Memory::AllocationTag::Stats, RawStatData::size());
   data->initialize(name);
   return data;
 }
@@ -258,6 +449,7 @@ TagProducerImpl::addDefaultExtractors(const envoy::config::metrics::v2::StatsCon
 void HeapRawStatDataAllocator::free(RawStatData& data) {
   // This allocator does not ever have concurrent access to the raw data.
   ASSERT(data.ref_count_ == 1);
+  Memory::TaggedAllocationStats::onFree(Memory::AllocationTag::Stats, RawStatData::size());
   ::free(&data);
 }
 
@@ -26,6 +26,70 @@
 namespace Envoy {
 namespace Stats {
 
+/**
+ * Matches stat names against the restricted forms of tag regex that most of the default tag
+ * extractors use, without std::regex. A match is identical to the one std::regex_search would find
+ * for the regex the matcher was created from. The supported forms are:
+ *   ^<prefix>\.((.*?)\.)                        e.g. ^cluster\.((.*?)\.)
+ *   ^<prefix>(?=\.).*?\.<infix>\.((.*?)\.)      e.g. ^listener(?=\.).*?\.http\.((.*?)\.)
+ * either of which may be followed by \w+?$, and
+ *   <lead>(<sep>(\d{<n>}))<trailer>$              e.g. _rq(_(\d{3}))$
+ *   <lead>(\d{<n>})<trailer>$                     e.g. _rq_(\d)xx$
+ * where each of <prefix>, <infix>, <lead>, <sep> and <trailer> is made up of word characters and
+ * escaped dots.
+ */
+class TokenTagMatcher {
+public:
+  /**
+   * @param regex absl::string_view the tag extraction regex.
+   * @return std::unique_ptr<const TokenTagMatcher> a matcher equivalent to the regex, or nullptr if
+   *         the regex is not of a supported form.
+   */
+  static std::unique_ptr<const TokenTagMatcher> create(absl::string_view regex);
+
+  /**
+   * @param stat_name absl::string_view the stat name to match.
+   * @param remove_start size_t& set to the offset of the first character to remove from stat_name
+   *        on a match.
+   * @param remove_end size_t& set to one past the offset of the last character to remove from
+   *        stat_name on a match.
+   * @param value absl::string_view& set to the tag value on a match.
+   * @return bool whether stat_name matched.
+   */
+  bool match(absl::string_view stat_name, size_t& remove_start, size_t& remove_end,
+             absl::string_view& value) const;
+
+private:
+  enum class Type { Token, DigitsSuffix };
+
+  TokenTagMatcher(Type type) : type_(type) {}
+
+  static std::unique_ptr<TokenTagMatcher> createToken(absl::string_view regex);
+  static std::unique_ptr<TokenTagMatcher> createDigitsSuffix(absl::string_view regex);
+
+  bool matchToken(absl::string_view stat_name, size_t& remove_start, size_t& remove_end,
+                  absl::string_view& value) const;
+  bool matchDigitsSuffix(absl::string_view stat_name, size_t& remove_start, size_t& remove_end,
+                         absl::string_view& value) const;
+
+  const Type type_;
+
+  // Type::Token: the stat name starts with prefix_. If infix_ is non-empty, the character after the
+  // prefix must be a '.' and the tag starts after the first occurrence of infix_ (which begins and
+  // ends with a '.') that follows. The tag extends to the next '.' or, if word_suffix_ is set, to
+  // the last '.', which must be followed only by one or more word characters.
+  std::string prefix_;
+  std::string infix_;
+  bool word_suffix_{};
+
+  // Type::DigitsSuffix: the stat name ends with lead_, sep_, num_digits_ digits and trailer_. The
+  // tag value is the digits, and sep_ is removed along with them.
+  std::string lead_;
+  std::string sep_;
+  size_t num_digits_{};
+  std::string trailer_;
+};
+
 class TagExtractorImpl : public TagExtractor {
 public:
   /**
@@ -63,9 +127,15 @@ private:
    */
   static std::string extractRegexPrefix(absl::string_view regex);
 
+  void addTag(std::string&& value, size_t remove_start, size_t remove_end, std::vector<Tag>& tags,
+              IntervalSet<size_t>& remove_characters) const;
+
   const std::string name_;
   const std::string prefix_;
   const std::string substr_;
+  // Set if the regex is of a form that can be matched without std::regex, in which case regex_ is
+  // not compiled.
+  const std::unique_ptr<const TokenTagMatcher> matcher_;
   const std::regex regex_;
 };
 
@@ -290,6 +360,29 @@ private:
   const std::vector<Tag> tags_;
 };
 
+/**
+ * A metric's bit in a bitmap of the metrics that changed since they were last flushed. Setting it
+ * is lock free, and only writes to the bitmap the first time the metric changes after the bit was
+ * cleared. A default constructed bit is not backed by a bitmap and does nothing.
+ */
+class DirtyBit {
+public:
+  DirtyBit() {}
+  DirtyBit(std::atomic<uint64_t>& word, uint64_t mask) : word_(&word), mask_(mask) {}
+
+  void set() {
+    // Sequentially consistent so that the load is ordered after the update of the metric. The
+    // flusher clears the bit before reading the metric, so an update is never missed.
+    if (word_ != nullptr && !(word_->load() & mask_)) {
+      word_->fetch_or(mask_);
+    }
+  }
+
+private:
+  std::atomic<uint64_t>* word_{};
+  uint64_t mask_{};
+};
+
 /**
  * Counter implementation that wraps a RawStatData.
  */
@@ -301,11 +394,18 @@ public:
         alloc_(alloc) {}
   ~CounterImpl() { alloc_.free(data_); }
 
+  /**
+   * Set the bit to mark when the counter is incremented. Must be called before the counter is
+   * shared with other threads.
+   */
+  void setDirtyBit(const DirtyBit& dirty) { dirty_ = dirty; }
+
   // Stats::Counter
   void add(uint64_t amount) override {
     data_.value_ += amount;
     data_.pending_increment_ += amount;
     data_.flags_ |= RawStatData::Flags::Used;
+    dirty_.set();
   }
 
   void inc() override { add(1); }
@@ -317,6 +417,7 @@ public:
 private:
   RawStatData& data_;
   RawStatDataAllocator& alloc_;
+  DirtyBit dirty_;
 };
 
 /**
@@ -330,21 +431,30 @@ public:
         alloc_(alloc) {}
   ~GaugeImpl() { alloc_.free(data_); }
 
+  /**
+   * Set the bit to mark when the gauge changes. Must be called before the gauge is shared with
+   * other threads.
+   */
+  void setDirtyBit(const DirtyBit& dirty) { dirty_ = dirty; }
+
   // Stats::Gauge
   virtual void add(uint64_t amount) override {
     data_.value_ += amount;
     data_.flags_ |= RawStatData::Flags::Used;
+    dirty_.set();
   }
   virtual void dec() override { sub(1); }
   virtual void inc() override { add(1); }
   virtual void set(uint64_t value) override {
     data_.value_ = value;
     data_.flags_ |= RawStatData::Flags::Used;
+    dirty_.set();
   }
   virtual void sub(uint64_t amount) override {
     ASSERT(data_.value_ >= amount);
     ASSERT(used());
     data_.value_ -= amount;
+    dirty_.set();
   }
   virtual uint64_t value() const override { return data_.value_; }
   bool used() const override { return data_.flags_ & RawStatData::Flags::Used; }
@@ -352,6 +462,7 @@ public:
 private:
   RawStatData& data_;
   RawStatDataAllocator& alloc_;
+  DirtyBit dirty_;
 };
 
 /**
@@ -0,0 +1,110 @@
+#include "common/stats/symbol_table_impl.h"
+
+#include <string>
+
+#include "common/common/assert.h"
+
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Stats {
+
+StatName SymbolTable::encode(absl::string_view name) {
+  StatName stat_name;
+  std::unique_lock<std::mutex> lock(lock_);
+  for (absl::string_view token : absl::StrSplit(name, '.')) {
+    auto it = encode_map_.find(token);
+    if (it == encode_map_.end()) {
+      Symbol symbol;
+      if (free_symbols_.empty()) {
+        symbol = next_symbol_++;
+      } else {
+        symbol = free_symbols_.back();
+        free_symbols_.pop_back();
+      }
+      const std::string& stored_token =
+          decode_map_.emplace(symbol, std::string(token)).first->second;
+      it = encode_map_.emplace(stored_token, SharedSymbol{symbol, 0}).first;
+    }
+    ++it->second.ref_count_;
+    appendSymbol(it->second.symbol_, stat_name.data_);
+  }
+  return stat_name;
+}
+
+absl::optional<StatName> SymbolTable::find(absl::string_view name) const {
+  StatName stat_name;
+  std::unique_lock<std::mutex> lock(lock_);
+  for (absl::string_view token : absl::StrSplit(name, '.')) {
+    const auto it = encode_map_.find(token);
+    if (it == encode_map_.end()) {
+      return absl::nullopt;
+    }
+    appendSymbol(it->second.symbol_, stat_name.data_);
+  }
+  return stat_name;
+}
+
+std::string SymbolTable::decode(const StatName& stat_name) const {
+  std::vector<absl::string_view> tokens;
+  absl::string_view data = stat_name.data_;
+  std::unique_lock<std::mutex> lock(lock_);
+  while (!data.empty()) {
+    const auto it = decode_map_.find(consumeSymbol(data));
+    ASSERT(it != decode_map_.end());
+    tokens.push_back(it->second);
+  }
+  return absl::StrJoin(tokens, ".");
+}
+
+void SymbolTable::free(const StatName& stat_name) {
+  absl::string_view data = stat_name.data_;
+  std::unique_lock<std::mutex> lock(lock_);
+  while (!data.empty()) {
+    const Symbol symbol = consumeSymbol(data);
+    const auto decode_it = decode_map_.find(symbol);
+    ASSERT(decode_it != decode_map_.end());
+    const auto encode_it = encode_map_.find(decode_it->second);
+    ASSERT(encode_it != encode_map_.end() && encode_it->second.ref_count_ > 0);
+    if (--encode_it->second.ref_count_ == 0) {
+      // The key of encode_map_ refers to the token in decode_map_, so it must be erased first.
+      encode_map_.erase(encode_it);
+      decode_map_.erase(decode_it);
+      free_symbols_.push_back(symbol);
+    }
+  }
+}
+
+size_t SymbolTable::numSymbols() const {
+  std::unique_lock<std::mutex> lock(lock_);
+  ASSERT(encode_map_.size() == decode_map_.size());
+  return encode_map_.size();
+}
+
+void SymbolTable::appendSymbol(Symbol symbol, std::string& data) {
+  // Seven bits per byte, least significant first, with the high bit set on all but the last byte.
+  while (symbol >= 0x80) {
+    data.push_back(static_cast<char>((symbol & 0x7f) | 0x80));
+    symbol >>= 7;
+  }
+  data.push_back(static_cast<char>(symbol));
+}
+
+SymbolTable::Symbol SymbolTable::consumeSymbol(absl::string_view& data) {
+  Symbol symbol = 0;
+  uint32_t shift = 0;
+  while (true) {
+    ASSERT(!data.empty());
+    const uint8_t byte = data[0];
+    data.remove_prefix(1);
+    symbol |= static_cast<Symbol>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return symbol;
+    }
+    shift += 7;
+  }
+}
+
+} // namespace Stats
+} // namespace Envoy
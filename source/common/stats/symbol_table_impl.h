@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common/hash.h"
+#include "common/common/utility.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * A stat name (or any other '.'-separated string, such as a tag value) encoded by a SymbolTable as
+ * a sequence of symbols, one per '.'-separated token. Each symbol is stored as a variable length
+ * integer, so the encodings of most names are only a few bytes long and fit in the inline storage
+ * of a std::string. A StatName does not own its symbols: they are held by the SymbolTable that
+ * created it until they are released with SymbolTable::free().
+ */
+class StatName {
+public:
+  bool operator==(const StatName& rhs) const { return data_ == rhs.data_; }
+  bool operator!=(const StatName& rhs) const { return data_ != rhs.data_; }
+
+  /**
+   * @return const std::string& the encoded symbols.
+   */
+  const std::string& data() const { return data_; }
+
+private:
+  friend class SymbolTable;
+
+  std::string data_;
+};
+
+/**
+ * Hashing functor for use with unordered_map and unordered_set with StatName as a key.
+ */
+struct StatNameHash {
+  size_t operator()(const StatName& stat_name) const {
+    return HashUtil::xxHash64(stat_name.data());
+  }
+};
+
+/**
+ * Interns the '.'-separated tokens of stat names so that names which share tokens, such as the
+ * same stat in many clusters or the same tag name on many stats, share the storage for them.
+ * Symbols are reference counted and recycled once no StatName refers to them. All operations are
+ * thread safe.
+ */
+class SymbolTable {
+public:
+  /**
+   * Encodes a name, interning any of its tokens that are not yet in the table. Each call must be
+   * matched by a call to free() with the result.
+   * @param name absl::string_view the name to encode.
+   * @return StatName the encoded name.
+   */
+  StatName encode(absl::string_view name);
+
+  /**
+   * Encodes a name without interning any of its tokens, to look up a name that may have been
+   * encoded before without having to free the result.
+   * @param name absl::string_view the name to look up.
+   * @return absl::optional<StatName> the encoded name, or absl::nullopt if one of its tokens is not
+   *         interned, in which case no name returned by encode() and not yet freed is equal to it.
+   *         The result must not be passed to free().
+   */
+  absl::optional<StatName> find(absl::string_view name) const;
+
+  /**
+   * @param stat_name const StatName& a name returned by encode() that has not been freed.
+   * @return std::string the name that was encoded.
+   */
+  std::string decode(const StatName& stat_name) const;
+
+  /**
+   * Releases the symbols of a name returned by encode().
+   * @param stat_name const StatName& the name to release.
+   */
+  void free(const StatName& stat_name);
+
+  /**
+   * @return size_t the number of distinct tokens currently interned.
+   */
+  size_t numSymbols() const;
+
+private:
+  typedef uint32_t Symbol;
+
+  struct SharedSymbol {
+    Symbol symbol_;
+    uint32_t ref_count_;
+  };
+
+  static void appendSymbol(Symbol symbol, std::string& data);
+  static Symbol consumeSymbol(absl::string_view& data);
+
+  mutable std::mutex lock_;
+  // Owns the token of each symbol.
+  std::unordered_map<Symbol, std::string> decode_map_;
+  // Keys refer to the tokens owned by decode_map_.
+  std::unordered_map<absl::string_view, SharedSymbol, StringViewHash> encode_map_;
+  // Symbols that have been freed and can be reused before allocating a new one.
+  std::vector<Symbol> free_symbols_;
+  Symbol next_symbol_{0};
+};
+
+} // namespace Stats
+} // namespace Envoy
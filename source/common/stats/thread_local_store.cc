@@ -1,5 +1,6 @@
 #include "common/stats/thread_local_store.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <list>
@@ -11,6 +12,15 @@
 namespace Envoy {
 namespace Stats {
 
+namespace {
+
+// Each flush sweeps at least this many registry slots, and at least 1/SweepFraction of them, so
+// that the slots of freed metrics are reclaimed within SweepFraction flushes.
+const size_t MinSweepSlots = 4096;
+const size_t SweepFraction = 16;
+
+} // namespace
+
 ThreadLocalStoreImpl::ThreadLocalStoreImpl(RawStatDataAllocator& alloc)
     : alloc_(alloc), default_scope_(createScope("")),
       tag_producer_(std::make_unique<TagProducerImpl>()),
@@ -25,11 +35,11 @@ ThreadLocalStoreImpl::~ThreadLocalStoreImpl() {
 std::list<CounterSharedPtr> ThreadLocalStoreImpl::counters() const {
   // Handle de-dup due to overlapping scopes.
   std::list<CounterSharedPtr> ret;
-  std::unordered_set<std::string> names;
+  std::unordered_set<absl::string_view, StringViewHash> names;
   std::unique_lock<std::mutex> lock(lock_);
   for (ScopeImpl* scope : scopes_) {
-    for (auto counter : scope->central_cache_.counters_) {
-      if (names.insert(counter.first).second) {
+    for (const auto& counter : scope->central_cache_.counters_) {
+      if (names.insert(counter.second->name()).second) {
         ret.push_back(counter.second);
       }
     }
@@ -38,6 +48,25 @@ std::list<CounterSharedPtr> ThreadLocalStoreImpl::counters() const {
   return ret;
 }
 
+void ThreadLocalStoreImpl::latchChangedMetrics(ChangedMetrics& changed) {
+  // Clearing may free metrics, so do it before taking the lock.
+  changed.clear();
+  std::unique_lock<std::mutex> lock(lock_);
+  counter_registry_.forEachDirty([&changed](const CounterSharedPtr& counter) {
+    // Counters of overlapping scopes share their backing storage, so the increments are only
+    // latched once.
+    const uint64_t delta = counter->latch();
+    if (delta > 0) {
+      changed.counters_.emplace_back(counter, delta);
+    }
+  });
+  gauge_registry_.forEachDirty(
+      [&changed](const GaugeSharedPtr& gauge) { changed.gauges_.push_back(gauge); });
+
+  counter_registry_.sweep(std::max(MinSweepSlots, counter_registry_.size() / SweepFraction));
+  gauge_registry_.sweep(std::max(MinSweepSlots, gauge_registry_.size() / SweepFraction));
+}
+
 ScopePtr ThreadLocalStoreImpl::createScope(const std::string& name) {
   std::unique_ptr<ScopeImpl> new_scope(new ScopeImpl(*this, name));
   std::unique_lock<std::mutex> lock(lock_);
@@ -48,11 +77,11 @@ ScopePtr ThreadLocalStoreImpl::createScope(const std::string& name) {
 std::list<GaugeSharedPtr> ThreadLocalStoreImpl::gauges() const {
   // Handle de-dup due to overlapping scopes.
   std::list<GaugeSharedPtr> ret;
-  std::unordered_set<std::string> names;
+  std::unordered_set<absl::string_view, StringViewHash> names;
   std::unique_lock<std::mutex> lock(lock_);
   for (ScopeImpl* scope : scopes_) {
-    for (auto gauge : scope->central_cache_.gauges_) {
-      if (names.insert(gauge.first).second) {
+    for (const auto& gauge : scope->central_cache_.gauges_) {
+      if (names.insert(gauge.second->name()).second) {
         ret.push_back(gauge.second);
       }
     }
@@ -114,40 +143,165 @@ ThreadLocalStoreImpl::SafeAllocData ThreadLocalStoreImpl::safeAlloc(const std::s
   }
 }
 
-ThreadLocalStoreImpl::ScopeImpl::~ScopeImpl() { parent_.releaseScopeCrossThread(this); }
+template <class StatType>
+DirtyBit
+ThreadLocalStoreImpl::MetricRegistry<StatType>::add(const std::shared_ptr<StatType>& stat) {
+  size_t index;
+  if (!free_slots_.empty()) {
+    index = free_slots_.back();
+    free_slots_.pop_back();
+  } else {
+    index = next_slot_++;
+    if (index % SlotsPerChunk == 0) {
+      chunks_.emplace_back(new Chunk());
+    }
+  }
 
-Counter& ThreadLocalStoreImpl::ScopeImpl::counter(const std::string& name) {
-  // Determine the final name based on the prefix and the passed name.
-  std::string final_name = prefix_ + name;
+  Slot& new_slot = slot(index);
+  ASSERT(!new_slot.registered_);
+  new_slot.stat_ = stat;
+  new_slot.registered_ = true;
+  const size_t chunk_index = index % SlotsPerChunk;
+  return DirtyBit(chunks_[index / SlotsPerChunk]->dirty_[chunk_index / BitsPerWord],
+                  1ULL << (chunk_index % BitsPerWord));
+}
+
+template <class StatType>
+void ThreadLocalStoreImpl::MetricRegistry<StatType>::forEachDirty(
+    std::function<void(const std::shared_ptr<StatType>&)> cb) {
+  for (size_t chunk = 0; chunk < chunks_.size(); chunk++) {
+    for (size_t word = 0; word < SlotsPerChunk / BitsPerWord; word++) {
+      std::atomic<uint64_t>& dirty = chunks_[chunk]->dirty_[word];
+      if (dirty.load() == 0) {
+        continue;
+      }
 
-  // We now try to acquire a *reference* to the TLS cache shared pointer. This might remain null
-  // if we don't have TLS initialized currently. The de-referenced pointer might be null if there
-  // is no cache entry.
-  CounterSharedPtr* tls_ref = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_) {
-    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].counters_[final_name];
+      // Clear the bits before reading the metrics, so that changes made from now on set them again.
+      uint64_t bits = dirty.exchange(0);
+      while (bits != 0) {
+        const size_t index = chunk * SlotsPerChunk + word * BitsPerWord + __builtin_ctzll(bits);
+        bits &= bits - 1;
+        const Slot& dirty_slot = slot(index);
+        const std::shared_ptr<StatType> stat = dirty_slot.stat_.lock();
+        if (stat) {
+          cb(stat);
+        } else if (dirty_slot.registered_) {
+          release(index);
+        }
+      }
+    }
   }
+}
 
-  // If we have a valid cache entry, return it.
-  if (tls_ref && *tls_ref) {
-    return **tls_ref;
+template <class StatType>
+void ThreadLocalStoreImpl::MetricRegistry<StatType>::sweep(size_t max_slots) {
+  for (size_t i = 0; i < max_slots && i < next_slot_; i++) {
+    if (sweep_cursor_ >= next_slot_) {
+      sweep_cursor_ = 0;
+    }
+    const Slot& swept = slot(sweep_cursor_);
+    if (swept.registered_ && swept.stat_.expired()) {
+      release(sweep_cursor_);
+    }
+    sweep_cursor_++;
+  }
+}
+
+template <class StatType>
+void ThreadLocalStoreImpl::MetricRegistry<StatType>::release(size_t index) {
+  Slot& released = slot(index);
+  ASSERT(released.registered_);
+  released.stat_.reset();
+  released.registered_ = false;
+  // The metric may have changed after the bits were last cleared. Clear its bit so that it is not
+  // mistaken for a change of the next metric in the slot.
+  const size_t chunk_index = index % SlotsPerChunk;
+  chunks_[index / SlotsPerChunk]->dirty_[chunk_index / BitsPerWord].fetch_and(
+      ~(1ULL << (chunk_index % BitsPerWord)));
+  free_slots_.push_back(index);
+}
+
+ThreadLocalStoreImpl::ScopeImpl::~ScopeImpl() {
+  parent_.releaseScopeCrossThread(this);
+  freeKeys(central_cache_.counters_);
+  freeKeys(central_cache_.gauges_);
+  freeKeys(central_cache_.histograms_);
+}
+
+ThreadLocalStoreImpl::TlsCacheEntry* ThreadLocalStoreImpl::ScopeImpl::tlsCache() {
+  if (parent_.shutting_down_ || !parent_.tls_) {
+    return nullptr;
+  }
+  return &parent_.tls_->getTyped<TlsCache>().scope_cache_[this];
+}
+
+template <class StatType>
+std::shared_ptr<StatType>&
+ThreadLocalStoreImpl::ScopeImpl::centralRef(CentralStatMap<StatType>& central_map,
+                                            const std::string& name) {
+  // Looking the name up does not intern it, so that a hit neither adds nor releases references.
+  const absl::optional<StatName> stat_name = parent_.symbol_table_.find(name);
+  if (stat_name) {
+    auto it = central_map.find(stat_name.value());
+    if (it != central_map.end()) {
+      return it->second;
+    }
+  }
+  return central_map[parent_.symbol_table_.encode(name)];
+}
+
+template <class StatType>
+void ThreadLocalStoreImpl::ScopeImpl::cacheInTls(TlsStatMap<StatType>& tls_map,
+                                                 const std::string& name,
+                                                 const std::shared_ptr<StatType>& stat) {
+  // The key refers to the stat's own name, which the map entry keeps alive. If the allocator had to
+  // truncate the name it no longer contains the requested name, so the stat is not cached per
+  // thread and every lookup goes to the central cache.
+  const std::string& stat_name = stat->name();
+  if (stat_name.size() == prefix_.size() + name.size()) {
+    ASSERT(stat_name == prefix_ + name);
+    tls_map.emplace(absl::string_view(stat_name).substr(prefix_.size()), stat);
+  }
+}
+
+template <class StatType>
+void ThreadLocalStoreImpl::ScopeImpl::freeKeys(const CentralStatMap<StatType>& central_map) {
+  for (const auto& stat : central_map) {
+    parent_.symbol_table_.free(stat.first);
+  }
+}
+
+Counter& ThreadLocalStoreImpl::ScopeImpl::counter(const std::string& name) {
+  // We now try to find the stat in the TLS cache. The cache might not be available if we don't have
+  // TLS initialized currently. The cache is keyed by the name relative to this scope, so a hit does
+  // not require building the final name.
+  TlsCacheEntry* tls_cache = tlsCache();
+  if (tls_cache) {
+    const auto it = tls_cache->counters_.find(name);
+    if (it != tls_cache->counters_.end()) {
+      return *it->second;
+    }
   }
 
   // We must now look in the central store so we must be locked. We grab a reference to the
   // central store location. It might contain nothing. In this case, we allocate a new stat.
   std::unique_lock<std::mutex> lock(parent_.lock_);
-  CounterSharedPtr& central_ref = central_cache_.counters_[final_name];
+  CounterSharedPtr& central_ref = centralRef(central_cache_.counters_, name);
   if (!central_ref) {
+    // Determine the final name based on the prefix and the passed name.
+    const std::string final_name = prefix_ + name;
     SafeAllocData alloc = parent_.safeAlloc(final_name);
     std::vector<Tag> tags;
     std::string tag_extracted_name = parent_.getTagsForName(final_name, tags);
-    central_ref.reset(
-        new CounterImpl(alloc.data_, alloc.free_, std::move(tag_extracted_name), std::move(tags)));
+    CounterImpl* counter = new CounterImpl(alloc.data_, alloc.free_,
+                                           std::move(tag_extracted_name), std::move(tags));
+    central_ref.reset(counter);
+    counter->setDirtyBit(parent_.counter_registry_.add(central_ref));
   }
 
-  // If we have a TLS location to store or allocation into, do it.
-  if (tls_ref) {
-    *tls_ref = central_ref;
+  // If we have a TLS cache to store the allocation into, do it.
+  if (tls_cache) {
+    cacheInTls(tls_cache->counters_, name, central_ref);
   }
 
   // Finally we return the reference.
@@ -173,28 +327,29 @@ void ThreadLocalStoreImpl::ScopeImpl::deliverHistogramToSinks(const Histogram& h
 Gauge& ThreadLocalStoreImpl::ScopeImpl::gauge(const std::string& name) {
   // See comments in counter(). There is no super clean way (via templates or otherwise) to
   // share this code so I'm leaving it largely duplicated for now.
-  std::string final_name = prefix_ + name;
-  GaugeSharedPtr* tls_ref = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_) {
-    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].gauges_[final_name];
-  }
-
-  if (tls_ref && *tls_ref) {
-    return **tls_ref;
+  TlsCacheEntry* tls_cache = tlsCache();
+  if (tls_cache) {
+    const auto it = tls_cache->gauges_.find(name);
+    if (it != tls_cache->gauges_.end()) {
+      return *it->second;
+    }
   }
 
   std::unique_lock<std::mutex> lock(parent_.lock_);
-  GaugeSharedPtr& central_ref = central_cache_.gauges_[final_name];
+  GaugeSharedPtr& central_ref = centralRef(central_cache_.gauges_, name);
   if (!central_ref) {
+    const std::string final_name = prefix_ + name;
     SafeAllocData alloc = parent_.safeAlloc(final_name);
     std::vector<Tag> tags;
     std::string tag_extracted_name = parent_.getTagsForName(final_name, tags);
-    central_ref.reset(
-        new GaugeImpl(alloc.data_, alloc.free_, std::move(tag_extracted_name), std::move(tags)));
+    GaugeImpl* gauge = new GaugeImpl(alloc.data_, alloc.free_, std::move(tag_extracted_name),
+                                     std::move(tags));
+    central_ref.reset(gauge);
+    gauge->setDirtyBit(parent_.gauge_registry_.add(central_ref));
   }
 
-  if (tls_ref) {
-    *tls_ref = central_ref;
+  if (tls_cache) {
+    cacheInTls(tls_cache->gauges_, name, central_ref);
   }
 
   return *central_ref;
@@ -203,27 +358,26 @@ Gauge& ThreadLocalStoreImpl::ScopeImpl::gauge(const std::string& name) {
 Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
   // See comments in counter(). There is no super clean way (via templates or otherwise) to
   // share this code so I'm leaving it largely duplicated for now.
-  std::string final_name = prefix_ + name;
-  HistogramSharedPtr* tls_ref = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_) {
-    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].histograms_[final_name];
-  }
-
-  if (tls_ref && *tls_ref) {
-    return **tls_ref;
+  TlsCacheEntry* tls_cache = tlsCache();
+  if (tls_cache) {
+    const auto it = tls_cache->histograms_.find(name);
+    if (it != tls_cache->histograms_.end()) {
+      return *it->second;
+    }
   }
 
   std::unique_lock<std::mutex> lock(parent_.lock_);
-  HistogramSharedPtr& central_ref = central_cache_.histograms_[final_name];
+  HistogramSharedPtr& central_ref = centralRef(central_cache_.histograms_, name);
   if (!central_ref) {
+    const std::string final_name = prefix_ + name;
     std::vector<Tag> tags;
     std::string tag_extracted_name = parent_.getTagsForName(final_name, tags);
     central_ref.reset(
         new HistogramImpl(final_name, parent_, std::move(tag_extracted_name), std::move(tags)));
   }
 
-  if (tls_ref) {
-    *tls_ref = central_ref;
+  if (tls_cache) {
+    cacheInTls(tls_cache->histograms_, name, central_ref);
   }
 
   return *central_ref;
@@ -3,15 +3,22 @@
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/common/utility.h"
 #include "common/stats/stats_impl.h"
+#include "common/stats/symbol_table_impl.h"
+
+#include "absl/strings/string_view.h"
 
 namespace Envoy {
 namespace Stats {
@@ -31,6 +38,10 @@ namespace Stats {
  * - Scopes can be deleted from any thread, and they are in practice as scopes are likely to be
  *   shared across all worker threads.
  * - Per thread caches are checked, and if empty, they are populated from the central cache.
+ * - Neither cache stores copies of stat names. The central cache is keyed by the symbol table
+ *   encoding of the name relative to the scope's prefix, and the per thread caches by a view of the
+ *   relative name in the storage of the stat itself, so memory does not grow with the number of
+ *   workers times the length of the names. Lookups in the central cache do not intern the name.
  * - Scopes are entirely owned by the caller. The store only keeps weak pointers.
  * - When a scope is destroyed, a cache flush operation is run on all threads to flush any cached
  *   data owned by the destroyed scope.
@@ -40,6 +51,10 @@ namespace Stats {
  *         repopulated on the next access.
  * - Since it's possible to have overlapping scopes, we de-dup stats when counters() or gauges() is
  *   called since these are very uncommon operations.
+ * - Every counter and gauge is also registered in a flat registry with a bit per metric that the
+ *   metric sets when it changes. Flushing via latchChangedMetrics() only visits metrics whose bits
+ *   are set, and does not build lists of all metrics. The registry only holds weak references, so
+ *   it does not change when metrics are freed.
  * - Though this implementation is designed to work with a fixed shared memory space, it will fall
  *   back to heap allocated stats if needed. NOTE: In this case, overlapping scopes will not share
  *   the same backing store. This is to keep things simple, it could be done in the future if
@@ -70,15 +85,31 @@ public:
   void setTagProducer(TagProducerPtr&& tag_producer) override {
     tag_producer_ = std::move(tag_producer);
   }
+  void latchChangedMetrics(ChangedMetrics& changed) override;
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
 
 private:
+  template <class StatType>
+  using TlsStatMap =
+      std::unordered_map<absl::string_view, std::shared_ptr<StatType>, StringViewHash>;
+
+  template <class StatType>
+  using CentralStatMap = std::unordered_map<StatName, std::shared_ptr<StatType>, StatNameHash>;
+
+  // Keys are the names relative to the scope's prefix, referring to the storage of the stat's name.
   struct TlsCacheEntry {
-    std::unordered_map<std::string, CounterSharedPtr> counters_;
-    std::unordered_map<std::string, GaugeSharedPtr> gauges_;
-    std::unordered_map<std::string, HistogramSharedPtr> histograms_;
+    TlsStatMap<Counter> counters_;
+    TlsStatMap<Gauge> gauges_;
+    TlsStatMap<Histogram> histograms_;
+  };
+
+  // Keys are the encodings of the names relative to the scope's prefix.
+  struct CentralCacheEntry {
+    CentralStatMap<Counter> counters_;
+    CentralStatMap<Gauge> gauges_;
+    CentralStatMap<Histogram> histograms_;
   };
 
   struct ScopeImpl : public Scope {
@@ -95,9 +126,86 @@ private:
     Gauge& gauge(const std::string& name) override;
     Histogram& histogram(const std::string& name) override;
 
+    /**
+     * @return TlsCacheEntry* the calling thread's cache for this scope, or nullptr if there is
+     *         none because threading is not initialized or is shutting down.
+     */
+    TlsCacheEntry* tlsCache();
+
+    /**
+     * Finds the central cache entry for name, inserting an empty one if there is none. Must be
+     * called with parent_.lock_ held.
+     */
+    template <class StatType>
+    std::shared_ptr<StatType>& centralRef(CentralStatMap<StatType>& central_map,
+                                          const std::string& name);
+
+    /**
+     * Adds stat to a per thread cache under name, if the stat's name is prefix_ + name.
+     */
+    template <class StatType>
+    void cacheInTls(TlsStatMap<StatType>& tls_map, const std::string& name,
+                    const std::shared_ptr<StatType>& stat);
+
+    template <class StatType> void freeKeys(const CentralStatMap<StatType>& central_map);
+
     ThreadLocalStoreImpl& parent_;
     const std::string prefix_;
-    TlsCacheEntry central_cache_;
+    CentralCacheEntry central_cache_;
+  };
+
+  /**
+   * Flat registry of the counters or gauges of the store with a dirty bit per metric. Slots never
+   * move, so a metric's bit stays valid for the metric's lifetime. Slots of freed metrics are
+   * reclaimed when they are found during a flush or by an incremental sweep. All methods must be
+   * called with lock_ held.
+   */
+  template <class StatType> class MetricRegistry {
+  public:
+    /**
+     * @return DirtyBit the bit the metric must set when it changes.
+     */
+    DirtyBit add(const std::shared_ptr<StatType>& stat);
+
+    /**
+     * Clears the set bits and calls cb with each live metric whose bit was set.
+     */
+    void forEachDirty(std::function<void(const std::shared_ptr<StatType>&)> cb);
+
+    /**
+     * Checks up to max_slots slots, continuing where the previous sweep stopped, and reclaims the
+     * slots of freed metrics.
+     */
+    void sweep(size_t max_slots);
+
+    /**
+     * @return size_t the number of slots in use.
+     */
+    size_t size() const { return next_slot_ - free_slots_.size(); }
+
+  private:
+    static const size_t BitsPerWord = 64;
+    static const size_t SlotsPerChunk = 4096;
+
+    struct Slot {
+      std::weak_ptr<StatType> stat_;
+      bool registered_{};
+    };
+
+    struct Chunk {
+      Slot slots_[SlotsPerChunk];
+      std::atomic<uint64_t> dirty_[SlotsPerChunk / BitsPerWord]{};
+    };
+
+    Slot& slot(size_t index) {
+      return chunks_[index / SlotsPerChunk]->slots_[index % SlotsPerChunk];
+    }
+    void release(size_t index);
+
+    std::vector<std::unique_ptr<Chunk>> chunks_;
+    std::vector<size_t> free_slots_;
+    size_t next_slot_{};
+    size_t sweep_cursor_{};
   };
 
   struct TlsCache : public ThreadLocal::ThreadLocalObject {
@@ -115,10 +223,15 @@ private:
   SafeAllocData safeAlloc(const std::string& name);
 
   RawStatDataAllocator& alloc_;
+  // Declared before the scopes, which hold symbols, so that it outlives them.
+  SymbolTable symbol_table_;
   Event::Dispatcher* main_thread_dispatcher_{};
   ThreadLocal::SlotPtr tls_;
   mutable std::mutex lock_;
   std::unordered_set<ScopeImpl*> scopes_;
+  // Declared before the default scope, which registers the overflow counter.
+  MetricRegistry<Counter> counter_registry_;
+  MetricRegistry<Gauge> gauge_registry_;
   ScopePtr default_scope_;
   std::list<std::reference_wrapper<Sink>> timer_sinks_;
   TagProducerPtr tag_producer_;
@@ -5,6 +5,7 @@
 #include <functional>
 #include <list>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "envoy/event/dispatcher.h"
@@ -13,6 +14,7 @@
 
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
+#include "common/common/thread.h"
 #include "common/common/utility.h"
 #include "common/config/cds_json.h"
 #include "common/config/utility.h"
@@ -188,15 +190,24 @@ ClusterManagerImpl::ClusterManagerImpl(const envoy::config::bootstrap::v2::Boots
     eds_config_ = bootstrap.dynamic_resources().deprecated_v1().sds_config();
   }
 
+  // Hashing a cluster serializes its whole config, which adds up with thousands of clusters, so
+  // the static clusters are all hashed up front across threads.
+  const auto& static_clusters = bootstrap.static_resources().clusters();
+  std::vector<uint64_t> static_cluster_hashes(static_clusters.size());
+  Thread::parallelFor(std::thread::hardware_concurrency(), static_clusters.size(),
+                      MinClustersPerThread, [&static_clusters, &static_cluster_hashes](size_t i) {
+                        static_cluster_hashes[i] = MessageUtil::hash(static_clusters[i]);
+                      });
+
   // Cluster loading happens in two phases: first all the primary clusters are loaded, and then all
   // the secondary clusters are loaded. As it currently stands all non-EDS clusters are primary and
   // only EDS clusters are secondary. This two phase loading is done because in v2 configuration
   // each EDS cluster individually sets up a subscription. When this subscription is an API source
   // the cluster will depend on a non-EDS cluster, so the non-EDS clusters must be loaded first.
-  for (const auto& cluster : bootstrap.static_resources().clusters()) {
+  for (int i = 0; i < static_clusters.size(); ++i) {
     // First load all the primary clusters.
-    if (cluster.type() != envoy::api::v2::Cluster::EDS) {
-      loadCluster(cluster, false, active_clusters_);
+    if (static_clusters[i].type() != envoy::api::v2::Cluster::EDS) {
+      loadCluster(static_clusters[i], static_cluster_hashes[i], false, active_clusters_);
     }
   }
 
@@ -215,10 +226,10 @@ ClusterManagerImpl::ClusterManagerImpl(const envoy::config::bootstrap::v2::Boots
   }
 
   // After ADS is initialized, load EDS static clusters as EDS config may potentially need ADS.
-  for (const auto& cluster : bootstrap.static_resources().clusters()) {
+  for (int i = 0; i < static_clusters.size(); ++i) {
     // Now load all the secondary clusters.
-    if (cluster.type() == envoy::api::v2::Cluster::EDS) {
-      loadCluster(cluster, false, active_clusters_);
+    if (static_clusters[i].type() == envoy::api::v2::Cluster::EDS) {
+      loadCluster(static_clusters[i], static_cluster_hashes[i], false, active_clusters_);
     }
   }
 
@@ -373,7 +384,7 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::api::v2::Cluster& clust
   //       and easy to understand.
   const bool use_active_map =
       init_helper_.state() != ClusterManagerInitHelper::State::AllClustersInitialized;
-  loadCluster(cluster, true, use_active_map ? active_clusters_ : warming_clusters_);
+  loadCluster(cluster, new_hash, true, use_active_map ? active_clusters_ : warming_clusters_);
 
   if (use_active_map) {
     ENVOY_LOG(info, "add/update cluster {} during init", cluster_name);
@@ -464,8 +475,8 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
   return removed;
 }
 
-void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster, bool added_via_api,
-                                     ClusterMap& cluster_map) {
+void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster, uint64_t hash,
+                                     bool added_via_api, ClusterMap& cluster_map) {
   ClusterSharedPtr new_cluster =
       factory_.clusterFromProto(cluster, *this, outlier_event_logger_, added_via_api);
 
@@ -495,8 +506,8 @@ void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster, boo
     });
   }
 
-  cluster_map[cluster_reference.info()->name()] = std::make_unique<ClusterData>(
-      MessageUtil::hash(cluster), added_via_api, std::move(new_cluster));
+  cluster_map[cluster_reference.info()->name()] =
+      std::make_unique<ClusterData>(hash, added_via_api, std::move(new_cluster));
   const auto cluster_entry_it = cluster_map.find(cluster_reference.info()->name());
 
   // If an LB is thread aware, create it here. The LB is not initialized until cluster pre-init
@@ -888,9 +899,17 @@ Http::ConnectionPool::InstancePtr ProdClusterManagerFactory::allocateConnPool(
 ClusterSharedPtr ProdClusterManagerFactory::clusterFromProto(
     const envoy::api::v2::Cluster& cluster, ClusterManager& cm,
     Outlier::EventLoggerSharedPtr outlier_event_logger, bool added_via_api) {
-  return ClusterImplBase::create(cluster, cm, stats_, tls_, dns_resolver_, ssl_context_manager_,
-                                 runtime_, random_, main_thread_dispatcher_, local_info_,
-                                 outlier_event_logger, added_via_api);
+  // The hosts of the parent process are only used for the first cluster created with the name.
+  // Clusters updated later on have since learned of their own hosts.
+  const auto warm_hosts = warm_cluster_hosts_.find(cluster.name());
+  ClusterSharedPtr new_cluster = ClusterImplBase::create(
+      cluster, cm, stats_, tls_, dns_resolver_, ssl_context_manager_, runtime_, random_,
+      main_thread_dispatcher_, local_info_, outlier_event_logger, added_via_api,
+      warm_hosts != warm_cluster_hosts_.end() ? &warm_hosts->second : nullptr);
+  if (warm_hosts != warm_cluster_hosts_.end()) {
+    warm_cluster_hosts_.erase(warm_hosts);
+  }
+  return new_cluster;
 }
 
 CdsApiPtr ProdClusterManagerFactory::createCds(
@@ -35,10 +35,12 @@ public:
                             Network::DnsResolverSharedPtr dns_resolver,
                             Ssl::ContextManager& ssl_context_manager,
                             Event::Dispatcher& main_thread_dispatcher,
-                            const LocalInfo::LocalInfo& local_info)
+                            const LocalInfo::LocalInfo& local_info,
+                            const ClusterHostsMap& warm_cluster_hosts)
       : main_thread_dispatcher_(main_thread_dispatcher), runtime_(runtime), stats_(stats),
         tls_(tls), random_(random), dns_resolver_(dns_resolver),
-        ssl_context_manager_(ssl_context_manager), local_info_(local_info) {}
+        ssl_context_manager_(ssl_context_manager), local_info_(local_info),
+        warm_cluster_hosts_(warm_cluster_hosts) {}
 
   // Upstream::ClusterManagerFactory
   ClusterManagerPtr
@@ -68,6 +70,8 @@ private:
   Network::DnsResolverSharedPtr dns_resolver_;
   Ssl::ContextManager& ssl_context_manager_;
   const LocalInfo::LocalInfo& local_info_;
+  // Hosts of the parent process of a hot restart, used to seed clusters when they are created.
+  ClusterHostsMap warm_cluster_hosts_;
 };
 
 /**
@@ -290,9 +294,13 @@ private:
   typedef std::unique_ptr<ClusterData> ClusterDataPtr;
   typedef std::unordered_map<std::string, ClusterDataPtr> ClusterMap;
 
+  // Static clusters are hashed on the main thread only when there are fewer than this many per
+  // thread.
+  static const size_t MinClustersPerThread = 64;
+
   void createOrUpdateThreadLocalCluster(ClusterData& cluster);
   static ClusterManagerStats generateStats(Stats::Scope& scope);
-  void loadCluster(const envoy::api::v2::Cluster& cluster, bool added_via_api,
+  void loadCluster(const envoy::api::v2::Cluster& cluster, uint64_t hash, bool added_via_api,
                    ClusterMap& cluster_map);
   void onClusterInit(Cluster& cluster);
   void postThreadLocalClusterUpdate(const Cluster& cluster, uint32_t priority,
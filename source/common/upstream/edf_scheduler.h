@@ -1,8 +1,13 @@
+#pragma once
+
+#include <algorithm>
 #include <cstdint>
-#include <queue>
+#include <vector>
 
 #include "common/common/assert.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -21,60 +26,66 @@ namespace Upstream {
 // Each pick from the schedule has the earliest deadline entry selected. Entries have deadlines set
 // at current time + 1 / weight, providing weighted round robin behavior with floating point
 // weights and an O(log n) pick time.
-template <class C> class EdfScheduler {
+//
+// The scheduler is pointer-free: entries are indices into a vector owned by the caller (e.g. a
+// HostVector or the localities of a host set) and are kept in a flat binary heap. Since there is no
+// remove operation, callers must rebuild the scheduler whenever the indexed vector changes.
+class EdfScheduler {
 public:
   /**
    * Pick queue entry with closest deadline.
-   * @return std::shared_ptr<C> to the queue entry if a valid entry exists in the queue, nullptr
-   *         otherwise. The entry is removed from the queue.
+   * @return absl::optional<uint32_t> the index of the queue entry if the queue is non-empty. The
+   *         entry is removed from the queue.
    */
-  std::shared_ptr<C> pick() {
+  absl::optional<uint32_t> pick() {
     EDF_TRACE("Queue pick: queue_.size()={}, current_time_={}.", queue_.size(), current_time_);
-    while (true) {
-      if (queue_.empty()) {
-        EDF_TRACE("Queue is empty.");
-        return nullptr;
-      }
-      const EdfEntry& edf_entry = queue_.top();
-      // Entry has been removed, let's see if there's another one.
-      if (edf_entry.entry_.expired()) {
-        EDF_TRACE("Entry has expired, repick.");
-        queue_.pop();
-        continue;
-      }
-      std::shared_ptr<C> ret{edf_entry.entry_};
-      ASSERT(edf_entry.deadline_ >= current_time_);
-      current_time_ = edf_entry.deadline_;
-      queue_.pop();
-      EDF_TRACE("Picked {}, current_time_={}.", static_cast<const void*>(ret.get()), current_time_);
-      return ret;
+    if (queue_.empty()) {
+      EDF_TRACE("Queue is empty.");
+      return {};
     }
+    std::pop_heap(queue_.begin(), queue_.end());
+    const EdfEntry& edf_entry = queue_.back();
+    ASSERT(edf_entry.deadline_ >= current_time_);
+    current_time_ = edf_entry.deadline_;
+    const uint32_t index = edf_entry.index_;
+    queue_.pop_back();
+    EDF_TRACE("Picked {}, current_time_={}.", index, current_time_);
+    return index;
   }
 
   /**
    * Insert entry into queue with a given weight. The deadline will be current_time_ + 1 / weight.
    * @param weight floating point weight.
-   * @param entry shared pointer to entry, only a weak reference will be retained.
+   * @param index caller defined index identifying the entry.
    */
-  void add(double weight, std::shared_ptr<C> entry) {
+  void add(double weight, uint32_t index) {
     ASSERT(weight > 0);
     const double deadline = current_time_ + 1.0 / weight;
-    EDF_TRACE("Insertion {} in queue with deadline {} and weight {}.",
-              static_cast<const void*>(entry.get()), deadline, weight);
-    queue_.push({deadline, order_offset_++, entry});
-    ASSERT(queue_.top().deadline_ >= current_time_);
+    EDF_TRACE("Insertion {} in queue with deadline {} and weight {}.", index, deadline, weight);
+    queue_.push_back({deadline, order_offset_++, index});
+    std::push_heap(queue_.begin(), queue_.end());
+    ASSERT(queue_.front().deadline_ >= current_time_);
   }
 
+  /**
+   * @return bool whether the queue has no entries.
+   */
+  bool empty() const { return queue_.empty(); }
+
+  /**
+   * Reserve space for a number of entries, avoiding reallocation while populating the queue.
+   * @param size number of entries.
+   */
+  void reserve(size_t size) { queue_.reserve(size); }
+
 private:
   struct EdfEntry {
     double deadline_;
     // Tie breaker for entries with the same deadline. This is used to provide FIFO behavior.
     uint64_t order_offset_;
-    // We only hold a weak pointer, since we don't support a remove operator. This allows entries to
-    // be lazily unloaded from the queue.
-    std::weak_ptr<C> entry_;
+    uint32_t index_;
 
-    // Flip < direction to make this a min queue.
+    // Flip < direction to make this a min heap.
     bool operator<(const EdfEntry& other) const {
       return deadline_ > other.deadline_ ||
              (deadline_ == other.deadline_ && order_offset_ > other.order_offset_);
@@ -88,8 +99,8 @@ private:
   // Offset used during addition to break ties when entries have the same weight but should reflect
   // FIFO insertion order in picks.
   uint64_t order_offset_{};
-  // Min priority queue for EDF.
-  std::priority_queue<EdfEntry> queue_;
+  // Min heap for EDF, maintained with std::push_heap()/std::pop_heap().
+  std::vector<EdfEntry> queue_;
 };
 
 #undef EDF_DEBUG
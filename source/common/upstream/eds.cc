@@ -42,11 +42,22 @@ EdsClusterImpl::EdsClusterImpl(const envoy::api::v2::Cluster& cluster, Runtime::
       "envoy.api.v2.EndpointDiscoveryService.StreamEndpoints");
 }
 
-void EdsClusterImpl::startPreInit() { subscription_->start({cluster_name_}, *this); }
+void EdsClusterImpl::setWarmHosts(const envoy::api::v2::ClusterLoadAssignment& hosts) {
+  warm_hosts_ = std::make_unique<envoy::api::v2::ClusterLoadAssignment>(hosts);
+}
+
+void EdsClusterImpl::startPreInit() {
+  if (warm_hosts_ != nullptr) {
+    ENVOY_LOG(debug, "serving hosts of the parent process for {} until the first EDS update",
+              cluster_name_);
+    updateClusterLoadAssignment(*warm_hosts_, true);
+    warm_hosts_.reset();
+    onPreInitComplete();
+  }
+  subscription_->start({cluster_name_}, *this);
+}
 
 void EdsClusterImpl::onConfigUpdate(const ResourceVector& resources) {
-  typedef std::unique_ptr<HostVector> HostListPtr;
-  std::vector<std::pair<HostListPtr, LocalityWeightsMap>> priority_state(1);
   if (resources.empty()) {
     ENVOY_LOG(debug, "Missing ClusterLoadAssignment for {} in onConfigUpdate()", cluster_name_);
     info_->stats().update_empty_.inc();
@@ -63,6 +74,17 @@ void EdsClusterImpl::onConfigUpdate(const ResourceVector& resources) {
     throw EnvoyException(fmt::format("Unexpected EDS cluster (expecting {}): {}", cluster_name_,
                                      cluster_load_assignment.cluster_name()));
   }
+  updateClusterLoadAssignment(cluster_load_assignment, false);
+
+  // If we didn't setup to initialize when our first round of health checking is complete, just
+  // do it now.
+  onPreInitComplete();
+}
+
+void EdsClusterImpl::updateClusterLoadAssignment(
+    const envoy::api::v2::ClusterLoadAssignment& cluster_load_assignment, bool warm) {
+  typedef std::unique_ptr<HostVector> HostListPtr;
+  std::vector<std::pair<HostListPtr, LocalityWeightsMap>> priority_state(1);
   for (const auto& locality_lb_endpoint : cluster_load_assignment.endpoints()) {
     const uint32_t priority = locality_lb_endpoint.priority();
     if (priority > 0 && !cluster_name_.empty() && cluster_name_ == cm_.localClusterName()) {
@@ -88,7 +110,11 @@ void EdsClusterImpl::onConfigUpdate(const ResourceVector& resources) {
       if (health_status == envoy::api::v2::core::HealthStatus::UNHEALTHY ||
           health_status == envoy::api::v2::core::HealthStatus::DRAINING ||
           health_status == envoy::api::v2::core::HealthStatus::TIMEOUT) {
-        priority_state[priority].first->back()->healthFlagSet(Host::HealthFlag::FAILED_EDS_HEALTH);
+        // Hosts of the parent process are unhealthy either through EDS or active health checks,
+        // and we can't tell which. If we are health checked, leave it to the health checker.
+        priority_state[priority].first->back()->healthFlagSet(
+            warm && health_checker_ != nullptr ? Host::HealthFlag::FAILED_ACTIVE_HC
+                                               : Host::HealthFlag::FAILED_EDS_HEALTH);
       }
     }
   }
@@ -96,17 +122,14 @@ void EdsClusterImpl::onConfigUpdate(const ResourceVector& resources) {
   for (size_t i = 0; i < priority_state.size(); ++i) {
     if (priority_state[i].first != nullptr) {
       updateHostsPerLocality(priority_set_.getOrCreateHostSet(i), *priority_state[i].first,
-                             priority_state[i].second);
+                             priority_state[i].second, !warm && health_checker_ != nullptr);
     }
   }
-
-  // If we didn't setup to initialize when our first round of health checking is complete, just
-  // do it now.
-  onPreInitComplete();
 }
 
 void EdsClusterImpl::updateHostsPerLocality(HostSet& host_set, const HostVector& new_hosts,
-                                            LocalityWeightsMap& locality_weights_map) {
+                                            LocalityWeightsMap& locality_weights_map,
+                                            bool depend_on_hc) {
   HostVectorSharedPtr current_hosts_copy(new HostVector(host_set.hosts()));
 
   HostVector hosts_added;
@@ -120,7 +143,7 @@ void EdsClusterImpl::updateHostsPerLocality(HostSet& host_set, const HostVector&
   // object for locality weights that we can update here, we should add something like this to
   // improve performance and scalability of locality weight updates.
   if (updateDynamicHostList(new_hosts, *current_hosts_copy, hosts_added, hosts_removed,
-                            health_checker_ != nullptr) ||
+                            depend_on_hc) ||
       current_locality_weights_map_ != locality_weights_map) {
     current_locality_weights_map_ = locality_weights_map;
     LocalityWeightsSharedPtr locality_weights;
@@ -28,6 +28,9 @@ public:
   // Upstream::Cluster
   InitializePhase initializePhase() const override { return InitializePhase::Secondary; }
 
+  // Upstream::ClusterImplBase
+  void setWarmHosts(const envoy::api::v2::ClusterLoadAssignment& hosts) override;
+
   // Config::SubscriptionCallbacks
   void onConfigUpdate(const ResourceVector& resources) override;
   void onConfigUpdateFailed(const EnvoyException* e) override;
@@ -38,8 +41,12 @@ public:
 private:
   using LocalityWeightsMap =
       std::unordered_map<envoy::api::v2::core::Locality, uint32_t, LocalityHash, LocalityEqualTo>;
+  // Updates the hosts from an EDS update, or from the hosts of the parent process if warm is true.
+  // Hosts of the parent process don't wait on active health checks to be used.
+  void updateClusterLoadAssignment(
+      const envoy::api::v2::ClusterLoadAssignment& cluster_load_assignment, bool warm);
   void updateHostsPerLocality(HostSet& host_set, const HostVector& new_hosts,
-                              LocalityWeightsMap& locality_weights_map);
+                              LocalityWeightsMap& locality_weights_map, bool depend_on_hc);
 
   // ClusterImplBase
   void startPreInit() override;
@@ -49,6 +56,7 @@ private:
   const LocalInfo::LocalInfo& local_info_;
   const std::string cluster_name_;
   LocalityWeightsMap current_locality_weights_map_;
+  std::unique_ptr<envoy::api::v2::ClusterLoadAssignment> warm_hosts_;
 };
 
 } // namespace Upstream
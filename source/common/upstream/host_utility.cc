@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include "common/network/utility.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -26,5 +28,47 @@ std::string HostUtility::healthFlagsToString(const Host& host) {
   return ret;
 }
 
+envoy::api::v2::ClusterLoadAssignment
+HostUtility::toClusterLoadAssignment(const std::string& cluster_name,
+                                     const PrioritySet& priority_set) {
+  envoy::api::v2::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name(cluster_name);
+
+  for (const HostSetPtr& host_set : priority_set.hostSetsPerPriority()) {
+    // Clusters that don't track localities leave hostsPerLocality() empty, in which case all of
+    // the hosts go in a single group.
+    std::vector<HostVector> per_locality = host_set->hostsPerLocality().get();
+    if (per_locality.empty()) {
+      per_locality.push_back(host_set->hosts());
+    }
+    const LocalityWeightsConstSharedPtr locality_weights = host_set->localityWeights();
+
+    for (size_t i = 0; i < per_locality.size(); ++i) {
+      if (per_locality[i].empty()) {
+        continue;
+      }
+      auto* locality_lb_endpoints = cluster_load_assignment.add_endpoints();
+      locality_lb_endpoints->set_priority(host_set->priority());
+      locality_lb_endpoints->mutable_locality()->MergeFrom(per_locality[i][0]->locality());
+      if (locality_weights != nullptr && i < locality_weights->size()) {
+        locality_lb_endpoints->mutable_load_balancing_weight()->set_value((*locality_weights)[i]);
+      }
+
+      for (const HostSharedPtr& host : per_locality[i]) {
+        auto* lb_endpoint = locality_lb_endpoints->add_lb_endpoints();
+        Network::Utility::addressToProtobufAddress(
+            *host->address(), *lb_endpoint->mutable_endpoint()->mutable_address());
+        lb_endpoint->set_health_status(host->healthy()
+                                           ? envoy::api::v2::core::HealthStatus::HEALTHY
+                                           : envoy::api::v2::core::HealthStatus::UNHEALTHY);
+        lb_endpoint->mutable_load_balancing_weight()->set_value(host->weight());
+        lb_endpoint->mutable_metadata()->MergeFrom(host->metadata());
+      }
+    }
+  }
+
+  return cluster_load_assignment;
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include <string>
 
+#include "envoy/api/v2/eds.pb.h"
 #include "envoy/upstream/upstream.h"
 
 namespace Envoy {
@@ -16,6 +17,16 @@ public:
    * Convert a host's health flags into a debug string.
    */
   static std::string healthFlagsToString(const Host& host);
+
+  /**
+   * Snapshot the hosts of a cluster, with their priority, locality, weight and whether they are
+   * healthy, in the form of an EDS update.
+   * @param cluster_name supplies the name of the cluster.
+   * @param priority_set supplies the hosts of the cluster.
+   * @return envoy::api::v2::ClusterLoadAssignment the snapshot.
+   */
+  static envoy::api::v2::ClusterLoadAssignment
+  toClusterLoadAssignment(const std::string& cluster_name, const PrioritySet& priority_set);
 };
 
 } // namespace Upstream
@@ -438,22 +438,33 @@ void RoundRobinLoadBalancer::refresh(uint32_t priority) {
     }
 
     // Nuke existing scheduler if it exists.
-    scheduler_[source] = Scheduler{};
-    scheduler_[source].weighted_ = weighted;
+    Scheduler& scheduler = scheduler_[source];
+    scheduler = Scheduler{};
+    scheduler.weighted_ = weighted;
     if (weighted) {
       // Populate scheduler with host list.
       // TODO(htuch): We should add the ability to randomly offset into the host list to
       // desynchronize the schedule across Envoys in large fleets.
+      std::vector<uint32_t> weights;
+      weights.reserve(hosts.size());
       for (const auto& host : hosts) {
-        // We use a fixed weight here. While the weight may change without
-        // notification, this will only be stale until this host is next picked,
-        // at which point it is reinserted into the EdfScheduler with its new
-        // weight in chooseHost().
-        scheduler_[source].edf_.add(host->weight(), host);
+        weights.push_back(host->weight());
+      }
+      // Host weight changes are delivered as membership updates (see
+      // BaseDynamicClusterImpl::updateDynamicHostList()), which rebuild the schedule.
+      if (!scheduler.schedule_.build(weights)) {
+        scheduler.edf_.reserve(hosts.size());
+        for (uint32_t i = 0; i < hosts.size(); ++i) {
+          // We use a fixed weight here. While the weight may change without
+          // notification, this will only be stale until this host is next picked,
+          // at which point it is reinserted into the EdfScheduler with its new
+          // weight in chooseHost().
+          scheduler.edf_.add(weights[i], i);
+        }
       }
     }
   };
-  // Populate EdfSchedulers for each valid HostsSource value for the host set
+  // Populate schedulers for each valid HostsSource value for the host set
   // at this priority.
   const auto& host_set = priority_set_.hostSetsPerPriority()[priority];
   add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts());
@@ -474,19 +485,27 @@ HostConstSharedPtr RoundRobinLoadBalancer::chooseHost(LoadBalancerContext*) {
   // hostSourceToUse() via the construction in refresh();
   ASSERT(scheduler_it != scheduler_.end());
   auto& scheduler = scheduler_it->second;
+  const HostVector& hosts_to_use = hostSourceToHosts(hosts_source);
+  if (hosts_to_use.size() == 0) {
+    return nullptr;
+  }
   if (scheduler.weighted_) {
-    auto host = scheduler.edf_.pick();
     // We should always succeed if weighted, since when we compute the scheduler
     // in refresh() above, any empty host vector will be treated as unweighted.
-    // We do not expire any hosts from the host list without rebuilding the scheduler.
-    ASSERT(host != nullptr);
-    scheduler.edf_.add(host->weight(), host);
-    return host;
-  } else {
-    const HostVector& hosts_to_use = hostSourceToHosts(hosts_source);
-    if (hosts_to_use.size() == 0) {
-      return nullptr;
+    // We do not modify the host list without rebuilding the scheduler, so host
+    // indices remain valid.
+    uint32_t index;
+    if (!scheduler.schedule_.empty()) {
+      index = scheduler.schedule_.pick();
+    } else {
+      const absl::optional<uint32_t> edf_index = scheduler.edf_.pick();
+      ASSERT(edf_index.has_value());
+      index = edf_index.value();
+      scheduler.edf_.add(hosts_to_use[index]->weight(), index);
     }
+    ASSERT(index < hosts_to_use.size());
+    return hosts_to_use[index];
+  } else {
     return hosts_to_use[scheduler.rr_index_++ % hosts_to_use.size()];
   }
 }
@@ -11,6 +11,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/upstream/edf_scheduler.h"
+#include "common/upstream/wrr_schedule.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -202,15 +203,15 @@ private:
 
 /**
  * Implementation of LoadBalancer that performs RR selection across the hosts in the cluster.
- * This scheduler respects host weighting and utilizes an EdfScheduler to achieve O(log n)
- * pick and insertion time complexity, O(n) memory use. The key insight is that if we schedule with
- * 1 / weight deadline, we will achieve the desired pick frequency for weighted RR in a given
- * interval. Naive implementations of weighted RR are either O(n) pick time or O(m * n) memory use,
- * where m is the weight range. We also explicitly check for the unweighted special case and use a
- * simple index to acheive O(1) scheduling in that case.
- * TODO(htuch): We use EDF at Google, but the EDF scheduler may be overkill if we don't want to
- * support large ranges of weights or arbitrary precision floating weights, we could construct an
- * explicit schedule, since m will be a small constant factor in O(m * n).
+ * This scheduler respects host weighting. When the hosts are weighted, a smooth weighted RR
+ * schedule over host indices is precomputed on host set membership change, giving O(1) pick time
+ * with no reference counting or allocation on the pick path. The schedule uses O(m * n) memory,
+ * where m is the (gcd reduced) weight range, so for large weighted host sets where this would be
+ * excessive we fall back to a pointer-free EdfScheduler over host indices, with O(log n) pick and
+ * insertion time complexity and O(n) memory use. The key insight behind both is that if we
+ * schedule with 1 / weight deadline, we will achieve the desired pick frequency for weighted RR in
+ * a given interval. We also explicitly check for the unweighted special case and use a simple index
+ * to acheive O(1) scheduling in that case.
  */
 class RoundRobinLoadBalancer : public LoadBalancer, ZoneAwareLoadBalancerBase {
 public:
@@ -226,8 +227,11 @@ private:
   void refresh(uint32_t priority);
 
   struct Scheduler {
-    // EdfScheduler for weighted RR.
-    EdfScheduler<const Host> edf_;
+    // Precomputed weighted RR schedule of host indices. Empty if the hosts are unweighted or the
+    // schedule would be too large, see WrrSchedule::kMaxScheduleSize.
+    WrrSchedule schedule_;
+    // EdfScheduler of host indices for weighted RR when schedule_ is empty.
+    EdfScheduler edf_;
     // Simple clock hand for when we do unweighted.
     size_t rr_index_{};
     bool weighted_{};
@@ -1,5 +1,6 @@
 #include "common/upstream/outlier_detection_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -41,40 +42,122 @@ void DetectorHostMonitorImpl::uneject(MonotonicTime unejection_time) {
   last_unejection_time_ = (unejection_time);
 }
 
-void DetectorHostMonitorImpl::updateCurrentSuccessRateBucket() {
-  success_rate_accumulator_bucket_.store(success_rate_accumulator_.updateCurrentWriter());
+DetectorHostMonitorImpl::~DetectorHostMonitorImpl() {
+  for (std::atomic<WorkerAccumulator*>& accumulator : worker_accumulators_) {
+    delete accumulator.load();
+  }
 }
 
-void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
-  success_rate_accumulator_bucket_.load()->total_request_counter_++;
-  if (Http::CodeUtility::is5xx(response_code)) {
-    std::shared_ptr<DetectorImpl> detector = detector_.lock();
-    if (!detector) {
-      // It's possible for the cluster/detector to go away while we still have a host in use.
-      return;
+void DetectorHostMonitorImpl::updateSuccessRateWindow() {
+  SuccessRateAccumulatorBucket totals;
+  for (const std::atomic<WorkerAccumulator*>& accumulator : worker_accumulators_) {
+    const WorkerAccumulator* worker = accumulator.load(std::memory_order_acquire);
+    if (worker != nullptr) {
+      totals.success_request_counter_ +=
+          worker->success_request_counter_.load(std::memory_order_relaxed);
+      totals.total_request_counter_ +=
+          worker->total_request_counter_.load(std::memory_order_relaxed);
+    }
+  }
+  success_rate_accumulator_.updateWindow(totals);
+}
+
+uint32_t DetectorHostMonitorImpl::workerAccumulatorIndex() {
+  static std::atomic<uint32_t> next_index{0};
+  static thread_local const uint32_t index = next_index++;
+  return index < kWorkerAccumulators - 1 ? index : kWorkerAccumulators - 1;
+}
+
+WorkerAccumulator& DetectorHostMonitorImpl::workerAccumulator(uint32_t index) {
+  WorkerAccumulator* accumulator = worker_accumulators_[index].load(std::memory_order_acquire);
+  if (accumulator == nullptr) {
+    // Only the shared accumulator can be raced for, in which case the loser frees its copy and
+    // uses the winner's.
+    std::unique_ptr<WorkerAccumulator> new_accumulator(
+        new WorkerAccumulator(index == kWorkerAccumulators - 1));
+    if (worker_accumulators_[index].compare_exchange_strong(accumulator, new_accumulator.get(),
+                                                            std::memory_order_acq_rel)) {
+      accumulator = new_accumulator.release();
     }
-    if (Http::CodeUtility::isGatewayError(response_code)) {
-      if (++consecutive_gateway_failure_ == detector->runtime().snapshot().getInteger(
-                                                "outlier_detection.consecutive_gateway_failure",
-                                                detector->config().consecutiveGatewayFailure())) {
-        detector->onConsecutiveGatewayFailure(host_.lock());
+  }
+  return *accumulator;
+}
+
+void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
+  const uint32_t index = workerAccumulatorIndex();
+  WorkerAccumulator& accumulator = workerAccumulator(index);
+  const bool is_5xx = Http::CodeUtility::is5xx(response_code);
+  accumulator.putRequest(!is_5xx);
+
+  // A success only needs to be handed to the main thread if it resets a count, or if it has to be
+  // ordered after errors that are still waiting to be applied. This keeps the common case free of
+  // locks and read-modify-write operations on memory shared with other workers.
+  // Acquiring post_pending_ makes the counts stored by the last applyConsecutiveErrors() visible.
+  if (!is_5xx && !accumulator.post_pending_.load(std::memory_order_acquire) &&
+      consecutive_5xx_.load(std::memory_order_relaxed) == 0 &&
+      consecutive_gateway_failure_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+
+  bool post = false;
+  {
+    std::unique_lock<std::mutex> lock(accumulator.lock_);
+    if (is_5xx) {
+      accumulator.consecutive_5xx_.putError();
+      if (Http::CodeUtility::isGatewayError(response_code)) {
+        accumulator.consecutive_gateway_failure_.putError();
+      } else {
+        accumulator.consecutive_gateway_failure_.putReset();
       }
     } else {
-      consecutive_gateway_failure_ = 0;
+      accumulator.consecutive_5xx_.putReset();
+      accumulator.consecutive_gateway_failure_.putReset();
     }
 
-    if (++consecutive_5xx_ ==
-        detector->runtime().snapshot().getInteger("outlier_detection.consecutive_5xx",
-                                                  detector->config().consecutive5xx())) {
-      detector->onConsecutive5xx(host_.lock());
+    if (!accumulator.post_pending_.load(std::memory_order_relaxed)) {
+      accumulator.post_pending_.store(true, std::memory_order_relaxed);
+      post = true;
     }
-  } else {
-    success_rate_accumulator_bucket_.load()->success_request_counter_++;
-    consecutive_5xx_ = 0;
-    consecutive_gateway_failure_ = 0;
+  }
+
+  // Responses that arrive while a post is outstanding are batched into it.
+  if (post) {
+    std::shared_ptr<DetectorImpl> detector = detector_.lock();
+    if (!detector) {
+      // It's possible for the cluster/detector to go away while we still have a host in use.
+      return;
+    }
+    detector->notifyMainThreadConsecutiveErrors(host_.lock(), this, index);
   }
 }
 
+void DetectorHostMonitorImpl::applyConsecutiveErrors(uint32_t index,
+                                                     uint64_t consecutive_5xx_threshold,
+                                                     uint64_t consecutive_gateway_failure_threshold,
+                                                     bool& consecutive_5xx,
+                                                     bool& consecutive_gateway_failure) {
+  ConsecutiveErrorRun run_5xx;
+  ConsecutiveErrorRun run_gateway_failure;
+  WorkerAccumulator& accumulator = workerAccumulator(index);
+  std::unique_lock<std::mutex> lock(accumulator.lock_);
+  std::swap(run_5xx, accumulator.consecutive_5xx_);
+  std::swap(run_gateway_failure, accumulator.consecutive_gateway_failure_);
+
+  uint32_t count = consecutive_5xx_;
+  consecutive_5xx = run_5xx.apply(count, consecutive_5xx_threshold);
+  consecutive_5xx_ = count;
+
+  count = consecutive_gateway_failure_;
+  consecutive_gateway_failure =
+      run_gateway_failure.apply(count, consecutive_gateway_failure_threshold);
+  consecutive_gateway_failure_ = count;
+
+  // The counts are stored before post_pending_ is cleared, so that a success taking the lock free
+  // path in putHttpResponseCode() never sees counts that do not include this batch yet. Otherwise
+  // it could skip a reset that is needed.
+  accumulator.post_pending_.store(false, std::memory_order_release);
+}
+
 Http::Code DetectorHostMonitorImpl::resultToHttpCode(Result result) {
   Http::Code http_code = Http::Code::InternalServerError;
 
@@ -289,7 +372,9 @@ DetectionStats DetectorImpl::generateStats(Stats::Scope& scope) {
                                       POOL_GAUGE_PREFIX(scope, prefix))};
 }
 
-void DetectorImpl::notifyMainThreadConsecutiveError(HostSharedPtr host, EjectionType type) {
+void DetectorImpl::notifyMainThreadConsecutiveErrors(HostSharedPtr host,
+                                                     DetectorHostMonitorImpl* monitor,
+                                                     uint32_t index) {
   // This event will come from all threads, so we synchronize with a post to the main thread.
   // NOTE: Unfortunately consecutive errors are complicated from a threading perspective because
   //       we catch consecutive errors on worker threads and then post back to the main thread.
@@ -300,21 +385,41 @@ void DetectorImpl::notifyMainThreadConsecutiveError(HostSharedPtr host, Ejection
   //       3) If when running on the main thread the weak pointer can be converted to a strong
   //          pointer, the detector/cluster must still exist so we can safely fire callbacks.
   //          Otherwise we do nothing since the detector/cluster is already gone.
+  //       The post carries the worker accumulator rather than the responses, so that responses
+  //       which arrive before it runs are applied by the same post.
   std::weak_ptr<DetectorImpl> weak_this = shared_from_this();
-  dispatcher_.post([weak_this, host, type]() -> void {
+  dispatcher_.post([weak_this, host, monitor, index]() -> void {
     std::shared_ptr<DetectorImpl> shared_this = weak_this.lock();
     if (shared_this) {
-      shared_this->onConsecutiveErrorWorker(host, type);
+      shared_this->onConsecutiveErrors(host, monitor, index);
     }
   });
 }
 
-void DetectorImpl::onConsecutive5xx(HostSharedPtr host) {
-  notifyMainThreadConsecutiveError(host, EjectionType::Consecutive5xx);
-}
+void DetectorImpl::onConsecutiveErrors(HostSharedPtr host, DetectorHostMonitorImpl* monitor,
+                                       uint32_t index) {
+  // The host may have been removed from the set, in which case its monitor may also have been
+  // replaced if it was added back. Either way the responses are stale, so just ignore them.
+  auto it = host_monitors_.find(host);
+  if (it == host_monitors_.end() || it->second != monitor) {
+    return;
+  }
 
-void DetectorImpl::onConsecutiveGatewayFailure(HostSharedPtr host) {
-  notifyMainThreadConsecutiveError(host, EjectionType::ConsecutiveGatewayFailure);
+  bool consecutive_5xx;
+  bool consecutive_gateway_failure;
+  monitor->applyConsecutiveErrors(
+      index,
+      runtime_.snapshot().getInteger("outlier_detection.consecutive_5xx",
+                                     config_.consecutive5xx()),
+      runtime_.snapshot().getInteger("outlier_detection.consecutive_gateway_failure",
+                                     config_.consecutiveGatewayFailure()),
+      consecutive_5xx, consecutive_gateway_failure);
+  if (consecutive_gateway_failure) {
+    onConsecutiveErrorWorker(host, EjectionType::ConsecutiveGatewayFailure);
+  }
+  if (consecutive_5xx) {
+    onConsecutiveErrorWorker(host, EjectionType::Consecutive5xx);
+  }
 }
 
 void DetectorImpl::onConsecutiveErrorWorker(HostSharedPtr host, EjectionType type) {
@@ -436,8 +541,8 @@ void DetectorImpl::onIntervalTimer() {
   for (auto host : host_monitors_) {
     checkHostForUneject(host.first, host.second, now);
 
-    // Need to update the writer bucket to keep the data valid.
-    host.second->updateCurrentSuccessRateBucket();
+    // Close the success rate window of the host over the totals of all workers.
+    host.second->updateSuccessRateWindow();
     // Refresh host success rate stat for the /clusters endpoint. If there is a new valid value, it
     // will get updated in processSuccessRateEjections().
     host.second->successRate(-1);
@@ -550,24 +655,64 @@ int EventLoggerImpl::secsSinceLastAction(const absl::optional<MonotonicTime>& la
   return -1;
 }
 
-SuccessRateAccumulatorBucket* SuccessRateAccumulator::updateCurrentWriter() {
-  // Right now current is being written to and backup is not. Flush the backup and swap.
-  backup_success_rate_bucket_->success_request_counter_ = 0;
-  backup_success_rate_bucket_->total_request_counter_ = 0;
-
-  current_success_rate_bucket_.swap(backup_success_rate_bucket_);
-
-  return current_success_rate_bucket_.get();
+void SuccessRateAccumulator::updateWindow(const SuccessRateAccumulatorBucket& totals) {
+  window_.success_request_counter_ =
+      totals.success_request_counter_ - window_start_.success_request_counter_;
+  window_.total_request_counter_ =
+      totals.total_request_counter_ - window_start_.total_request_counter_;
+  window_start_ = totals;
 }
 
 absl::optional<double>
 SuccessRateAccumulator::getSuccessRate(uint64_t success_rate_request_volume) {
-  if (backup_success_rate_bucket_->total_request_counter_ < success_rate_request_volume) {
+  if (window_.total_request_counter_ < success_rate_request_volume) {
     return absl::optional<double>();
   }
 
-  return absl::optional<double>(backup_success_rate_bucket_->success_request_counter_ * 100.0 /
-                                backup_success_rate_bucket_->total_request_counter_);
+  return absl::optional<double>(window_.success_request_counter_ * 100.0 /
+                                window_.total_request_counter_);
+}
+
+void ConsecutiveErrorRun::putError() {
+  if (!reset_) {
+    leading_errors_++;
+  } else {
+    trailing_errors_++;
+    max_run_ = std::max(max_run_, trailing_errors_);
+  }
+}
+
+void ConsecutiveErrorRun::putReset() {
+  reset_ = true;
+  trailing_errors_ = 0;
+}
+
+bool ConsecutiveErrorRun::apply(uint32_t& count, uint64_t threshold) const {
+  // The count reaches the threshold if the leading errors take it there, or if any later run of
+  // errors is long enough on its own. As when the count is charged one response at a time, a count
+  // that is already past the threshold does not reach it again.
+  const bool reached =
+      threshold > 0 &&
+      ((count < threshold && count + leading_errors_ >= threshold) || max_run_ >= threshold);
+  count = reset_ ? trailing_errors_ : count + leading_errors_;
+  return reached;
+}
+
+void WorkerAccumulator::putRequest(bool success) {
+  if (shared_) {
+    total_request_counter_++;
+    if (success) {
+      success_request_counter_++;
+    }
+  } else {
+    // Only this worker writes the totals, so they do not need a read-modify-write.
+    total_request_counter_.store(total_request_counter_.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_relaxed);
+    if (success) {
+      success_request_counter_.store(success_request_counter_.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+    }
+  }
 }
 
 } // namespace Outlier
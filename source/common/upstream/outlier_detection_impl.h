@@ -1,10 +1,12 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -60,27 +62,26 @@ struct HostSuccessRatePair {
   double success_rate_;
 };
 
+/**
+ * Request totals of a host, used to compute the success rate of the host over a window of time.
+ */
 struct SuccessRateAccumulatorBucket {
-  std::atomic<uint64_t> success_request_counter_;
-  std::atomic<uint64_t> total_request_counter_;
+  uint64_t success_request_counter_{};
+  uint64_t total_request_counter_{};
 };
 
 /**
- * The SuccessRateAccumulator uses the SuccessRateAccumulatorBucket to get per host success rate
- * stats. This implementation has a fixed window size of time, and thus only needs a
- * bucket to write to, and a bucket to accumulate/run stats over.
+ * The SuccessRateAccumulator computes per host success rate stats from the running request totals
+ * of the host. This implementation has a fixed window size of time, and thus only needs the totals
+ * at the start of the current window and the requests seen over the last complete window.
  */
 class SuccessRateAccumulator {
 public:
-  SuccessRateAccumulator()
-      : current_success_rate_bucket_(new SuccessRateAccumulatorBucket()),
-        backup_success_rate_bucket_(new SuccessRateAccumulatorBucket()) {}
-
   /**
-   * This function updates the bucket to write data to.
-   * @return a pointer to the SuccessRateAccumulatorBucket.
+   * This function closes the current window and starts a new one.
+   * @param totals the running request totals of the host at the end of the window.
    */
-  SuccessRateAccumulatorBucket* updateCurrentWriter();
+  void updateWindow(const SuccessRateAccumulatorBucket& totals);
   /**
    * This function returns the success rate of a host over a window of time if the request volume is
    * high enough. The underlying window of time could be dynamically adjusted. In the current
@@ -93,8 +94,56 @@ public:
   absl::optional<double> getSuccessRate(uint64_t success_rate_request_volume);
 
 private:
-  std::unique_ptr<SuccessRateAccumulatorBucket> current_success_rate_bucket_;
-  std::unique_ptr<SuccessRateAccumulatorBucket> backup_success_rate_bucket_;
+  SuccessRateAccumulatorBucket window_start_;
+  SuccessRateAccumulatorBucket window_;
+};
+
+/**
+ * Summary of the responses seen by one worker for one kind of consecutive error, with enough detail
+ * to replay them against the consecutive error count that the detector keeps for the host.
+ */
+struct ConsecutiveErrorRun {
+  void putError();
+  void putReset();
+
+  /**
+   * Applies the responses to a consecutive error count.
+   * @param count supplies the count before the responses, and is updated to the count after them.
+   * @param threshold supplies the consecutive error threshold.
+   * @return whether the count reached the threshold on one of the responses.
+   */
+  bool apply(uint32_t& count, uint64_t threshold) const;
+
+  // Errors before the first reset, which extend the count of the previous responses.
+  uint32_t leading_errors_{};
+  // Errors since the last reset.
+  uint32_t trailing_errors_{};
+  // The longest run of errors after the first reset.
+  uint32_t max_run_{};
+  bool reset_{};
+};
+
+/**
+ * Results charged to a host by one worker. The request totals are written only by the worker
+ * unless the accumulator is shared, and are read by the main thread when it closes a success rate
+ * window. Responses that can change the consecutive error counts are batched under the lock and
+ * handed to the main thread by a post.
+ */
+struct WorkerAccumulator {
+  WorkerAccumulator(bool shared) : shared_(shared) {}
+
+  void putRequest(bool success);
+
+  // Set for the accumulator used by all threads beyond the first kWorkerAccumulators - 1, in which
+  // case the request totals need atomic read-modify-write updates.
+  const bool shared_;
+  std::atomic<uint64_t> success_request_counter_{0};
+  std::atomic<uint64_t> total_request_counter_{0};
+  std::mutex lock_;
+  ConsecutiveErrorRun consecutive_5xx_;
+  ConsecutiveErrorRun consecutive_gateway_failure_;
+  // Written under lock_. Set while a post to drain the batch is outstanding.
+  std::atomic<bool> post_pending_{false};
 };
 
 class DetectorImpl;
@@ -104,21 +153,38 @@ class DetectorImpl;
  */
 class DetectorHostMonitorImpl : public DetectorHostMonitor {
 public:
+  // The number of worker accumulators per host. The last one is shared by any threads beyond the
+  // first kWorkerAccumulators - 1 to charge results to the host.
+  static constexpr uint32_t kWorkerAccumulators = 32;
+
   DetectorHostMonitorImpl(std::shared_ptr<DetectorImpl> detector, HostSharedPtr host)
-      : detector_(detector), host_(host), success_rate_(-1) {
-    // Point the success_rate_accumulator_bucket_ pointer to a bucket.
-    updateCurrentSuccessRateBucket();
-  }
+      : detector_(detector), host_(host), success_rate_(-1) {}
+  ~DetectorHostMonitorImpl();
 
   void eject(MonotonicTime ejection_time);
   void uneject(MonotonicTime ejection_time);
-  void updateCurrentSuccessRateBucket();
+  void updateSuccessRateWindow();
   SuccessRateAccumulator& successRateAccumulator() { return success_rate_accumulator_; }
   void successRate(double new_success_rate) { success_rate_ = new_success_rate; }
   void resetConsecutive5xx() { consecutive_5xx_ = 0; }
   void resetConsecutiveGatewayFailure() { consecutive_gateway_failure_ = 0; }
   static Http::Code resultToHttpCode(Result result);
 
+  /**
+   * Applies the responses batched by a worker to the consecutive error counts. Must be called on
+   * the main thread.
+   * @param index supplies the index of the worker accumulator.
+   * @param consecutive_5xx_threshold supplies the consecutive 5xx threshold.
+   * @param consecutive_gateway_failure_threshold supplies the consecutive gateway failure
+   *        threshold.
+   * @param consecutive_5xx set if the consecutive 5xx count reached its threshold.
+   * @param consecutive_gateway_failure set if the consecutive gateway failure count reached its
+   *        threshold.
+   */
+  void applyConsecutiveErrors(uint32_t index, uint64_t consecutive_5xx_threshold,
+                              uint64_t consecutive_gateway_failure_threshold,
+                              bool& consecutive_5xx, bool& consecutive_gateway_failure);
+
   // Upstream::Outlier::DetectorHostMonitor
   uint32_t numEjections() override { return num_ejections_; }
   void putHttpResponseCode(uint64_t response_code) override;
@@ -131,15 +197,21 @@ public:
   double successRate() const override { return success_rate_; }
 
 private:
+  static uint32_t workerAccumulatorIndex();
+  WorkerAccumulator& workerAccumulator(uint32_t index);
+
   std::weak_ptr<DetectorImpl> detector_;
   std::weak_ptr<Host> host_;
+  // Written only on the main thread, and read by workers to find out whether a success needs to be
+  // handed to the main thread to reset the count.
   std::atomic<uint32_t> consecutive_5xx_{0};
   std::atomic<uint32_t> consecutive_gateway_failure_{0};
   absl::optional<MonotonicTime> last_ejection_time_;
   absl::optional<MonotonicTime> last_unejection_time_;
   uint32_t num_ejections_{};
   SuccessRateAccumulator success_rate_accumulator_;
-  std::atomic<SuccessRateAccumulatorBucket*> success_rate_accumulator_bucket_;
+  // Allocated on first use by each worker.
+  std::array<std::atomic<WorkerAccumulator*>, kWorkerAccumulators> worker_accumulators_{};
   double success_rate_;
 };
 
@@ -215,8 +287,8 @@ public:
          EventLoggerSharedPtr event_logger);
   ~DetectorImpl();
 
-  void onConsecutive5xx(HostSharedPtr host);
-  void onConsecutiveGatewayFailure(HostSharedPtr host);
+  void notifyMainThreadConsecutiveErrors(HostSharedPtr host, DetectorHostMonitorImpl* monitor,
+                                         uint32_t index);
   Runtime::Loader& runtime() { return runtime_; }
   DetectorConfig& config() { return config_; }
 
@@ -236,8 +308,8 @@ private:
   void ejectHost(HostSharedPtr host, EjectionType type);
   static DetectionStats generateStats(Stats::Scope& scope);
   void initialize(const Cluster& cluster);
+  void onConsecutiveErrors(HostSharedPtr host, DetectorHostMonitorImpl* monitor, uint32_t index);
   void onConsecutiveErrorWorker(HostSharedPtr host, EjectionType type);
-  void notifyMainThreadConsecutiveError(HostSharedPtr host, EjectionType type);
   void onIntervalTimer();
   void runCallbacks(HostSharedPtr host);
   bool enforceEjection(EjectionType type);
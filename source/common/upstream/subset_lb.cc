@@ -1,6 +1,6 @@
 #include "common/upstream/subset_lb.h"
 
-#include <unordered_set>
+#include <algorithm>
 
 #include "envoy/api/v2/cds.pb.h"
 #include "envoy/runtime/runtime.h"
@@ -30,7 +30,22 @@ SubsetLoadBalancer::SubsetLoadBalancer(
       original_local_priority_set_(local_priority_set) {
   ASSERT(subsets.isEnabled());
 
-  // Create filtered default subset (if necessary) and other subsets based on current hosts.
+  // Create the fallback subset (if necessary). It is populated along with the other subsets below.
+  if (fallback_policy_ == envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK) {
+    ENVOY_LOG(debug, "subset lb: fallback load balancer disabled");
+  } else {
+    if (fallback_policy_ == envoy::api::v2::Cluster::LbSubsetConfig::ANY_ENDPOINT) {
+      ENVOY_LOG(debug, "subset lb: creating any-endpoint fallback load balancer");
+    } else {
+      ENVOY_LOG(debug, "subset lb: creating fallback load balancer for {}",
+                describeMetadata(default_subset_metadata_));
+    }
+
+    fallback_subset_.reset(new LbSubsetEntry());
+    fallback_subset_->priority_subset_.reset(new PrioritySubsetImpl(*this));
+  }
+
+  // Create subsets based on current hosts.
   for (auto& host_set : priority_set.hostSetsPerPriority()) {
     update(host_set->priority(), host_set->hosts(), {});
   }
@@ -73,7 +88,7 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
   }
 
   // Route has metadata match criteria defined, see if we have a matching subset.
-  LbSubsetEntryPtr entry = findSubset(match_criteria->metadataMatchCriteria());
+  LbSubsetEntry* entry = findSubset(*match_criteria);
   if (entry == nullptr || !entry->active()) {
     // No matching subset or subset not active: use fallback policy.
     return nullptr;
@@ -84,9 +99,26 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
   return entry->priority_subset_->lb_->chooseHost(context);
 }
 
+// Finds the LbSubsetEntry matching the given metadata match criteria, if any, consulting
+// subset_cache_ first.
+SubsetLoadBalancer::LbSubsetEntry*
+SubsetLoadBalancer::findSubset(const Router::MetadataMatchCriteria& match_criteria) {
+  const auto cache_it = subset_cache_.find(match_criteria.id());
+  if (cache_it != subset_cache_.end()) {
+    return cache_it->second;
+  }
+
+  LbSubsetEntry* entry = findSubset(match_criteria.metadataMatchCriteria());
+  if (subset_cache_.size() >= kMaxSubsetCacheSize) {
+    subset_cache_.clear();
+  }
+  subset_cache_.emplace(match_criteria.id(), entry);
+  return entry;
+}
+
 // Iterates over the given metadata match criteria (which must be lexically sorted by key) and find
 // a matching LbSubsetEnryPtr, if any.
-SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
+SubsetLoadBalancer::LbSubsetEntry* SubsetLoadBalancer::findSubset(
     const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& match_criteria) {
   const LbSubsetMap* subsets = &subsets_;
 
@@ -114,7 +146,7 @@ SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
     const LbSubsetEntryPtr& entry = vs_it->second;
     if (i + 1 == match_criteria.size()) {
       // We've reached the end of the criteria, and they all matched.
-      return entry;
+      return entry.get();
     }
 
     subsets = &entry->children_;
@@ -123,126 +155,178 @@ SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
   return nullptr;
 }
 
-void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
-                                              const HostVector& hosts_removed) {
-  if (fallback_policy_ == envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK) {
-    ENVOY_LOG(debug, "subset lb: fallback load balancer disabled");
-    return;
+// Returns the subsets the host belongs to, resolving them from the host's metadata (and creating
+// uninitialized subset entries as necessary) if the host has not been seen before.
+const SubsetLoadBalancer::HostSubsets&
+SubsetLoadBalancer::findOrResolveHostSubsets(const HostSharedPtr& host) {
+  const auto it = host_subsets_.find(host);
+  if (it != host_subsets_.end()) {
+    return it->second;
   }
 
-  if (fallback_subset_ == nullptr) {
-    // First update: create the default host subset.
-    HostPredicate predicate;
-    if (fallback_policy_ == envoy::api::v2::Cluster::LbSubsetConfig::ANY_ENDPOINT) {
-      predicate = [](const Host&) -> bool { return true; };
+  HostSubsets& host_subsets = host_subsets_[host];
+  for (const auto& keys : subset_keys_) {
+    // For each subset key, attempt to extract the metadata corresponding to the key from the host.
+    SubsetMetadata kvs = extractSubsetMetadata(keys, *host);
+    if (!kvs.empty()) {
+      // The host has metadata for each key, find or create its subset.
+      LbSubsetEntry* entry = findOrCreateSubset(subsets_, kvs, 0).get();
+      if (std::find(host_subsets.entries_.begin(), host_subsets.entries_.end(), entry) ==
+          host_subsets.entries_.end()) {
+        host_subsets.entries_.push_back(entry);
+      }
+    }
+  }
 
-      ENVOY_LOG(debug, "subset lb: creating any-endpoint fallback load balancer");
-    } else {
-      predicate = std::bind(&SubsetLoadBalancer::hostMatches, this, default_subset_metadata_,
-                            std::placeholders::_1);
+  switch (fallback_policy_) {
+  case envoy::api::v2::Cluster::LbSubsetConfig::ANY_ENDPOINT:
+    host_subsets.fallback_ = true;
+    break;
+  case envoy::api::v2::Cluster::LbSubsetConfig::DEFAULT_SUBSET:
+    host_subsets.fallback_ = hostMatches(default_subset_metadata_, *host);
+    break;
+  default:
+    break;
+  }
 
-      ENVOY_LOG(debug, "subset lb: creating fallback load balancer for {}",
-                describeMetadata(default_subset_metadata_));
+  return host_subsets;
+}
+
+// Given the addition and/or removal of hosts, update all subsets for this priority level, creating
+// new subsets as necessary. Subset membership is resolved once per host, so an update makes a
+// single pass over the priority's hosts, recording the position of each host in each of its
+// subsets. Every subset with hosts at this priority is then rebuilt in time proportional to its
+// number of members, and subsets without hosts at this priority are not visited. The rebuild is
+// not incremental: host positions are not stable across updates, so unchanged subsets with hosts
+// at this priority are rebuilt too.
+void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added,
+                                const HostVector& hosts_removed) {
+  const HostVector& hosts = original_priority_set_.hostSetsPerPriority()[priority]->hosts();
+
+  // Subset updates in the order the subsets were first touched, to keep updates deterministic.
+  std::vector<std::pair<LbSubsetEntry*, SubsetUpdate>> subset_updates;
+  std::unordered_map<LbSubsetEntry*, size_t> subset_update_index;
+  const auto subset_update = [&](LbSubsetEntry* entry) -> SubsetUpdate& {
+    const auto it = subset_update_index.find(entry);
+    if (it != subset_update_index.end()) {
+      return subset_updates[it->second].second;
     }
+    subset_update_index.emplace(entry, subset_updates.size());
+    subset_updates.emplace_back(entry, SubsetUpdate());
+    return subset_updates.back().second;
+  };
+  SubsetUpdate fallback_update;
+
+  for (const auto& host : hosts_added) {
+    const HostSubsets& host_subsets = findOrResolveHostSubsets(host);
+    for (LbSubsetEntry* entry : host_subsets.entries_) {
+      subset_update(entry).hosts_added_.push_back(host);
+    }
+    if (host_subsets.fallback_) {
+      fallback_update.hosts_added_.push_back(host);
+    }
+  }
 
-    fallback_subset_.reset(new LbSubsetEntry());
-    fallback_subset_->priority_subset_.reset(new PrioritySubsetImpl(*this, predicate));
-    return;
+  for (const auto& host : hosts_removed) {
+    const HostSubsets& host_subsets = findOrResolveHostSubsets(host);
+    for (LbSubsetEntry* entry : host_subsets.entries_) {
+      subset_update(entry).hosts_removed_.push_back(host);
+    }
+    if (host_subsets.fallback_) {
+      fallback_update.hosts_removed_.push_back(host);
+    }
   }
 
-  // Subsequent updates: add/remove hosts.
-  fallback_subset_->priority_subset_->update(priority, hosts_added, hosts_removed);
-}
+  for (uint32_t i = 0; i < hosts.size(); ++i) {
+    const HostSubsets& host_subsets = findOrResolveHostSubsets(hosts[i]);
+    for (LbSubsetEntry* entry : host_subsets.entries_) {
+      subset_update(entry).members_.push_back(i);
+    }
+    if (host_subsets.fallback_) {
+      fallback_update.members_.push_back(i);
+    }
+  }
 
-// Iterates over the added and removed hosts, looking up an LbSubsetEntryPtr for each. For every
-// unique LbSubsetEntryPtr found, it either invokes new_cb or update_cb depending on whether the
-// LbSubsetEntryPtr is already initialized (update_cb) or not (new_cb). In addition, update_cb is
-// invoked for any otherwise unmodified but active and initialized LbSubsetEntryPtr to allow host
-// health to be updated.
-void SubsetLoadBalancer::processSubsets(
-    const HostVector& hosts_added, const HostVector& hosts_removed,
-    std::function<void(LbSubsetEntryPtr)> update_cb,
-    std::function<void(LbSubsetEntryPtr, HostPredicate, const SubsetMetadata&, bool)> new_cb) {
-  std::unordered_set<LbSubsetEntryPtr> subsets_modified;
-
-  std::pair<const HostVector&, bool> steps[] = {{hosts_added, true}, {hosts_removed, false}};
-  for (const auto& step : steps) {
-    const auto& hosts = step.first;
-    const bool adding_hosts = step.second;
-
-    for (const auto& host : hosts) {
-      for (const auto& keys : subset_keys_) {
-        // For each host, for each subset key, attempt to extract the metadata corresponding to the
-        // key from the host.
-        SubsetMetadata kvs = extractSubsetMetadata(keys, *host);
-        if (!kvs.empty()) {
-          // The host has metadata for each key, find or create its subset.
-          LbSubsetEntryPtr entry = findOrCreateSubset(subsets_, kvs, 0);
-          if (subsets_modified.find(entry) != subsets_modified.end()) {
-            // We've already invoked the callback for this entry.
-            continue;
-          }
-          subsets_modified.emplace(entry);
-
-          if (entry->initialized()) {
-            update_cb(entry);
-          } else {
-            HostPredicate predicate =
-                std::bind(&SubsetLoadBalancer::hostMatches, this, kvs, std::placeholders::_1);
-
-            new_cb(entry, predicate, kvs, adding_hosts);
-          }
+  // Removed hosts are no longer tracked.
+  for (const auto& host : hosts_removed) {
+    host_subsets_.erase(host);
+  }
+
+  const HostSetIndex index(*original_priority_set_.hostSetsPerPriority()[priority]);
+  if (fallback_subset_ != nullptr) {
+    fallback_subset_->priority_subset_->update(priority, fallback_update, index);
+  }
+
+  // Indexes and subset members of every priority, only computed if a new subset must be
+  // initialized.
+  std::vector<HostSetIndex> indexes;
+  std::vector<SubsetMembers> members;
+  for (const auto& it : subset_updates) {
+    LbSubsetEntry& entry = *it.first;
+    const SubsetUpdate& entry_update = it.second;
+
+    if (entry.initialized()) {
+      updateSubset(entry, priority, entry_update, index);
+    } else if (!entry_update.hosts_added_.empty()) {
+      // Initialize new entry with hosts and update stats. (An uninitialized entry with only removed
+      // hosts is a degenerate case and we leave the entry uninitialized.)
+      if (indexes.empty()) {
+        const auto& host_sets = original_priority_set_.hostSetsPerPriority();
+        for (uint32_t i = 0; i < host_sets.size(); ++i) {
+          indexes.emplace_back(*host_sets[i]);
+          members.emplace_back(subsetMembers(i));
         }
       }
+      initializeSubset(entry, indexes, members);
     }
   }
+}
 
-  forEachSubset(subsets_, [&](LbSubsetEntryPtr entry) {
-    if (subsets_modified.find(entry) != subsets_modified.end()) {
-      // Already handled due to hosts being added or removed.
-      return;
-    }
+// Apply an update at a single priority to an initialized subset and update stats.
+void SubsetLoadBalancer::updateSubset(LbSubsetEntry& entry, uint32_t priority,
+                                      const SubsetUpdate& update, const HostSetIndex& index) {
+  const bool active_before = entry.active();
+  entry.priority_subset_->update(priority, update, index);
+
+  if (active_before && !entry.active()) {
+    stats_.lb_subsets_active_.dec();
+    stats_.lb_subsets_removed_.inc();
+  } else if (!active_before && entry.active()) {
+    stats_.lb_subsets_active_.inc();
+    stats_.lb_subsets_created_.inc();
+  }
+}
 
-    if (entry->initialized() && entry->active()) {
-      update_cb(entry);
-    }
-  });
+// Create the load balancer for a new subset, populated with its hosts at every priority.
+void SubsetLoadBalancer::initializeSubset(LbSubsetEntry& entry,
+                                          const std::vector<HostSetIndex>& indexes,
+                                          const std::vector<SubsetMembers>& members) {
+  entry.priority_subset_.reset(new PrioritySubsetImpl(*this));
+
+  const SubsetUpdate no_members;
+  for (uint32_t priority = 0; priority < indexes.size(); ++priority) {
+    const auto it = members[priority].find(&entry);
+    entry.priority_subset_->update(priority,
+                                   it != members[priority].end() ? it->second : no_members,
+                                   indexes[priority]);
+  }
+
+  stats_.lb_subsets_active_.inc();
+  stats_.lb_subsets_created_.inc();
 }
 
-// Given the addition and/or removal of hosts, update all subsets for this priority level, creating
-// new subsets as necessary.
-void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added,
-                                const HostVector& hosts_removed) {
-  updateFallbackSubset(priority, hosts_added, hosts_removed);
-
-  processSubsets(hosts_added, hosts_removed,
-                 [&](LbSubsetEntryPtr entry) {
-                   const bool active_before = entry->active();
-                   entry->priority_subset_->update(priority, hosts_added, hosts_removed);
-
-                   if (active_before && !entry->active()) {
-                     stats_.lb_subsets_active_.dec();
-                     stats_.lb_subsets_removed_.inc();
-                   } else if (!active_before && entry->active()) {
-                     stats_.lb_subsets_active_.inc();
-                     stats_.lb_subsets_created_.inc();
-                   }
-                 },
-                 [&](LbSubsetEntryPtr entry, HostPredicate predicate, const SubsetMetadata& kvs,
-                     bool adding_host) {
-                   UNREFERENCED_PARAMETER(kvs);
-                   if (adding_host) {
-                     ENVOY_LOG(debug, "subset lb: creating load balancer for {}",
-                               describeMetadata(kvs));
-
-                     // Initialize new entry with hosts and update stats. (An uninitialized entry
-                     // with only removed hosts is a degenerate case and we leave the entry
-                     // uninitialized.)
-                     entry->priority_subset_.reset(new PrioritySubsetImpl(*this, predicate));
-                     stats_.lb_subsets_active_.inc();
-                     stats_.lb_subsets_created_.inc();
-                   }
-                 });
+// The members of every subset with hosts at a priority, found in a single pass over its hosts.
+SubsetLoadBalancer::SubsetMembers SubsetLoadBalancer::subsetMembers(uint32_t priority) {
+  const HostVector& hosts = original_priority_set_.hostSetsPerPriority()[priority]->hosts();
+  SubsetMembers members;
+  for (uint32_t i = 0; i < hosts.size(); ++i) {
+    for (LbSubsetEntry* entry : findOrResolveHostSubsets(hosts[i]).entries_) {
+      SubsetUpdate& update = members[entry];
+      update.members_.push_back(i);
+      update.hosts_added_.push_back(hosts[i]);
+    }
+  }
+  return members;
 }
 
 bool SubsetLoadBalancer::hostMatches(const SubsetMetadata& kvs, const Host& host) {
@@ -331,8 +415,9 @@ SubsetLoadBalancer::findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadat
   }
 
   if (!entry) {
-    // Not found. Create an uninitialized entry.
+    // Not found. Create an uninitialized entry. Cached subset lookups may now resolve differently.
     entry.reset(new LbSubsetEntry());
+    subset_cache_.clear();
     if (kv_it != subsets.end()) {
       ValueSubsetMap& value_subset_map = kv_it->second;
       value_subset_map.emplace(value, entry);
@@ -351,31 +436,13 @@ SubsetLoadBalancer::findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadat
   return findOrCreateSubset(entry->children_, kvs, idx);
 }
 
-// Invokes cb for each LbSubsetEntryPtr in subsets.
-void SubsetLoadBalancer::forEachSubset(LbSubsetMap& subsets,
-                                       std::function<void(LbSubsetEntryPtr)> cb) {
-  for (auto& vsm : subsets) {
-    for (auto& em : vsm.second) {
-      LbSubsetEntryPtr entry = em.second;
-      cb(entry);
-      forEachSubset(entry->children_, cb);
-    }
-  }
-}
-
-// Initialize a new HostSubsetImpl and LoadBalancer from the SubsetLoadBalancer, filtering hosts
-// with the given predicate.
-SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalancer& subset_lb,
-                                                           HostPredicate predicate)
-    : PrioritySetImpl(), original_priority_set_(subset_lb.original_priority_set_),
-      predicate_(predicate) {
+// Initialize a new HostSubsetImpl and LoadBalancer from the SubsetLoadBalancer. The subset starts
+// out empty and is populated via update().
+SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalancer& subset_lb)
+    : PrioritySetImpl(), original_priority_set_(subset_lb.original_priority_set_) {
 
   for (size_t i = 0; i < original_priority_set_.hostSetsPerPriority().size(); ++i) {
-    empty_ &= getOrCreateHostSet(i).hosts().empty();
-  }
-
-  for (size_t i = 0; i < subset_lb.original_priority_set_.hostSetsPerPriority().size(); ++i) {
-    update(i, subset_lb.original_priority_set_.hostSetsPerPriority()[i]->hosts(), {});
+    getOrCreateHostSet(i);
   }
 
   switch (subset_lb.lb_type_) {
@@ -421,47 +488,54 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
   case LoadBalancerType::OriginalDst:
     NOT_REACHED;
   }
-
-  triggerCallbacks();
 }
 
-// Given hosts_added and hosts_removed, update the underlying HostSet. The hosts_added Hosts must
-// be filtered to match hosts that belong in this subset. The hosts_removed Hosts are ignored if
-// they are not currently a member of this subset.
-void SubsetLoadBalancer::HostSubsetImpl::update(const HostVector& hosts_added,
-                                                const HostVector& hosts_removed,
-                                                std::function<bool(const Host&)> predicate) {
-  HostVector filtered_added;
-  for (const auto host : hosts_added) {
-    if (predicate(*host)) {
-      filtered_added.emplace_back(host);
+// Given a subset update, rebuild the underlying HostSet from the positions of its members, in time
+// proportional to the number of members. The hosts_added and hosts_removed Hosts of the update have
+// already been filtered to members of this subset.
+void SubsetLoadBalancer::HostSubsetImpl::update(const SubsetUpdate& update,
+                                                const HostSetIndex& index) {
+  const HostVector& original_hosts = original_host_set_.hosts();
+  ASSERT(index.host_localities_.size() == original_hosts.size());
+
+  HostVectorSharedPtr hosts(new HostVector());
+  HostVectorSharedPtr healthy_hosts(new HostVector());
+  hosts->reserve(update.members_.size());
+
+  // The members of each locality, as their position within the locality and in hosts().
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> locality_members(index.num_localities_);
+  for (const uint32_t i : update.members_) {
+    ASSERT(i < original_hosts.size());
+    hosts->emplace_back(original_hosts[i]);
+    if (original_hosts[i]->healthy()) {
+      healthy_hosts->emplace_back(original_hosts[i]);
     }
-  }
 
-  HostVector filtered_removed;
-  for (const auto host : hosts_removed) {
-    if (predicate(*host)) {
-      filtered_removed.emplace_back(host);
+    const HostSetIndex::HostLocality& host_locality = index.host_localities_[i];
+    if (host_locality.locality_ != HostSetIndex::NoLocality) {
+      locality_members[host_locality.locality_].emplace_back(host_locality.position_, i);
     }
   }
 
-  HostVectorSharedPtr hosts(new HostVector());
-  HostVectorSharedPtr healthy_hosts(new HostVector());
-
-  for (const auto host : original_host_set_.hosts()) {
-    if (predicate(*host)) {
-      hosts->emplace_back(host);
+  std::vector<HostVector> locality_hosts(index.num_localities_);
+  std::vector<HostVector> healthy_locality_hosts(index.num_localities_);
+  for (size_t locality = 0; locality < index.num_localities_; ++locality) {
+    // Keep the hosts in the order of the original locality.
+    std::sort(locality_members[locality].begin(), locality_members[locality].end());
+    for (const auto& member : locality_members[locality]) {
+      const HostSharedPtr& host = original_hosts[member.second];
+      locality_hosts[locality].emplace_back(host);
       if (host->healthy()) {
-        healthy_hosts->emplace_back(host);
+        healthy_locality_hosts[locality].emplace_back(host);
       }
     }
   }
 
+  const bool has_local_locality = original_host_set_.hostsPerLocality().hasLocalLocality();
   HostsPerLocalityConstSharedPtr hosts_per_locality =
-      original_host_set_.hostsPerLocality().filter(predicate);
+      std::make_shared<HostsPerLocalityImpl>(std::move(locality_hosts), has_local_locality);
   HostsPerLocalityConstSharedPtr healthy_hosts_per_locality =
-      original_host_set_.hostsPerLocality().filter(
-          [&predicate](const Host& host) { return predicate(host) && host.healthy(); });
+      std::make_shared<HostsPerLocalityImpl>(std::move(healthy_locality_hosts), has_local_locality);
 
   // We pass in an empty list of locality weights here. This effectively disables locality balancing
   // for subset LB.
@@ -475,7 +549,30 @@ void SubsetLoadBalancer::HostSubsetImpl::update(const HostVector& hosts_added,
   // respected this way, those weightings were made by a management server that was not taking into
   // consideration subsets (e.g. LRS only reports at locality level).
   HostSetImpl::updateHosts(hosts, healthy_hosts, hosts_per_locality, healthy_hosts_per_locality, {},
-                           filtered_added, filtered_removed);
+                           update.hosts_added_, update.hosts_removed_);
+}
+
+SubsetLoadBalancer::HostSetIndex::HostSetIndex(const HostSet& host_set)
+    : host_localities_(host_set.hosts().size()) {
+  const HostVector& hosts = host_set.hosts();
+  std::unordered_map<const Host*, uint32_t> positions;
+  positions.reserve(hosts.size());
+  for (uint32_t i = 0; i < hosts.size(); ++i) {
+    positions.emplace(hosts[i].get(), i);
+  }
+
+  const auto& hosts_per_locality = host_set.hostsPerLocality().get();
+  num_localities_ = hosts_per_locality.size();
+  for (uint32_t locality = 0; locality < hosts_per_locality.size(); ++locality) {
+    const HostVector& locality_hosts = hosts_per_locality[locality];
+    for (uint32_t position = 0; position < locality_hosts.size(); ++position) {
+      const auto it = positions.find(locality_hosts[position].get());
+      if (it != positions.end()) {
+        host_localities_[it->second].locality_ = locality;
+        host_localities_[it->second].position_ = position;
+      }
+    }
+  }
 }
 
 HostSetImplPtr SubsetLoadBalancer::PrioritySubsetImpl::createHostSet(uint32_t priority) {
@@ -484,11 +581,10 @@ HostSetImplPtr SubsetLoadBalancer::PrioritySubsetImpl::createHostSet(uint32_t pr
       new HostSubsetImpl(*original_priority_set_.hostSetsPerPriority()[priority])};
 }
 
-void SubsetLoadBalancer::PrioritySubsetImpl::update(uint32_t priority,
-                                                    const HostVector& hosts_added,
-                                                    const HostVector& hosts_removed) {
+void SubsetLoadBalancer::PrioritySubsetImpl::update(uint32_t priority, const SubsetUpdate& update,
+                                                    const HostSetIndex& index) {
   HostSubsetImpl* host_subset = getOrCreateHostSubset(priority);
-  host_subset->update(hosts_added, hosts_removed, predicate_);
+  host_subset->update(update, index);
 
   if (host_subset->hosts().empty() != empty_) {
     empty_ = true;
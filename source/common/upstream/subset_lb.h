@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "envoy/runtime/runtime.h"
 #include "envoy/upstream/load_balancer.h"
@@ -32,7 +34,34 @@ public:
   HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
 
 private:
-  typedef std::function<bool(const Host&)> HostPredicate;
+  // Localities of the hosts of an original HostSet, computed once per update of the original host
+  // set and shared by all subsets.
+  struct HostSetIndex {
+    HostSetIndex(const HostSet& host_set);
+
+    static const uint32_t NoLocality = UINT32_MAX;
+
+    struct HostLocality {
+      // Index of the locality in hostsPerLocality(), or NoLocality if the host is in none.
+      uint32_t locality_{NoLocality};
+      // Position of the host within the locality.
+      uint32_t position_{};
+    };
+
+    // The locality of each host in hosts().
+    std::vector<HostLocality> host_localities_;
+    size_t num_localities_{};
+  };
+
+  // The change to a single subset at a single priority, computed for all subsets in one pass over
+  // the original HostSet.
+  struct SubsetUpdate {
+    // Positions of the subset's members in the original HostSet's hosts(), in ascending order.
+    std::vector<uint32_t> members_;
+    // Subset members added to and removed from the original HostSet.
+    HostVector hosts_added_;
+    HostVector hosts_removed_;
+  };
 
   // Represents a subset of an original HostSet.
   class HostSubsetImpl : public HostSetImpl {
@@ -40,10 +69,8 @@ private:
     HostSubsetImpl(const HostSet& original_host_set)
         : HostSetImpl(original_host_set.priority()), original_host_set_(original_host_set) {}
 
-    void update(const HostVector& hosts_added, const HostVector& hosts_removed,
-                HostPredicate predicate);
+    void update(const SubsetUpdate& update, const HostSetIndex& index);
 
-    void triggerCallbacks() { HostSetImpl::runUpdateCallbacks({}, {}); }
     bool empty() { return hosts().empty(); }
 
   private:
@@ -53,9 +80,9 @@ private:
   // Represents a subset of an original PrioritySet.
   class PrioritySubsetImpl : public PrioritySetImpl {
   public:
-    PrioritySubsetImpl(const SubsetLoadBalancer& subset_lb, HostPredicate predicate);
+    PrioritySubsetImpl(const SubsetLoadBalancer& subset_lb);
 
-    void update(uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed);
+    void update(uint32_t priority, const SubsetUpdate& update, const HostSetIndex& index);
 
     bool empty() { return empty_; }
 
@@ -63,12 +90,6 @@ private:
       return reinterpret_cast<HostSubsetImpl*>(&getOrCreateHostSet(priority));
     }
 
-    void triggerCallbacks() {
-      for (size_t i = 0; i < hostSetsPerPriority().size(); ++i) {
-        getOrCreateHostSubset(i)->triggerCallbacks();
-      }
-    }
-
     // Thread aware LB if applicable.
     ThreadAwareLoadBalancerPtr thread_aware_lb_;
     // Current active LB.
@@ -79,7 +100,6 @@ private:
 
   private:
     const PrioritySet& original_priority_set_;
-    const HostPredicate predicate_;
     bool empty_ = true;
   };
 
@@ -107,26 +127,39 @@ private:
     PrioritySubsetImplPtr priority_subset_;
   };
 
+  // The subsets a host belongs to. This is resolved from the host's metadata once, when the host is
+  // first seen, and reused on every subsequent update. Entries are never removed from subsets_, so
+  // the raw pointers remain valid for the lifetime of the load balancer.
+  struct HostSubsets {
+    std::vector<LbSubsetEntry*> entries_;
+    // Whether the host belongs to the fallback subset.
+    bool fallback_{};
+  };
+
+  // The members of each subset with hosts at a single priority, with all of them as hosts added.
+  typedef std::unordered_map<LbSubsetEntry*, SubsetUpdate> SubsetMembers;
+
   // Called by HostSet::MemberUpdateCb
   void update(uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed);
 
-  void updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
-                            const HostVector& hosts_removed);
-  void processSubsets(
-      const HostVector& hosts_added, const HostVector& hosts_removed,
-      std::function<void(LbSubsetEntryPtr)> update_cb,
-      std::function<void(LbSubsetEntryPtr, HostPredicate, const SubsetMetadata&, bool)> cb);
+  void updateSubset(LbSubsetEntry& entry, uint32_t priority, const SubsetUpdate& update,
+                    const HostSetIndex& index);
+  void initializeSubset(LbSubsetEntry& entry, const std::vector<HostSetIndex>& indexes,
+                        const std::vector<SubsetMembers>& members);
+  SubsetMembers subsetMembers(uint32_t priority);
+
+  const HostSubsets& findOrResolveHostSubsets(const HostSharedPtr& host);
 
   HostConstSharedPtr tryChooseHostFromContext(LoadBalancerContext* context, bool& host_chosen);
 
   bool hostMatches(const SubsetMetadata& kvs, const Host& host);
 
-  LbSubsetEntryPtr
+  LbSubsetEntry* findSubset(const Router::MetadataMatchCriteria& match_criteria);
+  LbSubsetEntry*
   findSubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
 
   LbSubsetEntryPtr findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadata& kvs,
                                       uint32_t idx);
-  void forEachSubset(LbSubsetMap& subsets, std::function<void(LbSubsetEntryPtr)> cb);
 
   SubsetMetadata extractSubsetMetadata(const std::set<std::string>& subset_keys, const Host& host);
   std::string describeMetadata(const SubsetMetadata& kvs);
@@ -150,6 +183,17 @@ private:
   // Forms a trie-like structure. Requires lexically sorted Host and Route metadata.
   LbSubsetMap subsets_;
 
+  // Subset membership of every known host. Keyed by shared pointer so that a host's address cannot
+  // be reused by a different host while it is still tracked here.
+  std::unordered_map<HostSharedPtr, HostSubsets> host_subsets_;
+
+  // Resolved subsets keyed by Router::MetadataMatchCriteria::id(). The criteria of a route entry
+  // are fixed, so requests after the first resolve their subset with a single lookup. Cleared
+  // whenever a new subset is created, since that may change the result for criteria that
+  // previously had no match, and when it grows beyond kMaxSubsetCacheSize.
+  std::unordered_map<uint64_t, LbSubsetEntry*> subset_cache_;
+  static constexpr size_t kMaxSubsetCacheSize = 1024;
+
   friend class SubsetLoadBalancerDescribeMetadataTester;
 };
 
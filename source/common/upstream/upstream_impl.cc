@@ -156,17 +156,18 @@ void HostSetImpl::updateHosts(HostVectorConstSharedPtr hosts,
   // apply the new weights.
   if (hosts_per_locality_ != nullptr && locality_weights_ != nullptr &&
       !locality_weights_->empty()) {
-    locality_scheduler_ = std::make_unique<EdfScheduler<LocalityEntry>>();
-    locality_entries_.clear();
+    locality_scheduler_ = std::make_unique<EdfScheduler>();
+    locality_effective_weights_.clear();
     for (uint32_t i = 0; i < hosts_per_locality_->get().size(); ++i) {
       const double effective_weight = effectiveLocalityWeight(i);
+      locality_effective_weights_.push_back(effective_weight);
       if (effective_weight > 0) {
-        locality_entries_.emplace_back(std::make_shared<LocalityEntry>(i, effective_weight));
-        locality_scheduler_->add(effective_weight, locality_entries_.back());
+        locality_scheduler_->add(effective_weight, i);
       }
     }
   } else {
     locality_scheduler_ = nullptr;
+    locality_effective_weights_.clear();
   }
   runUpdateCallbacks(hosts_added, hosts_removed);
 }
@@ -175,13 +176,14 @@ absl::optional<uint32_t> HostSetImpl::chooseLocality() {
   if (locality_scheduler_ == nullptr) {
     return {};
   }
-  const std::shared_ptr<LocalityEntry> locality = locality_scheduler_->pick();
+  const absl::optional<uint32_t> locality = locality_scheduler_->pick();
   // We don't build a schedule if there are no weighted localities, so we should always succeed.
-  ASSERT(locality != nullptr);
+  ASSERT(locality.has_value());
+  const double effective_weight = locality_effective_weights_[locality.value()];
   // If we picked it before, its weight must have been positive.
-  ASSERT(locality->effective_weight_ > 0);
-  locality_scheduler_->add(locality->effective_weight_, locality);
-  return locality->index_;
+  ASSERT(effective_weight > 0);
+  locality_scheduler_->add(effective_weight, locality.value());
+  return locality;
 }
 
 double HostSetImpl::effectiveLocalityWeight(uint32_t index) const {
@@ -317,7 +319,8 @@ ClusterSharedPtr ClusterImplBase::create(const envoy::api::v2::Cluster& cluster,
                                          Event::Dispatcher& dispatcher,
                                          const LocalInfo::LocalInfo& local_info,
                                          Outlier::EventLoggerSharedPtr outlier_event_logger,
-                                         bool added_via_api) {
+                                         bool added_via_api,
+                                         const envoy::api::v2::ClusterLoadAssignment* warm_hosts) {
   std::unique_ptr<ClusterImplBase> new_cluster;
 
   // We make this a shared pointer to deal with the distinct ownership
@@ -386,6 +389,10 @@ ClusterSharedPtr ClusterImplBase::create(const envoy::api::v2::Cluster& cluster,
 
   new_cluster->setOutlierDetector(Outlier::DetectorImplFactory::createForCluster(
       *new_cluster, cluster, dispatcher, runtime, outlier_event_logger));
+
+  if (warm_hosts != nullptr) {
+    new_cluster->setWarmHosts(*warm_hosts);
+  }
   return std::move(new_cluster);
 }
 
@@ -648,6 +655,9 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
   // updates to the Cluster objeect. This will probably make sense to do in
   // conjunction with https://github.com/envoyproxy/envoy/issues/2874.
   bool health_changed = false;
+  // Has the EDS weight of any endpoint changed? Load balancers precompute schedules from host
+  // weights, so we also rebuild the hosts vectors in this case.
+  bool weight_changed = false;
 
   // Go through and see if the list we have is different from what we just got. If it is, we make a
   // new host list and raise a change notification. This uses an N^2 search given that this does not
@@ -688,7 +698,10 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
           }
         }
 
-        (*i)->weight(host->weight());
+        if ((*i)->weight() != host->weight()) {
+          (*i)->weight(host->weight());
+          weight_changed = true;
+        }
         final_hosts.push_back(*i);
         i = current_hosts.erase(i);
         found = true;
@@ -738,11 +751,11 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
     // During the search we moved all of the hosts from hosts_ into final_hosts so just
     // move them back.
     current_hosts = std::move(final_hosts);
-    // We return false here in the absence of EDS health status, because we
-    // have no changes to host vector status (modulo weights). When we have EDS
-    // health status, we return true, causing updateHosts() to fire in the
-    // caller.
-    return health_changed;
+    // We return false here in the absence of EDS health status or weight
+    // changes, because we have no changes to host vector status. When we have
+    // EDS health status or weight changes, we return true, causing
+    // updateHosts() to fire in the caller.
+    return health_changed || weight_changed;
   }
 }
 
@@ -779,7 +792,42 @@ StrictDnsClusterImpl::StrictDnsClusterImpl(const envoy::api::v2::Cluster& cluste
   }
 }
 
+void StrictDnsClusterImpl::setWarmHosts(const envoy::api::v2::ClusterLoadAssignment& hosts) {
+  if (resolve_targets_.empty()) {
+    return;
+  }
+
+  for (const auto& locality_lb_endpoint : hosts.endpoints()) {
+    // Given the current config, only EDS clusters support multiple priorities.
+    if (locality_lb_endpoint.priority() != 0) {
+      continue;
+    }
+    for (const auto& lb_endpoint : locality_lb_endpoint.lb_endpoints()) {
+      warm_hosts_.emplace_back(new HostImpl(
+          info_, "", resolveProtoAddress(lb_endpoint.endpoint().address()),
+          envoy::api::v2::core::Metadata::default_instance(),
+          lb_endpoint.load_balancing_weight().value(),
+          envoy::api::v2::core::Locality().default_instance(),
+          envoy::api::v2::endpoint::Endpoint::HealthCheckConfig().default_instance()));
+      // Hosts our parent had found healthy are served right away, the others wait for the health
+      // checker. Without one, hosts are only ever unhealthy in the parent through outlier
+      // detection, which starts over here.
+      if (health_checker_ != nullptr &&
+          lb_endpoint.health_status() == envoy::api::v2::core::HealthStatus::UNHEALTHY) {
+        warm_hosts_.back()->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+      }
+    }
+  }
+}
+
 void StrictDnsClusterImpl::startPreInit() {
+  if (!warm_hosts_.empty()) {
+    ENVOY_LOG(debug, "serving {} hosts of the parent process for {} until DNS resolves",
+              warm_hosts_.size(), info_->name());
+    updateAllHosts(HostVector(warm_hosts_), {});
+    onPreInitComplete();
+  }
+
   for (const ResolveTargetPtr& target : resolve_targets_) {
     target->startResolve();
   }
@@ -789,9 +837,26 @@ void StrictDnsClusterImpl::updateAllHosts(const HostVector& hosts_added,
                                           const HostVector& hosts_removed) {
   // At this point we know that we are different so make a new host list and notify.
   HostVectorSharedPtr new_hosts(new HostVector());
+  std::unordered_set<std::string> resolved_addresses;
+  bool all_resolved = true;
   for (const ResolveTargetPtr& target : resolve_targets_) {
     for (const HostSharedPtr& host : target->hosts_) {
       new_hosts->emplace_back(host);
+      resolved_addresses.emplace(host->address()->asString());
+    }
+    all_resolved &= target->resolved_;
+  }
+
+  // Warm hosts are dropped when a target resolves to the same address, and all of them once every
+  // target has resolved, as we no longer know which target they came from before that.
+  HostVector all_hosts_removed(hosts_removed);
+  for (auto i = warm_hosts_.begin(); i != warm_hosts_.end();) {
+    if (all_resolved || resolved_addresses.count((*i)->address()->asString()) != 0) {
+      all_hosts_removed.emplace_back(std::move(*i));
+      i = warm_hosts_.erase(i);
+    } else {
+      new_hosts->emplace_back(*i);
+      ++i;
     }
   }
 
@@ -800,7 +865,7 @@ void StrictDnsClusterImpl::updateAllHosts(const HostVector& hosts_added,
   auto& first_host_set = priority_set_.getOrCreateHostSet(0);
   first_host_set.updateHosts(new_hosts, createHealthyHostList(*new_hosts),
                              HostsPerLocalityImpl::empty(), HostsPerLocalityImpl::empty(), {},
-                             hosts_added, hosts_removed);
+                             hosts_added, all_hosts_removed);
 }
 
 StrictDnsClusterImpl::ResolveTarget::ResolveTarget(StrictDnsClusterImpl& parent,
@@ -842,9 +907,14 @@ void StrictDnsClusterImpl::ResolveTarget::startResolve() {
 
         HostVector hosts_added;
         HostVector hosts_removed;
+        const bool first_resolve = !resolved_;
+        resolved_ = true;
         if (parent_.updateDynamicHostList(new_hosts, hosts_, hosts_added, hosts_removed, false)) {
           ENVOY_LOG(debug, "DNS hosts have changed for {}", dns_address_);
           parent_.updateAllHosts(hosts_added, hosts_removed);
+        } else if (first_resolve && !parent_.warm_hosts_.empty()) {
+          // Give the warm hosts a chance to be dropped even if DNS returned nothing.
+          parent_.updateAllHosts({}, {});
         }
 
         // If there is an initialize callback, fire it now. Note that if the cluster refers to
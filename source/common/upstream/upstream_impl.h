@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "envoy/api/v2/core/base.pb.h"
+#include "envoy/api/v2/eds.pb.h"
 #include "envoy/api/v2/endpoint/endpoint.pb.h"
 #include "envoy/event/timer.h"
 #include "envoy/local_info/local_info.h"
@@ -253,15 +254,10 @@ private:
       member_update_cb_helper_;
   // Locality weights (used to build WRR locality_scheduler_);
   LocalityWeightsConstSharedPtr locality_weights_;
-  // WRR locality scheduler state.
-  struct LocalityEntry {
-    LocalityEntry(uint32_t index, double effective_weight)
-        : index_(index), effective_weight_(effective_weight) {}
-    const uint32_t index_;
-    const double effective_weight_;
-  };
-  std::vector<std::shared_ptr<LocalityEntry>> locality_entries_;
-  std::unique_ptr<EdfScheduler<LocalityEntry>> locality_scheduler_;
+  // WRR locality scheduler state. The scheduler holds locality indices, with the effective weight
+  // of each locality (indexed the same way) kept alongside.
+  std::vector<double> locality_effective_weights_;
+  std::unique_ptr<EdfScheduler> locality_scheduler_;
 };
 
 typedef std::unique_ptr<HostSetImpl> HostSetImplPtr;
@@ -408,7 +404,8 @@ public:
                                  Runtime::RandomGenerator& random, Event::Dispatcher& dispatcher,
                                  const LocalInfo::LocalInfo& local_info,
                                  Outlier::EventLoggerSharedPtr outlier_event_logger,
-                                 bool added_via_api);
+                                 bool added_via_api,
+                                 const envoy::api::v2::ClusterLoadAssignment* warm_hosts);
   // From Upstream::Cluster
   virtual PrioritySet& prioritySet() override { return priority_set_; }
   virtual const PrioritySet& prioritySet() const override { return priority_set_; }
@@ -426,6 +423,14 @@ public:
    */
   void setOutlierDetector(const Outlier::DetectorSharedPtr& outlier_detector);
 
+  /**
+   * Optionally seed a dynamic cluster with the hosts it had in the parent process of a hot
+   * restart. The cluster then finishes pre-init without waiting for its first DNS resolution or
+   * EDS update, and the hosts are replaced once that arrives. Other clusters ignore the hosts.
+   * @param hosts supplies the parent's hosts, see HostUtility::toClusterLoadAssignment().
+   */
+  virtual void setWarmHosts(const envoy::api::v2::ClusterLoadAssignment&) {}
+
   /**
    * Wrapper around Network::Address::resolveProtoAddress() that provides improved error message
    * based on the cluster's type.
@@ -527,6 +532,9 @@ public:
   // Upstream::Cluster
   InitializePhase initializePhase() const override { return InitializePhase::Primary; }
 
+  // Upstream::ClusterImplBase
+  void setWarmHosts(const envoy::api::v2::ClusterLoadAssignment& hosts) override;
+
 private:
   struct ResolveTarget {
     ResolveTarget(StrictDnsClusterImpl& parent, Event::Dispatcher& dispatcher,
@@ -540,6 +548,7 @@ private:
     uint32_t port_;
     Event::TimerPtr resolve_timer_;
     HostVector hosts_;
+    bool resolved_{};
   };
 
   typedef std::unique_ptr<ResolveTarget> ResolveTargetPtr;
@@ -553,6 +562,8 @@ private:
   std::list<ResolveTargetPtr> resolve_targets_;
   const std::chrono::milliseconds dns_refresh_rate_ms_;
   Network::DnsLookupFamily dns_lookup_family_;
+  // Hosts of the parent process, served until every target has been resolved once.
+  HostVector warm_hosts_;
 };
 
 } // namespace Upstream
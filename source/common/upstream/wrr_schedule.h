@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Precomputed smooth weighted round robin schedule over indices [0, weights.size()). The schedule
+ * is a table holding each index as many times as its (gcd reduced) weight, interleaved in earliest
+ * deadline first order so that picks for an index are spread evenly across the table rather than
+ * clustered. Picks walk the table with a clock hand, i.e. O(1) with no allocation or reference
+ * counting. The table is built once when the indexed vector changes and must be rebuilt by the
+ * caller on any change to the indices or their weights.
+ */
+class WrrSchedule {
+public:
+  // Upper bound on the table size. Beyond this, the memory cost of the table (per worker, per hosts
+  // source) outweighs the pick time savings and callers should fall back to EdfScheduler.
+  static constexpr uint32_t kMaxScheduleSize = 16384;
+
+  /**
+   * Rebuild the schedule from a set of integer weights.
+   * @param weights weight for each index, all weights must be positive.
+   * @return bool true if the schedule was built, false if the table would exceed
+   *         kMaxScheduleSize entries, in which case the schedule is left empty.
+   */
+  bool build(const std::vector<uint32_t>& weights) {
+    schedule_.clear();
+    next_ = 0;
+
+    uint32_t divisor = 0;
+    for (const uint32_t weight : weights) {
+      ASSERT(weight > 0);
+      divisor = gcd(divisor, weight);
+    }
+    uint64_t total_weight = 0;
+    for (const uint32_t weight : weights) {
+      total_weight += weight / divisor;
+    }
+    if (total_weight == 0 || total_weight > kMaxScheduleSize) {
+      return false;
+    }
+
+    // The k-th pick of index i has deadline (k - 1/2) / w_i, which centres the picks of each index
+    // within its share of the round (Webster's method) and avoids bunching the heaviest index at
+    // the start of the table. Deadlines are compared as exact fractions, so every index appears
+    // exactly w_i times in the table regardless of floating point rounding. Ties are broken in
+    // FIFO insertion order, matching EdfScheduler.
+    std::vector<Entry> heap;
+    heap.reserve(weights.size());
+    uint64_t order = 0;
+    for (uint32_t i = 0; i < weights.size(); ++i) {
+      heap.push_back({1, weights[i] / divisor, order++, i});
+    }
+    std::make_heap(heap.begin(), heap.end());
+
+    schedule_.reserve(total_weight);
+    while (!heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end());
+      Entry& entry = heap.back();
+      schedule_.push_back(entry.index_);
+      if (entry.count_ < entry.weight_) {
+        ++entry.count_;
+        entry.order_ = order++;
+        std::push_heap(heap.begin(), heap.end());
+      } else {
+        heap.pop_back();
+      }
+    }
+    ASSERT(schedule_.size() == total_weight);
+    return true;
+  }
+
+  /**
+   * @return uint32_t the next index in the schedule. The schedule must not be empty.
+   */
+  uint32_t pick() {
+    ASSERT(!schedule_.empty());
+    const uint32_t index = schedule_[next_];
+    if (++next_ == schedule_.size()) {
+      next_ = 0;
+    }
+    return index;
+  }
+
+  /**
+   * @return bool whether the schedule is empty, either because it has not been built or because
+   *         build() declined to tabulate the weights.
+   */
+  bool empty() const { return schedule_.empty(); }
+
+  /**
+   * @return size_t the number of entries in a full round of the schedule.
+   */
+  size_t size() const { return schedule_.size(); }
+
+private:
+  struct Entry {
+    // Number of times this index has been picked, including the pending pick.
+    uint64_t count_;
+    uint64_t weight_;
+    // Tie breaker for entries with the same deadline.
+    uint64_t order_;
+    uint32_t index_;
+
+    // Flip < direction to make this a min heap on (2 * count_ - 1) / (2 * weight_).
+    bool operator<(const Entry& other) const {
+      const uint64_t lhs = (2 * count_ - 1) * other.weight_;
+      const uint64_t rhs = (2 * other.count_ - 1) * weight_;
+      return lhs > rhs || (lhs == rhs && order_ > other.order_);
+    }
+  };
+
+  static uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b != 0) {
+      const uint32_t t = a % b;
+      a = b;
+      b = t;
+    }
+    return a;
+  }
+
+  std::vector<uint32_t> schedule_;
+  // Clock hand into schedule_.
+  size_t next_{};
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -42,8 +42,7 @@ public:
   MainCommon(int argc, char** argv);
   bool run() { return base_.run(); }
 
-  static std::string hotRestartVersion(uint64_t max_num_stats, uint64_t max_stat_name_len,
-                                       bool hot_restart_enabled);
+  static std::string hotRestartVersion(bool hot_restart_enabled);
 
 private:
 #ifdef ENVOY_HANDLE_SIGNALS
@@ -31,7 +31,12 @@ void FileAccessLog::log(const Http::HeaderMap* request_headers,
     }
   }
 
-  log_file_->write(formatter_->format(*request_headers, *response_headers, request_info));
+  // Each worker formats into its own buffer, which is reused across log lines. write() copies the
+  // line into the file's flush buffer, so the buffer is free again once it returns.
+  static thread_local std::string log_line;
+  log_line.clear();
+  formatter_->formatTo(*request_headers, *response_headers, request_info, log_line);
+  log_file_->write(log_line);
 }
 
 } // namespace File
@@ -3,6 +3,7 @@
 #include "common/common/assert.h"
 #include "common/http/header_map_impl.h"
 #include "common/network/utility.h"
+#include "common/protobuf/utility.h"
 #include "common/request_info/utility.h"
 
 namespace Envoy {
@@ -62,12 +63,81 @@ void GrpcAccessLogStreamerImpl::ThreadLocalStreamer::send(
   }
 }
 
+bool GrpcAccessLogStreamerImpl::ThreadLocalStreamer::isAboveWriteBufferHighWatermark(
+    const std::string& log_name) const {
+  auto stream_it = stream_map_.find(log_name);
+  return stream_it != stream_map_.end() && stream_it->second.stream_ != nullptr &&
+         stream_it->second.stream_->isAboveWriteBufferHighWatermark();
+}
+
+HttpGrpcAccessLog::ThreadLocalBatch::ThreadLocalBatch(
+    const std::shared_ptr<const BatchSettings>& settings, const HttpGrpcAccessLogStats& stats,
+    const GrpcAccessLogStreamerSharedPtr& streamer, Event::Dispatcher& dispatcher)
+    : settings_(settings), stats_(stats), streamer_(streamer) {
+  if (settings_->enabled()) {
+    flush_timer_ = dispatcher.createTimer([this]() {
+      flush();
+      flush_timer_->enableTimer(settings_->flush_interval_);
+    });
+    flush_timer_->enableTimer(settings_->flush_interval_);
+  }
+}
+
+envoy::config::filter::accesslog::v2::HTTPAccessLogEntry*
+HttpGrpcAccessLog::ThreadLocalBatch::addEntry() {
+  if (approximate_bytes_ >= settings_->max_pending_bytes_) {
+    // The pending entries can only be this large if the stream has been backed up for a while.
+    // Try to make room before giving up on the log.
+    flush();
+    if (approximate_bytes_ >= settings_->max_pending_bytes_) {
+      stats_.logs_dropped_.inc();
+      return nullptr;
+    }
+  }
+
+  // Once the batch has been sent and cleared, this returns a previously allocated entry.
+  return message_.mutable_http_logs()->add_log_entry();
+}
+
+void HttpGrpcAccessLog::ThreadLocalBatch::onEntryAdded(
+    const envoy::config::filter::accesslog::v2::HTTPAccessLogEntry& entry) {
+  approximate_bytes_ += entry.ByteSizeLong();
+  const uint32_t entries = message_.http_logs().log_entry_size();
+  if (!settings_->enabled() ||
+      (settings_->max_entries_ > 0 && entries >= settings_->max_entries_) ||
+      (settings_->max_bytes_ > 0 && approximate_bytes_ >= settings_->max_bytes_)) {
+    flush();
+  }
+}
+
+void HttpGrpcAccessLog::ThreadLocalBatch::flush() {
+  const uint32_t entries = message_.http_logs().log_entry_size();
+  if (entries == 0 || streamer_->isAboveWriteBufferHighWatermark(settings_->log_name_)) {
+    return;
+  }
+
+  streamer_->send(message_, settings_->log_name_);
+  stats_.logs_written_.add(entries);
+  stats_.batches_sent_.inc();
+  message_.Clear();
+  approximate_bytes_ = 0;
+}
+
 HttpGrpcAccessLog::HttpGrpcAccessLog(
     AccessLog::FilterPtr&& filter,
     const envoy::config::accesslog::v2::HttpGrpcAccessLogConfig& config,
-    GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer)
+    GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer, ThreadLocal::SlotAllocator& tls,
+    Stats::Scope& scope)
     : filter_(std::move(filter)), config_(config),
-      grpc_access_log_streamer_(grpc_access_log_streamer) {
+      grpc_access_log_streamer_(grpc_access_log_streamer), stats_(generateStats(scope)),
+      batch_settings_(new BatchSettings{
+          config_.common_config().log_name(),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_.common_config(), buffer_max_entries, 0),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_.common_config(), buffer_size_bytes, 0),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_.common_config(), max_pending_bytes, 1024 * 1024),
+          std::chrono::milliseconds(
+              PROTOBUF_GET_MS_OR_DEFAULT(config_.common_config(), buffer_flush_interval, 1000))}),
+      tls_slot_(tls.allocateSlot()) {
   for (const auto& header : config_.additional_request_headers_to_log()) {
     request_headers_to_log_.emplace_back(header);
   }
@@ -75,6 +145,18 @@ HttpGrpcAccessLog::HttpGrpcAccessLog(
   for (const auto& header : config_.additional_response_headers_to_log()) {
     response_headers_to_log_.emplace_back(header);
   }
+
+  std::shared_ptr<const BatchSettings> settings = batch_settings_;
+  HttpGrpcAccessLogStats stats = stats_;
+  tls_slot_->set([settings, stats, grpc_access_log_streamer](Event::Dispatcher& dispatcher) {
+    return ThreadLocal::ThreadLocalObjectSharedPtr{
+        new ThreadLocalBatch(settings, stats, grpc_access_log_streamer, dispatcher)};
+  });
+}
+
+HttpGrpcAccessLogStats HttpGrpcAccessLog::generateStats(Stats::Scope& scope) {
+  const std::string final_prefix = "access_log.http_grpc.";
+  return {ALL_HTTP_GRPC_ACCESS_LOG_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
 }
 
 void HttpGrpcAccessLog::responseFlagsToAccessLogResponseFlags(
@@ -156,8 +238,11 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
     }
   }
 
-  envoy::service::accesslog::v2::StreamAccessLogsMessage message;
-  auto* log_entry = message.mutable_http_logs()->add_log_entry();
+  ThreadLocalBatch& batch = tls_slot_->getTyped<ThreadLocalBatch>();
+  auto* log_entry = batch.addEntry();
+  if (log_entry == nullptr) {
+    return;
+  }
 
   // Common log properties.
   // TODO(mattklein123): Populate sample_rate field.
@@ -317,8 +402,7 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
     }
   }
 
-  // TODO(mattklein123): Consider batching multiple logs and flushing.
-  grpc_access_log_streamer_->send(message, config_.common_config().log_name());
+  batch.onEntryAdded(*log_entry);
 }
 
 } // namespace HttpGrpc
@@ -11,6 +11,7 @@
 #include "envoy/local_info/local_info.h"
 #include "envoy/service/accesslog/v2/als.pb.h"
 #include "envoy/singleton/instance.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 
 namespace Envoy {
@@ -18,8 +19,6 @@ namespace Extensions {
 namespace AccessLoggers {
 namespace HttpGrpc {
 
-// TODO(mattklein123): Stats
-
 /**
  * Interface for an access log streamer. The streamer deals with threading and sends access logs
  * on the correct stream.
@@ -35,6 +34,13 @@ public:
    */
   virtual void send(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
                     const std::string& log_name) PURE;
+
+  /**
+   * @param log_name supplies the name of the log stream.
+   * @return bool whether the current thread's stream for the log is above its write buffer high
+   *         watermark, i.e. the access log service is not keeping up with what is being sent.
+   */
+  virtual bool isAboveWriteBufferHighWatermark(const std::string& log_name) PURE;
 };
 
 typedef std::shared_ptr<GrpcAccessLogStreamer> GrpcAccessLogStreamerSharedPtr;
@@ -53,6 +59,9 @@ public:
             const std::string& log_name) override {
     tls_slot_->getTyped<ThreadLocalStreamer>().send(message, log_name);
   }
+  bool isAboveWriteBufferHighWatermark(const std::string& log_name) override {
+    return tls_slot_->getTyped<ThreadLocalStreamer>().isAboveWriteBufferHighWatermark(log_name);
+  }
 
 private:
   /**
@@ -99,6 +108,7 @@ private:
     ThreadLocalStreamer(const SharedStateSharedPtr& shared_state);
     void send(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
               const std::string& log_name);
+    bool isAboveWriteBufferHighWatermark(const std::string& log_name) const;
 
     Grpc::AsyncClientPtr client_;
     std::unordered_map<std::string, ThreadLocalStream> stream_map_;
@@ -109,13 +119,32 @@ private:
 };
 
 /**
- * Access log Instance that streams HTTP logs over gRPC.
+ * All stats for the HTTP gRPC access log. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_HTTP_GRPC_ACCESS_LOG_STATS(COUNTER)                                                    \
+  COUNTER(logs_written)                                                                            \
+  COUNTER(logs_dropped)                                                                            \
+  COUNTER(batches_sent)
+// clang-format on
+
+/**
+ * Struct definition for all HTTP gRPC access log stats. @see stats_macros.h
+ */
+struct HttpGrpcAccessLogStats {
+  ALL_HTTP_GRPC_ACCESS_LOG_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Access log Instance that streams HTTP logs over gRPC. Each worker fills log entries directly into
+ * a per-worker batch message, which is handed to the streamer when it is full or on a timer.
  */
 class HttpGrpcAccessLog : public AccessLog::Instance {
 public:
   HttpGrpcAccessLog(AccessLog::FilterPtr&& filter,
                     const envoy::config::accesslog::v2::HttpGrpcAccessLogConfig& config,
-                    GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer);
+                    GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer,
+                    ThreadLocal::SlotAllocator& tls, Stats::Scope& scope);
 
   static void responseFlagsToAccessLogResponseFlags(
       envoy::config::filter::accesslog::v2::AccessLogCommon& common_access_log,
@@ -125,12 +154,69 @@ public:
   void log(const Http::HeaderMap* request_headers, const Http::HeaderMap* response_headers,
            const RequestInfo::RequestInfo& request_info) override;
 
+  const HttpGrpcAccessLogStats& stats() const { return stats_; }
+
 private:
+  /**
+   * Batching limits, copied out of the config so that the per-worker batches do not refer back to
+   * the access log, which may be destroyed before them.
+   */
+  struct BatchSettings {
+    std::string log_name_;
+    uint32_t max_entries_;
+    uint32_t max_bytes_;
+    uint32_t max_pending_bytes_;
+    std::chrono::milliseconds flush_interval_;
+
+    // If no batch limit is configured every entry is sent as soon as it is logged.
+    bool enabled() const { return max_entries_ > 0 || max_bytes_ > 0; }
+  };
+
+  /**
+   * Per-worker batch of log entries. The batch message is cleared rather than destroyed after it
+   * is sent, so the log entry messages it owns are reused for subsequent logs.
+   */
+  struct ThreadLocalBatch : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalBatch(const std::shared_ptr<const BatchSettings>& settings,
+                     const HttpGrpcAccessLogStats& stats,
+                     const GrpcAccessLogStreamerSharedPtr& streamer, Event::Dispatcher& dispatcher);
+
+    /**
+     * @return the entry to populate for a new log, or nullptr if the log must be dropped because
+     *         the pending entries are at their bound.
+     */
+    envoy::config::filter::accesslog::v2::HTTPAccessLogEntry* addEntry();
+
+    /**
+     * Account for the entry last returned by addEntry() and send the batch if it is full.
+     */
+    void onEntryAdded(const envoy::config::filter::accesslog::v2::HTTPAccessLogEntry& entry);
+
+    /**
+     * Send the batch unless the stream is backed up, in which case the entries are kept until
+     * the next flush.
+     */
+    void flush();
+
+    std::shared_ptr<const BatchSettings> settings_;
+    HttpGrpcAccessLogStats stats_;
+    GrpcAccessLogStreamerSharedPtr streamer_;
+    Event::TimerPtr flush_timer_;
+    envoy::service::accesslog::v2::StreamAccessLogsMessage message_;
+    uint64_t approximate_bytes_{};
+  };
+
+  static HttpGrpcAccessLogStats generateStats(Stats::Scope& scope);
+
   AccessLog::FilterPtr filter_;
   const envoy::config::accesslog::v2::HttpGrpcAccessLogConfig config_;
   GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer_;
   std::vector<Http::LowerCaseString> request_headers_to_log_;
   std::vector<Http::LowerCaseString> response_headers_to_log_;
+  HttpGrpcAccessLogStats stats_;
+  // Shared with the per-worker batches, which may outlive this access log.
+  std::shared_ptr<const BatchSettings> batch_settings_;
+  ThreadLocal::SlotPtr tls_slot_;
 };
 
 } // namespace HttpGrpc
@@ -10,8 +10,39 @@ namespace Filters {
 namespace Common {
 namespace Lua {
 
-Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state)
-    : coroutine_state_(new_thread_state, false) {}
+namespace {
+
+// The address of this variable is the registry key under which each worker's CoroutineContext is
+// stored so that the instruction hook can find it.
+const char CONTEXT_REGISTRY_KEY = 0;
+
+int bytecodeWriter(lua_State*, const void* data, size_t size, void* bytecode) {
+  static_cast<std::string*>(bytecode)->append(static_cast<const char*>(data), size);
+  return 0;
+}
+
+} // namespace
+
+Coroutine::Coroutine(lua_State* parent_state, CoroutineContext& context) : context_(context) {
+  if (!context_.idle_threads_.empty()) {
+    const std::pair<lua_State*, int> thread = context_.idle_threads_.back();
+    context_.idle_threads_.pop_back();
+    coroutine_state_.adopt({thread.first, parent_state}, thread.second);
+  } else {
+    coroutine_state_.reset({lua_newthread(parent_state), parent_state}, false);
+  }
+}
+
+Coroutine::~Coroutine() {
+  // A thread that returned normally has an empty call stack and can run another function. Threads
+  // that errored are dead and threads that are still suspended pin their stack, so those are
+  // released back to Lua.
+  if (state_ != State::Yielded && !errored_ && !context_.closing_) {
+    lua_settop(coroutine_state_.get(), 0);
+    lua_State* thread = coroutine_state_.get();
+    context_.idle_threads_.emplace_back(thread, coroutine_state_.release());
+  }
+}
 
 void Coroutine::start(int function_ref, int num_args, const std::function<void()>& yield_callback) {
   ASSERT(state_ == State::NotStarted);
@@ -28,7 +59,15 @@ void Coroutine::start(int function_ref, int num_args, const std::function<void()
 
 void Coroutine::resume(int num_args, const std::function<void()>& yield_callback) {
   ASSERT(state_ == State::Yielded);
+
+  // A script can cause another coroutine on the same worker to run inline (e.g., a local reply
+  // running the response script), so restore whatever was running before.
+  Coroutine* previous = context_.running_;
+  context_.running_ = this;
+  const auto start_time = std::chrono::steady_clock::now();
   int rc = lua_resume(coroutine_state_.get(), num_args);
+  run_time_ += std::chrono::steady_clock::now() - start_time;
+  context_.running_ = previous;
 
   if (0 == rc) {
     state_ = State::Finished;
@@ -39,25 +78,51 @@ void Coroutine::resume(int num_args, const std::function<void()>& yield_callback
     yield_callback();
   } else {
     state_ = State::Finished;
+    errored_ = true;
     const char* error = lua_tostring(coroutine_state_.get(), -1);
     throw LuaException(error);
   }
 }
 
-ThreadLocalState::ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls)
+void Coroutine::instructionHook(lua_State* state, lua_Debug*) {
+  lua_pushlightuserdata(state, const_cast<char*>(&CONTEXT_REGISTRY_KEY));
+  lua_rawget(state, LUA_REGISTRYINDEX);
+  CoroutineContext* context = static_cast<CoroutineContext*>(lua_touserdata(state, -1));
+  lua_pop(state, 1);
+
+  Coroutine* coroutine = context->running_;
+  if (coroutine == nullptr) {
+    return;
+  }
+
+  coroutine->instructions_ += INSTRUCTION_HOOK_INTERVAL;
+  if (coroutine->instructions_ > context->instruction_budget_) {
+    coroutine->instruction_budget_exceeded_ = true;
+    luaL_error(state, "instruction budget exceeded");
+  }
+}
+
+ThreadLocalState::ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls,
+                                   uint64_t instruction_budget)
     : tls_slot_(tls.allocateSlot()) {
 
-  // First verify that the supplied code can be parsed.
+  // First verify that the supplied code can be parsed and run. The code is compiled once here and
+  // the bytecode is what gets loaded on each worker. The code is used as the chunk name so that
+  // error messages are the same as when loading the source directly.
   CSmartPtr<lua_State, lua_close> state(lua_open());
   luaL_openlibs(state.get());
 
-  if (0 != luaL_dostring(state.get(), code.c_str())) {
+  std::string bytecode;
+  if (0 != luaL_loadbuffer(state.get(), code.data(), code.size(), code.c_str()) ||
+      0 != lua_dump(state.get(), bytecodeWriter, &bytecode) ||
+      0 != lua_pcall(state.get(), 0, LUA_MULTRET, 0)) {
     throw LuaException(fmt::format("script load error: {}", lua_tostring(state.get(), -1)));
   }
 
   // Now initialize on all threads.
-  tls_slot_->set([code](Event::Dispatcher&) {
-    return ThreadLocal::ThreadLocalObjectSharedPtr{new LuaThreadLocal(code)};
+  tls_slot_->set([bytecode, instruction_budget](Event::Dispatcher&) {
+    return ThreadLocal::ThreadLocalObjectSharedPtr{
+        new LuaThreadLocal(bytecode, instruction_budget)};
   });
 }
 
@@ -84,16 +149,45 @@ uint64_t ThreadLocalState::registerGlobal(const std::string& global) {
 }
 
 CoroutinePtr ThreadLocalState::createCoroutine() {
-  lua_State* state = tls_slot_->getTyped<LuaThreadLocal>().state_.get();
-  return CoroutinePtr{new Coroutine({lua_newthread(state), state})};
+  LuaThreadLocal& tls = tls_slot_->getTyped<LuaThreadLocal>();
+  return CoroutinePtr{new Coroutine(tls.state_.get(), tls.context_)};
 }
 
-ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& code) : state_(lua_open()) {
+int64_t ThreadLocalState::runtimeBytesDelta() {
+  LuaThreadLocal& tls = tls_slot_->getTyped<LuaThreadLocal>();
+  const uint64_t bytes = static_cast<uint64_t>(lua_gc(tls.state_.get(), LUA_GCCOUNT, 0)) * 1024 +
+                         lua_gc(tls.state_.get(), LUA_GCCOUNTB, 0);
+  const int64_t delta = static_cast<int64_t>(bytes) - static_cast<int64_t>(tls.reported_bytes_);
+  tls.reported_bytes_ = bytes;
+  return delta;
+}
+
+ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& bytecode,
+                                                 uint64_t instruction_budget)
+    : state_(lua_open()) {
   luaL_openlibs(state_.get());
-  int rc = luaL_dostring(state_.get(), code.c_str());
+
+  context_.instruction_budget_ = instruction_budget;
+  if (instruction_budget > 0) {
+    lua_pushlightuserdata(state_.get(), const_cast<char*>(&CONTEXT_REGISTRY_KEY));
+    lua_pushlightuserdata(state_.get(), &context_);
+    lua_rawset(state_.get(), LUA_REGISTRYINDEX);
+
+    // LuaJIT hooks are global to the state, so this covers every coroutine created from it. The
+    // hook is installed before any code runs because LuaJIT does not deliver hooks inside compiled
+    // traces and does not start recording new ones while an instruction hook is set.
+    lua_sethook(state_.get(), &Coroutine::instructionHook, LUA_MASKCOUNT,
+                Coroutine::INSTRUCTION_HOOK_INTERVAL);
+  }
+
+  int rc = luaL_loadbuffer(state_.get(), bytecode.data(), bytecode.size(), "");
+  ASSERT(rc == 0);
+  rc = lua_pcall(state_.get(), 0, LUA_MULTRET, 0);
   ASSERT(rc == 0);
 }
 
+ThreadLocalState::LuaThreadLocal::~LuaThreadLocal() { context_.closing_ = true; }
+
 } // namespace Lua
 } // namespace Common
 } // namespace Filters
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -232,6 +233,28 @@ public:
     ASSERT(ref_ != LUA_REFNIL);
   }
 
+  /**
+   * Take ownership of an existing registry reference, e.g. one previously returned by release().
+   * @param object supplies the referenced object and the state that owns the reference.
+   * @param ref supplies the registry reference.
+   */
+  void adopt(const std::pair<T*, lua_State*>& object, int ref) {
+    unref();
+    object_ = object;
+    ref_ = ref;
+  }
+
+  /**
+   * Give up ownership of the reference without unreferencing it. The LuaRef is left empty.
+   * @return int the registry reference that was held. The caller is responsible for it.
+   */
+  int release() {
+    const int ref = ref_;
+    object_ = std::pair<T*, lua_State*>{};
+    ref_ = LUA_NOREF;
+    return ref;
+  }
+
   /**
    * Return a LuaRef to its default/empty state.
    */
@@ -294,6 +317,23 @@ public:
   }
 };
 
+class Coroutine;
+
+/**
+ * Per worker state shared by all of the coroutines created from a ThreadLocalState.
+ */
+struct CoroutineContext {
+  // Threads of coroutines that ran to completion, along with their registry references. New
+  // coroutines reuse these before asking Lua for a new thread.
+  std::vector<std::pair<lua_State*, int>> idle_threads_;
+  // The coroutine currently being resumed on this worker, if any. Used by the instruction hook.
+  Coroutine* running_{};
+  // The maximum number of instructions a coroutine may execute. 0 means unlimited.
+  uint64_t instruction_budget_{};
+  // Set while the owning Lua state is being closed, at which point threads must not be reused.
+  bool closing_{};
+};
+
 /**
  * This is a wraper for a Lua coroutine. Lua intermixes coroutine and "thread." Lua does not have
  * real threads, only cooperatively scheduled coroutines.
@@ -302,10 +342,27 @@ class Coroutine : Logger::Loggable<Logger::Id::lua> {
 public:
   enum class State { NotStarted, Yielded, Finished };
 
-  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state);
+  /**
+   * The number of instructions between invocations of the instruction budget hook.
+   */
+  static const int INSTRUCTION_HOOK_INTERVAL = 1000;
+
+  Coroutine(lua_State* parent_state, CoroutineContext& context);
+  ~Coroutine();
+
   lua_State* luaState() { return coroutine_state_.get(); }
   State state() { return state_; }
 
+  /**
+   * @return the total wall clock time spent running the coroutine across all resumes.
+   */
+  std::chrono::steady_clock::duration runTime() const { return run_time_; }
+
+  /**
+   * @return whether the coroutine was aborted because it exceeded the instruction budget.
+   */
+  bool instructionBudgetExceeded() const { return instruction_budget_exceeded_; }
+
   /**
    * Start a coroutine.
    * @param function_ref supplies the previously registered function to call. Registered with
@@ -324,9 +381,20 @@ public:
    */
   void resume(int num_args, const std::function<void()>& yield_callback);
 
+  /**
+   * Lua count hook which charges instructions to the running coroutine and raises an error in it
+   * once it exceeds the instruction budget.
+   */
+  static void instructionHook(lua_State* state, lua_Debug* debug);
+
 private:
+  CoroutineContext& context_;
   LuaRef<lua_State> coroutine_state_;
   State state_{State::NotStarted};
+  bool errored_{};
+  bool instruction_budget_exceeded_{};
+  uint64_t instructions_{};
+  std::chrono::steady_clock::duration run_time_{};
 };
 
 typedef std::unique_ptr<Coroutine> CoroutinePtr;
@@ -338,13 +406,27 @@ typedef std::unique_ptr<Coroutine> CoroutinePtr;
  */
 class ThreadLocalState : Logger::Loggable<Logger::Id::lua> {
 public:
-  ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls);
+  /**
+   * @param code supplies the script. It is compiled to bytecode once and each worker loads the
+   *        bytecode rather than parsing the source again.
+   * @param tls supplies the slot allocator used to create the per worker states.
+   * @param instruction_budget supplies the maximum number of instructions that a single coroutine
+   *        may execute before it is aborted with an error. 0 disables the budget.
+   */
+  ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls,
+                   uint64_t instruction_budget);
 
   /**
-   * @return CoroutinePtr a new coroutine.
+   * @return CoroutinePtr a new coroutine. The underlying Lua thread is reused from a coroutine
+   *         that previously ran to completion on this worker when possible.
    */
   CoroutinePtr createCoroutine();
 
+  /**
+   * @return the change in bytes of this worker's Lua heap since the previous call on this worker.
+   */
+  int64_t runtimeBytesDelta();
+
   /**
    * @return a global reference previously registered via registerGlobal(). This may return
    *         LUA_REFNIL if there was no such global.
@@ -370,10 +452,15 @@ public:
 
 private:
   struct LuaThreadLocal : public ThreadLocal::ThreadLocalObject {
-    LuaThreadLocal(const std::string& code);
+    LuaThreadLocal(const std::string& bytecode, uint64_t instruction_budget);
+    ~LuaThreadLocal();
 
+    // Closing the state runs the destructors of coroutines still owned by Lua, so the context must
+    // outlive it.
+    CoroutineContext context_;
     CSmartPtr<lua_State, lua_close> state_;
     std::vector<int> global_slots_;
+    uint64_t reported_bytes_{};
   };
 
   ThreadLocal::SlotPtr tls_slot_;
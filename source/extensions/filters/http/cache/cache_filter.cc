@@ -0,0 +1,299 @@
+#include "extensions/filters/http/cache/cache_filter.h"
+
+#include <chrono>
+#include <string>
+
+#include "envoy/event/dispatcher.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/common/enum_to_int.h"
+#include "common/common/utility.h"
+#include "common/http/codes.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/headers.h"
+#include "common/http/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+namespace {
+
+// Weak comparison, as required for If-None-Match by RFC 7232.
+absl::string_view opaqueTag(absl::string_view etag) {
+  etag = StringUtil::trim(etag);
+  if (etag.size() >= 2 && etag[0] == 'W' && etag[1] == '/') {
+    etag.remove_prefix(2);
+  }
+  return etag;
+}
+
+bool ifNoneMatch(const Http::HeaderEntry& if_none_match, const Http::HeaderEntry* etag) {
+  if (StringUtil::trim(if_none_match.value().getStringView()) == "*") {
+    return true;
+  }
+  if (etag == nullptr) {
+    return false;
+  }
+  const absl::string_view tag = opaqueTag(etag->value().getStringView());
+  for (absl::string_view candidate :
+       StringUtil::splitToken(if_none_match.value().getStringView(), ",")) {
+    if (opaqueTag(candidate) == tag) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void copyHeader(const Http::HeaderMap& from, const Http::LowerCaseString& key,
+                Http::HeaderMap& to) {
+  const Http::HeaderEntry* entry = from.get(key);
+  if (entry != nullptr) {
+    to.addCopy(key, entry->value().c_str());
+  }
+}
+
+} // namespace
+
+CacheFilterConfig::CacheFilterConfig(uint64_t max_size_bytes, uint64_t max_body_bytes,
+                                     const std::string& stats_prefix, Stats::Scope& scope,
+                                     MonotonicTimeSource& time_source)
+    : max_body_bytes_(max_body_bytes), time_source_(time_source),
+      stats_(generateStats(stats_prefix + "cache.", scope)),
+      cache_(max_size_bytes, time_source, stats_) {}
+
+CacheFilterStats CacheFilterConfig::generateStats(const std::string& prefix,
+                                                  Stats::Scope& scope) {
+  return {ALL_CACHE_FILTER_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+}
+
+bool CacheFilter::isCacheableRequest(const Http::HeaderMap& headers) {
+  if (headers.Path() == nullptr || headers.Host() == nullptr || headers.Method() == nullptr ||
+      headers.Method()->value() != Http::Headers::get().MethodValues.Get.c_str() ||
+      headers.Authorization() != nullptr) {
+    return false;
+  }
+
+  if (headers.CacheControl() != nullptr) {
+    const CacheControl cache_control =
+        CacheControl::parse(headers.CacheControl()->value().getStringView());
+    if (cache_control.no_cache_ || cache_control.no_store_) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool CacheFilter::isCacheableResponse(const Http::HeaderMap& headers) {
+  if (Http::Utility::getResponseStatus(headers) != enumToInt(Http::Code::OK) ||
+      headers.CacheControl() == nullptr || headers.get(Http::Headers::get().SetCookie) != nullptr) {
+    return false;
+  }
+
+  const Http::HeaderEntry* vary = headers.get(Http::Headers::get().Vary);
+  if (vary != nullptr && StringUtil::findToken(vary->value().getStringView(), ",", "*")) {
+    return false;
+  }
+
+  const CacheControl cache_control =
+      CacheControl::parse(headers.CacheControl()->value().getStringView());
+  return !cache_control.no_cache_ && !cache_control.no_store_ && !cache_control.private_ &&
+         cache_control.max_age_ && cache_control.max_age_.value().count() > 0;
+}
+
+Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::HeaderMap& headers, bool end_stream) {
+  if (!end_stream || !isCacheableRequest(headers)) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  request_headers_ = &headers;
+  key_ = std::string(headers.Host()->value().c_str()) + headers.Path()->value().c_str();
+
+  // A miss for a conditional request is not used to fill the cache, since the response is likely
+  // to be a 304 that cannot be stored.
+  if (headers.get(Http::Headers::get().IfNoneMatch) != nullptr) {
+    CachedResponseConstSharedPtr response = config_->cache().find(key_, headers);
+    if (response) {
+      config_->stats().hit_.inc();
+      serve(*response);
+      return Http::FilterHeadersStatus::StopIteration;
+    }
+    config_->stats().miss_.inc();
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  HttpCache::LookupResult result = config_->cache().lookup(
+      key_, headers, decoder_callbacks_->dispatcher(), shared_from_this());
+  switch (result.status_) {
+  case HttpCache::LookupStatus::Hit:
+    config_->stats().hit_.inc();
+    serve(*result.response_);
+    return Http::FilterHeadersStatus::StopIteration;
+  case HttpCache::LookupStatus::Miss:
+    config_->stats().miss_.inc();
+    state_ = State::Filling;
+    return Http::FilterHeadersStatus::Continue;
+  case HttpCache::LookupStatus::Coalesced:
+    config_->stats().coalesced_.inc();
+    state_ = State::Waiting;
+    return Http::FilterHeadersStatus::StopIteration;
+  }
+
+  NOT_REACHED;
+}
+
+Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::HeaderMap& headers, bool end_stream) {
+  if (state_ != State::Filling) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  if (!isCacheableResponse(headers)) {
+    config_->stats().uncacheable_.inc();
+    abandonFill();
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  response_ = std::make_shared<CachedResponse>();
+  response_->headers_.reset(new Http::HeaderMapImpl(headers));
+  // The body is sent with a known length when served from the cache, and the upstream service
+  // time only applies to the original response.
+  response_->headers_->removeTransferEncoding();
+  response_->headers_->removeConnection();
+  response_->headers_->removeEnvoyUpstreamServiceTime();
+  response_->response_time_ = config_->timeSource().currentTime();
+  response_->max_age_ =
+      CacheControl::parse(headers.CacheControl()->value().getStringView()).max_age_.value();
+
+  const Http::HeaderEntry* age = headers.get(Http::Headers::get().Age);
+  uint64_t initial_age;
+  if (age != nullptr && StringUtil::atoul(age->value().c_str(), initial_age)) {
+    response_->initial_age_ = std::chrono::seconds(initial_age);
+  }
+
+  const Http::HeaderEntry* vary = headers.get(Http::Headers::get().Vary);
+  if (vary != nullptr) {
+    for (absl::string_view name : StringUtil::splitToken(vary->value().getStringView(), ",")) {
+      Http::LowerCaseString key(std::string(StringUtil::trim(name)));
+      const Http::HeaderEntry* request_header = request_headers_->get(key);
+      response_->vary_headers_.emplace_back(
+          key, request_header == nullptr
+                   ? absl::optional<std::string>()
+                   : absl::optional<std::string>(request_header->value().c_str()));
+    }
+  }
+
+  if (end_stream) {
+    insertResponse();
+  }
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (state_ != State::Filling || !response_) {
+    return Http::FilterDataStatus::Continue;
+  }
+
+  std::string& body = response_->body_;
+  if (body.size() + data.length() > config_->maxBodyBytes()) {
+    config_->stats().uncacheable_.inc();
+    abandonFill();
+    return Http::FilterDataStatus::Continue;
+  }
+
+  const size_t offset = body.size();
+  body.resize(offset + data.length());
+  data.copyOut(0, data.length(), &body[offset]);
+
+  if (end_stream) {
+    insertResponse();
+  }
+  return Http::FilterDataStatus::Continue;
+}
+
+Http::FilterTrailersStatus CacheFilter::encodeTrailers(Http::HeaderMap&) {
+  // Trailers are not stored, so a response that has them is not cached.
+  if (state_ == State::Filling) {
+    config_->stats().uncacheable_.inc();
+    abandonFill();
+  }
+  return Http::FilterTrailersStatus::Continue;
+}
+
+void CacheFilter::onDestroy() {
+  destroyed_ = true;
+  if (state_ == State::Filling) {
+    abandonFill();
+  }
+}
+
+void CacheFilter::onFillComplete() {
+  if (destroyed_ || state_ != State::Waiting) {
+    return;
+  }
+
+  // The response may not have been cacheable, or may vary on headers that differ for this request,
+  // in which case the request goes upstream on its own.
+  CachedResponseConstSharedPtr response = config_->cache().find(key_, *request_headers_);
+  if (response) {
+    serve(*response);
+  } else {
+    state_ = State::PassThrough;
+    decoder_callbacks_->continueDecoding();
+  }
+}
+
+void CacheFilter::serve(const CachedResponse& response) {
+  state_ = State::Serving;
+  const uint64_t age = response.age(config_->timeSource().currentTime()).count();
+
+  const Http::HeaderEntry* if_none_match =
+      request_headers_->get(Http::Headers::get().IfNoneMatch);
+  if (if_none_match != nullptr && ifNoneMatch(*if_none_match, response.headers_->Etag())) {
+    config_->stats().not_modified_.inc();
+    Http::HeaderMapPtr headers{new Http::HeaderMapImpl{
+        {Http::Headers::get().Status, std::to_string(enumToInt(Http::Code::NotModified))}}};
+    // The headers that RFC 7232 requires in a 304 response, if they were in the 200 response.
+    copyHeader(*response.headers_, Http::Headers::get().CacheControl, *headers);
+    copyHeader(*response.headers_, Http::Headers::get().Date, *headers);
+    copyHeader(*response.headers_, Http::Headers::get().Etag, *headers);
+    copyHeader(*response.headers_, Http::Headers::get().Expires, *headers);
+    copyHeader(*response.headers_, Http::Headers::get().Vary, *headers);
+    headers->addReferenceKey(Http::Headers::get().Age, age);
+    decoder_callbacks_->encodeHeaders(std::move(headers), true);
+    return;
+  }
+
+  Http::HeaderMapPtr headers{new Http::HeaderMapImpl(*response.headers_)};
+  headers->remove(Http::Headers::get().Age);
+  headers->addReferenceKey(Http::Headers::get().Age, age);
+  if (response.body_.empty()) {
+    decoder_callbacks_->encodeHeaders(std::move(headers), true);
+  } else {
+    decoder_callbacks_->encodeHeaders(std::move(headers), false);
+    Buffer::OwnedImpl body(response.body_);
+    decoder_callbacks_->encodeData(body, true);
+  }
+}
+
+void CacheFilter::insertResponse() {
+  ASSERT(state_ == State::Filling && response_);
+  response_->headers_->insertContentLength().value(response_->body_.size());
+  response_->headers_->remove(Http::Headers::get().Age);
+  config_->cache().insert(key_, std::move(response_));
+  state_ = State::PassThrough;
+}
+
+void CacheFilter::abandonFill() {
+  ASSERT(state_ == State::Filling);
+  config_->cache().abandonFill(key_);
+  response_.reset();
+  state_ = State::PassThrough;
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/http/filter.h"
+#include "envoy/stats/stats.h"
+
+#include "extensions/filters/http/cache/http_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Configuration for the cache filter. Owns the cache, so that it is shared by the filters on all
+ * workers.
+ */
+class CacheFilterConfig {
+public:
+  CacheFilterConfig(uint64_t max_size_bytes, uint64_t max_body_bytes,
+                    const std::string& stats_prefix, Stats::Scope& scope,
+                    MonotonicTimeSource& time_source);
+
+  HttpCache& cache() { return cache_; }
+  CacheFilterStats& stats() { return stats_; }
+  uint64_t maxBodyBytes() const { return max_body_bytes_; }
+  MonotonicTimeSource& timeSource() { return time_source_; }
+
+private:
+  static CacheFilterStats generateStats(const std::string& prefix, Stats::Scope& scope);
+
+  const uint64_t max_body_bytes_;
+  MonotonicTimeSource& time_source_;
+  CacheFilterStats stats_;
+  HttpCache cache_;
+};
+
+typedef std::shared_ptr<CacheFilterConfig> CacheFilterConfigSharedPtr;
+
+/**
+ * A filter that serves GET requests from a cache of the responses received for earlier requests,
+ * following the Cache-Control, Vary and ETag semantics of a shared cache. Concurrent misses for the
+ * same key on any worker are coalesced into a single upstream request.
+ */
+class CacheFilter : public Http::StreamFilter,
+                    public CacheFillWaiter,
+                    public std::enable_shared_from_this<CacheFilter> {
+public:
+  CacheFilter(CacheFilterConfigSharedPtr config) : config_(config) {}
+
+  // Http::StreamFilterBase
+  void onDestroy() override;
+
+  // Http::StreamDecoderFilter
+  Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus decodeData(Buffer::Instance&, bool) override {
+    return Http::FilterDataStatus::Continue;
+  }
+  Http::FilterTrailersStatus decodeTrailers(Http::HeaderMap&) override {
+    return Http::FilterTrailersStatus::Continue;
+  }
+  void setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks& callbacks) override {
+    decoder_callbacks_ = &callbacks;
+  }
+
+  // Http::StreamEncoderFilter
+  Http::FilterHeadersStatus encode100ContinueHeaders(Http::HeaderMap&) override {
+    return Http::FilterHeadersStatus::Continue;
+  }
+  Http::FilterHeadersStatus encodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override;
+  Http::FilterTrailersStatus encodeTrailers(Http::HeaderMap& trailers) override;
+  void setEncoderFilterCallbacks(Http::StreamEncoderFilterCallbacks&) override {}
+
+  // CacheFillWaiter
+  void onFillComplete() override;
+
+  /**
+   * @param headers supplies the headers of a request.
+   * @return bool whether a response to the request may be served from, and stored in, the cache.
+   */
+  static bool isCacheableRequest(const Http::HeaderMap& headers);
+
+  /**
+   * @param headers supplies the headers of a response.
+   * @return bool whether the response may be stored in the cache.
+   */
+  static bool isCacheableResponse(const Http::HeaderMap& headers);
+
+private:
+  enum class State {
+    // The request is not handled by the cache.
+    PassThrough,
+    // The request missed, and the response is being stored in the cache.
+    Filling,
+    // The request is waiting for another stream to fill the cache.
+    Waiting,
+    // The response is being served from the cache.
+    Serving
+  };
+
+  void serve(const CachedResponse& response);
+  void insertResponse();
+  void abandonFill();
+
+  CacheFilterConfigSharedPtr config_;
+  Http::StreamDecoderFilterCallbacks* decoder_callbacks_{};
+  const Http::HeaderMap* request_headers_{};
+  State state_{State::PassThrough};
+  std::string key_;
+  std::shared_ptr<CachedResponse> response_;
+  bool destroyed_{};
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,48 @@
+#include "extensions/filters/http/cache/config.h"
+
+#include "envoy/config/filter/http/cache/v2alpha/cache.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/common/utility.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/filters/http/cache/cache_filter.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+Server::Configuration::HttpFilterFactoryCb
+CacheFilterFactory::createFilterFactory(const Json::Object&, const std::string&,
+                                        Server::Configuration::FactoryContext&) {
+  NOT_IMPLEMENTED;
+}
+
+Server::Configuration::HttpFilterFactoryCb
+CacheFilterFactory::createFilterFactoryFromProto(const Protobuf::Message& proto_config,
+                                                 const std::string& stats_prefix,
+                                                 Server::Configuration::FactoryContext& context) {
+  const auto& cache_config =
+      MessageUtil::downcastAndValidate<const envoy::config::filter::http::cache::v2alpha::Cache&>(
+          proto_config);
+  CacheFilterConfigSharedPtr config = std::make_shared<CacheFilterConfig>(
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(cache_config, max_size_bytes, 64 * 1024 * 1024),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(cache_config, max_body_bytes, 1024 * 1024), stats_prefix,
+      context.scope(), ProdMonotonicTimeSource::instance_);
+  return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamFilter(std::make_shared<CacheFilter>(config));
+  };
+}
+
+/**
+ * Static registration for the cache filter. @see RegisterFactory.
+ */
+static Registry::RegisterFactory<CacheFilterFactory,
+                                 Server::Configuration::NamedHttpFilterConfigFactory>
+    register_;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "envoy/config/filter/http/cache/v2alpha/cache.pb.h"
+#include "envoy/server/filter_config.h"
+
+#include "extensions/filters/http/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Config registration for the cache filter. @see NamedHttpFilterConfigFactory.
+ */
+class CacheFilterFactory : public Server::Configuration::NamedHttpFilterConfigFactory {
+public:
+  Server::Configuration::HttpFilterFactoryCb
+  createFilterFactory(const Json::Object& json_config, const std::string& stats_prefix,
+                      Server::Configuration::FactoryContext& context) override;
+  Server::Configuration::HttpFilterFactoryCb
+  createFilterFactoryFromProto(const Protobuf::Message& config, const std::string& stats_prefix,
+                               Server::Configuration::FactoryContext& context) override;
+
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return ProtobufTypes::MessagePtr{new envoy::config::filter::http::cache::v2alpha::Cache()};
+  }
+
+  std::string name() override { return HttpFilterNames::get().CACHE; }
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,208 @@
+#include "extensions/filters/http/cache/http_cache.h"
+
+#include <string>
+
+#include "common/common/assert.h"
+#include "common/common/hash.h"
+#include "common/common/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+namespace {
+
+bool parseSeconds(absl::string_view value, std::chrono::seconds& out) {
+  uint64_t seconds;
+  if (!StringUtil::atoul(std::string(StringUtil::trim(value)).c_str(), seconds)) {
+    return false;
+  }
+  out = std::chrono::seconds(seconds);
+  return true;
+}
+
+} // namespace
+
+CacheControl CacheControl::parse(absl::string_view value) {
+  CacheControl cache_control;
+  absl::optional<std::chrono::seconds> max_age;
+  absl::optional<std::chrono::seconds> s_maxage;
+  for (absl::string_view directive : StringUtil::splitToken(value, ",")) {
+    directive = StringUtil::trim(directive);
+    const size_t equals = directive.find('=');
+    const absl::string_view name = StringUtil::trim(directive.substr(0, equals));
+    const absl::string_view argument =
+        equals == absl::string_view::npos ? absl::string_view() : directive.substr(equals + 1);
+    std::chrono::seconds seconds;
+
+    if (StringUtil::caseCompare(name, "no-cache")) {
+      cache_control.no_cache_ = true;
+    } else if (StringUtil::caseCompare(name, "no-store")) {
+      cache_control.no_store_ = true;
+    } else if (StringUtil::caseCompare(name, "private")) {
+      cache_control.private_ = true;
+    } else if (StringUtil::caseCompare(name, "max-age") && parseSeconds(argument, seconds)) {
+      max_age = seconds;
+    } else if (StringUtil::caseCompare(name, "s-maxage") && parseSeconds(argument, seconds)) {
+      s_maxage = seconds;
+    }
+  }
+
+  cache_control.max_age_ = s_maxage ? s_maxage : max_age;
+  return cache_control;
+}
+
+uint64_t CachedResponse::byteSize() const { return headers_->byteSize() + body_.size(); }
+
+bool CachedResponse::varyMatches(const Http::HeaderMap& request_headers) const {
+  for (const auto& vary_header : vary_headers_) {
+    const Http::HeaderEntry* entry = request_headers.get(vary_header.first);
+    if (entry == nullptr) {
+      if (vary_header.second) {
+        return false;
+      }
+    } else if (!vary_header.second || vary_header.second.value() != entry->value().c_str()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::chrono::seconds CachedResponse::age(MonotonicTime now) const {
+  return initial_age_ + std::chrono::duration_cast<std::chrono::seconds>(now - response_time_);
+}
+
+HttpCache::HttpCache(uint64_t max_size_bytes, MonotonicTimeSource& time_source,
+                     CacheFilterStats& stats)
+    : max_shard_size_bytes_(max_size_bytes / kNumShards), time_source_(time_source),
+      stats_(stats) {}
+
+HttpCache::LookupResult HttpCache::lookup(const std::string& key,
+                                          const Http::HeaderMap& request_headers,
+                                          Event::Dispatcher& dispatcher,
+                                          CacheFillWaiterWeakPtr waiter) {
+  Shard& key_shard = shard(key);
+  std::unique_lock<std::mutex> lock(key_shard.lock_);
+  CachedResponseConstSharedPtr response = findLocked(key_shard, key, request_headers);
+  if (response) {
+    return {LookupStatus::Hit, response};
+  }
+
+  auto fill = key_shard.fills_.find(key);
+  if (fill != key_shard.fills_.end()) {
+    fill->second.push_back({&dispatcher, waiter});
+    return {LookupStatus::Coalesced, nullptr};
+  }
+
+  key_shard.fills_.emplace(key, std::vector<Waiter>());
+  return {LookupStatus::Miss, nullptr};
+}
+
+CachedResponseConstSharedPtr HttpCache::find(const std::string& key,
+                                             const Http::HeaderMap& request_headers) {
+  Shard& key_shard = shard(key);
+  std::unique_lock<std::mutex> lock(key_shard.lock_);
+  return findLocked(key_shard, key, request_headers);
+}
+
+void HttpCache::insert(const std::string& key, CachedResponseConstSharedPtr response) {
+  const uint64_t byte_size = key.size() + response->byteSize();
+  Shard& key_shard = shard(key);
+  std::unique_lock<std::mutex> lock(key_shard.lock_);
+
+  auto existing = key_shard.entries_.find(key);
+  if (existing != key_shard.entries_.end()) {
+    eraseLocked(key_shard, existing->second);
+  }
+
+  // A response that is larger than a whole shard would evict everything and still not fit.
+  if (byte_size <= max_shard_size_bytes_) {
+    key_shard.lru_.push_front({key, response});
+    key_shard.entries_.emplace(key, key_shard.lru_.begin());
+    key_shard.size_bytes_ += byte_size;
+    stats_.insert_.inc();
+
+    while (key_shard.size_bytes_ > max_shard_size_bytes_) {
+      ASSERT(key_shard.lru_.size() > 1);
+      eraseLocked(key_shard, std::prev(key_shard.lru_.end()));
+      stats_.eviction_.inc();
+    }
+  }
+
+  completeFill(key_shard, key, lock);
+}
+
+void HttpCache::abandonFill(const std::string& key) {
+  Shard& key_shard = shard(key);
+  std::unique_lock<std::mutex> lock(key_shard.lock_);
+  completeFill(key_shard, key, lock);
+}
+
+uint64_t HttpCache::sizeBytes() const {
+  uint64_t size_bytes = 0;
+  for (const Shard& key_shard : shards_) {
+    std::unique_lock<std::mutex> lock(key_shard.lock_);
+    size_bytes += key_shard.size_bytes_;
+  }
+  return size_bytes;
+}
+
+HttpCache::Shard& HttpCache::shard(const std::string& key) {
+  return shards_[HashUtil::xxHash64(key) % kNumShards];
+}
+
+CachedResponseConstSharedPtr HttpCache::findLocked(Shard& shard, const std::string& key,
+                                                   const Http::HeaderMap& request_headers) {
+  auto it = shard.entries_.find(key);
+  if (it == shard.entries_.end()) {
+    return nullptr;
+  }
+
+  const CachedResponseConstSharedPtr& response = it->second->response_;
+  if (response->age(time_source_.currentTime()) >= response->max_age_) {
+    // Stale responses are never served, so there is no point in keeping them around.
+    eraseLocked(shard, it->second);
+    return nullptr;
+  }
+
+  if (!response->varyMatches(request_headers)) {
+    return nullptr;
+  }
+
+  shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second);
+  return response;
+}
+
+void HttpCache::eraseLocked(Shard& shard, std::list<Entry>::iterator it) {
+  shard.size_bytes_ -= it->key_.size() + it->response_->byteSize();
+  shard.entries_.erase(it->key_);
+  shard.lru_.erase(it);
+}
+
+void HttpCache::completeFill(Shard& shard, const std::string& key,
+                             std::unique_lock<std::mutex>& lock) {
+  std::vector<Waiter> waiters;
+  auto fill = shard.fills_.find(key);
+  if (fill != shard.fills_.end()) {
+    waiters = std::move(fill->second);
+    shard.fills_.erase(fill);
+  }
+  lock.unlock();
+
+  // Waiters may be on any worker, and may have gone away since they started to wait.
+  for (const Waiter& waiter : waiters) {
+    CacheFillWaiterWeakPtr weak_waiter = waiter.waiter_;
+    waiter.dispatcher_->post([weak_waiter]() -> void {
+      std::shared_ptr<CacheFillWaiter> shared_waiter = weak_waiter.lock();
+      if (shared_waiter) {
+        shared_waiter->onFillComplete();
+      }
+    });
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
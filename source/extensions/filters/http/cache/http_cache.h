@@ -0,0 +1,221 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/header_map.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All stats for the cache filter. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_CACHE_FILTER_STATS(COUNTER)                                                            \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  COUNTER(coalesced)                                                                               \
+  COUNTER(not_modified)                                                                            \
+  COUNTER(insert)                                                                                  \
+  COUNTER(eviction)                                                                                \
+  COUNTER(uncacheable)
+// clang-format on
+
+/**
+ * Wrapper struct for cache filter stats. @see stats_macros.h
+ */
+struct CacheFilterStats {
+  ALL_CACHE_FILTER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * The directives of a Cache-Control header that affect whether and for how long a response may be
+ * stored by a shared cache.
+ */
+struct CacheControl {
+  /**
+   * @param value supplies the value of a Cache-Control header.
+   * @return CacheControl the parsed directives. Unknown directives are ignored.
+   */
+  static CacheControl parse(absl::string_view value);
+
+  bool no_cache_{};
+  bool no_store_{};
+  bool private_{};
+  // s-maxage if present, as it overrides max-age for shared caches, otherwise max-age.
+  absl::optional<std::chrono::seconds> max_age_;
+};
+
+/**
+ * A response held by the cache. Entries are immutable once inserted, so that they can be served
+ * by the streams of all workers without copying.
+ */
+struct CachedResponse {
+  /**
+   * @return uint64_t the number of bytes charged against the size of the cache for the entry.
+   */
+  uint64_t byteSize() const;
+
+  /**
+   * @param request_headers supplies the headers of a request.
+   * @return bool whether the request has the same values as the request that the response was
+   *         received for, for all of the headers named by the Vary header of the response.
+   */
+  bool varyMatches(const Http::HeaderMap& request_headers) const;
+
+  /**
+   * @param now supplies the current time.
+   * @return std::chrono::seconds the age of the response.
+   */
+  std::chrono::seconds age(MonotonicTime now) const;
+
+  Http::HeaderMapPtr headers_;
+  std::string body_;
+  MonotonicTime response_time_;
+  // The value of the Age header of the response when it was received.
+  std::chrono::seconds initial_age_{};
+  std::chrono::seconds max_age_{};
+  // The request headers named by the Vary header of the response, with the values they had in the
+  // request that the response was received for. Absent headers have no value.
+  std::vector<std::pair<Http::LowerCaseString, absl::optional<std::string>>> vary_headers_;
+};
+
+typedef std::shared_ptr<const CachedResponse> CachedResponseConstSharedPtr;
+
+/**
+ * A stream that is waiting for another stream to fill the cache for the same key.
+ */
+class CacheFillWaiter {
+public:
+  virtual ~CacheFillWaiter() {}
+
+  /**
+   * Called on the dispatcher of the waiting stream once the fill it waited for has completed,
+   * either by inserting a response or by giving up.
+   */
+  virtual void onFillComplete() PURE;
+};
+
+typedef std::weak_ptr<CacheFillWaiter> CacheFillWaiterWeakPtr;
+
+/**
+ * A size bounded LRU cache of HTTP responses, shared by all workers. The cache is split into
+ * shards that are locked independently, so that streams on different workers looking up
+ * different keys rarely contend.
+ *
+ * At most one stream per key fills the cache at a time. Streams that miss while a fill is in
+ * progress register as waiters instead of going upstream, and are woken when the fill completes.
+ */
+class HttpCache {
+public:
+  HttpCache(uint64_t max_size_bytes, MonotonicTimeSource& time_source, CacheFilterStats& stats);
+
+  enum class LookupStatus {
+    // A fresh response was found.
+    Hit,
+    // No response was found, and the caller must fill the cache by calling insert() or
+    // abandonFill() with the key.
+    Miss,
+    // No response was found but another stream is filling the cache for the key. The waiter
+    // will be notified when it is done.
+    Coalesced
+  };
+
+  struct LookupResult {
+    LookupStatus status_;
+    CachedResponseConstSharedPtr response_;
+  };
+
+  /**
+   * Looks up a fresh response for a request.
+   * @param key supplies the key of the request.
+   * @param request_headers supplies the request headers, which are matched against the Vary
+   *        headers of a cached response.
+   * @param dispatcher supplies the dispatcher to notify the waiter on if the lookup is coalesced.
+   * @param waiter supplies the waiter to notify if the lookup is coalesced.
+   * @return LookupResult the result of the lookup.
+   */
+  LookupResult lookup(const std::string& key, const Http::HeaderMap& request_headers,
+                      Event::Dispatcher& dispatcher, CacheFillWaiterWeakPtr waiter);
+
+  /**
+   * Looks up a fresh response for a request without starting or joining a fill.
+   * @param key supplies the key of the request.
+   * @param request_headers supplies the request headers.
+   * @return CachedResponseConstSharedPtr the response, or nullptr if there is none.
+   */
+  CachedResponseConstSharedPtr find(const std::string& key, const Http::HeaderMap& request_headers);
+
+  /**
+   * Inserts a response and completes the fill for its key.
+   * @param key supplies the key.
+   * @param response supplies the response.
+   */
+  void insert(const std::string& key, CachedResponseConstSharedPtr response);
+
+  /**
+   * Completes the fill for a key without inserting a response.
+   * @param key supplies the key.
+   */
+  void abandonFill(const std::string& key);
+
+  /**
+   * @return uint64_t the number of bytes charged for the responses in the cache.
+   */
+  uint64_t sizeBytes() const;
+
+  static constexpr uint32_t kNumShards = 16;
+
+private:
+  struct Entry {
+    std::string key_;
+    CachedResponseConstSharedPtr response_;
+  };
+
+  struct Waiter {
+    Event::Dispatcher* dispatcher_;
+    CacheFillWaiterWeakPtr waiter_;
+  };
+
+  struct Shard {
+    mutable std::mutex lock_;
+    // Most recently used first.
+    std::list<Entry> lru_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+    uint64_t size_bytes_{};
+    // Keys being filled, with the streams waiting for them.
+    std::unordered_map<std::string, std::vector<Waiter>> fills_;
+  };
+
+  Shard& shard(const std::string& key);
+  CachedResponseConstSharedPtr findLocked(Shard& shard, const std::string& key,
+                                          const Http::HeaderMap& request_headers);
+  void eraseLocked(Shard& shard, std::list<Entry>::iterator it);
+  void completeFill(Shard& shard, const std::string& key, std::unique_lock<std::mutex>& lock);
+
+  const uint64_t max_shard_size_bytes_;
+  MonotonicTimeSource& time_source_;
+  CacheFilterStats& stats_;
+  Shard shards_[kNumShards];
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -14,9 +14,11 @@ namespace Lua {
 
 Server::Configuration::HttpFilterFactoryCb
 LuaFilterConfig::createFilter(const envoy::config::filter::http::lua::v2::Lua& proto_config,
-                              const std::string&, Server::Configuration::FactoryContext& context) {
+                              const std::string& stat_prefix,
+                              Server::Configuration::FactoryContext& context) {
   FilterConfigConstSharedPtr filter_config(new FilterConfig{
-      proto_config.inline_code(), context.threadLocal(), context.clusterManager()});
+      proto_config.inline_code(), proto_config.instruction_budget(), context.threadLocal(),
+      context.clusterManager(), stat_prefix, context.scope()});
   return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<Filter>(filter_config));
   };
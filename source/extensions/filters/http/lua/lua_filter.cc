@@ -403,9 +403,12 @@ int StreamHandleWrapper::luaLogCritical(lua_State* state) {
   return 0;
 }
 
-FilterConfig::FilterConfig(const std::string& lua_code, ThreadLocal::SlotAllocator& tls,
-                           Upstream::ClusterManager& cluster_manager)
-    : cluster_manager_(cluster_manager), lua_state_(lua_code, tls) {
+FilterConfig::FilterConfig(const std::string& lua_code, uint64_t instruction_budget,
+                           ThreadLocal::SlotAllocator& tls,
+                           Upstream::ClusterManager& cluster_manager,
+                           const std::string& stat_prefix, Stats::Scope& scope)
+    : cluster_manager_(cluster_manager), stats_(generateStats(stat_prefix, scope)),
+      lua_state_(lua_code, tls, instruction_budget) {
   lua_state_.registerType<Filters::Common::Lua::BufferWrapper>();
   lua_state_.registerType<Filters::Common::Lua::MetadataMapWrapper>();
   lua_state_.registerType<Filters::Common::Lua::MetadataMapIterator>();
@@ -424,14 +427,31 @@ FilterConfig::FilterConfig(const std::string& lua_code, ThreadLocal::SlotAllocat
   }
 }
 
+LuaFilterStats FilterConfig::generateStats(const std::string& prefix, Stats::Scope& scope) {
+  const std::string final_prefix = prefix + "lua.";
+  return {ALL_LUA_FILTER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
+                               POOL_GAUGE_PREFIX(scope, final_prefix),
+                               POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
+}
+
 void Filter::onDestroy() {
   destroyed_ = true;
   if (request_stream_wrapper_.get()) {
+    recordScriptStats(request_stream_wrapper_);
     request_stream_wrapper_.get()->onReset();
   }
   if (response_stream_wrapper_.get()) {
+    recordScriptStats(response_stream_wrapper_);
     response_stream_wrapper_.get()->onReset();
   }
+
+  // The gauge is shared by all workers, so each worker contributes the change in its own heap.
+  const int64_t delta = config_->runtimeBytesDelta();
+  if (delta >= 0) {
+    config_->stats_.memory_bytes_.add(delta);
+  } else {
+    config_->stats_.memory_bytes_.sub(-delta);
+  }
 }
 
 Http::FilterHeadersStatus Filter::doHeaders(StreamHandleRef& handle, FilterCallbacks& callbacks,
@@ -490,10 +510,26 @@ Http::FilterTrailersStatus Filter::doTrailers(StreamHandleRef& handle, Http::Hea
 
 void Filter::scriptError(const Filters::Common::Lua::LuaException& e) {
   scriptLog(spdlog::level::err, e.what());
+  config_->stats_.errors_.inc();
+  if (request_stream_wrapper_.get()) {
+    recordScriptStats(request_stream_wrapper_);
+  }
+  if (response_stream_wrapper_.get()) {
+    recordScriptStats(response_stream_wrapper_);
+  }
   request_stream_wrapper_.reset();
   response_stream_wrapper_.reset();
 }
 
+void Filter::recordScriptStats(StreamHandleRef& handle) {
+  const Filters::Common::Lua::Coroutine& coroutine = handle.get()->coroutine();
+  config_->stats_.script_time_us_.recordValue(
+      std::chrono::duration_cast<std::chrono::microseconds>(coroutine.runTime()).count());
+  if (coroutine.instructionBudgetExceeded()) {
+    config_->stats_.instruction_budget_exceeded_.inc();
+  }
+}
+
 void Filter::scriptLog(spdlog::level::level_enum level, const char* message) {
   switch (level) {
   case spdlog::level::trace:
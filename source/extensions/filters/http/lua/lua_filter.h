@@ -1,6 +1,7 @@
 #pragma once
 
 #include "envoy/http/filter.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "extensions/filters/common/lua/wrappers.h"
@@ -194,6 +195,8 @@ private:
 
   static Http::HeaderMapPtr buildHeadersFromTable(lua_State* state, int table_index);
 
+  const Filters::Common::Lua::Coroutine& coroutine() const { return *coroutine_; }
+
   // Filters::Common::Lua::BaseLuaObject
   void onMarkDead() override {
     // Headers/body/trailers wrappers do not survive any yields. The user can request them
@@ -226,20 +229,43 @@ private:
   Http::AsyncClient::Request* http_request_{};
 };
 
+/**
+ * All stats for the Lua filter. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_LUA_FILTER_STATS(COUNTER, GAUGE, HISTOGRAM)                                            \
+  COUNTER  (errors)                                                                                \
+  COUNTER  (instruction_budget_exceeded)                                                           \
+  GAUGE    (memory_bytes)                                                                          \
+  HISTOGRAM(script_time_us)
+// clang-format on
+
+/**
+ * Wrapper struct for Lua filter stats. @see stats_macros.h
+ */
+struct LuaFilterStats {
+  ALL_LUA_FILTER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
 /**
  * Global configuration for the filter.
  */
 class FilterConfig : Logger::Loggable<Logger::Id::lua> {
 public:
-  FilterConfig(const std::string& lua_code, ThreadLocal::SlotAllocator& tls,
-               Upstream::ClusterManager& cluster_manager);
+  FilterConfig(const std::string& lua_code, uint64_t instruction_budget,
+               ThreadLocal::SlotAllocator& tls, Upstream::ClusterManager& cluster_manager,
+               const std::string& stat_prefix, Stats::Scope& scope);
   Filters::Common::Lua::CoroutinePtr createCoroutine() { return lua_state_.createCoroutine(); }
   int requestFunctionRef() { return lua_state_.getGlobalRef(request_function_slot_); }
   int responseFunctionRef() { return lua_state_.getGlobalRef(response_function_slot_); }
+  int64_t runtimeBytesDelta() { return lua_state_.runtimeBytesDelta(); }
 
   Upstream::ClusterManager& cluster_manager_;
+  LuaFilterStats stats_;
 
 private:
+  static LuaFilterStats generateStats(const std::string& prefix, Stats::Scope& scope);
+
   Filters::Common::Lua::ThreadLocalState lua_state_;
   uint64_t request_function_slot_;
   uint64_t response_function_slot_;
@@ -247,8 +273,6 @@ private:
 
 typedef std::shared_ptr<FilterConfig> FilterConfigConstSharedPtr;
 
-// TODO(mattklein123): Filter stats.
-
 /**
  * The HTTP Lua filter. Allows scripts to run in both the request an response flow.
  */
@@ -339,6 +363,7 @@ private:
                                       int function_ref, Http::HeaderMap& headers, bool end_stream);
   Http::FilterDataStatus doData(StreamHandleRef& handle, Buffer::Instance& data, bool end_stream);
   Http::FilterTrailersStatus doTrailers(StreamHandleRef& handle, Http::HeaderMap& trailers);
+  void recordScriptStats(StreamHandleRef& handle);
 
   FilterConfigConstSharedPtr config_;
   DecoderCallbacks decoder_callbacks_{*this};
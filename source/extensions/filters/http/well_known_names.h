@@ -14,6 +14,8 @@ class HttpFilterNameValues {
 public:
   // Buffer filter
   const std::string BUFFER = "envoy.buffer";
+  // Cache filter
+  const std::string CACHE = "envoy.filters.http.cache";
   // CORS filter
   const std::string CORS = "envoy.cors";
   // Dynamo filter
@@ -0,0 +1,183 @@
+#include "extensions/filters/listener/tls_inspector/tls_inspector.h"
+
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/network/listen_socket.h"
+#include "envoy/stats/stats.h"
+
+#include "common/common/assert.h"
+
+#include "openssl/bytestring.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace TlsInspector {
+
+Config::Config(Stats::Scope& scope)
+    : stats_{ALL_TLS_INSPECTOR_STATS(POOL_COUNTER_PREFIX(scope, "tls_inspector."))},
+      ssl_ctx_(SSL_CTX_new(TLS_with_buffers_method())) {
+  RELEASE_ASSERT(ssl_ctx_);
+  SSL_CTX_set_options(ssl_ctx_.get(), SSL_OP_NO_TICKET);
+  SSL_CTX_set_session_cache_mode(ssl_ctx_.get(), SSL_SESS_CACHE_OFF);
+
+  // The select certificate callback runs as soon as the ClientHello has been parsed, and the
+  // servername callback after it, even if the client sent no SNI.
+  SSL_CTX_set_select_certificate_cb(
+      ssl_ctx_.get(), [](const SSL_CLIENT_HELLO* client_hello) -> ssl_select_cert_result_t {
+        const uint8_t* data;
+        size_t len;
+        if (SSL_early_callback_ctx_extension_get(
+                client_hello, TLSEXT_TYPE_application_layer_protocol_negotiation, &data, &len)) {
+          Filter* filter = static_cast<Filter*>(SSL_get_app_data(client_hello->ssl));
+          filter->onAlpn(data, len);
+        }
+        return ssl_select_cert_success;
+      });
+  SSL_CTX_set_tlsext_servername_callback(
+      ssl_ctx_.get(), [](SSL* ssl, int* out_alert, void*) -> int {
+        Filter* filter = static_cast<Filter*>(SSL_get_app_data(ssl));
+        const char* name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+        filter->onServername(name != nullptr ? name : "");
+        // Fail the handshake, as the filter has everything it needs from the ClientHello.
+        *out_alert = SSL_AD_USER_CANCELLED;
+        return SSL_TLSEXT_ERR_ALERT_FATAL;
+      });
+}
+
+bssl::UniquePtr<SSL> Config::newSsl() { return bssl::UniquePtr<SSL>{SSL_new(ssl_ctx_.get())}; }
+
+Filter::Filter(const ConfigSharedPtr& config) : config_(config), ssl_(config_->newSsl()) {
+  RELEASE_ASSERT(ssl_);
+  SSL_set_app_data(ssl_.get(), this);
+  SSL_set_accept_state(ssl_.get());
+}
+
+Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
+  ENVOY_LOG(debug, "tls inspector: new connection accepted");
+  Network::ConnectionSocket& socket = cb.socket();
+  ASSERT(file_event_.get() == nullptr);
+  file_event_ = cb.dispatcher().createFileEvent(
+      socket.fd(),
+      [this](uint32_t events) {
+        if (events & Event::FileReadyType::Closed) {
+          config_->stats().connection_closed_.inc();
+          done(false);
+          return;
+        }
+        ASSERT(events == Event::FileReadyType::Read);
+        onRead();
+      },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Closed);
+  cb_ = &cb;
+  return Network::FilterStatus::StopIteration;
+}
+
+void Filter::onServername(absl::string_view name) {
+  if (!name.empty()) {
+    config_->stats().sni_found_.inc();
+    cb_->socket().setRequestedServerName(name);
+  } else {
+    config_->stats().sni_not_found_.inc();
+  }
+  client_hello_done_ = true;
+}
+
+void Filter::onAlpn(const uint8_t* data, size_t len) {
+  // The extension holds a list of 8-bit length prefixed protocol names, itself prefixed by its
+  // 16-bit length. Anything malformed is left for the TLS handshake proper to reject.
+  CBS wire, list;
+  CBS_init(&wire, data, len);
+  if (!CBS_get_u16_length_prefixed(&wire, &list) || CBS_len(&wire) != 0) {
+    return;
+  }
+  std::vector<std::string> protocols;
+  while (CBS_len(&list) > 0) {
+    CBS name;
+    if (!CBS_get_u8_length_prefixed(&list, &name) || CBS_len(&name) == 0) {
+      return;
+    }
+    protocols.emplace_back(reinterpret_cast<const char*>(CBS_data(&name)), CBS_len(&name));
+  }
+  cb_->socket().setRequestedApplicationProtocols(protocols);
+  alpn_found_ = !protocols.empty();
+}
+
+void Filter::onRead() {
+  // The data is peeked rather than read, so that the transport socket can do the real handshake,
+  // and each read returns the bytes already parsed again.
+  const ssize_t n = recv(cb_->socket().fd(), buf_, Config::TLS_MAX_CLIENT_HELLO, MSG_PEEK);
+  ENVOY_LOG(trace, "tls inspector: recv: {}", n);
+  if (n == -1 && errno == EAGAIN) {
+    return;
+  } else if (n < 0) {
+    config_->stats().read_error_.inc();
+    done(false);
+    return;
+  } else if (n == 0) {
+    config_->stats().connection_closed_.inc();
+    done(false);
+    return;
+  }
+
+  if (static_cast<size_t>(n) > read_) {
+    const uint8_t* data = buf_ + read_;
+    const size_t len = n - read_;
+    read_ = n;
+    parseClientHello(data, len);
+  }
+}
+
+void Filter::parseClientHello(const void* data, size_t len) {
+  // A memory BIO reporting that more data may follow its end, so that an incomplete ClientHello
+  // makes the handshake wait for more rather than fail.
+  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(data, len));
+  BIO_set_mem_eof_return(bio.get(), -1);
+  SSL_set_bio(ssl_.get(), bio.get(), bio.get());
+  bio.release();
+
+  switch (SSL_get_error(ssl_.get(), SSL_do_handshake(ssl_.get()))) {
+  case SSL_ERROR_WANT_READ:
+    if (read_ == Config::TLS_MAX_CLIENT_HELLO) {
+      // The ClientHello doesn't fit in the buffer, so it will never be parsed.
+      config_->stats().client_hello_too_large_.inc();
+      done(false);
+    }
+    break;
+  case SSL_ERROR_SSL:
+    // The handshake always fails once the servername callback has run. If it didn't run, this
+    // isn't TLS, which is left for the filter chains to handle.
+    if (client_hello_done_) {
+      config_->stats().tls_found_.inc();
+      if (alpn_found_) {
+        config_->stats().alpn_found_.inc();
+      } else {
+        config_->stats().alpn_not_found_.inc();
+      }
+    } else {
+      config_->stats().tls_not_found_.inc();
+    }
+    done(true);
+    break;
+  default:
+    done(false);
+    break;
+  }
+}
+
+void Filter::done(bool success) {
+  ENVOY_LOG(trace, "tls inspector: done: {}", success);
+  // Release the file event so that it does not interfere with the connection read events.
+  file_event_.reset();
+  cb_->continueFilterChain(success);
+}
+
+} // namespace TlsInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
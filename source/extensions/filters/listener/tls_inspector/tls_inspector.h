@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/event/file_event.h"
+#include "envoy/network/filter.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/logger.h"
+
+#include "absl/strings/string_view.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace TlsInspector {
+
+/**
+ * All stats for the TLS inspector. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_TLS_INSPECTOR_STATS(COUNTER)                                                           \
+  COUNTER(connection_closed)                                                                       \
+  COUNTER(client_hello_too_large)                                                                  \
+  COUNTER(read_error)                                                                              \
+  COUNTER(tls_found)                                                                               \
+  COUNTER(tls_not_found)                                                                           \
+  COUNTER(alpn_found)                                                                              \
+  COUNTER(alpn_not_found)                                                                          \
+  COUNTER(sni_found)                                                                               \
+  COUNTER(sni_not_found)
+// clang-format on
+
+/**
+ * Definition of all stats for the TLS inspector. @see stats_macros.h
+ */
+struct TlsInspectorStats {
+  ALL_TLS_INSPECTOR_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Global configuration for the TLS inspector listener filter, shared by the filters of all the
+ * connections of a listener.
+ */
+class Config {
+public:
+  Config(Stats::Scope& scope);
+
+  const TlsInspectorStats& stats() const { return stats_; }
+  bssl::UniquePtr<SSL> newSsl();
+
+  /**
+   * The largest ClientHello the filter will buffer. Real ClientHellos are a few hundred bytes, so
+   * this only stops clients that never finish theirs from holding on to memory.
+   */
+  static const size_t TLS_MAX_CLIENT_HELLO = 16 * 1024;
+
+private:
+  TlsInspectorStats stats_;
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+};
+
+typedef std::shared_ptr<Config> ConfigSharedPtr;
+
+/**
+ * Listener filter that peeks at the TLS ClientHello of new connections, without consuming it, to
+ * set the requested server name (SNI) and application protocols (ALPN) of the connection socket
+ * for filter chain matching. Connections that don't start with a TLS handshake are let through
+ * unchanged.
+ */
+class Filter : public Network::ListenerFilter, Logger::Loggable<Logger::Id::filter> {
+public:
+  Filter(const ConfigSharedPtr& config);
+
+  // Network::ListenerFilter
+  Network::FilterStatus onAccept(Network::ListenerFilterCallbacks& cb) override;
+
+  // Called by the BoringSSL callbacks of Config while the ClientHello is parsed.
+  void onServername(absl::string_view name);
+  void onAlpn(const uint8_t* data, size_t len);
+
+private:
+  void onRead();
+  void parseClientHello(const void* data, size_t len);
+  void done(bool success);
+
+  ConfigSharedPtr config_;
+  Network::ListenerFilterCallbacks* cb_{};
+  Event::FileEventPtr file_event_;
+  bssl::UniquePtr<SSL> ssl_;
+  // Bytes of the socket already handed to ssl_.
+  size_t read_{};
+  // Set once the whole ClientHello has been parsed.
+  bool client_hello_done_{};
+  bool alpn_found_{};
+  uint8_t buf_[Config::TLS_MAX_CLIENT_HELLO];
+};
+
+} // namespace TlsInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -16,6 +16,8 @@ public:
   const std::string ORIGINAL_DST = "envoy.listener.original_dst";
   // Proxy Protocol listener filter
   const std::string PROXY_PROTOCOL = "envoy.listener.proxy_protocol";
+  // TLS inspector listener filter
+  const std::string TLS_INSPECTOR = "envoy.listener.tls_inspector";
 };
 
 typedef ConstSingleton<ListenerFilterNameValues> ListenerFilterNames;
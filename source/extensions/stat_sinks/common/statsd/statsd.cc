@@ -1,5 +1,9 @@
 #include "extensions/stat_sinks/common/statsd/statsd.h"
 
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <string>
@@ -37,53 +41,169 @@ void Writer::write(const std::string& message) {
   ::send(fd_, message.c_str(), message.size(), MSG_DONTWAIT);
 }
 
+void Writer::writeBatch(const std::vector<absl::string_view>& datagrams) {
+#if defined(__linux__)
+  struct iovec iovecs[MAX_BATCH_SIZE];
+  struct mmsghdr headers[MAX_BATCH_SIZE];
+  for (size_t batch_start = 0; batch_start < datagrams.size(); batch_start += MAX_BATCH_SIZE) {
+    const size_t count = std::min(datagrams.size() - batch_start, MAX_BATCH_SIZE);
+    memset(headers, 0, sizeof(headers[0]) * count);
+    for (size_t i = 0; i < count; i++) {
+      const absl::string_view datagram = datagrams[batch_start + i];
+      iovecs[i].iov_base = const_cast<char*>(datagram.data());
+      iovecs[i].iov_len = datagram.size();
+      headers[i].msg_hdr.msg_iov = &iovecs[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // sendmmsg() stops at the first datagram that fails. Drop that one and carry on with the rest
+    // of the batch, which matches sending each datagram with write().
+    size_t sent = 0;
+    while (sent < count) {
+      const int rc = ::sendmmsg(fd_, &headers[sent], count - sent, MSG_DONTWAIT);
+      sent += rc > 0 ? rc : 1;
+    }
+  }
+#else
+  for (const absl::string_view datagram : datagrams) {
+    ::send(fd_, datagram.data(), datagram.size(), MSG_DONTWAIT);
+  }
+#endif
+}
+
+constexpr size_t Writer::MAX_BATCH_SIZE;
+constexpr size_t UdpStatsdSink::MAX_DATAGRAM_BYTES;
+constexpr std::chrono::milliseconds UdpStatsdSink::HISTOGRAM_FLUSH_INTERVAL;
+const char UdpStatsdSink::STAT_PREFIX[] = "envoy.";
+
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag)
     : tls_(tls.allocateSlot()), server_address_(std::move(address)), use_tag_(use_tag) {
-  tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
-    return std::make_shared<Writer>(this->server_address_);
+  tls_->set([this](Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<TlsSink>(std::make_shared<Writer>(this->server_address_), dispatcher);
   });
 }
 
 void UdpStatsdSink::flushCounter(const Stats::Counter& counter, uint64_t delta) {
-  const std::string message(
-      fmt::format("envoy.{}:{}|c{}", getName(counter), delta, buildTagStr(counter.tags())));
-  tls_->getTyped<Writer>().write(message);
+  addLine(counter, delta, "c");
 }
 
 void UdpStatsdSink::flushGauge(const Stats::Gauge& gauge, uint64_t value) {
-  const std::string message(
-      fmt::format("envoy.{}:{}|g{}", getName(gauge), value, buildTagStr(gauge.tags())));
-  tls_->getTyped<Writer>().write(message);
+  addLine(gauge, value, "g");
 }
 
+void UdpStatsdSink::endFlush() { tls_->getTyped<TlsSink>().flush(); }
+
 void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) {
   // For statsd histograms are all timers.
-  const std::string message(fmt::format("envoy.{}:{}|ms{}", getName(histogram),
-                                        std::chrono::milliseconds(value).count(),
-                                        buildTagStr(histogram.tags())));
-  tls_->getTyped<Writer>().write(message);
+  addLine(histogram, std::chrono::milliseconds(value).count(), "ms");
+  // Histograms complete on workers outside of any flush, so their lines are sent once a datagram
+  // fills up or when the flush timer fires, whichever happens first.
+  tls_->getTyped<TlsSink>().enableFlushTimer();
 }
 
-const std::string UdpStatsdSink::getName(const Stats::Metric& metric) {
+void UdpStatsdSink::addLine(const Stats::Metric& metric, uint64_t value, absl::string_view type) {
+  TlsSink& tls_sink = tls_->getTyped<TlsSink>();
+
+  // Produces something like "envoy.{}:{}|c|#{}:{}" directly in the datagram buffer, avoiding a
+  // temporary string per line.
+  std::string& buffer = tls_sink.startLine();
+  buffer.append(STAT_PREFIX, sizeof(STAT_PREFIX) - 1);
   if (use_tag_) {
-    return metric.tagExtractedName();
+    buffer.append(metric.tagExtractedName());
   } else {
-    return metric.name();
+    buffer.append(metric.name());
   }
+  buffer.push_back(':');
+  char value_str[StringUtil::MIN_ITOA_OUT_LEN];
+  buffer.append(value_str, StringUtil::itoa(value_str, sizeof(value_str), value));
+  buffer.push_back('|');
+  buffer.append(type.data(), type.size());
+  if (use_tag_) {
+    appendTags(buffer, metric.tags());
+  }
+  tls_sink.endLine();
 }
 
-const std::string UdpStatsdSink::buildTagStr(const std::vector<Stats::Tag>& tags) {
-  if (!use_tag_ || tags.empty()) {
-    return "";
+void UdpStatsdSink::appendTags(std::string& buffer, const std::vector<Stats::Tag>& tags) {
+  if (tags.empty()) {
+    return;
+  }
+
+  buffer.append("|#");
+  for (size_t i = 0; i < tags.size(); i++) {
+    if (i > 0) {
+      buffer.push_back(',');
+    }
+    buffer.append(tags[i].name_);
+    buffer.push_back(':');
+    buffer.append(tags[i].value_);
+  }
+}
+
+UdpStatsdSink::TlsSink::TlsSink(std::shared_ptr<Writer> writer, Event::Dispatcher& dispatcher)
+    : writer_(std::move(writer)), flush_timer_(dispatcher.createTimer([this]() -> void {
+        flush_timer_enabled_ = false;
+        flush();
+      })) {}
+
+UdpStatsdSink::TlsSink::~TlsSink() { flush(); }
+
+std::string& UdpStatsdSink::TlsSink::startLine() {
+  line_start_ = buffer_.size();
+  if (line_start_ > datagram_start_) {
+    buffer_.push_back('\n');
+  }
+  return buffer_;
+}
+
+void UdpStatsdSink::TlsSink::endLine() {
+  if (buffer_.size() - datagram_start_ > MAX_DATAGRAM_BYTES && line_start_ > datagram_start_) {
+    // The line does not fit in the current datagram. Complete that one and move the line, minus
+    // its leading separator, to the start of the next.
+    datagram_ends_.push_back(line_start_);
+    buffer_.erase(line_start_, 1);
+    datagram_start_ = line_start_;
+    if (datagram_ends_.size() == Writer::MAX_BATCH_SIZE) {
+      writeCompleteDatagrams();
+    }
+  }
+}
+
+void UdpStatsdSink::TlsSink::enableFlushTimer() {
+  if (!flush_timer_enabled_ && buffer_.size() > 0) {
+    flush_timer_->enableTimer(HISTOGRAM_FLUSH_INTERVAL);
+    flush_timer_enabled_ = true;
+  }
+}
+
+void UdpStatsdSink::TlsSink::flush() {
+  if (buffer_.size() > datagram_start_) {
+    datagram_ends_.push_back(buffer_.size());
+    datagram_start_ = buffer_.size();
+  }
+  writeCompleteDatagrams();
+}
+
+void UdpStatsdSink::TlsSink::writeCompleteDatagrams() {
+  if (datagram_ends_.empty()) {
+    return;
   }
 
-  std::vector<std::string> tag_strings;
-  tag_strings.reserve(tags.size());
-  for (const Stats::Tag& tag : tags) {
-    tag_strings.emplace_back(tag.name_ + ":" + tag.value_);
+  datagrams_.clear();
+  size_t start = 0;
+  for (const size_t end : datagram_ends_) {
+    datagrams_.emplace_back(buffer_.data() + start, end - start);
+    start = end;
   }
-  return "|#" + StringUtil::join(tag_strings, ",");
+  writer_->writeBatch(datagrams_);
+
+  // Keep the datagram still being built, if any, at the front of the buffer.
+  ASSERT(start == datagram_start_);
+  buffer_.erase(0, datagram_start_);
+  line_start_ -= std::min(line_start_, datagram_start_);
+  datagram_start_ = 0;
+  datagram_ends_.clear();
 }
 
 char TcpStatsdSink::STAT_PREFIX[] = "envoy.";
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
 #include "envoy/local_info/local_info.h"
 #include "envoy/network/connection.h"
 #include "envoy/stats/stats.h"
@@ -8,6 +15,8 @@
 
 #include "common/buffer/buffer_impl.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace StatSinks {
@@ -24,10 +33,24 @@ public:
   Writer() : fd_(-1) {}
   virtual ~Writer();
 
+  /**
+   * Send a single datagram.
+   */
   virtual void write(const std::string& message);
+
+  /**
+   * Send a batch of datagrams. Where sendmmsg(2) is available up to MAX_BATCH_SIZE datagrams are
+   * sent per syscall. As with write(), datagrams that cannot be sent immediately are dropped.
+   * @param datagrams supplies the datagrams to send.
+   */
+  virtual void writeBatch(const std::vector<absl::string_view>& datagrams);
+
   // Called in unit test to validate address.
   int getFdForTests() const { return fd_; };
 
+  // Maximum number of datagrams handed to a single sendmmsg(2) call.
+  static constexpr size_t MAX_BATCH_SIZE = 64;
+
 private:
   int fd_;
 };
@@ -43,24 +66,70 @@ public:
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, const std::shared_ptr<Writer>& writer,
                 const bool use_tag)
       : tls_(tls.allocateSlot()), use_tag_(use_tag) {
-    tls_->set(
-        [writer](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr { return writer; });
+    tls_->set([writer](Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+      return std::make_shared<TlsSink>(writer, dispatcher);
+    });
   }
 
   // Stats::Sink
   void beginFlush() override {}
   void flushCounter(const Stats::Counter& counter, uint64_t delta) override;
   void flushGauge(const Stats::Gauge& gauge, uint64_t value) override;
-  void endFlush() override {}
+  void endFlush() override;
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override;
+  bool wantsChangedOnly() const override { return true; }
 
   // Called in unit test to validate writer construction and address.
-  int getFdForTests() { return tls_->getTyped<Writer>().getFdForTests(); }
+  int getFdForTests() { return tls_->getTyped<TlsSink>().writer_->getFdForTests(); }
   bool getUseTagForTest() { return use_tag_; }
 
+  // Largest datagram the sink builds. This fits in a 1500 byte Ethernet MTU after IPv6 and UDP
+  // headers, with some margin. A single line longer than this is sent in a datagram of its own.
+  static constexpr size_t MAX_DATAGRAM_BYTES = 1432;
+
+  // Histogram lines recorded on a thread are sent at most this long after being buffered.
+  static constexpr std::chrono::milliseconds HISTOGRAM_FLUSH_INTERVAL{1000};
+
 private:
-  const std::string getName(const Stats::Metric& metric);
-  const std::string buildTagStr(const std::vector<Stats::Tag>& tags);
+  /**
+   * Per thread buffer that packs newline separated statsd lines into datagrams of at most
+   * MAX_DATAGRAM_BYTES. Completed datagrams are stored back to back in a single reused string and
+   * sent in batches through the writer.
+   */
+  struct TlsSink : public ThreadLocal::ThreadLocalObject {
+    TlsSink(std::shared_ptr<Writer> writer, Event::Dispatcher& dispatcher);
+    ~TlsSink();
+
+    /**
+     * Start a new line. The caller appends the line to the returned buffer and then calls
+     * endLine().
+     * @return std::string& the buffer to append the line to.
+     */
+    std::string& startLine();
+    void endLine();
+    void enableFlushTimer();
+    void flush();
+    void writeCompleteDatagrams();
+
+    std::shared_ptr<Writer> writer_;
+    Event::TimerPtr flush_timer_;
+    bool flush_timer_enabled_{};
+    std::string buffer_;
+    // End offsets in buffer_ of completed datagrams not yet sent.
+    std::vector<size_t> datagram_ends_;
+    // Offset in buffer_ of the datagram being built.
+    size_t datagram_start_{};
+    // Offset in buffer_ of the line being built.
+    size_t line_start_{};
+    // Reused for each batch handed to the writer.
+    std::vector<absl::string_view> datagrams_;
+  };
+
+  void addLine(const Stats::Metric& metric, uint64_t value, absl::string_view type);
+  void appendTags(std::string& buffer, const std::vector<Stats::Tag>& tags);
+
+  // Prefix for all flushed stats.
+  static const char STAT_PREFIX[];
 
   ThreadLocal::SlotPtr tls_;
   Network::Address::InstanceConstSharedPtr server_address_;
@@ -95,6 +164,8 @@ public:
                                                  std::chrono::milliseconds(value));
   }
 
+  bool wantsChangedOnly() const override { return true; }
+
 private:
   struct TlsSink : public ThreadLocal::ThreadLocalObject, public Network::ConnectionCallbacks {
     TlsSink(TcpStatsdSink& parent, Event::Dispatcher& dispatcher);
@@ -144,6 +144,9 @@ public:
     // TODO : Need to figure out how to map existing histogram to Proto Model
   }
 
+  // Each message is a full snapshot of the counters and gauges.
+  bool wantsChangedOnly() const override { return false; }
+
 private:
   GrpcMetricsStreamerSharedPtr grpc_metrics_streamer_;
   envoy::service::metrics::v2::StreamMetricsMessage message_;
@@ -1,37 +1,63 @@
 #include "extensions/tracers/zipkin/span_buffer.h"
 
+#include "common/common/assert.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Tracers {
 namespace Zipkin {
 
-// TODO(fabolive): Need to avoid the copy to improve performance.
 bool SpanBuffer::addSpan(const Span& span) {
-  if (span_buffer_.size() == span_buffer_.capacity()) {
+  if (pending_spans_ == max_spans_) {
     // Buffer full
     return false;
   }
-  span_buffer_.push_back(std::move(span));
+
+  if (encoding_ == SpanEncoding::Thrift) {
+    ThriftWriter writer(serialized_spans_);
+    span.toThrift(writer);
+  } else {
+    if (pending_spans_ > 0) {
+      serialized_spans_.add(",", 1);
+    }
+    serialized_spans_.add(span.toJson());
+  }
+  pending_spans_++;
 
   return true;
 }
 
+void SpanBuffer::clear() {
+  serialized_spans_.drain(serialized_spans_.length());
+  pending_spans_ = 0;
+}
+
 std::string SpanBuffer::toStringifiedJsonArray() {
+  ASSERT(encoding_ == SpanEncoding::Json);
   std::string stringified_json_array = "[";
-
-  if (pendingSpans()) {
-    stringified_json_array += span_buffer_[0].toJson();
-    const uint64_t size = span_buffer_.size();
-    for (uint64_t i = 1; i < size; i++) {
-      stringified_json_array += ",";
-      stringified_json_array += span_buffer_[i].toJson();
-    }
+  const uint64_t length = serialized_spans_.length();
+  if (length > 0) {
+    stringified_json_array.append(
+        static_cast<const char*>(serialized_spans_.linearize(static_cast<uint32_t>(length))),
+        length);
   }
   stringified_json_array += "]";
 
   return stringified_json_array;
 }
 
+void SpanBuffer::drainTo(Buffer::Instance& output) {
+  if (encoding_ == SpanEncoding::Thrift) {
+    ThriftWriter(output).writeListBegin(ThriftType::Struct, pending_spans_);
+    output.move(serialized_spans_);
+  } else {
+    output.add("[", 1);
+    output.move(serialized_spans_);
+    output.add("]", 1);
+  }
+  pending_spans_ = 0;
+}
+
 } // namespace Zipkin
 } // namespace Tracers
 } // namespace Extensions
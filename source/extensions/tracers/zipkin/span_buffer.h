@@ -1,5 +1,7 @@
 #pragma once
 
+#include "common/buffer/buffer_impl.h"
+
 #include "extensions/tracers/zipkin/zipkin_core_types.h"
 
 namespace Envoy {
@@ -7,9 +9,20 @@ namespace Extensions {
 namespace Tracers {
 namespace Zipkin {
 
+/**
+ * Encodings that spans can be sent to a Zipkin collector in.
+ */
+enum class SpanEncoding {
+  // A JSON array of spans.
+  Json,
+  // A Thrift list of spans using the binary protocol.
+  Thrift,
+};
+
 /**
  * This class implements a simple buffer to store Zipkin tracing spans
- * prior to flushing them.
+ * prior to flushing them. Spans are serialized as they are added, so the
+ * buffer holds encoded bytes rather than copies of the spans.
  */
 class SpanBuffer {
 public:
@@ -27,14 +40,22 @@ public:
   SpanBuffer(uint64_t size) { allocateBuffer(size); }
 
   /**
-   * Allocates space for an empty buffer or resizes a previously-allocated one.
+   * Constructor that initializes a buffer with the given encoding and size.
    *
+   * @param encoding The encoding spans are serialized with.
    * @param size The desired buffer size.
    */
-  void allocateBuffer(uint64_t size) { span_buffer_.reserve(size); }
+  SpanBuffer(SpanEncoding encoding, uint64_t size) : encoding_(encoding) { allocateBuffer(size); }
 
   /**
-   * Adds the given Zipkin span to the buffer.
+   * Sets the maximum number of spans the buffer will hold.
+   *
+   * @param size The desired buffer size.
+   */
+  void allocateBuffer(uint64_t size) { max_spans_ = size; }
+
+  /**
+   * Serializes the given Zipkin span into the buffer.
    *
    * @param span The span to be added to the buffer.
    *
@@ -46,22 +67,39 @@ public:
    * Empties the buffer. This method is supposed to be called when all buffered spans
    * have been sent to to the Zipkin service.
    */
-  void clear() { span_buffer_.clear(); }
+  void clear();
 
   /**
    * @return the number of spans currently buffered.
    */
-  uint64_t pendingSpans() { return span_buffer_.size(); }
+  uint64_t pendingSpans() { return pending_spans_; }
+
+  /**
+   * @return the encoding spans are serialized with.
+   */
+  SpanEncoding encoding() const { return encoding_; }
 
   /**
    * @return the contents of the buffer as a stringified array of JSONs, where
-   * each JSON in the array corresponds to one Zipkin span.
+   * each JSON in the array corresponds to one Zipkin span. Only valid for the JSON encoding.
    */
   std::string toStringifiedJsonArray();
 
+  /**
+   * Moves the buffered spans, framed as a complete collector request body, into the given
+   * buffer. The span buffer is left empty.
+   *
+   * @param output The buffer to write the request body to.
+   */
+  void drainTo(Buffer::Instance& output);
+
 private:
-  // We use a pre-allocated vector to improve performance
-  std::vector<Span> span_buffer_;
+  SpanEncoding encoding_{SpanEncoding::Json};
+  uint64_t max_spans_{};
+  uint64_t pending_spans_{};
+  // The serialized spans. For JSON they are comma separated; the array brackets (or the Thrift
+  // list header, which needs the final count) are only added when the buffer is drained.
+  Buffer::OwnedImpl serialized_spans_;
 };
 
 } // namespace Zipkin
@@ -0,0 +1,52 @@
+#include "extensions/tracers/zipkin/thrift_writer.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Zipkin {
+
+void ThriftWriter::writeFieldBegin(ThriftType type, int16_t id) {
+  writeByte(static_cast<uint8_t>(type));
+  writeI16(id);
+}
+
+void ThriftWriter::writeFieldStop() { writeByte(static_cast<uint8_t>(ThriftType::Stop)); }
+
+void ThriftWriter::writeListBegin(ThriftType element_type, uint32_t size) {
+  writeByte(static_cast<uint8_t>(element_type));
+  writeI32(static_cast<int32_t>(size));
+}
+
+void ThriftWriter::writeBool(bool value) { writeByte(value ? 1 : 0); }
+
+void ThriftWriter::writeI16(int16_t value) {
+  const uint16_t v = static_cast<uint16_t>(value);
+  const uint8_t bytes[] = {static_cast<uint8_t>(v >> 8), static_cast<uint8_t>(v)};
+  buffer_.add(bytes, sizeof(bytes));
+}
+
+void ThriftWriter::writeI32(int32_t value) {
+  const uint32_t v = static_cast<uint32_t>(value);
+  const uint8_t bytes[] = {static_cast<uint8_t>(v >> 24), static_cast<uint8_t>(v >> 16),
+                           static_cast<uint8_t>(v >> 8), static_cast<uint8_t>(v)};
+  buffer_.add(bytes, sizeof(bytes));
+}
+
+void ThriftWriter::writeI64(int64_t value) {
+  const uint64_t v = static_cast<uint64_t>(value);
+  uint8_t bytes[8];
+  for (int i = 0; i < 8; i++) {
+    bytes[i] = static_cast<uint8_t>(v >> (56 - 8 * i));
+  }
+  buffer_.add(bytes, sizeof(bytes));
+}
+
+void ThriftWriter::writeString(absl::string_view value) {
+  writeI32(static_cast<int32_t>(value.size()));
+  buffer_.add(value.data(), value.size());
+}
+
+} // namespace Zipkin
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
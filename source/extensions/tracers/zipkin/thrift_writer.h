@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/buffer/buffer.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Zipkin {
+
+/**
+ * Thrift field types used by the Zipkin span model.
+ */
+enum class ThriftType : uint8_t {
+  Stop = 0,
+  Bool = 2,
+  I16 = 6,
+  I32 = 8,
+  I64 = 10,
+  String = 11,
+  Struct = 12,
+  List = 15,
+};
+
+/**
+ * Writes values encoded with the Thrift binary protocol directly into a buffer. Only the subset of
+ * the protocol needed to encode Zipkin spans is supported.
+ */
+class ThriftWriter {
+public:
+  ThriftWriter(Buffer::Instance& buffer) : buffer_(buffer) {}
+
+  /**
+   * Writes the header of a struct field.
+   * @param type supplies the field type.
+   * @param id supplies the field id.
+   */
+  void writeFieldBegin(ThriftType type, int16_t id);
+
+  /**
+   * Writes the marker that ends a struct.
+   */
+  void writeFieldStop();
+
+  /**
+   * Writes the header of a list.
+   * @param element_type supplies the type of the list elements.
+   * @param size supplies the number of elements that follow.
+   */
+  void writeListBegin(ThriftType element_type, uint32_t size);
+
+  void writeBool(bool value);
+  void writeI16(int16_t value);
+  void writeI32(int32_t value);
+  void writeI64(int64_t value);
+
+  /**
+   * Writes a length prefixed string or binary value.
+   */
+  void writeString(absl::string_view value);
+
+private:
+  void writeByte(uint8_t value) { buffer_.add(&value, sizeof(value)); }
+
+  Buffer::Instance& buffer_;
+};
+
+} // namespace Zipkin
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
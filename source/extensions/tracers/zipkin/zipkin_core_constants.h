@@ -40,6 +40,7 @@ public:
   const std::string NOT_SAMPLED = "0";
 
   const std::string DEFAULT_COLLECTOR_ENDPOINT = "/api/v1/spans";
+  const std::string THRIFT_CONTENT_TYPE = "application/x-thrift";
 };
 
 typedef ConstSingleton<ZipkinCoreConstantValues> ZipkinCoreConstants;
@@ -1,5 +1,7 @@
 #include "extensions/tracers/zipkin/zipkin_core_types.h"
 
+#include <arpa/inet.h>
+
 #include "common/common/utility.h"
 
 #include "extensions/tracers/zipkin/span_context.h"
@@ -26,7 +28,7 @@ Endpoint& Endpoint::operator=(const Endpoint& ep) {
   return *this;
 }
 
-const std::string Endpoint::toJson() {
+const std::string Endpoint::toJson() const {
   rapidjson::StringBuffer s;
   rapidjson::Writer<rapidjson::StringBuffer> writer(s);
   writer.StartObject();
@@ -55,6 +57,32 @@ const std::string Endpoint::toJson() {
   return json_string;
 }
 
+void Endpoint::toThrift(ThriftWriter& writer) const {
+  // Field ids follow zipkinCore.thrift. The ipv4 field is required, so it is written as 0 when the
+  // address is IPv6 or unknown.
+  uint32_t ipv4 = 0;
+  uint16_t port = 0;
+  if (address_) {
+    port = address_->ip()->port();
+    if (address_->ip()->version() == Network::Address::IpVersion::v4) {
+      ipv4 = ntohl(address_->ip()->ipv4()->address());
+    }
+  }
+  writer.writeFieldBegin(ThriftType::I32, 1);
+  writer.writeI32(static_cast<int32_t>(ipv4));
+  writer.writeFieldBegin(ThriftType::I16, 2);
+  writer.writeI16(static_cast<int16_t>(port));
+  writer.writeFieldBegin(ThriftType::String, 3);
+  writer.writeString(service_name_);
+  if (address_ && address_->ip()->version() == Network::Address::IpVersion::v6) {
+    // The address is already in network byte order, which is what the binary field expects.
+    const absl::uint128 ipv6 = address_->ip()->ipv6()->address();
+    writer.writeFieldBegin(ThriftType::String, 4);
+    writer.writeString(absl::string_view(reinterpret_cast<const char*>(&ipv6), sizeof(ipv6)));
+  }
+  writer.writeFieldStop();
+}
+
 Annotation::Annotation(const Annotation& ann) {
   timestamp_ = ann.timestamp();
   value_ = ann.value();
@@ -79,7 +107,7 @@ void Annotation::changeEndpointServiceName(const std::string& service_name) {
   }
 }
 
-const std::string Annotation::toJson() {
+const std::string Annotation::toJson() const {
   rapidjson::StringBuffer s;
   rapidjson::Writer<rapidjson::StringBuffer> writer(s);
   writer.StartObject();
@@ -99,6 +127,18 @@ const std::string Annotation::toJson() {
   return json_string;
 }
 
+void Annotation::toThrift(ThriftWriter& writer) const {
+  writer.writeFieldBegin(ThriftType::I64, 1);
+  writer.writeI64(timestamp_);
+  writer.writeFieldBegin(ThriftType::String, 2);
+  writer.writeString(value_);
+  if (endpoint_) {
+    writer.writeFieldBegin(ThriftType::Struct, 3);
+    endpoint_.value().toThrift(writer);
+  }
+  writer.writeFieldStop();
+}
+
 BinaryAnnotation::BinaryAnnotation(const BinaryAnnotation& ann) {
   key_ = ann.key();
   value_ = ann.value();
@@ -119,7 +159,7 @@ BinaryAnnotation& BinaryAnnotation::operator=(const BinaryAnnotation& ann) {
   return *this;
 }
 
-const std::string BinaryAnnotation::toJson() {
+const std::string BinaryAnnotation::toJson() const {
   rapidjson::StringBuffer s;
   rapidjson::Writer<rapidjson::StringBuffer> writer(s);
   writer.StartObject();
@@ -139,6 +179,26 @@ const std::string BinaryAnnotation::toJson() {
   return json_string;
 }
 
+void BinaryAnnotation::toThrift(ThriftWriter& writer) const {
+  // zipkinCore.thrift numbers annotation types BOOL = 0 and STRING = 6.
+  writer.writeFieldBegin(ThriftType::String, 1);
+  writer.writeString(key_);
+  writer.writeFieldBegin(ThriftType::String, 2);
+  if (annotation_type_ == BOOL) {
+    const char value = value_ == "true" ? 1 : 0;
+    writer.writeString(absl::string_view(&value, 1));
+  } else {
+    writer.writeString(value_);
+  }
+  writer.writeFieldBegin(ThriftType::I32, 3);
+  writer.writeI32(annotation_type_ == BOOL ? 0 : 6);
+  if (endpoint_) {
+    writer.writeFieldBegin(ThriftType::Struct, 4);
+    endpoint_.value().toThrift(writer);
+  }
+  writer.writeFieldStop();
+}
+
 const std::string Span::EMPTY_HEX_STRING_ = "0000000000000000";
 
 Span::Span(const Span& span) {
@@ -171,7 +231,7 @@ void Span::setServiceName(const std::string& service_name) {
   }
 }
 
-const std::string Span::toJson() {
+const std::string Span::toJson() const {
   rapidjson::StringBuffer s;
   rapidjson::Writer<rapidjson::StringBuffer> writer(s);
   writer.StartObject();
@@ -219,6 +279,54 @@ const std::string Span::toJson() {
   return json_string;
 }
 
+void Span::toThrift(ThriftWriter& writer) const {
+  writer.writeFieldBegin(ThriftType::I64, 1);
+  writer.writeI64(trace_id_);
+  writer.writeFieldBegin(ThriftType::String, 3);
+  writer.writeString(name_);
+  writer.writeFieldBegin(ThriftType::I64, 4);
+  writer.writeI64(id_);
+
+  if (parent_id_ && parent_id_.value()) {
+    writer.writeFieldBegin(ThriftType::I64, 5);
+    writer.writeI64(parent_id_.value());
+  }
+
+  writer.writeFieldBegin(ThriftType::List, 6);
+  writer.writeListBegin(ThriftType::Struct, annotations_.size());
+  for (const Annotation& annotation : annotations_) {
+    annotation.toThrift(writer);
+  }
+
+  writer.writeFieldBegin(ThriftType::List, 8);
+  writer.writeListBegin(ThriftType::Struct, binary_annotations_.size());
+  for (const BinaryAnnotation& binary_annotation : binary_annotations_) {
+    binary_annotation.toThrift(writer);
+  }
+
+  if (debug_) {
+    writer.writeFieldBegin(ThriftType::Bool, 9);
+    writer.writeBool(true);
+  }
+
+  if (timestamp_) {
+    writer.writeFieldBegin(ThriftType::I64, 10);
+    writer.writeI64(timestamp_.value());
+  }
+
+  if (duration_) {
+    writer.writeFieldBegin(ThriftType::I64, 11);
+    writer.writeI64(duration_.value());
+  }
+
+  if (trace_id_high_) {
+    writer.writeFieldBegin(ThriftType::I64, 12);
+    writer.writeI64(trace_id_high_.value());
+  }
+
+  writer.writeFieldStop();
+}
+
 void Span::finish() {
   // Assumption: Span will have only one annotation when this method is called
   SpanContext context(*this);
@@ -7,6 +7,7 @@
 
 #include "common/common/hex.h"
 
+#include "extensions/tracers/zipkin/thrift_writer.h"
 #include "extensions/tracers/zipkin/tracer_interface.h"
 #include "extensions/tracers/zipkin/util.h"
 
@@ -32,7 +33,13 @@ public:
    * All classes defining Zipkin abstractions need to implement this method to convert
    * the corresponding abstraction to a Zipkin-compliant JSON.
    */
-  virtual const std::string toJson() PURE;
+  virtual const std::string toJson() const PURE;
+
+  /**
+   * All classes defining Zipkin abstractions need to implement this method to write the
+   * corresponding abstraction as a struct of Zipkin's Thrift model.
+   */
+  virtual void toThrift(ThriftWriter& writer) const PURE;
 };
 
 /**
@@ -90,7 +97,12 @@ public:
    *
    * @return a stringified JSON.
    */
-  const std::string toJson() override;
+  const std::string toJson() const override;
+
+  /**
+   * Writes the endpoint as a Thrift struct.
+   */
+  void toThrift(ThriftWriter& writer) const override;
 
 private:
   std::string service_name_;
@@ -182,7 +194,12 @@ public:
    *
    * @return a stringified JSON.
    */
-  const std::string toJson() override;
+  const std::string toJson() const override;
+
+  /**
+   * Writes the annotation as a Thrift struct.
+   */
+  void toThrift(ThriftWriter& writer) const override;
 
 private:
   uint64_t timestamp_;
@@ -280,7 +297,12 @@ public:
    *
    * @return a stringified JSON.
    */
-  const std::string toJson() override;
+  const std::string toJson() const override;
+
+  /**
+   * Writes the binary annotation as a Thrift struct.
+   */
+  void toThrift(ThriftWriter& writer) const override;
 
 private:
   std::string key_;
@@ -508,7 +530,12 @@ public:
    *
    * @return a stringified JSON.
    */
-  const std::string toJson() override;
+  const std::string toJson() const override;
+
+  /**
+   * Writes the span as a Thrift struct.
+   */
+  void toThrift(ThriftWriter& writer) const override;
 
   /**
    * Associates a Tracer object with the span. The tracer's reportSpan() method is invoked
@@ -55,7 +55,8 @@ Driver::Driver(const Json::Object& config, Upstream::ClusterManager& cluster_man
                Stats::Store& stats, ThreadLocal::SlotAllocator& tls, Runtime::Loader& runtime,
                const LocalInfo::LocalInfo& local_info, Runtime::RandomGenerator& random_generator)
     : cm_(cluster_manager), tracer_stats_{ZIPKIN_TRACER_STATS(
-                                POOL_COUNTER_PREFIX(stats, "tracing.zipkin."))},
+                                POOL_COUNTER_PREFIX(stats, "tracing.zipkin."),
+                                POOL_GAUGE_PREFIX(stats, "tracing.zipkin."))},
       tls_(tls.allocateSlot()), runtime_(runtime), local_info_(local_info) {
 
   Upstream::ThreadLocalCluster* cluster = cm_.get(config.getString("collector_cluster"));
@@ -68,12 +69,22 @@ Driver::Driver(const Json::Object& config, Upstream::ClusterManager& cluster_man
   const std::string collector_endpoint =
       config.getString("collector_endpoint", ZipkinCoreConstants::get().DEFAULT_COLLECTOR_ENDPOINT);
 
-  tls_->set([this, collector_endpoint, &random_generator](
+  const std::string collector_encoding = config.getString("collector_encoding", "JSON");
+  SpanEncoding encoding;
+  if (collector_encoding == "JSON") {
+    encoding = SpanEncoding::Json;
+  } else if (collector_encoding == "THRIFT") {
+    encoding = SpanEncoding::Thrift;
+  } else {
+    throw EnvoyException(fmt::format("unknown zipkin collector encoding '{}'", collector_encoding));
+  }
+
+  tls_->set([this, collector_endpoint, encoding, &random_generator](
                 Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     TracerPtr tracer(
         new Tracer(local_info_.clusterName(), local_info_.address(), random_generator));
-    tracer->setReporter(
-        ReporterImpl::NewInstance(std::ref(*this), std::ref(dispatcher), collector_endpoint));
+    tracer->setReporter(ReporterImpl::NewInstance(std::ref(*this), std::ref(dispatcher),
+                                                  collector_endpoint, encoding));
     return ThreadLocal::ThreadLocalObjectSharedPtr{new TlsTracer(std::move(tracer), *this)};
   });
 }
@@ -120,8 +131,8 @@ Tracing::SpanPtr Driver::startSpan(const Tracing::Config& config, Http::HeaderMa
 }
 
 ReporterImpl::ReporterImpl(Driver& driver, Event::Dispatcher& dispatcher,
-                           const std::string& collector_endpoint)
-    : driver_(driver), collector_endpoint_(collector_endpoint) {
+                           const std::string& collector_endpoint, SpanEncoding encoding)
+    : driver_(driver), span_buffer_(encoding, 0), collector_endpoint_(collector_endpoint) {
   flush_timer_ = dispatcher.createTimer([this]() -> void {
     driver_.tracerStats().timer_flushed_.inc();
     flushSpans();
@@ -135,14 +146,18 @@ ReporterImpl::ReporterImpl(Driver& driver, Event::Dispatcher& dispatcher,
   enableTimer();
 }
 
+ReporterImpl::~ReporterImpl() { driver_.tracerStats().reports_pending_.sub(pending_reports_); }
+
 ReporterPtr ReporterImpl::NewInstance(Driver& driver, Event::Dispatcher& dispatcher,
-                                      const std::string& collector_endpoint) {
-  return ReporterPtr(new ReporterImpl(driver, dispatcher, collector_endpoint));
+                                      const std::string& collector_endpoint,
+                                      SpanEncoding encoding) {
+  return ReporterPtr(new ReporterImpl(driver, dispatcher, collector_endpoint, encoding));
 }
 
-// TODO(fabolive): Need to avoid the copy to improve performance.
 void ReporterImpl::reportSpan(const Span& span) {
-  span_buffer_.addSpan(span);
+  if (!span_buffer_.addSpan(span)) {
+    driver_.tracerStats().spans_dropped_.inc();
+  }
 
   const uint64_t min_flush_spans =
       driver_.runtime().snapshot().getInteger("tracing.zipkin.min_flush_spans", 5U);
@@ -160,35 +175,60 @@ void ReporterImpl::enableTimer() {
 
 void ReporterImpl::flushSpans() {
   if (span_buffer_.pendingSpans()) {
+    const uint64_t max_pending_reports =
+        driver_.runtime().snapshot().getInteger("tracing.zipkin.max_pending_reports", 8U);
+    if (pending_reports_ >= max_pending_reports) {
+      // The collector is not keeping up. Drop the spans rather than queue more requests behind it.
+      driver_.tracerStats().reports_throttled_.inc();
+      driver_.tracerStats().spans_dropped_.add(span_buffer_.pendingSpans());
+      span_buffer_.clear();
+      return;
+    }
+
     driver_.tracerStats().spans_sent_.add(span_buffer_.pendingSpans());
 
-    const std::string request_body = span_buffer_.toStringifiedJsonArray();
     Http::MessagePtr message(new Http::RequestMessageImpl());
     message->headers().insertMethod().value().setReference(Http::Headers::get().MethodValues.Post);
     message->headers().insertPath().value(collector_endpoint_);
     message->headers().insertHost().value(driver_.cluster()->name());
-    message->headers().insertContentType().value().setReference(
-        Http::Headers::get().ContentTypeValues.Json);
+    if (span_buffer_.encoding() == SpanEncoding::Thrift) {
+      message->headers().insertContentType().value().setReference(
+          ZipkinCoreConstants::get().THRIFT_CONTENT_TYPE);
+    } else {
+      message->headers().insertContentType().value().setReference(
+          Http::Headers::get().ContentTypeValues.Json);
+    }
 
     Buffer::InstancePtr body(new Buffer::OwnedImpl());
-    body->add(request_body);
+    span_buffer_.drainTo(*body);
     message->body() = std::move(body);
 
+    // The request can fail inline, which completes it before send() returns.
+    pending_reports_++;
+    driver_.tracerStats().reports_pending_.inc();
+
     const uint64_t timeout =
         driver_.runtime().snapshot().getInteger("tracing.zipkin.request_timeout", 5000U);
     driver_.clusterManager()
         .httpAsyncClientForCluster(driver_.cluster()->name())
         .send(std::move(message), *this, std::chrono::milliseconds(timeout));
+  }
+}
 
-    span_buffer_.clear();
+void ReporterImpl::onReportComplete() {
+  if (pending_reports_ > 0) {
+    pending_reports_--;
+    driver_.tracerStats().reports_pending_.dec();
   }
 }
 
 void ReporterImpl::onFailure(Http::AsyncClient::FailureReason) {
+  onReportComplete();
   driver_.tracerStats().reports_failed_.inc();
 }
 
 void ReporterImpl::onSuccess(Http::MessagePtr&& http_response) {
+  onReportComplete();
   if (Http::Utility::getResponseStatus(http_response->headers()) !=
       enumToInt(Http::Code::Accepted)) {
     driver_.tracerStats().reports_dropped_.inc();
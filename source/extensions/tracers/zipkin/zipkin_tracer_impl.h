@@ -17,15 +17,18 @@ namespace Extensions {
 namespace Tracers {
 namespace Zipkin {
 
-#define ZIPKIN_TRACER_STATS(COUNTER)                                                               \
+#define ZIPKIN_TRACER_STATS(COUNTER, GAUGE)                                                        \
   COUNTER(spans_sent)                                                                              \
+  COUNTER(spans_dropped)                                                                           \
   COUNTER(timer_flushed)                                                                           \
   COUNTER(reports_sent)                                                                            \
   COUNTER(reports_dropped)                                                                         \
-  COUNTER(reports_failed)
+  COUNTER(reports_failed)                                                                          \
+  COUNTER(reports_throttled)                                                                       \
+  GAUGE(reports_pending)
 
 struct ZipkinTracerStats {
-  ZIPKIN_TRACER_STATS(GENERATE_COUNTER_STRUCT)
+  ZIPKIN_TRACER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
 };
 
 /**
@@ -133,7 +136,7 @@ private:
 /**
  * This class derives from the abstract Zipkin::Reporter.
  * It buffers spans and relies on Http::AsyncClient to send spans to
- * Zipkin using JSON over HTTP.
+ * Zipkin using JSON or binary Thrift over HTTP.
  *
  * Two runtime parameters control the span buffering/flushing behavior, namely:
  * tracing.zipkin.min_flush_spans and tracing.zipkin.flush_interval_ms.
@@ -142,7 +145,10 @@ private:
  * either when the buffer is full, or when a timer, set to `tracing.zipkin.flush_interval_ms`,
  * expires, whichever happens first.
  *
- * The default values for the runtime parameters are 5 spans and 5000ms.
+ * If the collector is slow, at most `tracing.zipkin.max_pending_reports` requests are kept in
+ * flight. Spans flushed while that many requests are outstanding are dropped.
+ *
+ * The default values for the runtime parameters are 5 spans, 5000ms, and 8 reports.
  */
 class ReporterImpl : public Reporter, Http::AsyncClient::Callbacks {
 public:
@@ -154,9 +160,11 @@ public:
    * @param collector_endpoint String representing the Zipkin endpoint to be used
    * when making HTTP POST requests carrying spans. This value comes from the
    * Zipkin-related tracing configuration.
+   * @param encoding The encoding spans are sent to the collector in.
    */
-  ReporterImpl(Driver& driver, Event::Dispatcher& dispatcher,
-               const std::string& collector_endpoint);
+  ReporterImpl(Driver& driver, Event::Dispatcher& dispatcher, const std::string& collector_endpoint,
+               SpanEncoding encoding);
+  ~ReporterImpl();
 
   /**
    * Implementation of Zipkin::Reporter::reportSpan().
@@ -180,11 +188,12 @@ public:
    * @param collector_endpoint String representing the Zipkin endpoint to be used
    * when making HTTP POST requests carrying spans. This value comes from the
    * Zipkin-related tracing configuration.
+   * @param encoding The encoding spans are sent to the collector in.
    *
    * @return Pointer to the newly-created ZipkinReporter.
    */
   static ReporterPtr NewInstance(Driver& driver, Event::Dispatcher& dispatcher,
-                                 const std::string& collector_endpoint);
+                                 const std::string& collector_endpoint, SpanEncoding encoding);
 
 private:
   /**
@@ -194,13 +203,20 @@ private:
 
   /**
    * Removes all spans from the span buffer and sends them to Zipkin using Http::AsyncClient.
+   * The spans are dropped instead if too many earlier reports are still in flight.
    */
   void flushSpans();
 
+  /**
+   * Called when an in flight report completes, successfully or not.
+   */
+  void onReportComplete();
+
   Driver& driver_;
   Event::TimerPtr flush_timer_;
   SpanBuffer span_buffer_;
   const std::string collector_endpoint_;
+  uint64_t pending_reports_{};
 };
 }
 } // namespace Tracers
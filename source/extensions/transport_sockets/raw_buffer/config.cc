@@ -15,7 +15,7 @@ Network::TransportSocketFactoryPtr UpstreamRawBufferSocketFactory::createTranspo
 }
 
 Network::TransportSocketFactoryPtr DownstreamRawBufferSocketFactory::createTransportSocketFactory(
-    const std::string&, const std::vector<std::string>&, bool, const Protobuf::Message&,
+    const std::vector<std::string>&, const Protobuf::Message&,
     Server::Configuration::TransportSocketFactoryContext&) {
   return std::make_unique<Network::RawBufferSocketFactory>();
 }
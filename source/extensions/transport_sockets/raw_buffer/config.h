@@ -34,8 +34,7 @@ class DownstreamRawBufferSocketFactory
       public RawBufferSocketFactory {
 public:
   Network::TransportSocketFactoryPtr createTransportSocketFactory(
-      const std::string& listener_name, const std::vector<std::string>& server_names,
-      bool skip_context_update, const Protobuf::Message& config,
+      const std::vector<std::string>& server_names, const Protobuf::Message& config,
       Server::Configuration::TransportSocketFactoryContext& context) override;
 };
 
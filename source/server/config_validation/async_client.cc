@@ -11,7 +11,7 @@ ValidationAsyncClient::send(MessagePtr&&, Callbacks&,
 
 AsyncClient::Stream* ValidationAsyncClient::start(StreamCallbacks&,
                                                   const absl::optional<std::chrono::milliseconds>&,
-                                                  bool) {
+                                                  bool, uint32_t) {
   return nullptr;
 }
 
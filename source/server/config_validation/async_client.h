@@ -24,7 +24,7 @@ public:
                              const absl::optional<std::chrono::milliseconds>& timeout) override;
   AsyncClient::Stream* start(StreamCallbacks& callbacks,
                              const absl::optional<std::chrono::milliseconds>& timeout,
-                             bool buffer_body_for_retry) override;
+                             bool buffer_body_for_retry, uint32_t buffer_limit) override;
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
 
 private:
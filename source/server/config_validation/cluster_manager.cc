@@ -9,7 +9,7 @@ ValidationClusterManagerFactory::ValidationClusterManagerFactory(
     Ssl::ContextManager& ssl_context_manager, Event::Dispatcher& main_thread_dispatcher,
     const LocalInfo::LocalInfo& local_info)
     : ProdClusterManagerFactory(runtime, stats, tls, random, dns_resolver, ssl_context_manager,
-                                main_thread_dispatcher, local_info) {}
+                                main_thread_dispatcher, local_info, {}) {}
 
 ClusterManagerPtr ValidationClusterManagerFactory::clusterManagerFromProto(
     const envoy::config::bootstrap::v2::Bootstrap& bootstrap, Stats::Store& stats,
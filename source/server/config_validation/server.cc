@@ -39,8 +39,7 @@ ValidationInstance::ValidationInstance(Options& options,
     : options_(options), stats_store_(store),
       api_(new Api::ValidationImpl(options.fileFlushIntervalMsec())),
       dispatcher_(api_->allocateDispatcher()), singleton_manager_(new Singleton::ManagerImpl()),
-      access_log_manager_(*api_, *dispatcher_, access_log_lock, store),
-      listener_manager_(*this, *this, *this) {
+      access_log_manager_(*api_, *dispatcher_, access_log_lock, store) {
   try {
     initialize(options, local_address, component_factory);
   } catch (const EnvoyException& e) {
@@ -76,6 +75,14 @@ void ValidationInstance::initialize(Options& options,
                                    options.serviceClusterName(), options.serviceNodeName()));
 
   Configuration::InitialImpl initial_config(bootstrap);
+  overload_manager_.reset(new OverloadManagerImpl(
+      dispatcher(), stats(), threadLocal(), bootstrap.overload_manager(),
+      [](const envoy::config::overload::v2alpha::ResourceMonitor& config) {
+        // No connections are accepted during validation.
+        return ResourceMonitorUtility::createResourceMonitor(config,
+                                                             []() -> uint64_t { return 0; });
+      }));
+  listener_manager_.reset(new ListenerManagerImpl(*this, *this, *this));
   thread_local_.registerThread(*dispatcher_, true);
   runtime_loader_ = component_factory.createRuntime(*this, initial_config);
   ssl_context_manager_.reset(new Ssl::ContextManagerImpl(*runtime_loader_));
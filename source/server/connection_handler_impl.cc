@@ -1,5 +1,7 @@
 #include "server/connection_handler_impl.h"
 
+#include <chrono>
+
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
 #include "envoy/network/filter.h"
@@ -11,11 +13,15 @@
 namespace Envoy {
 namespace Server {
 
-ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher)
-    : logger_(logger), dispatcher_(dispatcher) {}
+ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                                             const std::string& per_handler_stat_prefix)
+    : logger_(logger), dispatcher_(dispatcher), per_handler_stat_prefix_(per_handler_stat_prefix) {}
 
 void ConnectionHandlerImpl::addListener(Network::ListenerConfig& config) {
   ActiveListenerPtr l(new ActiveListener(*this, config));
+  if (listeners_disabled_ && l->listener_) {
+    l->listener_->disable();
+  }
   listeners_.emplace_back(config.socket().localAddress(), std::move(l));
 }
 
@@ -43,6 +49,24 @@ void ConnectionHandlerImpl::stopListeners() {
   }
 }
 
+void ConnectionHandlerImpl::disableListeners() {
+  listeners_disabled_ = true;
+  for (auto& listener : listeners_) {
+    if (listener.second->listener_) {
+      listener.second->listener_->disable();
+    }
+  }
+}
+
+void ConnectionHandlerImpl::enableListeners() {
+  listeners_disabled_ = false;
+  for (auto& listener : listeners_) {
+    if (listener.second->listener_) {
+      listener.second->listener_->enable();
+    }
+  }
+}
+
 void ConnectionHandlerImpl::ActiveListener::removeConnection(ActiveConnection& connection) {
   ENVOY_CONN_LOG_TO_LOGGER(parent_.logger_, debug, "adding to cleanup list",
                            *connection.connection_);
@@ -50,6 +74,46 @@ void ConnectionHandlerImpl::ActiveListener::removeConnection(ActiveConnection& c
   parent_.dispatcher_.deferredDelete(std::move(removed));
   ASSERT(parent_.num_connections_ > 0);
   parent_.num_connections_--;
+  decNumConnections();
+}
+
+void ConnectionHandlerImpl::ActiveListener::incNumConnections() {
+  if (balancer_ != nullptr) {
+    num_balanced_connections_++;
+    per_handler_stats_->downstream_cx_balanced_.inc();
+  }
+}
+
+void ConnectionHandlerImpl::ActiveListener::decNumConnections() {
+  if (balancer_ != nullptr) {
+    ASSERT(num_balanced_connections_ > 0);
+    num_balanced_connections_--;
+    per_handler_stats_->downstream_cx_balanced_.dec();
+  }
+}
+
+void ConnectionHandlerImpl::ActiveListener::post(Network::ConnectionSocketPtr&& socket) {
+  // Called on the worker that accepted the socket. The listener may be removed from this worker
+  // before the socket gets to it, so it is looked up again by tag once there, and the socket is
+  // closed if it is gone.
+  std::shared_ptr<Network::ConnectionSocketPtr> socket_to_rebalance =
+      std::make_shared<Network::ConnectionSocketPtr>(std::move(socket));
+  ConnectionHandlerImpl& parent = parent_;
+  const uint64_t listener_tag = listener_tag_;
+  const MonotonicTime posted_time = std::chrono::steady_clock::now();
+  parent_.dispatcher_.post([&parent, listener_tag, socket_to_rebalance, posted_time]() -> void {
+    ActiveListener* listener = parent.findActiveListenerByTag(listener_tag);
+    if (listener == nullptr) {
+      return;
+    }
+    listener->per_handler_stats_->downstream_cx_rebalanced_in_.inc();
+    listener->per_handler_stats_->downstream_cx_rebalance_handoff_us_.recordValue(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                              posted_time)
+            .count());
+    listener->onAcceptWorker(std::move(*socket_to_rebalance),
+                             listener->config_.handOffRestoredDestinationConnections(), true);
+  });
 }
 
 ConnectionHandlerImpl::ActiveListener::ActiveListener(ConnectionHandlerImpl& parent,
@@ -65,14 +129,23 @@ ConnectionHandlerImpl::ActiveListener::ActiveListener(ConnectionHandlerImpl& par
                                                       Network::ListenerConfig& config)
     : parent_(parent), listener_(std::move(listener)),
       stats_(generateStats(config.listenerScope())), listener_tag_(config.listenerTag()),
-      config_(config) {}
+      config_(config), balancer_(config.connectionBalancer()) {
+  if (balancer_ != nullptr) {
+    per_handler_stats_ = std::make_unique<PerHandlerListenerStats>(
+        generatePerHandlerStats(config.listenerScope(), parent.per_handler_stat_prefix_));
+    balancer_->registerHandler(*this);
+  }
+}
 
 ConnectionHandlerImpl::ActiveListener::~ActiveListener() {
+  if (balancer_ != nullptr) {
+    balancer_->unregisterHandler(*this);
+  }
+
   // Purge sockets that have not progressed to connections. This should only happen when
   // a listener filter stops iteration and never resumes.
   while (!sockets_.empty()) {
-    ActiveSocketPtr removed = sockets_.front()->removeFromList(sockets_);
-    parent_.dispatcher_.deferredDelete(std::move(removed));
+    sockets_.front()->unlink();
   }
 
   while (!connections_.empty()) {
@@ -117,6 +190,16 @@ ConnectionHandlerImpl::findActiveListenerByAddress(const Network::Address::Insta
   return (listener_it != listeners_.end()) ? listener_it->second.get() : nullptr;
 }
 
+ConnectionHandlerImpl::ActiveListener*
+ConnectionHandlerImpl::findActiveListenerByTag(uint64_t listener_tag) {
+  for (auto& listener : listeners_) {
+    if (listener.second->listener_tag_ == listener_tag) {
+      return listener.second.get();
+    }
+  }
+  return nullptr;
+}
+
 void ConnectionHandlerImpl::ActiveSocket::continueFilterChain(bool success) {
   if (success) {
     if (iter_ == accept_filters_.end()) {
@@ -134,35 +217,87 @@ void ConnectionHandlerImpl::ActiveSocket::continueFilterChain(bool success) {
       }
     }
     // Successfully ran all the accept filters.
-
-    // Check if the socket may need to be redirected to another listener.
-    ActiveListener* new_listener = nullptr;
-
-    if (hand_off_restored_destination_connections_ && socket_->localAddressRestored()) {
-      // Find a listener associated with the original destination address.
-      new_listener = listener_.parent_.findActiveListenerByAddress(*socket_->localAddress());
-    }
-    if (new_listener != nullptr) {
-      // Hands off connections redirected by iptables to the listener associated with the
-      // original destination address. Pass 'hand_off_restored_destionations' as false to
-      // prevent further redirection.
-      new_listener->onAccept(std::move(socket_), false);
-    } else {
-      // Create a new connection on this listener.
-      listener_.newConnection(std::move(socket_));
-    }
+    newConnection();
+  } else {
+    listener_.decNumConnections();
   }
 
   // Filter execution concluded, unlink and delete this ActiveSocket if it was linked.
   if (inserted()) {
-    ActiveSocketPtr removed = removeFromList(listener_.sockets_);
-    listener_.parent_.dispatcher_.deferredDelete(std::move(removed));
+    unlink();
+  }
+}
+
+void ConnectionHandlerImpl::ActiveSocket::startTimer() {
+  const std::chrono::milliseconds timeout = listener_.config_.listenerFiltersTimeout();
+  if (timeout.count() > 0) {
+    timer_ = listener_.parent_.dispatcher_.createTimer([this]() -> void { onTimeout(); });
+    timer_->enableTimer(timeout);
+  }
+}
+
+void ConnectionHandlerImpl::ActiveSocket::onTimeout() {
+  ENVOY_LOG_TO_LOGGER(listener_.parent_.logger_, debug, "listener filters timed out");
+  ASSERT(inserted());
+  listener_.stats_.downstream_pre_cx_timeout_.inc();
+
+  // Destroy the filters first, so that the one waiting for the socket doesn't run again.
+  accept_filters_.clear();
+  iter_ = accept_filters_.end();
+  if (listener_.config_.continueOnListenerFiltersTimeout()) {
+    newConnection();
+  } else {
+    listener_.decNumConnections();
+    socket_->close();
+  }
+  unlink();
+}
+
+void ConnectionHandlerImpl::ActiveSocket::newConnection() {
+  // Check if the socket may need to be redirected to another listener.
+  ActiveListener* new_listener = nullptr;
+
+  if (hand_off_restored_destination_connections_ && socket_->localAddressRestored()) {
+    // Find a listener associated with the original destination address.
+    new_listener = listener_.parent_.findActiveListenerByAddress(*socket_->localAddress());
+  }
+  if (new_listener != nullptr) {
+    // Hands off connections redirected by iptables to the listener associated with the
+    // original destination address. Pass 'hand_off_restored_destionations' as false to
+    // prevent further redirection. The connection stays on this worker.
+    listener_.decNumConnections();
+    new_listener->incNumConnections();
+    new_listener->onAcceptWorker(std::move(socket_), false, true);
+  } else {
+    // Create a new connection on this listener.
+    listener_.newConnection(std::move(socket_));
   }
 }
 
+void ConnectionHandlerImpl::ActiveSocket::unlink() {
+  if (timer_ != nullptr) {
+    timer_->disableTimer();
+  }
+  ActiveSocketPtr removed = removeFromList(listener_.sockets_);
+  listener_.stats_.downstream_pre_cx_active_.dec();
+  listener_.parent_.dispatcher_.deferredDelete(std::move(removed));
+}
+
 void ConnectionHandlerImpl::ActiveListener::onAccept(
     Network::ConnectionSocketPtr&& socket, bool hand_off_restored_destination_connections) {
-  Network::Address::InstanceConstSharedPtr local_address = socket->localAddress();
+  onAcceptWorker(std::move(socket), hand_off_restored_destination_connections, false);
+}
+
+void ConnectionHandlerImpl::ActiveListener::onAcceptWorker(
+    Network::ConnectionSocketPtr&& socket, bool hand_off_restored_destination_connections,
+    bool rebalanced) {
+  if (balancer_ != nullptr && !rebalanced) {
+    if (balancer_->balanceConnection(*this, socket)) {
+      per_handler_stats_->downstream_cx_rebalanced_out_.inc();
+      return;
+    }
+  }
+
   auto active_socket = std::make_unique<ActiveSocket>(*this, std::move(socket),
                                                       hand_off_restored_destination_connections);
 
@@ -173,35 +308,59 @@ void ConnectionHandlerImpl::ActiveListener::onAccept(
   // Move active_socket to the sockets_ list if filter iteration needs to continue later.
   // Otherwise we let active_socket be destructed when it goes out of scope.
   if (active_socket->iter_ != active_socket->accept_filters_.end()) {
+    active_socket->startTimer();
+    stats_.downstream_pre_cx_active_.inc();
     active_socket->moveIntoListBack(std::move(active_socket), sockets_);
   }
 }
 
 void ConnectionHandlerImpl::ActiveListener::newConnection(Network::ConnectionSocketPtr&& socket) {
+  // From here on the connection is counted once it is added to connections_, if it is.
+  decNumConnections();
+
+  // Find the filter chain matching what the listener filters found out about the connection.
+  const Network::FilterChain* filter_chain = config_.filterChainManager().findFilterChain(*socket);
+  if (filter_chain == nullptr) {
+    ENVOY_LOG_TO_LOGGER(parent_.logger_, debug,
+                        "closing connection: no matching filter chain found");
+    stats_.no_filter_chain_match_.inc();
+    socket->close();
+    return;
+  }
+
   Network::ConnectionPtr new_connection = parent_.dispatcher_.createServerConnection(
-      std::move(socket), config_.transportSocketFactory().createTransportSocket());
-  new_connection->setBufferLimits(config_.perConnectionBufferLimitBytes());
+      std::move(socket), filter_chain->transportSocketFactory().createTransportSocket());
+  uint32_t buffer_limit = config_.perConnectionBufferLimitBytes();
+  if (parent_.buffer_limit_cap_ != 0 &&
+      (buffer_limit == 0 || buffer_limit > parent_.buffer_limit_cap_)) {
+    buffer_limit = parent_.buffer_limit_cap_;
+  }
+  new_connection->setBufferLimits(buffer_limit);
+
+  const bool empty_filter_chain = !config_.filterChainFactory().createNetworkFilterChain(
+      *new_connection, filter_chain->networkFilterFactories());
+  if (empty_filter_chain) {
+    // Close the connection if the filter chain is empty to avoid leaving open connections
+    // with nothing to do.
+    ENVOY_CONN_LOG_TO_LOGGER(parent_.logger_, debug, "closing connection: no filters",
+                             *new_connection);
+    new_connection->close(Network::ConnectionCloseType::NoFlush);
+    return;
+  }
+
   onNewConnection(std::move(new_connection));
 }
 
 void ConnectionHandlerImpl::ActiveListener::onNewConnection(
     Network::ConnectionPtr&& new_connection) {
   ENVOY_CONN_LOG_TO_LOGGER(parent_.logger_, debug, "new connection", *new_connection);
-  bool empty_filter_chain = !config_.filterChainFactory().createNetworkFilterChain(*new_connection);
 
   // If the connection is already closed, we can just let this connection immediately die.
   if (new_connection->state() != Network::Connection::State::Closed) {
-    // Close the connection if the filter chain is empty to avoid leaving open connections
-    // with nothing to do.
-    if (empty_filter_chain) {
-      ENVOY_CONN_LOG_TO_LOGGER(parent_.logger_, debug, "closing connection: no filters",
-                               *new_connection);
-      new_connection->close(Network::ConnectionCloseType::NoFlush);
-    } else {
-      ActiveConnectionPtr active_connection(new ActiveConnection(*this, std::move(new_connection)));
-      active_connection->moveIntoList(std::move(active_connection), connections_);
-      parent_.num_connections_++;
-    }
+    ActiveConnectionPtr active_connection(new ActiveConnection(*this, std::move(new_connection)));
+    active_connection->moveIntoList(std::move(active_connection), connections_);
+    parent_.num_connections_++;
+    incNumConnections();
   }
 }
 
@@ -227,5 +386,12 @@ ListenerStats ConnectionHandlerImpl::generateStats(Stats::Scope& scope) {
   return {ALL_LISTENER_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
 }
 
+PerHandlerListenerStats ConnectionHandlerImpl::generatePerHandlerStats(Stats::Scope& scope,
+                                                                       const std::string& prefix) {
+  return {ALL_PER_HANDLER_LISTENER_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                         POOL_GAUGE_PREFIX(scope, prefix),
+                                         POOL_HISTOGRAM_PREFIX(scope, prefix))};
+}
+
 } // namespace Server
 } // namespace Envoy
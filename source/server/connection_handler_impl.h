@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <string>
 
 #include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
@@ -27,7 +28,10 @@ namespace Server {
 #define ALL_LISTENER_STATS(COUNTER, GAUGE, HISTOGRAM)                                              \
   COUNTER  (downstream_cx_total)                                                                   \
   COUNTER  (downstream_cx_destroy)                                                                 \
+  COUNTER  (no_filter_chain_match)                                                                 \
+  COUNTER  (downstream_pre_cx_timeout)                                                             \
   GAUGE    (downstream_cx_active)                                                                  \
+  GAUGE    (downstream_pre_cx_active)                                                              \
   HISTOGRAM(downstream_cx_length_ms)
 // clang-format on
 
@@ -38,13 +42,38 @@ struct ListenerStats {
   ALL_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
+/**
+ * Stats of the connection balancer of a listener, kept for each handler running the listener.
+ */
+// clang-format off
+#define ALL_PER_HANDLER_LISTENER_STATS(COUNTER, GAUGE, HISTOGRAM)                                  \
+  COUNTER  (downstream_cx_rebalanced_in)                                                           \
+  COUNTER  (downstream_cx_rebalanced_out)                                                          \
+  GAUGE    (downstream_cx_balanced)                                                                \
+  HISTOGRAM(downstream_cx_rebalance_handoff_us)
+// clang-format on
+
+/**
+ * Wrapper struct for per handler listener stats. @see stats_macros.h
+ */
+struct PerHandlerListenerStats {
+  ALL_PER_HANDLER_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                                 GENERATE_HISTOGRAM_STRUCT)
+};
+
 /**
  * Server side connection handler. This is used both by workers as well as the
  * main thread for non-threaded listeners.
  */
 class ConnectionHandlerImpl : public Network::ConnectionHandler, NonCopyable {
 public:
-  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher);
+  /**
+   * @param per_handler_stat_prefix supplies the prefix of the stats this handler keeps for each of
+   *        its listeners, to tell them apart from those of the other handlers running the same
+   *        listeners, e.g. "worker_0.".
+   */
+  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                        const std::string& per_handler_stat_prefix = "");
 
   // Network::ConnectionHandler
   uint64_t numConnections() override { return num_connections_; }
@@ -52,12 +81,16 @@ public:
   void removeListeners(uint64_t listener_tag) override;
   void stopListeners(uint64_t listener_tag) override;
   void stopListeners() override;
+  void disableListeners() override;
+  void enableListeners() override;
+  void setPerConnectionBufferLimitCap(uint32_t limit) override { buffer_limit_cap_ = limit; }
 
   Network::Listener* findListenerByAddress(const Network::Address::Instance& address) override;
 
 private:
   struct ActiveListener;
   ActiveListener* findActiveListenerByAddress(const Network::Address::Instance& address);
+  ActiveListener* findActiveListenerByTag(uint64_t listener_tag);
 
   struct ActiveConnection;
   typedef std::unique_ptr<ActiveConnection> ActiveConnectionPtr;
@@ -67,7 +100,8 @@ private:
   /**
    * Wrapper for an active listener owned by this handler.
    */
-  struct ActiveListener : public Network::ListenerCallbacks {
+  struct ActiveListener : public Network::ListenerCallbacks,
+                          public Network::BalancedConnectionHandler {
     ActiveListener(ConnectionHandlerImpl& parent, Network::ListenerConfig& config);
 
     ActiveListener(ConnectionHandlerImpl& parent, Network::ListenerPtr&& listener,
@@ -80,6 +114,24 @@ private:
                   bool hand_off_restored_destination_connections) override;
     void onNewConnection(Network::ConnectionPtr&& new_connection) override;
 
+    // Network::BalancedConnectionHandler
+    uint64_t numConnections() const override { return num_balanced_connections_; }
+    void incNumConnections() override;
+    void post(Network::ConnectionSocketPtr&& socket) override;
+
+    /**
+     * Stop counting a connection against this listener in the connection balancer, if any.
+     */
+    void decNumConnections();
+
+    /**
+     * Process a socket accepted by this worker.
+     * @param rebalanced supplies whether the connection balancer already picked this worker for
+     *        the socket, in which case the socket is not moved to another worker.
+     */
+    void onAcceptWorker(Network::ConnectionSocketPtr&& socket,
+                        bool hand_off_restored_destination_connections, bool rebalanced);
+
     /**
      * Remove and destroy an active connection.
      * @param connection supplies the connection to remove.
@@ -98,6 +150,12 @@ private:
     std::list<ActiveConnectionPtr> connections_;
     const uint64_t listener_tag_;
     Network::ListenerConfig& config_;
+    Network::ConnectionBalancer* const balancer_;
+    // Only set if the listener has a connection balancer.
+    std::unique_ptr<PerHandlerListenerStats> per_handler_stats_;
+    // Connections assigned to this listener by the balancer, counting accepted sockets that are
+    // still being processed by the listener filters or being handed over from another worker.
+    std::atomic<uint64_t> num_balanced_connections_{};
   };
 
   typedef std::unique_ptr<ActiveListener> ActiveListenerPtr;
@@ -151,19 +209,42 @@ private:
     Event::Dispatcher& dispatcher() override { return listener_.parent_.dispatcher_; }
     void continueFilterChain(bool success) override;
 
+    /**
+     * Start the listener filters timeout, if any, of a socket waiting for a listener filter.
+     */
+    void startTimer();
+    void onTimeout();
+
+    /**
+     * Create a connection from the socket, on this listener or the one the socket is handed off
+     * to, once the listener filters are done with it.
+     */
+    void newConnection();
+
+    /**
+     * Unlink this socket from the sockets waiting for listener filters and delete it.
+     */
+    void unlink();
+
     ActiveListener& listener_;
     Network::ConnectionSocketPtr socket_;
     const bool hand_off_restored_destination_connections_;
     std::list<Network::ListenerFilterPtr> accept_filters_;
     std::list<Network::ListenerFilterPtr>::iterator iter_;
+    Event::TimerPtr timer_;
   };
 
   static ListenerStats generateStats(Stats::Scope& scope);
+  static PerHandlerListenerStats generatePerHandlerStats(Stats::Scope& scope,
+                                                         const std::string& prefix);
 
   spdlog::logger& logger_;
   Event::Dispatcher& dispatcher_;
+  const std::string per_handler_stat_prefix_;
   std::list<std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerPtr>> listeners_;
   std::atomic<uint64_t> num_connections_{};
+  bool listeners_disabled_{};
+  uint32_t buffer_limit_cap_{};
 };
 
 } // Server
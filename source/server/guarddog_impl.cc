@@ -27,6 +27,7 @@ GuardDogImpl::GuardDogImpl(Stats::Scope& stats_scope, const Server::Configuratio
       }()),
       watchdog_miss_counter_(stats_scope.counter("server.watchdog_miss")),
       watchdog_megamiss_counter_(stats_scope.counter("server.watchdog_mega_miss")),
+      watchdog_touch_delay_(stats_scope.histogram("server.watchdog_touch_delay_ms")),
       run_thread_(true) {
   start();
 }
@@ -84,7 +85,7 @@ WatchDogSharedPtr GuardDogImpl::createWatchDog(int32_t thread_id) {
   // state).
   auto wd_interval = loop_interval_ / 2;
   WatchDogSharedPtr new_watchdog =
-      std::make_shared<WatchDogImpl>(thread_id, time_source_, wd_interval);
+      std::make_shared<WatchDogImpl>(thread_id, time_source_, wd_interval, watchdog_touch_delay_);
   WatchedDog watched_dog;
   watched_dog.dog_ = new_watchdog;
   {
@@ -32,7 +32,7 @@ class GuardDogImpl : public GuardDog {
 public:
   /**
    * @param stats_scope Statistics scope to write watchdog_miss and
-   * watchdog_mega_miss events into.
+   * watchdog_mega_miss events and watchdog_touch_delay_ms latencies into.
    * @param config Configuration object.
    *
    * See the configuration documentation for details on the timeout settings.
@@ -83,6 +83,7 @@ private:
   const std::chrono::milliseconds loop_interval_;
   Stats::Counter& watchdog_miss_counter_;
   Stats::Counter& watchdog_megamiss_counter_;
+  Stats::Histogram& watchdog_touch_delay_;
   std::vector<WatchedDog> watched_dogs_;
   std::mutex wd_lock_;
   Thread::ThreadPtr thread_;
@@ -5,9 +5,11 @@
 #include <sys/types.h>
 #include <sys/un.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
+#include "envoy/api/v2/discovery.pb.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/file_event.h"
 #include "envoy/server/instance.h"
@@ -17,6 +19,8 @@
 #include "common/common/fmt.h"
 #include "common/common/utility.h"
 #include "common/network/utility.h"
+#include "common/protobuf/utility.h"
+#include "common/upstream/host_utility.h"
 
 #include "absl/strings/string_view.h"
 
@@ -25,22 +29,22 @@ namespace Server {
 
 // Increment this whenever there is a shared memory / RPC change that will prevent a hot restart
 // from working. Operations code can then cope with this and do a full restart.
-const uint64_t SharedMemory::VERSION = 9;
-
-static SharedMemoryHashSetOptions sharedMemHashOptions(uint64_t max_stats) {
-  SharedMemoryHashSetOptions hash_set_options;
-  hash_set_options.capacity = max_stats;
+const uint64_t SharedMemory::VERSION = 11;
 
+static Stats::SegmentedRawStatDataSetOptions statsSetOptions(uint64_t max_stats) {
+  Stats::SegmentedRawStatDataSetOptions stats_set_options;
+  // max_stats is only a hint for sizing the hash table. The set grows past it as needed.
   // https://stackoverflow.com/questions/3980117/hash-table-why-size-should-be-prime
-  hash_set_options.num_slots = Primes::findPrimeLargerThan(hash_set_options.capacity / 2);
-  return hash_set_options;
+  stats_set_options.num_slots = Primes::findPrimeLargerThan(max_stats / 2);
+  stats_set_options.segment_size = HotRestartImpl::STATS_SEGMENT_SIZE;
+  stats_set_options.max_segments = HotRestartImpl::MAX_STATS_SEGMENTS;
+  return stats_set_options;
 }
 
-SharedMemory& SharedMemory::initialize(uint32_t stats_set_size, Options& options) {
+SharedMemory& SharedMemory::initialize(Options& options) {
   Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
 
-  const uint64_t entry_size = Stats::RawStatData::size();
-  const uint64_t total_size = sizeof(SharedMemory) + stats_set_size;
+  const uint64_t total_size = sizeof(SharedMemory);
 
   int flags = O_RDWR;
   const std::string shmem_name = fmt::format("/envoy_shared_memory_{}", options.baseId());
@@ -70,8 +74,6 @@ SharedMemory& SharedMemory::initialize(uint32_t stats_set_size, Options& options
   if (options.restartEpoch() == 0) {
     shmem->size_ = total_size;
     shmem->version_ = VERSION;
-    shmem->max_stats_ = options.maxStats();
-    shmem->entry_size_ = entry_size;
     shmem->initializeMutex(shmem->log_lock_);
     shmem->initializeMutex(shmem->access_log_lock_);
     shmem->initializeMutex(shmem->stat_lock_);
@@ -79,14 +81,8 @@ SharedMemory& SharedMemory::initialize(uint32_t stats_set_size, Options& options
   } else {
     RELEASE_ASSERT(shmem->size_ == total_size);
     RELEASE_ASSERT(shmem->version_ == VERSION);
-    RELEASE_ASSERT(shmem->max_stats_ == options.maxStats());
-    RELEASE_ASSERT(shmem->entry_size_ == entry_size);
   }
 
-  // Stats::RawStatData must be naturally aligned for atomics to work properly.
-  RELEASE_ASSERT((reinterpret_cast<uintptr_t>(shmem->stats_set_data_) % alignof(RawStatDataSet)) ==
-                 0);
-
   // Here we catch the case where a new Envoy starts up when the current Envoy has not yet fully
   // initialized. The startup logic is quite complicated, and it's not worth trying to handle this
   // in a finer way. This will cause the startup to fail with an error code early, without
@@ -108,22 +104,27 @@ void SharedMemory::initializeMutex(pthread_mutex_t& mutex) {
   pthread_mutex_init(&mutex, &attribute);
 }
 
-std::string SharedMemory::version(size_t max_num_stats, size_t max_stat_name_len) {
-  return fmt::format("{}.{}.{}.{}", VERSION, sizeof(SharedMemory), max_num_stats,
-                     max_stat_name_len);
+std::string SharedMemory::version() {
+  return fmt::format("{}.{}", VERSION, sizeof(SharedMemory));
 }
 
 HotRestartImpl::HotRestartImpl(Options& options)
-    : options_(options), stats_set_options_(sharedMemHashOptions(options.maxStats())),
-      shmem_(SharedMemory::initialize(RawStatDataSet::numBytes(stats_set_options_), options)),
-      log_lock_(shmem_.log_lock_), access_log_lock_(shmem_.access_log_lock_),
-      stat_lock_(shmem_.stat_lock_), init_lock_(shmem_.init_lock_) {
+    : options_(options), shmem_(SharedMemory::initialize(options)), log_lock_(shmem_.log_lock_),
+      access_log_lock_(shmem_.access_log_lock_), stat_lock_(shmem_.stat_lock_),
+      init_lock_(shmem_.init_lock_) {
   {
     // We must hold the stat lock when attaching to an existing shared-memory segment
     // because it might be actively written to while we sanityCheck it.
     std::unique_lock<Thread::BasicLockable> lock(stat_lock_);
-    stats_set_.reset(new RawStatDataSet(stats_set_options_, options.restartEpoch() == 0,
-                                        shmem_.stats_set_data_));
+    stats_set_.reset(new Stats::SegmentedRawStatDataSet(
+        shmem_.stats_set_control_, statsSetOptions(options.maxStats()),
+        options.restartEpoch() == 0,
+        [this](const std::string& name, uint64_t size, bool create) -> uint8_t* {
+          return mapStatsMemory(name, size, create);
+        }));
+    if (options.restartEpoch() == 0) {
+      unlinkStaleStatsSegments();
+    }
   }
   my_domain_socket_ = bindDomainSocket(options.restartEpoch());
   child_address_ = createDomainSocketAddress((options.restartEpoch() + 1));
@@ -150,7 +151,7 @@ Stats::RawStatData* HotRestartImpl::alloc(const std::string& name) {
   if (data == nullptr) {
     return nullptr;
   }
-  // For new entries (value-created.second==true), SharedMemoryHashSet calls Value::initialize()
+  // For new entries (value-created.second==true), SegmentedRawStatDataSet calls initialize()
   // automatically, but on recycled entries (value-created.second==false) we need to bump the
   // ref-count.
   if (!value_created.second) {
@@ -168,7 +169,50 @@ void HotRestartImpl::free(Stats::RawStatData& data) {
   }
   bool key_removed = stats_set_->remove(data.key());
   ASSERT(key_removed);
-  memset(&data, 0, Stats::RawStatData::size());
+}
+
+std::string HotRestartImpl::statsMemoryName(const std::string& name) {
+  return fmt::format("/envoy_shared_memory_{}_stats_{}", options_.baseId(), name);
+}
+
+uint8_t* HotRestartImpl::mapStatsMemory(const std::string& name, uint64_t size, bool create) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const std::string shmem_name = statsMemoryName(name);
+  int flags = O_RDWR;
+  if (create) {
+    flags |= O_CREAT | O_EXCL;
+
+    // Remove a region left behind by an earlier envoy that we were not hot restarted from.
+    os_sys_calls.shmUnlink(shmem_name.c_str());
+  }
+
+  int shmem_fd = os_sys_calls.shmOpen(shmem_name.c_str(), flags, S_IRUSR | S_IWUSR);
+  if (shmem_fd == -1) {
+    ENVOY_LOG(error, "cannot open shared memory region {} for stats", shmem_name);
+    return nullptr;
+  }
+
+  void* memory = MAP_FAILED;
+  if (!create || os_sys_calls.ftruncate(shmem_fd, size) != -1) {
+    memory = os_sys_calls.mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, shmem_fd, 0);
+  }
+  // The mapping stays valid once the descriptor is closed.
+  os_sys_calls.close(shmem_fd);
+  if (memory == MAP_FAILED) {
+    ENVOY_LOG(error, "cannot map shared memory region {} for stats", shmem_name);
+    return nullptr;
+  }
+  return static_cast<uint8_t*>(memory);
+}
+
+void HotRestartImpl::unlinkStaleStatsSegments() {
+  // An earlier envoy that we were not hot restarted from may have grown its stats into more
+  // segments than this one ever creates. Segments are only unlinked when they are created again,
+  // so remove all of those this set has not created yet.
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  for (uint64_t i = stats_set_->numSegments(); i < MAX_STATS_SEGMENTS; ++i) {
+    os_sys_calls.shmUnlink(statsMemoryName(Stats::SegmentedRawStatDataSet::segmentName(i)).c_str());
+  }
 }
 
 int HotRestartImpl::bindDomainSocket(uint64_t id) {
@@ -264,6 +308,42 @@ void HotRestartImpl::getParentStats(GetParentStatsInfo& info) {
   info.num_connections_ = reply->num_connections_;
 }
 
+void HotRestartImpl::getParentClusterHosts(Upstream::ClusterHostsMap& cluster_hosts) {
+  // See large comment in getParentStats() on why this operation is locked.
+  std::unique_lock<Thread::BasicLockable> lock(init_lock_);
+  cluster_hosts.clear();
+  if (options_.restartEpoch() == 0 || parent_terminated_) {
+    return;
+  }
+
+  std::string snapshot;
+  RpcGetClusterHostsRequest rpc;
+  uint64_t total_size;
+  do {
+    rpc.offset_ = snapshot.size();
+    sendMessage(parent_address_, rpc);
+    RpcGetClusterHostsReply* reply =
+        receiveTypedRpc<RpcGetClusterHostsReply, RpcMessageType::GetClusterHostsReply>();
+    RELEASE_ASSERT(reply->size_ <= sizeof(reply->data_));
+    RELEASE_ASSERT(reply->size_ > 0 || reply->total_size_ == snapshot.size());
+    snapshot.append(reply->data_, reply->size_);
+    total_size = reply->total_size_;
+  } while (snapshot.size() < total_size);
+
+  envoy::api::v2::DiscoveryResponse response;
+  if (!response.ParseFromString(snapshot)) {
+    ENVOY_LOG(warn, "unable to parse the cluster hosts of the parent process");
+    return;
+  }
+  for (const auto& resource : response.resources()) {
+    auto cluster_load_assignment =
+        MessageUtil::anyConvert<envoy::api::v2::ClusterLoadAssignment>(resource);
+    const std::string cluster_name = cluster_load_assignment.cluster_name();
+    cluster_hosts[cluster_name] = std::move(cluster_load_assignment);
+  }
+  ENVOY_LOG(info, "got the hosts of {} clusters from the parent process", cluster_hosts.size());
+}
+
 void HotRestartImpl::initialize(Event::Dispatcher& dispatcher, Server::Instance& server) {
   socket_event_ =
       dispatcher.createFileEvent(my_domain_socket_,
@@ -348,6 +428,34 @@ void HotRestartImpl::sendMessage(sockaddr_un& address, RpcBase& rpc) {
   RELEASE_ASSERT(rc != -1);
 }
 
+void HotRestartImpl::onGetClusterHosts(RpcGetClusterHostsRequest& rpc) {
+  if (rpc.offset_ == 0) {
+    // Only clusters that learn of their hosts at runtime are worth warming up.
+    envoy::api::v2::DiscoveryResponse response;
+    for (const auto& cluster : server_->clusterManager().clusters()) {
+      const auto type = cluster.second.get().info()->type();
+      if (type == envoy::api::v2::Cluster::EDS || type == envoy::api::v2::Cluster::STRICT_DNS) {
+        response.add_resources()->PackFrom(Upstream::HostUtility::toClusterLoadAssignment(
+            cluster.first, cluster.second.get().prioritySet()));
+      }
+    }
+    cluster_hosts_snapshot_ = response.SerializeAsString();
+  }
+
+  RpcGetClusterHostsReply reply;
+  reply.total_size_ = cluster_hosts_snapshot_.size();
+  if (rpc.offset_ < cluster_hosts_snapshot_.size()) {
+    reply.size_ = std::min<uint64_t>(sizeof(reply.data_),
+                                     cluster_hosts_snapshot_.size() - rpc.offset_);
+    memcpy(reply.data_, cluster_hosts_snapshot_.data() + rpc.offset_, reply.size_);
+  }
+  if (rpc.offset_ + reply.size_ >= cluster_hosts_snapshot_.size()) {
+    // The child has the whole snapshot.
+    cluster_hosts_snapshot_.clear();
+  }
+  sendMessage(child_address_, reply);
+}
+
 void HotRestartImpl::onGetListenSocket(RpcGetListenSocketRequest& rpc) {
   RpcGetListenSocketReply reply;
   reply.fd_ = -1;
@@ -425,6 +533,13 @@ void HotRestartImpl::onSocketEvent() {
       break;
     }
 
+    case RpcMessageType::GetClusterHostsRequest: {
+      RpcGetClusterHostsRequest* message =
+          reinterpret_cast<RpcGetClusterHostsRequest*>(base_message);
+      onGetClusterHosts(*message);
+      break;
+    }
+
     case RpcMessageType::DrainListenersRequest: {
       server_->drainListeners();
       break;
@@ -471,24 +586,10 @@ void HotRestartImpl::terminateParent() {
 
 void HotRestartImpl::shutdown() { socket_event_.reset(); }
 
-std::string HotRestartImpl::version() {
-  return versionHelper(shmem_.maxStats(), Stats::RawStatData::maxNameLength(), *stats_set_);
-}
-
-// Called from envoy --hot-restart-version -- needs to instantiate a RawStatDataSet so it
-// can generate the version string.
-std::string HotRestartImpl::hotRestartVersion(size_t max_num_stats, size_t max_stat_name_len) {
-  const SharedMemoryHashSetOptions options = sharedMemHashOptions(max_num_stats);
-  const size_t bytes = RawStatDataSet::numBytes(options);
-  std::unique_ptr<uint8_t[]> mem_buffer_for_dry_run_(new uint8_t[bytes]);
-  RawStatDataSet stats_set(options, true /* init */, mem_buffer_for_dry_run_.get());
-
-  return versionHelper(max_num_stats, max_stat_name_len, stats_set);
-}
+std::string HotRestartImpl::version() { return hotRestartVersion(); }
 
-std::string HotRestartImpl::versionHelper(size_t max_num_stats, size_t max_stat_name_len,
-                                          RawStatDataSet& stats_set) {
-  return SharedMemory::version(max_num_stats, max_stat_name_len) + "." + stats_set.version();
+std::string HotRestartImpl::hotRestartVersion() {
+  return SharedMemory::version() + "." + Stats::SegmentedRawStatDataSet::version();
 }
 
 } // namespace Server
@@ -12,35 +12,30 @@
 #include "envoy/server/options.h"
 
 #include "common/common/assert.h"
-#include "common/common/shared_memory_hash_set.h"
+#include "common/stats/segmented_raw_stat_data_set.h"
 #include "common/stats/stats_impl.h"
 
 namespace Envoy {
 namespace Server {
 
-typedef SharedMemoryHashSet<Stats::RawStatData> RawStatDataSet;
-
 /**
  * Shared memory segment. This structure is laid directly into shared memory and is used amongst
  * all running envoy processes.
  */
 class SharedMemory {
 public:
-  static void configure(size_t max_num_stats, size_t max_stat_name_len);
-  static std::string version(uint64_t max_num_stats, uint64_t max_stat_name_len);
+  static std::string version();
 
   // Made public for testing.
   static const uint64_t VERSION;
 
-  int64_t maxStats() const { return max_stats_; }
-
 private:
   struct Flags {
     static const uint64_t INITIALIZING = 0x1;
   };
 
-  // Due to the flexible-array-length of stats_set_data_, c-style allocation
-  // and initialization are neccessary.
+  // The segment is laid directly into shared memory, so c-style allocation and initialization are
+  // neccessary.
   SharedMemory() = delete;
   ~SharedMemory() = delete;
 
@@ -48,7 +43,7 @@ private:
    * Initialize the shared memory segment, depending on whether we should be the first running
    * envoy, or a host restarted envoy process.
    */
-  static SharedMemory& initialize(uint32_t stats_set_size, Options& options);
+  static SharedMemory& initialize(Options& options);
 
   /**
    * Initialize a pthread mutex for process shared locking.
@@ -57,14 +52,13 @@ private:
 
   uint64_t size_;
   uint64_t version_;
-  uint64_t max_stats_;
-  uint64_t entry_size_;
   std::atomic<uint64_t> flags_;
   pthread_mutex_t log_lock_;
   pthread_mutex_t access_log_lock_;
   pthread_mutex_t stat_lock_;
   pthread_mutex_t init_lock_;
-  alignas(SharedMemoryHashSet<Stats::RawStatData>) uint8_t stats_set_data_[];
+  // The stats themselves are in separate shared memory regions, which are added as needed.
+  Stats::SegmentedRawStatDataSet::Control stats_set_control_;
 
   friend class HotRestartImpl;
 };
@@ -123,6 +117,7 @@ public:
   void drainParentListeners() override;
   int duplicateParentListenSocket(const std::string& address) override;
   void getParentStats(GetParentStatsInfo& info) override;
+  void getParentClusterHosts(Upstream::ClusterHostsMap& cluster_hosts) override;
   void initialize(Event::Dispatcher& dispatcher, Server::Instance& server) override;
   void shutdownParentAdmin(ShutdownParentAdminInfo& info) override;
   void terminateParent() override;
@@ -133,10 +128,18 @@ public:
   Stats::RawStatDataAllocator& statsAllocator() override { return *this; }
 
   /**
-   * envoy --hot_restart_version doesn't initialize Envoy, but computes the version string
-   * based on the configured options.
+   * envoy --hot_restart_version doesn't initialize Envoy, but computes the version string. The
+   * stats options don't affect it, as the shared memory for stats is sized when it is first
+   * created and grows as needed.
    */
-  static std::string hotRestartVersion(uint64_t max_num_stats, uint64_t max_stat_name_len);
+  static std::string hotRestartVersion();
+
+  // Size of each shared memory region holding stats.
+  static const uint64_t STATS_SEGMENT_SIZE = 2 * 1024 * 1024;
+
+  // Limit on the number of shared memory regions holding stats. Once it is reached, stats are
+  // allocated on the heap instead.
+  static const uint64_t MAX_STATS_SEGMENTS = 512;
 
   // RawStatDataAllocator
   Stats::RawStatData* alloc(const std::string& name) override;
@@ -152,7 +155,9 @@ private:
     TerminateRequest = 6,
     UnknownRequestReply = 7,
     GetStatsRequest = 8,
-    GetStatsReply = 9
+    GetStatsReply = 9,
+    GetClusterHostsRequest = 10,
+    GetClusterHostsReply = 11
   };
 
   struct RpcBase {
@@ -189,6 +194,23 @@ private:
     uint64_t unused_[16]{0};
   } __attribute__((packed));
 
+  struct RpcGetClusterHostsRequest : public RpcBase {
+    RpcGetClusterHostsRequest()
+        : RpcBase(RpcMessageType::GetClusterHostsRequest, sizeof(*this)) {}
+
+    uint64_t offset_{0};
+  } __attribute__((packed));
+
+  // The snapshot of the cluster hosts doesn't fit in a single datagram, so the child requests it
+  // a chunk at a time.
+  struct RpcGetClusterHostsReply : public RpcBase {
+    RpcGetClusterHostsReply() : RpcBase(RpcMessageType::GetClusterHostsReply, sizeof(*this)) {}
+
+    uint64_t total_size_{0};
+    uint64_t size_{0};
+    char data_[4000]{0};
+  } __attribute__((packed));
+
   template <class rpc_class, RpcMessageType rpc_type> rpc_class* receiveTypedRpc() {
     RpcBase* base_message = receiveRpc(true);
     RELEASE_ASSERT(base_message->length_ == sizeof(rpc_class));
@@ -199,17 +221,18 @@ private:
   int bindDomainSocket(uint64_t id);
   void initDomainSocketAddress(sockaddr_un* address);
   sockaddr_un createDomainSocketAddress(uint64_t id);
+  void onGetClusterHosts(RpcGetClusterHostsRequest& rpc);
   void onGetListenSocket(RpcGetListenSocketRequest& rpc);
   void onSocketEvent();
   RpcBase* receiveRpc(bool block);
   void sendMessage(sockaddr_un& address, RpcBase& rpc);
-  static std::string versionHelper(uint64_t max_num_stats, uint64_t max_stat_name_len,
-                                   RawStatDataSet& stats_set);
+  std::string statsMemoryName(const std::string& name);
+  uint8_t* mapStatsMemory(const std::string& name, uint64_t size, bool create);
+  void unlinkStaleStatsSegments();
 
   Options& options_;
-  SharedMemoryHashSetOptions stats_set_options_;
   SharedMemory& shmem_;
-  std::unique_ptr<RawStatDataSet> stats_set_;
+  std::unique_ptr<Stats::SegmentedRawStatDataSet> stats_set_;
   ProcessSharedMutex log_lock_;
   ProcessSharedMutex access_log_lock_;
   ProcessSharedMutex stat_lock_;
@@ -219,6 +242,8 @@ private:
   sockaddr_un child_address_;
   Event::FileEventPtr socket_event_;
   std::array<uint8_t, 4096> rpc_buffer_;
+  // Serialized snapshot of our cluster hosts, taken when the child requests its first chunk.
+  std::string cluster_hosts_snapshot_;
   Server::Instance* server_{};
   bool parent_terminated_{};
 };
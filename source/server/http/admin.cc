@@ -33,6 +33,9 @@
 #include "common/http/headers.h"
 #include "common/http/http1/codec_impl.h"
 #include "common/json/json_loader.h"
+#include "common/memory/pooled_allocation.h"
+#include "common/memory/stats.h"
+#include "common/memory/tagged_allocation.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/profiler/profiler.h"
 #include "common/router/config_impl.h"
@@ -319,6 +322,43 @@ Http::Code AdminImpl::handlerCpuProfiler(absl::string_view url, Http::HeaderMap&
   return Http::Code::OK;
 }
 
+Http::Code AdminImpl::handlerHeapProfiler(absl::string_view url, Http::HeaderMap&,
+                                          Buffer::Instance& response) {
+  Http::Utility::QueryParams query_params = Http::Utility::parseQueryString(url);
+  if (query_params.size() != 1 || query_params.begin()->first != "enable" ||
+      (query_params.begin()->second != "y" && query_params.begin()->second != "n")) {
+    response.add("?enable=<y|n>\n");
+    return Http::Code::BadRequest;
+  }
+
+  bool enable = query_params.begin()->second == "y";
+  if (enable && !Profiler::Heap::profilerEnabled()) {
+    // The heap profiler writes numbered files using the profile path as a prefix.
+    if (!Profiler::Heap::startProfiler(profile_path_ + ".heap")) {
+      response.add("failure to start the heap profiler");
+      return Http::Code::InternalServerError;
+    }
+
+  } else if (!enable && Profiler::Heap::profilerEnabled()) {
+    Profiler::Heap::stopProfiler();
+  }
+
+  response.add("OK\n");
+  return Http::Code::OK;
+}
+
+Http::Code AdminImpl::handlerHeapSample(absl::string_view, Http::HeaderMap&,
+                                        Buffer::Instance& response) {
+  std::string sample;
+  if (!Profiler::Heap::sampledAllocations(sample)) {
+    response.add("no heap sample available; set TCMALLOC_SAMPLE_PARAMETER to enable sampling\n");
+    return Http::Code::NotImplemented;
+  }
+
+  response.add(sample);
+  return Http::Code::OK;
+}
+
 Http::Code AdminImpl::handlerHealthcheckFail(absl::string_view, Http::HeaderMap&,
                                              Buffer::Instance& response) {
   server_.failHealthcheck(true);
@@ -503,6 +543,42 @@ std::string AdminImpl::statsAsJson(const std::map<std::string, uint64_t>& all_st
   return strbuf.GetString();
 }
 
+Http::Code AdminImpl::handlerMemory(absl::string_view, Http::HeaderMap& response_headers,
+                                    Buffer::Instance& response) {
+  response_headers.insertContentType().value().setReference(
+      Http::Headers::get().ContentTypeValues.Json);
+
+  rapidjson::Document document;
+  document.SetObject();
+  auto& allocator = document.GetAllocator();
+  document.AddMember("allocated", Memory::Stats::totalCurrentlyAllocated(), allocator);
+  document.AddMember("heap_size", Memory::Stats::totalCurrentlyReserved(), allocator);
+  document.AddMember("heap_profiler_enabled", Profiler::Heap::profilerEnabled(), allocator);
+
+  rapidjson::Value tagged{rapidjson::kObjectType};
+  for (size_t i = 0; i < Memory::TaggedAllocationStats::NumTags; i++) {
+    const Memory::AllocationTag tag = static_cast<Memory::AllocationTag>(i);
+    rapidjson::Value tag_object{rapidjson::kObjectType};
+    tag_object.AddMember("allocated_bytes", Memory::TaggedAllocationStats::allocatedBytes(tag),
+                         allocator);
+    tag_object.AddMember("allocations", Memory::TaggedAllocationStats::allocations(tag),
+                         allocator);
+    tag_object.AddMember("pooled_bytes", Memory::AllocationPools::pooledBytes(tag), allocator);
+    tag_object.AddMember("pooled_blocks", Memory::AllocationPools::pooledBlocks(tag), allocator);
+    tag_object.AddMember("reused_allocations", Memory::AllocationPools::reusedAllocations(tag),
+                         allocator);
+    tagged.AddMember(rapidjson::StringRef(Memory::TaggedAllocationStats::tagName(tag).c_str()),
+                     std::move(tag_object), allocator);
+  }
+  document.AddMember("tagged", std::move(tagged), allocator);
+
+  rapidjson::StringBuffer strbuf;
+  rapidjson::PrettyWriter<StringBuffer> writer(strbuf);
+  document.Accept(writer);
+  response.add(strbuf.GetString());
+  return Http::Code::OK;
+}
+
 Http::Code AdminImpl::handlerQuitQuitQuit(absl::string_view, Http::HeaderMap&,
                                           Buffer::Instance& response) {
   server_.shutdown();
@@ -696,6 +772,10 @@ AdminImpl::AdminImpl(const std::string& access_log_path, const std::string& prof
            false, false},
           {"/cpuprofiler", "enable/disable the CPU profiler",
            MAKE_ADMIN_HANDLER(handlerCpuProfiler), false, true},
+          {"/heapprofiler", "enable/disable the heap profiler",
+           MAKE_ADMIN_HANDLER(handlerHeapProfiler), false, true},
+          {"/heap_sample", "print sampled heap allocation sites",
+           MAKE_ADMIN_HANDLER(handlerHeapSample), false, false},
           {"/healthcheck/fail", "cause the server to fail health checks",
            MAKE_ADMIN_HANDLER(handlerHealthcheckFail), false, true},
           {"/healthcheck/ok", "cause the server to pass health checks",
@@ -706,6 +786,8 @@ AdminImpl::AdminImpl(const std::string& access_log_path, const std::string& prof
            MAKE_ADMIN_HANDLER(handlerHotRestartVersion), false, false},
           {"/logging", "query/change logging levels", MAKE_ADMIN_HANDLER(handlerLogging), false,
            true},
+          {"/memory", "print current allocation/heap usage", MAKE_ADMIN_HANDLER(handlerMemory),
+           false, false},
           {"/quitquitquit", "exit the server", MAKE_ADMIN_HANDLER(handlerQuitQuitQuit), false,
            true},
           {"/reset_counters", "reset all counters to zero",
@@ -747,10 +829,11 @@ Http::ServerConnectionPtr AdminImpl::createCodec(Network::Connection& connection
       new Http::Http1::ServerConnectionImpl(connection, callbacks, Http::Http1Settings())};
 }
 
-bool AdminImpl::createNetworkFilterChain(Network::Connection& connection) {
+bool AdminImpl::createNetworkFilterChain(Network::Connection& connection,
+                                         const std::vector<Network::FilterFactoryCb>&) {
   connection.addReadFilter(Network::ReadFilterSharedPtr{new Http::ConnectionManagerImpl(
       *this, server_.drainManager(), server_.random(), server_.httpTracer(), server_.runtime(),
-      server_.localInfo(), server_.clusterManager())});
+      server_.localInfo(), server_.clusterManager(), nullptr)});
   return true;
 }
 
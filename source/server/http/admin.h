@@ -35,6 +35,7 @@ namespace Server {
  * Implementation of Server::Admin.
  */
 class AdminImpl : public Admin,
+                  public Network::FilterChainManager,
                   public Network::FilterChainFactory,
                   public Http::FilterChainFactory,
                   public Http::ConnectionManagerConfig,
@@ -58,8 +59,14 @@ public:
   bool removeHandler(const std::string& prefix) override;
   ConfigTracker& getConfigTracker() override;
 
+  // Network::FilterChainManager
+  const Network::FilterChain* findFilterChain(const Network::ConnectionSocket&) const override {
+    return &admin_filter_chain_;
+  }
+
   // Network::FilterChainFactory
-  bool createNetworkFilterChain(Network::Connection& connection) override;
+  bool createNetworkFilterChain(Network::Connection& connection,
+                                const std::vector<Network::FilterFactoryCb>& factories) override;
   bool createListenerFilterChain(Network::ListenerFilterManager&) override { return true; }
 
   // Http::FilterChainFactory
@@ -153,6 +160,10 @@ private:
                                Buffer::Instance& response) const;
   Http::Code handlerCpuProfiler(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                                 Buffer::Instance& response);
+  Http::Code handlerHeapProfiler(absl::string_view path_and_query,
+                                 Http::HeaderMap& response_headers, Buffer::Instance& response);
+  Http::Code handlerHeapSample(absl::string_view path_and_query, Http::HeaderMap& response_headers,
+                               Buffer::Instance& response);
   Http::Code handlerHealthcheckFail(absl::string_view path_and_query,
                                     Http::HeaderMap& response_headers, Buffer::Instance& response);
   Http::Code handlerHealthcheckOk(absl::string_view path_and_query,
@@ -167,6 +178,8 @@ private:
   Http::Code handlerLogging(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                             Buffer::Instance& response);
   Http::Code handlerMain(const std::string& path, Buffer::Instance& response);
+  Http::Code handlerMemory(absl::string_view path_and_query, Http::HeaderMap& response_headers,
+                           Buffer::Instance& response);
   Http::Code handlerQuitQuitQuit(absl::string_view path_and_query,
                                  Http::HeaderMap& response_headers, Buffer::Instance& response);
   Http::Code handlerResetCounters(absl::string_view path_and_query,
@@ -182,6 +195,25 @@ private:
   Http::Code handlerRuntimeModify(absl::string_view path_and_query,
                                   Http::HeaderMap& response_headers, Buffer::Instance& response);
 
+  /**
+   * The only filter chain of the admin listener. The admin connection manager is added to its
+   * connections by createNetworkFilterChain() rather than by filter factories.
+   */
+  class AdminFilterChain : public Network::FilterChain {
+  public:
+    // Network::FilterChain
+    const Network::TransportSocketFactory& transportSocketFactory() const override {
+      return transport_socket_factory_;
+    }
+    const std::vector<Network::FilterFactoryCb>& networkFilterFactories() const override {
+      return empty_network_filter_factory_;
+    }
+
+  private:
+    Network::RawBufferSocketFactory transport_socket_factory_;
+    const std::vector<Network::FilterFactoryCb> empty_network_filter_factory_;
+  };
+
   class AdminListener : public Network::ListenerConfig {
   public:
     AdminListener(AdminImpl& parent, Stats::ScopePtr&& listener_scope)
@@ -189,14 +221,15 @@ private:
           stats_(Http::ConnectionManagerImpl::generateListenerStats("http.admin.", *scope_)) {}
 
     // Network::ListenerConfig
+    Network::FilterChainManager& filterChainManager() override { return parent_; }
     Network::FilterChainFactory& filterChainFactory() override { return parent_; }
     Network::Socket& socket() override { return parent_.mutable_socket(); }
-    Network::TransportSocketFactory& transportSocketFactory() override {
-      return parent_.transport_socket_factory_;
-    }
+    Network::ConnectionBalancer* connectionBalancer() override { return nullptr; }
     bool bindToPort() override { return true; }
     bool handOffRestoredDestinationConnections() const override { return false; }
     uint32_t perConnectionBufferLimitBytes() override { return 0; }
+    std::chrono::milliseconds listenerFiltersTimeout() const override { return {}; }
+    bool continueOnListenerFiltersTimeout() const override { return false; }
     Stats::Scope& listenerScope() override { return *scope_; }
     uint64_t listenerTag() const override { return 0; }
     const std::string& name() const override { return name_; }
@@ -211,7 +244,7 @@ private:
   std::list<AccessLog::InstanceSharedPtr> access_logs_;
   const std::string profile_path_;
   Network::SocketPtr socket_;
-  Network::RawBufferSocketFactory transport_socket_factory_;
+  AdminFilterChain admin_filter_chain_;
   Http::ConnectionManagerStats stats_;
   Http::ConnectionManagerTracingStats tracing_stats_;
   NullRouteConfigProvider route_config_provider_;
@@ -43,9 +43,7 @@ void LdsApi::initialize(std::function<void()> callback) {
 void LdsApi::onConfigUpdate(const ResourceVector& resources) {
   cm_.adsMux().pause(Config::TypeUrl::get().RouteConfiguration);
   Cleanup rds_resume([this] { cm_.adsMux().resume(Config::TypeUrl::get().RouteConfiguration); });
-  for (const auto& listener : resources) {
-    MessageUtil::validate(listener);
-  }
+  MessageUtil::validate(resources);
   // We need to keep track of which listeners we might need to remove.
   std::unordered_map<std::string, std::reference_wrapper<Network::ListenerConfig>>
       listeners_to_remove;
@@ -5,8 +5,11 @@
 
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
+#include "common/common/empty_string.h"
 #include "common/common/fmt.h"
 #include "common/config/utility.h"
+#include "common/network/cidr_range.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/resolver_impl.h"
 #include "common/network/socket_option_impl.h"
@@ -132,18 +135,26 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, ListenerManag
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, use_original_dst, false)),
       per_connection_buffer_limit_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
+      listener_filters_timeout_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config, listener_filters_timeout, 15000)),
+      continue_on_listener_filters_timeout_(config.continue_on_listener_filters_timeout()),
       listener_tag_(parent_.factory_.nextListenerTag()), name_(name), modifiable_(modifiable),
       workers_started_(workers_started), hash_(hash),
       local_drain_manager_(parent.factory_.createDrainManager(config.drain_type())),
       metadata_(config.has_metadata() ? config.metadata()
                                       : envoy::api::v2::core::Metadata::default_instance()) {
-  // TODO(htuch): Support multiple filter chains #1280, add constraint to ensure we have at least on
-  // filter chain #1308.
+  // TODO(htuch): add constraint to ensure we have at least on filter chain #1308.
   ASSERT(config.filter_chains().size() >= 1);
 
   // Add listen socket options from the config.
   addListenSocketOption(std::make_shared<ListenerSocketOption>(config));
 
+  if (config.has_connection_balance_config()) {
+    // Exact balancing is the only kind of balancing so far.
+    ASSERT(config.connection_balance_config().has_exact_balance());
+    connection_balancer_ = std::make_unique<Network::ExactConnectionBalancerImpl>();
+  }
+
   if (!config.listener_filters().empty()) {
     listener_filter_factories_ =
         parent_.factory_.createListenerFilterFactoryList(config.listener_filters(), *this);
@@ -168,27 +179,36 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, ListenerManag
         factory.createFilterFactoryFromProto(Envoy::ProtobufWkt::Empty(), *this));
   }
 
-  // Skip lookup and update of the SSL Context if there is only one filter chain
-  // and it doesn't enforce any SNI restrictions.
-  const bool skip_context_update =
-      (config.filter_chains().size() == 1 &&
-       config.filter_chains()[0].filter_chain_match().sni_domains().empty());
+  // Add TLS inspector listener filter if any filter chain matches on server names or application
+  // protocols, and it isn't configured already. It comes after the proxy protocol filter, as the
+  // PROXY header precedes the TLS handshake.
+  bool need_tls_inspector = false;
+  for (const auto& filter_chain : config.filter_chains()) {
+    const auto& filter_chain_match = filter_chain.filter_chain_match();
+    if (!filter_chain_match.sni_domains().empty() ||
+        !filter_chain_match.application_protocols().empty()) {
+      need_tls_inspector = true;
+    }
+  }
+  for (const auto& listener_filter : config.listener_filters()) {
+    if (listener_filter.name() ==
+        Extensions::ListenerFilters::ListenerFilterNames::get().TLS_INSPECTOR) {
+      need_tls_inspector = false;
+    }
+  }
+  if (need_tls_inspector) {
+    auto& factory =
+        Config::Utility::getAndCheckFactory<Configuration::NamedListenerFilterConfigFactory>(
+            Extensions::ListenerFilters::ListenerFilterNames::get().TLS_INSPECTOR);
+    listener_filter_factories_.push_back(
+        factory.createFilterFactoryFromProto(Envoy::ProtobufWkt::Empty(), *this));
+  }
 
-  absl::optional<uint64_t> filters_hash;
   uint32_t has_tls = 0;
   uint32_t has_stk = 0;
   for (const auto& filter_chain : config.filter_chains()) {
     std::vector<std::string> sni_domains(filter_chain.filter_chain_match().sni_domains().begin(),
                                          filter_chain.filter_chain_match().sni_domains().end());
-    if (!filters_hash) {
-      filters_hash = RepeatedPtrUtil::hash(filter_chain.filters());
-      filter_factories_ =
-          parent_.factory_.createNetworkFilterFactoryList(filter_chain.filters(), *this);
-    } else if (filters_hash.value() != RepeatedPtrUtil::hash(filter_chain.filters())) {
-      throw EnvoyException(fmt::format("error adding listener '{}': use of different filter chains "
-                                       "is currently not supported",
-                                       address_->asString()));
-    }
 
     // If the cluster doesn't have transport socke configured, override with default transport
     // socket implementation based on tls_context. We copy by value first then override if
@@ -214,17 +234,32 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, ListenerManag
     ProtobufTypes::MessagePtr message =
         Config::Utility::translateToFactoryConfig(transport_socket, config_factory);
 
-    // Each transport socket factory owns one SslServerContext, we need to store them all in a
-    // vector since Ssl::ContextManager doesn't own SslServerContext. While transportSocketFacotry()
-    // always returns the first element of transport_socket_factories_, other transport socket
-    // factories are needed when the default Ssl::ServerContext updates SSL context based on
-    // ClientHello. This behavior is a workaround for initial SNI support before the full SNI based
-    // filter chain match is implemented.
-    transport_socket_factories_.emplace_back(config_factory.createTransportSocketFactory(
-        name_, sni_domains, skip_context_update, *message, *this));
-    ASSERT(transport_socket_factories_.back() != nullptr);
+    Network::TransportSocketFactoryPtr transport_socket_factory =
+        config_factory.createTransportSocketFactory(sni_domains, *message, *this);
+    ASSERT(transport_socket_factory != nullptr);
+
+    filter_chains_.emplace_back(std::make_shared<FilterChainImpl>(
+        std::move(transport_socket_factory),
+        parent_.factory_.createNetworkFilterFactoryList(filter_chain.filters(), *this)));
+    addFilterChain(filter_chain.filter_chain_match(), filter_chains_.back().get());
+  }
+  ASSERT(!filter_chains_.empty());
+
+  // Build the destination IP tries once all the filter chains have been added.
+  for (auto& destination_port : destination_ports_map_) {
+    DestinationIps& destination_ips = destination_port.second;
+    std::vector<std::pair<std::string, std::vector<Network::Address::CidrRange>>> tag_data;
+    for (const auto& cidr_range : destination_ips.cidr_ranges_) {
+      if (!cidr_range.first.empty()) {
+        tag_data.emplace_back(cidr_range.first, std::vector<Network::Address::CidrRange>{
+                                                    Network::Address::CidrRange::create(
+                                                        cidr_range.first)});
+      }
+    }
+    if (!tag_data.empty()) {
+      destination_ips.trie_ = std::make_unique<Network::LcTrie::LcTrie>(tag_data);
+    }
   }
-  ASSERT(!transport_socket_factories_.empty());
 
   // TODO(PiotrSikora): allow filter chains with mixed use of Session Ticket Keys.
   // This doesn't work right now, because BoringSSL uses "session context" (initial SSL_CTX that
@@ -245,11 +280,145 @@ ListenerImpl::~ListenerImpl() {
   // active. This is done here explicitly by setting a boolean and then clearing the factory
   // vector for clarity.
   initialize_canceled_ = true;
-  filter_factories_.clear();
+  destination_ports_map_.clear();
+  server_name_keys_.clear();
+  filter_chains_.clear();
+}
+
+void ListenerImpl::addFilterChain(const envoy::api::v2::listener::FilterChainMatch& match,
+                                  const Network::FilterChain* filter_chain) {
+  // An empty criteria matches any connection, and is stored under an empty key.
+  const std::vector<std::string> any{""};
+  std::vector<std::string> cidr_ranges;
+  for (const auto& prefix_range : match.prefix_ranges()) {
+    cidr_ranges.push_back(Network::Address::CidrRange::create(prefix_range).asString());
+  }
+  const std::vector<std::string> server_names(match.sni_domains().begin(),
+                                              match.sni_domains().end());
+  const std::vector<std::string> application_protocols(match.application_protocols().begin(),
+                                                       match.application_protocols().end());
+
+  DestinationIps& destination_ips =
+      destination_ports_map_[PROTOBUF_GET_WRAPPED_OR_DEFAULT(match, destination_port, 0)];
+  for (const std::string& cidr_range : cidr_ranges.empty() ? any : cidr_ranges) {
+    DestinationIp& destination_ip = destination_ips.cidr_ranges_[cidr_range];
+    if (!cidr_range.empty()) {
+      destination_ip.prefix_len_ = Network::Address::CidrRange::create(cidr_range).length();
+    }
+    for (const std::string& server_name : server_names.empty() ? any : server_names) {
+      // Wildcard names only cover a single label, so they are keyed by the suffix that the
+      // requested server name has after its first label.
+      const bool wildcard =
+          server_name.size() > 2 && StringUtil::startsWith(server_name.c_str(), "*.");
+      const absl::string_view key =
+          *server_name_keys_.insert(wildcard ? server_name.substr(1) : server_name).first;
+      ApplicationProtocolsMap& protocols_map =
+          (wildcard ? destination_ip.wildcard_server_names_ : destination_ip.server_names_)[key];
+      for (const std::string& protocol :
+           application_protocols.empty() ? any : application_protocols) {
+        const Network::FilterChain*& slot = protocols_map[protocol];
+        if (slot != nullptr) {
+          throw EnvoyException(
+              fmt::format("error adding listener '{}': multiple filter chains with the same "
+                          "matching rules are defined",
+                          address_->asString()));
+        }
+        slot = filter_chain;
+      }
+    }
+  }
+}
+
+const Network::FilterChain*
+ListenerImpl::findFilterChain(const Network::ConnectionSocket& socket) const {
+  const auto& address = socket.localAddress();
+
+  // Match on the destination port. Connections to listeners on pipes only match filter chains
+  // without a destination port.
+  if (address->type() == Network::Address::Type::Ip) {
+    const auto port_match = destination_ports_map_.find(address->ip()->port());
+    if (port_match != destination_ports_map_.end()) {
+      return findFilterChainForDestinationIp(port_match->second, socket);
+    }
+  }
+  const auto any_port = destination_ports_map_.find(0);
+  if (any_port != destination_ports_map_.end()) {
+    return findFilterChainForDestinationIp(any_port->second, socket);
+  }
+  return nullptr;
+}
+
+const Network::FilterChain*
+ListenerImpl::findFilterChainForDestinationIp(const DestinationIps& destination_ips,
+                                              const Network::ConnectionSocket& socket) const {
+  // Match on the longest destination IP prefix.
+  const DestinationIp* match = nullptr;
+  const auto& address = socket.localAddress();
+  if (destination_ips.trie_ != nullptr && address->type() == Network::Address::Type::Ip) {
+    for (const std::string& tag : destination_ips.trie_->getTags(address)) {
+      const DestinationIp& destination_ip = destination_ips.cidr_ranges_.at(tag);
+      if (match == nullptr || destination_ip.prefix_len_ > match->prefix_len_) {
+        match = &destination_ip;
+      }
+    }
+  }
+  if (match == nullptr) {
+    const auto any_ip = destination_ips.cidr_ranges_.find(EMPTY_STRING);
+    if (any_ip == destination_ips.cidr_ranges_.end()) {
+      return nullptr;
+    }
+    match = &any_ip->second;
+  }
+  return findFilterChainForServerName(*match, socket);
+}
+
+const Network::FilterChain*
+ListenerImpl::findFilterChainForServerName(const DestinationIp& destination_ip,
+                                           const Network::ConnectionSocket& socket) const {
+  // Match on the exact server name, then on the wildcard domain covering its first label, e.g.
+  // "www.example.com", then "*.example.com". Wildcards don't cover several labels, so
+  // "a.b.example.com" doesn't match "*.example.com".
+  const ServerNamesMap& server_names = destination_ip.server_names_;
+  const absl::string_view server_name = socket.requestedServerName();
+  if (!server_name.empty()) {
+    const auto match = server_names.find(server_name);
+    if (match != server_names.end()) {
+      return findFilterChainForApplicationProtocols(match->second, socket);
+    }
+    const size_t pos = server_name.find('.');
+    if (pos != absl::string_view::npos && pos > 0 && pos < server_name.size() - 1) {
+      const ServerNamesMap& wildcard_server_names = destination_ip.wildcard_server_names_;
+      const auto wildcard_match = wildcard_server_names.find(server_name.substr(pos));
+      if (wildcard_match != wildcard_server_names.end()) {
+        return findFilterChainForApplicationProtocols(wildcard_match->second, socket);
+      }
+    }
+  }
+  const auto any_server_name = server_names.find(EMPTY_STRING);
+  if (any_server_name == server_names.end()) {
+    return nullptr;
+  }
+  return findFilterChainForApplicationProtocols(any_server_name->second, socket);
+}
+
+const Network::FilterChain* ListenerImpl::findFilterChainForApplicationProtocols(
+    const ApplicationProtocolsMap& application_protocols,
+    const Network::ConnectionSocket& socket) const {
+  // Match on the first of the requested application protocols, in the client's order of
+  // preference, that any filter chain matches.
+  for (const std::string& protocol : socket.requestedApplicationProtocols()) {
+    const auto match = application_protocols.find(protocol);
+    if (match != application_protocols.end()) {
+      return match->second;
+    }
+  }
+  const auto any_protocol = application_protocols.find(EMPTY_STRING);
+  return any_protocol != application_protocols.end() ? any_protocol->second : nullptr;
 }
 
-bool ListenerImpl::createNetworkFilterChain(Network::Connection& connection) {
-  return Configuration::FilterChainUtility::buildFilterChain(connection, filter_factories_);
+bool ListenerImpl::createNetworkFilterChain(
+    Network::Connection& connection, const std::vector<Network::FilterFactoryCb>& factories) {
+  return Configuration::FilterChainUtility::buildFilterChain(connection, factories);
 }
 
 bool ListenerImpl::createListenerFilterChain(Network::ListenerFilterManager& manager) {
@@ -315,7 +484,7 @@ ListenerManagerImpl::ListenerManagerImpl(Instance& server,
                                          WorkerFactory& worker_factory)
     : server_(server), factory_(listener_factory), stats_(generateStats(server.stats())) {
   for (uint32_t i = 0; i < std::max(1U, server.options().concurrency()); i++) {
-    workers_.emplace_back(worker_factory.createWorker());
+    workers_.emplace_back(worker_factory.createWorker(server.overloadManager()));
   }
 }
 
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "envoy/api/v2/listener/listener.pb.h"
 #include "envoy/server/filter_config.h"
 #include "envoy/server/instance.h"
@@ -8,6 +14,8 @@
 #include "envoy/server/worker.h"
 
 #include "common/common/logger.h"
+#include "common/common/utility.h"
+#include "common/network/lc_trie.h"
 
 #include "server/init_manager_impl.h"
 
@@ -160,15 +168,40 @@ private:
   ListenerManagerStats stats_;
 };
 
+/**
+ * A filter chain of a listener: the transport socket factory and network filters that connections
+ * matching the filter chain are created with.
+ */
+class FilterChainImpl : public Network::FilterChain {
+public:
+  FilterChainImpl(Network::TransportSocketFactoryPtr&& transport_socket_factory,
+                  std::vector<Network::FilterFactoryCb>&& filters_factory)
+      : transport_socket_factory_(std::move(transport_socket_factory)),
+        filters_factory_(std::move(filters_factory)) {}
+
+  // Network::FilterChain
+  const Network::TransportSocketFactory& transportSocketFactory() const override {
+    return *transport_socket_factory_;
+  }
+  const std::vector<Network::FilterFactoryCb>& networkFilterFactories() const override {
+    return filters_factory_;
+  }
+
+private:
+  const Network::TransportSocketFactoryPtr transport_socket_factory_;
+  const std::vector<Network::FilterFactoryCb> filters_factory_;
+};
+
 // TODO(mattklein123): Consider getting rid of pre-worker start and post-worker start code by
 //                     initializing all listeners after workers are started.
 
 /**
- * Maps proto config to runtime config for a listener with a network filter chain.
+ * Maps proto config to runtime config for a listener with network filter chains.
  */
 class ListenerImpl : public Network::ListenerConfig,
                      public Configuration::ListenerFactoryContext,
                      public Network::DrainDecision,
+                     public Network::FilterChainManager,
                      public Network::FilterChainFactory,
                      public Configuration::TransportSocketFactoryContext,
                      Logger::Loggable<Logger::Id::config> {
@@ -213,16 +246,21 @@ public:
   const Network::Socket::OptionsSharedPtr& listenSocketOptions() { return listen_socket_options_; }
 
   // Network::ListenerConfig
+  Network::FilterChainManager& filterChainManager() override { return *this; }
   Network::FilterChainFactory& filterChainFactory() override { return *this; }
   Network::Socket& socket() override { return *socket_; }
+  Network::ConnectionBalancer* connectionBalancer() override { return connection_balancer_.get(); }
   bool bindToPort() override { return bind_to_port_; }
   bool handOffRestoredDestinationConnections() const override {
     return hand_off_restored_destination_connections_;
   }
-  Network::TransportSocketFactory& transportSocketFactory() override {
-    return *transport_socket_factories_[0];
-  }
   uint32_t perConnectionBufferLimitBytes() override { return per_connection_buffer_limit_bytes_; }
+  std::chrono::milliseconds listenerFiltersTimeout() const override {
+    return listener_filters_timeout_;
+  }
+  bool continueOnListenerFiltersTimeout() const override {
+    return continue_on_listener_filters_timeout_;
+  }
   Stats::Scope& listenerScope() override { return *listener_scope_; }
   uint64_t listenerTag() const override { return listener_tag_; }
   const std::string& name() const override { return name_; }
@@ -238,6 +276,7 @@ public:
   Tracing::HttpTracer& httpTracer() override { return parent_.server_.httpTracer(); }
   Init::Manager& initManager() override;
   const LocalInfo::LocalInfo& localInfo() override { return parent_.server_.localInfo(); }
+  OverloadManager& overloadManager() override { return parent_.server_.overloadManager(); }
   Envoy::Runtime::RandomGenerator& random() override { return parent_.server_.random(); }
   RateLimit::ClientPtr
   rateLimitClient(const absl::optional<std::chrono::milliseconds>& timeout) override {
@@ -260,8 +299,13 @@ public:
   // Network::DrainDecision
   bool drainClose() const override;
 
+  // Network::FilterChainManager
+  const Network::FilterChain*
+  findFilterChain(const Network::ConnectionSocket& socket) const override;
+
   // Network::FilterChainFactory
-  bool createNetworkFilterChain(Network::Connection& connection) override;
+  bool createNetworkFilterChain(Network::Connection& connection,
+                                const std::vector<Network::FilterFactoryCb>& factories) override;
   bool createListenerFilterChain(Network::ListenerFilterManager& manager) override;
 
   // Configuration::TransportSocketFactoryContext
@@ -269,16 +313,53 @@ public:
   Stats::Scope& statsScope() const override { return *listener_scope_; }
 
 private:
+  // Filter chains are found by walking these maps, from the destination port of a connection down
+  // to its application protocols. At each level an empty key (or port 0) stands for the filter
+  // chains that don't match on that criteria, which are only used if no other key matches.
+  // Server names are looked up by views of the requested server name, so that matching a
+  // connection doesn't allocate. The keys view the strings owned by server_name_keys_.
+  typedef std::unordered_map<std::string, const Network::FilterChain*> ApplicationProtocolsMap;
+  typedef std::unordered_map<absl::string_view, ApplicationProtocolsMap, StringViewHash>
+      ServerNamesMap;
+  struct DestinationIp {
+    uint32_t prefix_len_{};
+    ServerNamesMap server_names_;
+    // Wildcard server names keyed by their suffix, e.g. ".example.com" for "*.example.com".
+    ServerNamesMap wildcard_server_names_;
+  };
+  struct DestinationIps {
+    // Keyed by CidrRange::asString(), which is also the tag of the range in the trie.
+    std::unordered_map<std::string, DestinationIp> cidr_ranges_;
+    std::unique_ptr<Network::LcTrie::LcTrie> trie_;
+  };
+  typedef std::unordered_map<uint32_t, DestinationIps> DestinationPortsMap;
+
+  void addFilterChain(const envoy::api::v2::listener::FilterChainMatch& match,
+                      const Network::FilterChain* filter_chain);
+  const Network::FilterChain* findFilterChainForDestinationIp(
+      const DestinationIps& destination_ips, const Network::ConnectionSocket& socket) const;
+  const Network::FilterChain*
+  findFilterChainForServerName(const DestinationIp& destination_ip,
+                               const Network::ConnectionSocket& socket) const;
+  const Network::FilterChain*
+  findFilterChainForApplicationProtocols(const ApplicationProtocolsMap& application_protocols,
+                                         const Network::ConnectionSocket& socket) const;
+
   ListenerManagerImpl& parent_;
   Network::Address::InstanceConstSharedPtr address_;
   Network::SocketSharedPtr socket_;
   Stats::ScopePtr global_scope_;   // Stats with global named scope, but needed for LDS cleanup.
   Stats::ScopePtr listener_scope_; // Stats with listener named scope.
   std::vector<Ssl::ServerContextPtr> tls_contexts_;
-  std::vector<Network::TransportSocketFactoryPtr> transport_socket_factories_;
+  std::vector<Network::FilterChainSharedPtr> filter_chains_;
+  std::unordered_set<std::string> server_name_keys_;
+  DestinationPortsMap destination_ports_map_;
+  Network::ConnectionBalancerPtr connection_balancer_;
   const bool bind_to_port_;
   const bool hand_off_restored_destination_connections_;
   const uint32_t per_connection_buffer_limit_bytes_;
+  const std::chrono::milliseconds listener_filters_timeout_;
+  const bool continue_on_listener_filters_timeout_;
   const uint64_t listener_tag_;
   const std::string name_;
   const bool modifiable_;
@@ -286,7 +367,6 @@ private:
   const uint64_t hash_;
   InitManagerImpl dynamic_init_manager_;
   bool initialize_canceled_{};
-  std::vector<Configuration::NetworkFilterFactoryCb> filter_factories_;
   std::vector<Configuration::ListenerFilterFactoryCb> listener_filter_factories_;
   DrainManagerPtr local_drain_manager_;
   bool saw_listener_create_failure_{};
@@ -133,10 +133,7 @@ OptionsImpl::OptionsImpl(int argc, char** argv, const HotRestartVersionCb& hot_r
 
   hot_restart_disabled_ = disable_hot_restart.getValue();
   if (hot_restart_version_option.getValue()) {
-    std::cerr << hot_restart_version_cb(max_stats.getValue(),
-                                        max_obj_name_len.getValue() +
-                                            Stats::RawStatData::maxStatSuffixLength(),
-                                        !hot_restart_disabled_);
+    std::cerr << hot_restart_version_cb(!hot_restart_disabled_);
     throw NoServingException();
   }
 
@@ -0,0 +1,193 @@
+#include "server/overload_manager_impl.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Server {
+
+OverloadAction::OverloadAction(const envoy::config::overload::v2alpha::OverloadAction& config,
+                               Stats::Scope& stats_scope)
+    : active_gauge_(stats_scope.gauge(fmt::format("overload.{}.active", config.name()))) {
+  for (const auto& trigger_config : config.triggers()) {
+    if (!triggers_.emplace(trigger_config.name(), trigger_config.threshold().value()).second) {
+      throw EnvoyException(
+          fmt::format("Duplicate trigger resource for overload action {}", config.name()));
+    }
+  }
+  active_gauge_.set(0);
+}
+
+bool OverloadAction::updateResourcePressure(const std::string& resource, double pressure) {
+  const bool was_active = isActive();
+  const auto it = triggers_.find(resource);
+  ASSERT(it != triggers_.end());
+  if (pressure >= it->second) {
+    fired_triggers_.insert(resource);
+  } else {
+    fired_triggers_.erase(resource);
+  }
+
+  const bool active = isActive();
+  if (active == was_active) {
+    return false;
+  }
+  active_gauge_.set(active ? 1 : 0);
+  return true;
+}
+
+ThreadLocalOverloadStateImpl::ThreadLocalOverloadStateImpl(
+    const std::vector<std::string>& actions) {
+  for (const std::string& action : actions) {
+    actions_[action] = OverloadActionState::Inactive;
+  }
+}
+
+const OverloadActionState& ThreadLocalOverloadStateImpl::getState(const std::string& action) {
+  const auto it = actions_.find(action);
+  if (it == actions_.end()) {
+    return OverloadManager::getInactiveState();
+  }
+  return it->second;
+}
+
+void ThreadLocalOverloadStateImpl::setState(const std::string& action,
+                                            OverloadActionState state) {
+  const auto it = actions_.find(action);
+  ASSERT(it != actions_.end());
+  it->second = state;
+}
+
+OverloadManagerImpl::OverloadManagerImpl(
+    Event::Dispatcher& dispatcher, Stats::Scope& stats_scope,
+    ThreadLocal::SlotAllocator& slot_allocator,
+    const envoy::config::overload::v2alpha::OverloadManager& config,
+    ResourceMonitorFactory monitor_factory)
+    : dispatcher_(dispatcher), tls_(slot_allocator.allocateSlot()),
+      refresh_interval_(
+          std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, refresh_interval, 1000))) {
+  for (const auto& resource : config.resource_monitors()) {
+    const std::string& name = resource.name();
+    ResourceMonitorPtr monitor = monitor_factory(resource);
+    auto result =
+        resources_.emplace(std::piecewise_construct, std::forward_as_tuple(name),
+                           std::forward_as_tuple(name, std::move(monitor), *this, stats_scope));
+    if (!result.second) {
+      throw EnvoyException(fmt::format("Duplicate resource monitor {}", name));
+    }
+  }
+
+  for (const auto& action : config.actions()) {
+    const std::string& name = action.name();
+    auto result = actions_.emplace(std::piecewise_construct, std::forward_as_tuple(name),
+                                   std::forward_as_tuple(action, stats_scope));
+    if (!result.second) {
+      throw EnvoyException(fmt::format("Duplicate overload action {}", name));
+    }
+    action_names_.push_back(name);
+
+    for (const auto& trigger : action.triggers()) {
+      const std::string& resource = trigger.name();
+      if (resources_.find(resource) == resources_.end()) {
+        throw EnvoyException(
+            fmt::format("Unknown trigger resource {} for overload action {}", resource, name));
+      }
+      resource_to_actions_[resource].push_back(name);
+    }
+  }
+}
+
+void OverloadManagerImpl::start() {
+  ASSERT(!started_);
+  started_ = true;
+
+  const std::vector<std::string> action_names = action_names_;
+  tls_->set([action_names](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ThreadLocalOverloadStateImpl>(action_names);
+  });
+
+  if (resources_.empty()) {
+    return;
+  }
+
+  timer_ = dispatcher_.createTimer([this]() -> void {
+    for (auto& resource : resources_) {
+      resource.second.update();
+    }
+    timer_->enableTimer(refresh_interval_);
+  });
+  timer_->enableTimer(refresh_interval_);
+}
+
+bool OverloadManagerImpl::registerForAction(const std::string& action,
+                                            Event::Dispatcher& dispatcher,
+                                            OverloadActionCb callback) {
+  ASSERT(!started_);
+  if (actions_.find(action) == actions_.end()) {
+    ENVOY_LOG(debug, "No overload action configured for {}.", action);
+    return false;
+  }
+
+  action_to_callbacks_.emplace(std::piecewise_construct, std::forward_as_tuple(action),
+                               std::forward_as_tuple(dispatcher, callback));
+  return true;
+}
+
+ThreadLocalOverloadState& OverloadManagerImpl::getThreadLocalOverloadState() {
+  return tls_->getTyped<ThreadLocalOverloadStateImpl>();
+}
+
+void OverloadManagerImpl::updateResourcePressure(const std::string& resource, double pressure) {
+  const auto actions = resource_to_actions_.find(resource);
+  if (actions == resource_to_actions_.end()) {
+    return;
+  }
+
+  for (const std::string& action : actions->second) {
+    if (!actions_.at(action).updateResourcePressure(resource, pressure)) {
+      continue;
+    }
+
+    const OverloadActionState state = actions_.at(action).isActive()
+                                          ? OverloadActionState::Active
+                                          : OverloadActionState::Inactive;
+    ENVOY_LOG(info, "Overload action {} became {}", action,
+              state == OverloadActionState::Active ? "active" : "inactive");
+    tls_->runOnAllThreads([this, action, state]() -> void {
+      tls_->getTyped<ThreadLocalOverloadStateImpl>().setState(action, state);
+    });
+
+    const auto callbacks = action_to_callbacks_.equal_range(action);
+    for (auto it = callbacks.first; it != callbacks.second; ++it) {
+      OverloadActionCb callback = it->second.callback_;
+      it->second.dispatcher_.post([callback, state]() -> void { callback(state); });
+    }
+  }
+}
+
+OverloadManagerImpl::Resource::Resource(const std::string& name, ResourceMonitorPtr monitor,
+                                        OverloadManagerImpl& manager, Stats::Scope& stats_scope)
+    : name_(name), monitor_(std::move(monitor)), manager_(manager),
+      pressure_gauge_(stats_scope.gauge(fmt::format("overload.{}.pressure", name))),
+      failed_updates_counter_(
+          stats_scope.counter(fmt::format("overload.{}.failed_updates", name))) {}
+
+void OverloadManagerImpl::Resource::update() {
+  double pressure;
+  try {
+    pressure = monitor_->pressure();
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(debug, "Failed to update resource {}: {}", name_, e.what());
+    failed_updates_counter_.inc();
+    return;
+  }
+
+  pressure_gauge_.set(static_cast<uint64_t>(pressure * 100));
+  manager_.updateResourcePressure(name_, pressure);
+}
+
+} // namespace Server
+} // namespace Envoy
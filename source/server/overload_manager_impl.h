@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "envoy/config/overload/v2alpha/overload.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/server/overload_manager.h"
+#include "envoy/server/resource_monitor.h"
+#include "envoy/stats/stats.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Creates the monitor for a configured resource.
+ */
+typedef std::function<ResourceMonitorPtr(const envoy::config::overload::v2alpha::ResourceMonitor&)>
+    ResourceMonitorFactory;
+
+/**
+ * An overload action and the triggers which activate it.
+ */
+class OverloadAction {
+public:
+  OverloadAction(const envoy::config::overload::v2alpha::OverloadAction& config,
+                 Stats::Scope& stats_scope);
+
+  /**
+   * Re-evaluate the triggers on a resource against its latest pressure.
+   * @param resource supplies the name of the resource monitor.
+   * @param pressure supplies the latest pressure of the resource.
+   * @return bool true if the action changed state.
+   */
+  bool updateResourcePressure(const std::string& resource, double pressure);
+
+  /**
+   * @return bool whether any of the action's triggers are firing.
+   */
+  bool isActive() const { return !fired_triggers_.empty(); }
+
+private:
+  // Trigger thresholds keyed by resource monitor name.
+  std::unordered_map<std::string, double> triggers_;
+  std::unordered_set<std::string> fired_triggers_;
+  Stats::Gauge& active_gauge_;
+};
+
+/**
+ * Thread local overload action state. The map is fully populated before any reader runs, so the
+ * references handed out by getState() stay valid.
+ */
+class ThreadLocalOverloadStateImpl : public ThreadLocalOverloadState {
+public:
+  explicit ThreadLocalOverloadStateImpl(const std::vector<std::string>& actions);
+
+  // Server::ThreadLocalOverloadState
+  const OverloadActionState& getState(const std::string& action) override;
+
+  void setState(const std::string& action, OverloadActionState state);
+
+private:
+  std::unordered_map<std::string, OverloadActionState> actions_;
+};
+
+class OverloadManagerImpl : public OverloadManager, Logger::Loggable<Logger::Id::main> {
+public:
+  /**
+   * @throw EnvoyException if the configuration is invalid.
+   */
+  OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::Scope& stats_scope,
+                      ThreadLocal::SlotAllocator& slot_allocator,
+                      const envoy::config::overload::v2alpha::OverloadManager& config,
+                      ResourceMonitorFactory monitor_factory);
+
+  // Server::OverloadManager
+  void start() override;
+  bool registerForAction(const std::string& action, Event::Dispatcher& dispatcher,
+                         OverloadActionCb callback) override;
+  ThreadLocalOverloadState& getThreadLocalOverloadState() override;
+
+private:
+  class Resource {
+  public:
+    Resource(const std::string& name, ResourceMonitorPtr monitor, OverloadManagerImpl& manager,
+             Stats::Scope& stats_scope);
+
+    void update();
+
+  private:
+    const std::string name_;
+    ResourceMonitorPtr monitor_;
+    OverloadManagerImpl& manager_;
+    Stats::Gauge& pressure_gauge_;
+    Stats::Counter& failed_updates_counter_;
+  };
+
+  struct ActionCallback {
+    ActionCallback(Event::Dispatcher& dispatcher, OverloadActionCb callback)
+        : dispatcher_(dispatcher), callback_(callback) {}
+    Event::Dispatcher& dispatcher_;
+    OverloadActionCb callback_;
+  };
+
+  void updateResourcePressure(const std::string& resource, double pressure);
+
+  bool started_{};
+  Event::Dispatcher& dispatcher_;
+  ThreadLocal::SlotPtr tls_;
+  const std::chrono::milliseconds refresh_interval_;
+  Event::TimerPtr timer_;
+  std::unordered_map<std::string, Resource> resources_;
+  std::unordered_map<std::string, OverloadAction> actions_;
+  std::vector<std::string> action_names_;
+  // Names of the actions with a trigger on each resource, keyed by resource name.
+  std::unordered_map<std::string, std::vector<std::string>> resource_to_actions_;
+  std::unordered_multimap<std::string, ActionCallback> action_to_callbacks_;
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,83 @@
+#include "server/resource_monitor_impl.h"
+
+#include <dirent.h>
+#include <sys/resource.h>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/fmt.h"
+#include "common/memory/stats.h"
+
+namespace Envoy {
+namespace Server {
+
+double HeapResourceMonitor::pressure() {
+  return static_cast<double>(Memory::Stats::totalCurrentlyAllocated()) / max_heap_bytes_;
+}
+
+double ConnectionsResourceMonitor::pressure() {
+  return static_cast<double>(num_connections_()) / max_connections_;
+}
+
+FileDescriptorsResourceMonitor::FileDescriptorsResourceMonitor(uint64_t max_fds)
+    : max_fds_(max_fds) {
+  if (max_fds_ == 0) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY ||
+        limit.rlim_cur == 0) {
+      throw EnvoyException("unable to determine the file descriptor limit of the process");
+    }
+    max_fds_ = limit.rlim_cur;
+  }
+}
+
+double FileDescriptorsResourceMonitor::pressure() {
+  DIR* dir = opendir("/proc/self/fd");
+  if (dir == nullptr) {
+    throw EnvoyException("unable to open /proc/self/fd");
+  }
+
+  uint64_t num_fds = 0;
+  while (const dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      num_fds++;
+    }
+  }
+  closedir(dir);
+
+  // Do not count the descriptor opendir() itself used.
+  if (num_fds > 0) {
+    num_fds--;
+  }
+  return static_cast<double>(num_fds) / max_fds_;
+}
+
+ResourceMonitorPtr ResourceMonitorUtility::createResourceMonitor(
+    const envoy::config::overload::v2alpha::ResourceMonitor& config,
+    std::function<uint64_t()> num_connections) {
+  switch (config.resource()) {
+  case envoy::config::overload::v2alpha::ResourceMonitor::HEAP:
+    if (config.max() == 0) {
+      throw EnvoyException(
+          fmt::format("resource monitor {}: max must be set for HEAP", config.name()));
+    }
+    if (!Memory::Stats::available()) {
+      throw EnvoyException(fmt::format(
+          "resource monitor {}: HEAP is only supported in builds with tcmalloc", config.name()));
+    }
+    return ResourceMonitorPtr{new HeapResourceMonitor(config.max())};
+  case envoy::config::overload::v2alpha::ResourceMonitor::CONNECTIONS:
+    if (config.max() == 0) {
+      throw EnvoyException(
+          fmt::format("resource monitor {}: max must be set for CONNECTIONS", config.name()));
+    }
+    return ResourceMonitorPtr{new ConnectionsResourceMonitor(config.max(), num_connections)};
+  case envoy::config::overload::v2alpha::ResourceMonitor::FILE_DESCRIPTORS:
+    return ResourceMonitorPtr{new FileDescriptorsResourceMonitor(config.max())};
+  default:
+    throw EnvoyException(fmt::format("resource monitor {}: unknown resource", config.name()));
+  }
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "envoy/config/overload/v2alpha/overload.pb.h"
+#include "envoy/server/resource_monitor.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Monitors the heap allocated through tcmalloc. Only created when Memory::Stats are available.
+ */
+class HeapResourceMonitor : public ResourceMonitor {
+public:
+  explicit HeapResourceMonitor(uint64_t max_heap_bytes) : max_heap_bytes_(max_heap_bytes) {}
+
+  // Server::ResourceMonitor
+  double pressure() override;
+
+private:
+  const uint64_t max_heap_bytes_;
+};
+
+/**
+ * Monitors the number of active downstream connections.
+ */
+class ConnectionsResourceMonitor : public ResourceMonitor {
+public:
+  ConnectionsResourceMonitor(uint64_t max_connections, std::function<uint64_t()> num_connections)
+      : max_connections_(max_connections), num_connections_(num_connections) {}
+
+  // Server::ResourceMonitor
+  double pressure() override;
+
+private:
+  const uint64_t max_connections_;
+  std::function<uint64_t()> num_connections_;
+};
+
+/**
+ * Monitors the number of file descriptors open in the process by counting the entries of
+ * /proc/self/fd.
+ */
+class FileDescriptorsResourceMonitor : public ResourceMonitor {
+public:
+  /**
+   * @param max_fds supplies the maximum number of file descriptors. 0 uses the soft limit on
+   *        open files of the process.
+   * @throw EnvoyException if max_fds is 0 and the soft limit can not be determined.
+   */
+  explicit FileDescriptorsResourceMonitor(uint64_t max_fds);
+
+  // Server::ResourceMonitor
+  double pressure() override;
+
+private:
+  uint64_t max_fds_;
+};
+
+class ResourceMonitorUtility {
+public:
+  /**
+   * Create the monitor for a configured resource.
+   * @param config supplies the resource monitor configuration.
+   * @param num_connections supplies the number of active downstream connections of the server.
+   * @throw EnvoyException if the configuration is invalid.
+   */
+  static ResourceMonitorPtr
+  createResourceMonitor(const envoy::config::overload::v2alpha::ResourceMonitor& config,
+                        std::function<uint64_t()> num_connections);
+};
+
+} // namespace Server
+} // namespace Envoy
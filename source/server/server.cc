@@ -5,7 +5,9 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "envoy/config/bootstrap/v2//bootstrap.pb.validate.h"
 #include "envoy/config/bootstrap/v2/bootstrap.pb.h"
@@ -14,6 +16,7 @@
 #include "envoy/event/timer.h"
 #include "envoy/network/dns.h"
 #include "envoy/server/options.h"
+#include "envoy/stats/timespan.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/api/api_impl.h"
@@ -35,6 +38,7 @@
 #include "server/configuration_impl.h"
 #include "server/connection_handler_impl.h"
 #include "server/guarddog_impl.h"
+#include "server/resource_monitor_impl.h"
 #include "server/test_hooks.h"
 
 namespace Envoy {
@@ -49,7 +53,7 @@ InstanceImpl::InstanceImpl(Options& options, Network::Address::InstanceConstShar
       api_(new Api::Impl(options.fileFlushIntervalMsec())), dispatcher_(api_->allocateDispatcher()),
       singleton_manager_(new Singleton::ManagerImpl()),
       handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher_)),
-      listener_component_factory_(*this), worker_factory_(thread_local_, *api_, hooks),
+      listener_component_factory_(*this), worker_factory_(thread_local_, *api_, hooks, store),
       dns_resolver_(dispatcher_->createDnsResolver({})),
       access_log_manager_(*api_, *dispatcher_, access_log_lock, store), terminated_(false) {
 
@@ -100,24 +104,49 @@ void InstanceImpl::failHealthcheck(bool fail) {
 }
 
 void InstanceUtil::flushCountersAndGaugesToSinks(const std::list<Stats::SinkPtr>& sinks,
-                                                 Stats::Store& store) {
+                                                 Stats::Store& store,
+                                                 const Stats::ChangedMetrics& changed) {
+  std::vector<Stats::Sink*> changed_sinks;
+  std::vector<Stats::Sink*> snapshot_sinks;
   for (const auto& sink : sinks) {
     sink->beginFlush();
+    (sink->wantsChangedOnly() ? changed_sinks : snapshot_sinks).push_back(sink.get());
   }
 
-  for (const Stats::CounterSharedPtr& counter : store.counters()) {
-    uint64_t delta = counter->latch();
-    if (counter->used()) {
-      for (const auto& sink : sinks) {
-        sink->flushCounter(*counter, delta);
-      }
+  for (const auto& counter : changed.counters_) {
+    for (Stats::Sink* sink : changed_sinks) {
+      sink->flushCounter(*counter.first, counter.second);
+    }
+  }
+
+  for (const Stats::GaugeSharedPtr& gauge : changed.gauges_) {
+    for (Stats::Sink* sink : changed_sinks) {
+      sink->flushGauge(*gauge, gauge->value());
     }
   }
 
-  for (const Stats::GaugeSharedPtr& gauge : store.gauges()) {
-    if (gauge->used()) {
-      for (const auto& sink : sinks) {
-        sink->flushGauge(*gauge, gauge->value());
+  // Only sinks that want snapshots pay for listing all the stats of the store. Counters of
+  // overlapping scopes share storage, so their deltas are looked up by name.
+  if (!snapshot_sinks.empty()) {
+    std::unordered_map<absl::string_view, uint64_t, StringViewHash> deltas;
+    for (const auto& counter : changed.counters_) {
+      deltas.emplace(counter.first->name(), counter.second);
+    }
+
+    for (const Stats::CounterSharedPtr& counter : store.counters()) {
+      if (counter->used()) {
+        const auto delta = deltas.find(counter->name());
+        for (Stats::Sink* sink : snapshot_sinks) {
+          sink->flushCounter(*counter, delta != deltas.end() ? delta->second : 0);
+        }
+      }
+    }
+
+    for (const Stats::GaugeSharedPtr& gauge : store.gauges()) {
+      if (gauge->used()) {
+        for (Stats::Sink* sink : snapshot_sinks) {
+          sink->flushGauge(*gauge, gauge->value());
+        }
       }
     }
   }
@@ -140,7 +169,13 @@ void InstanceImpl::flushStats() {
   server_stats_->days_until_first_cert_expiring_.set(
       sslContextManager().daysUntilFirstCertExpires());
 
-  InstanceUtil::flushCountersAndGaugesToSinks(config_->statsSinks(), stats_store_);
+  Stats::Timespan flush_time(server_stats_->stats_flush_time_ms_);
+  stats_store_.latchChangedMetrics(changed_metrics_);
+  InstanceUtil::flushCountersAndGaugesToSinks(config_->statsSinks(), stats_store_,
+                                              changed_metrics_);
+  changed_metrics_.clear();
+  flush_time.complete();
+
   stat_flush_timer_->enableTimer(config_->statsFlushInterval());
 }
 
@@ -219,7 +254,8 @@ void InstanceImpl::initialize(Options& options,
   stats_store_.setTagProducer(Config::Utility::createTagProducer(bootstrap));
 
   server_stats_.reset(
-      new ServerStats{ALL_SERVER_STATS(POOL_GAUGE_PREFIX(stats_store_, "server."))});
+      new ServerStats{ALL_SERVER_STATS(POOL_GAUGE_PREFIX(stats_store_, "server."),
+                                       POOL_HISTOGRAM_PREFIX(stats_store_, "server."))});
 
   failHealthcheck(false);
 
@@ -247,9 +283,28 @@ void InstanceImpl::initialize(Options& options,
                              initial_config.admin().address(), *this,
                              stats_store_.createScope("listener.admin.")));
   handler_->addListener(admin_->listener());
+  if (bootstrap.enable_dispatcher_stats()) {
+    // Timing every loop iteration and callback has a cost, so it is only done when asked for.
+    main_thread_dispatcher_stats_ =
+        dispatcher_->initializeStats(stats_store_, "server.main_thread.dispatcher.");
+    worker_factory_.enableDispatcherStats();
+    admin_->addHandler("/event_loop", "print event loop latency of the main thread and workers",
+                       [this](absl::string_view, Http::HeaderMap&, Buffer::Instance& response) {
+                         return handlerEventLoop(response);
+                       },
+                       false, false);
+  }
 
   loadServerFlags(initial_config.flagsPath());
 
+  // The overload manager is created before the workers so they can register for its actions.
+  overload_manager_.reset(new OverloadManagerImpl(
+      dispatcher(), stats(), threadLocal(), bootstrap.overload_manager(),
+      [this](const envoy::config::overload::v2alpha::ResourceMonitor& config) {
+        return ResourceMonitorUtility::createResourceMonitor(
+            config, [this]() -> uint64_t { return numConnections(); });
+      }));
+
   // Workers get created first so they register for thread local updates.
   listener_manager_.reset(
       new ListenerManagerImpl(*this, listener_component_factory_, worker_factory_));
@@ -268,9 +323,13 @@ void InstanceImpl::initialize(Options& options,
   // Once we have runtime we can initialize the SSL context manager.
   ssl_context_manager_.reset(new Ssl::ContextManagerImpl(*runtime_loader_));
 
+  // Clusters start out with the hosts our parent has for them, so that they can serve traffic
+  // while their first DNS resolutions and EDS updates are in flight.
+  Upstream::ClusterHostsMap parent_cluster_hosts;
+  restarter_.getParentClusterHosts(parent_cluster_hosts);
   cluster_manager_factory_.reset(new Upstream::ProdClusterManagerFactory(
       runtime(), stats(), threadLocal(), random(), dnsResolver(), sslContextManager(), dispatcher(),
-      localInfo()));
+      localInfo(), parent_cluster_hosts));
 
   // Now the configuration gets parsed. The configuration may start setting thread local data
   // per above. See MainImpl::initialize() for why we do this pointer dance.
@@ -291,6 +350,10 @@ void InstanceImpl::initialize(Options& options,
   // started and before our own run() loop runs.
   guard_dog_.reset(
       new Server::GuardDogImpl(stats_store_, *config_, ProdMonotonicTimeSource::instance_));
+
+  // All threads are registered for thread local updates and all workers have registered for
+  // overload actions, so resource monitoring can start.
+  overload_manager_->start();
 }
 
 void InstanceImpl::startWorkers() {
@@ -335,6 +398,17 @@ void InstanceImpl::loadServerFlags(const absl::optional<std::string>& flags_path
   }
 }
 
+Http::Code InstanceImpl::handlerEventLoop(Buffer::Instance& response) {
+  response.add("main_thread:\n");
+  response.add(main_thread_dispatcher_stats_->format());
+  const auto& worker_stats = worker_factory_.dispatcherStats();
+  for (size_t i = 0; i < worker_stats.size(); i++) {
+    response.add(fmt::format("worker_{}:\n", i));
+    response.add(worker_stats[i]->format());
+  }
+  return Http::Code::OK;
+}
+
 uint64_t InstanceImpl::numConnections() { return listener_manager_->numConnections(); }
 
 RunHelper::RunHelper(Event::Dispatcher& dispatcher, Upstream::ClusterManager& cm,
@@ -1,5 +1,8 @@
 #include "server/watchdog_impl.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include "envoy/event/dispatcher.h"
 
 #include "common/common/assert.h"
@@ -9,9 +12,15 @@ namespace Server {
 
 void WatchDogImpl::startWatchdog(Event::Dispatcher& dispatcher) {
   timer_ = dispatcher.createTimer([this]() -> void {
+    const MonotonicTime now = time_source_.currentTime();
+    const auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - timer_enabled_time_ - timer_interval_);
+    touch_delay_.recordValue(std::max<int64_t>(delay.count(), 0));
     this->touch();
+    timer_enabled_time_ = now;
     timer_->enableTimer(timer_interval_);
   });
+  timer_enabled_time_ = time_source_.currentTime();
   timer_->enableTimer(timer_interval_);
 }
 
@@ -6,6 +6,7 @@
 #include "envoy/common/time.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/server/watchdog.h"
+#include "envoy/stats/stats.h"
 
 namespace Envoy {
 namespace Server {
@@ -19,11 +20,14 @@ public:
   /**
    * @param thread_id A system thread ID (such as from Thread::currentThreadId())
    * @param interval WatchDog timer interval (used after startWatchdog())
+   * @param touch_delay histogram of how late the timer touches the WatchDog, which is how long
+   *        the thread was too busy to run it. It is recorded on the watched thread.
    */
-  WatchDogImpl(int32_t thread_id, MonotonicTimeSource& tsource, std::chrono::milliseconds interval)
+  WatchDogImpl(int32_t thread_id, MonotonicTimeSource& tsource, std::chrono::milliseconds interval,
+               Stats::Histogram& touch_delay)
       : thread_id_(thread_id), time_source_(tsource),
         latest_touch_time_since_epoch_(tsource.currentTime().time_since_epoch()),
-        timer_interval_(interval) {}
+        timer_interval_(interval), touch_delay_(touch_delay) {}
 
   int32_t threadId() const override { return thread_id_; }
   MonotonicTime lastTouchTime() const override {
@@ -42,6 +46,9 @@ private:
   std::atomic<std::chrono::steady_clock::duration> latest_touch_time_since_epoch_;
   Event::TimerPtr timer_;
   const std::chrono::milliseconds timer_interval_;
+  Stats::Histogram& touch_delay_;
+  // When the timer was last enabled, so that it should fire timer_interval_ later.
+  MonotonicTime timer_enabled_time_;
 };
 
 } // namespace Server
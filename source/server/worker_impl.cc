@@ -7,6 +7,7 @@
 #include "envoy/server/configuration.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/common/fmt.h"
 #include "common/common/thread.h"
 
 #include "server/connection_handler_impl.h"
@@ -14,17 +15,30 @@
 namespace Envoy {
 namespace Server {
 
-WorkerPtr ProdWorkerFactory::createWorker() {
+WorkerPtr ProdWorkerFactory::createWorker(OverloadManager& overload_manager) {
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher());
-  return WorkerPtr{new WorkerImpl(
-      tls_, hooks_, std::move(dispatcher),
-      Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher)})};
+  if (dispatcher_stats_enabled_) {
+    dispatcher_stats_.push_back(dispatcher->initializeStats(
+        stats_scope_, fmt::format("server.worker_{}.dispatcher.", next_worker_index_)));
+  }
+  const std::string per_handler_stat_prefix = fmt::format("worker_{}.", next_worker_index_++);
+  return WorkerPtr{new WorkerImpl(tls_, hooks_, std::move(dispatcher),
+                                  Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(
+                                      ENVOY_LOGGER(), *dispatcher, per_handler_stat_prefix)},
+                                  overload_manager)};
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, TestHooks& hooks,
-                       Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler)
+                       Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
+                       OverloadManager& overload_manager)
     : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)) {
   tls_.registerThread(*dispatcher_, false);
+  overload_manager.registerForAction(
+      OverloadActionNames::get().StopAcceptingConnections, *dispatcher_,
+      [this](OverloadActionState state) -> void { stopAcceptingConnectionsCb(state); });
+  overload_manager.registerForAction(
+      OverloadActionNames::get().ShrinkBufferLimits, *dispatcher_,
+      [this](OverloadActionState state) -> void { shrinkBufferLimitsCb(state); });
 }
 
 void WorkerImpl::addListener(Network::ListenerConfig& listener, AddListenerCompletion completion) {
@@ -104,5 +118,27 @@ void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
   watchdog.reset();
 }
 
+void WorkerImpl::stopAcceptingConnectionsCb(OverloadActionState state) {
+  switch (state) {
+  case OverloadActionState::Active:
+    handler_->disableListeners();
+    break;
+  case OverloadActionState::Inactive:
+    handler_->enableListeners();
+    break;
+  }
+}
+
+void WorkerImpl::shrinkBufferLimitsCb(OverloadActionState state) {
+  switch (state) {
+  case OverloadActionState::Active:
+    handler_->setPerConnectionBufferLimitCap(SHRUNK_BUFFER_LIMIT_BYTES);
+    break;
+  case OverloadActionState::Inactive:
+    handler_->setPerConnectionBufferLimitCap(0);
+    break;
+  }
+}
+
 } // namespace Server
 } // namespace Envoy
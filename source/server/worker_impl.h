@@ -2,12 +2,16 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/listener_manager.h"
+#include "envoy/server/overload_manager.h"
 #include "envoy/server/worker.h"
+#include "envoy/stats/stats.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/logger.h"
@@ -20,16 +24,35 @@ namespace Server {
 
 class ProdWorkerFactory : public WorkerFactory, Logger::Loggable<Logger::Id::main> {
 public:
-  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, TestHooks& hooks)
-      : tls_(tls), api_(api), hooks_(hooks) {}
+  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, TestHooks& hooks,
+                    Stats::Scope& stats_scope)
+      : tls_(tls), api_(api), hooks_(hooks), stats_scope_(stats_scope) {}
 
   // Server::WorkerFactory
-  WorkerPtr createWorker() override;
+  WorkerPtr createWorker(OverloadManager& overload_manager) override;
+
+  /**
+   * Record event loop statistics in the workers created from now on.
+   */
+  void enableDispatcherStats() { dispatcher_stats_enabled_ = true; }
+
+  /**
+   * @return the summaries of the event loop latency of the workers created so far, in order, if
+   *         event loop statistics are enabled.
+   */
+  const std::vector<Event::DispatcherStatsSummaryConstSharedPtr>& dispatcherStats() const {
+    return dispatcher_stats_;
+  }
 
 private:
   ThreadLocal::Instance& tls_;
   Api::Api& api_;
   TestHooks& hooks_;
+  Stats::Scope& stats_scope_;
+  // Index of the next worker, naming its per worker listener and event loop stats.
+  uint32_t next_worker_index_{};
+  bool dispatcher_stats_enabled_{};
+  std::vector<Event::DispatcherStatsSummaryConstSharedPtr> dispatcher_stats_;
 };
 
 /**
@@ -38,7 +61,7 @@ private:
 class WorkerImpl : public Worker, Logger::Loggable<Logger::Id::main> {
 public:
   WorkerImpl(ThreadLocal::Instance& tls, TestHooks& hooks, Event::DispatcherPtr&& dispatcher,
-             Network::ConnectionHandlerPtr handler);
+             Network::ConnectionHandlerPtr handler, OverloadManager& overload_manager);
 
   // Server::Worker
   void addListener(Network::ListenerConfig& listener, AddListenerCompletion completion) override;
@@ -50,7 +73,13 @@ public:
   void stopListeners() override;
 
 private:
+  // Per connection buffer limit of connections accepted while the shrink_buffer_limits overload
+  // action is active.
+  static const uint32_t SHRUNK_BUFFER_LIMIT_BYTES = 16 * 1024;
+
   void threadRoutine(GuardDog& guard_dog);
+  void stopAcceptingConnectionsCb(OverloadActionState state);
+  void shrinkBufferLimitsCb(OverloadActionState state);
 
   ThreadLocal::Instance& tls_;
   TestHooks& hooks_;
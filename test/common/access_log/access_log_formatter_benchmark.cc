@@ -0,0 +1,78 @@
+// Usage: bazel run //test/common/access_log:access_log_formatter_benchmark
+
+#include <string>
+
+#include "common/access_log/access_log_formatter.h"
+#include "common/http/header_map_impl.h"
+#include "common/request_info/request_info_impl.h"
+
+#include "testing/base/public/benchmark.h"
+
+namespace Envoy {
+namespace AccessLog {
+namespace {
+
+// A completed request, with the fields used by the default access log format populated.
+struct TestRequest {
+  TestRequest() : request_info_(Http::Protocol::Http11) {
+    request_headers_.insertMethod().value(std::string("GET"));
+    request_headers_.insertPath().value(std::string("/api/v1/resources/12345?verbose=true"));
+    request_headers_.insertHost().value(std::string("service.example.com"));
+    request_headers_.insertForwardedFor().value(std::string("10.1.2.3"));
+    request_headers_.insertUserAgent().value(
+        std::string("Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko)"));
+    request_headers_.insertRequestId().value(std::string("2f3b8ba9-35bb-4cbe-a4bd-0ed4cc25f7ac"));
+    response_headers_.insertStatus().value(std::string("200"));
+    response_headers_.insertEnvoyUpstreamServiceTime().value(std::string("12"));
+
+    request_info_.response_code_ = 200;
+    request_info_.bytes_received_ = 512;
+    request_info_.bytes_sent_ = 16384;
+    request_info_.onRequestComplete();
+  }
+
+  Http::HeaderMapImpl request_headers_;
+  Http::HeaderMapImpl response_headers_;
+  RequestInfo::RequestInfoImpl request_info_;
+};
+
+// Formats the default access log line into a new string for each request.
+static void BM_AccessLogFormatterFormat(benchmark::State& state) {
+  TestRequest request;
+  FormatterPtr formatter = AccessLogFormatUtils::defaultAccessLogFormatter();
+  for (auto _ : state) {
+    std::string line = formatter->format(request.request_headers_, request.response_headers_,
+                                         request.request_info_);
+    benchmark::DoNotOptimize(line);
+  }
+}
+BENCHMARK(BM_AccessLogFormatterFormat);
+
+// Formats the default access log line into a buffer reused across requests, as the file access
+// log does.
+static void BM_AccessLogFormatterFormatTo(benchmark::State& state) {
+  TestRequest request;
+  FormatterPtr formatter = AccessLogFormatUtils::defaultAccessLogFormatter();
+  std::string line;
+  for (auto _ : state) {
+    line.clear();
+    formatter->formatTo(request.request_headers_, request.response_headers_, request.request_info_,
+                        line);
+    benchmark::DoNotOptimize(line);
+  }
+}
+BENCHMARK(BM_AccessLogFormatterFormatTo);
+
+} // namespace
+} // namespace AccessLog
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
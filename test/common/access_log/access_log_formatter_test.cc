@@ -31,6 +31,17 @@ TEST(AccessLogFormatUtilsTest, protocolToString) {
   EXPECT_EQ("-", AccessLogFormatUtils::protocolToString({}));
 }
 
+TEST(AccessLogFormatUtilsTest, appendNumbers) {
+  std::string output = "x";
+  AccessLogFormatUtils::appendInteger(0, output);
+  AccessLogFormatUtils::appendInteger(18446744073709551615UL, output);
+  AccessLogFormatUtils::appendDuration(std::chrono::nanoseconds(5000000), output);
+  AccessLogFormatUtils::appendDuration({}, output);
+  EXPECT_EQ("x0184467440737095516155-", output);
+  EXPECT_EQ("-", AccessLogFormatUtils::durationToString({}));
+  EXPECT_EQ("5", AccessLogFormatUtils::durationToString(std::chrono::nanoseconds(5000000)));
+}
+
 TEST(AccessLogFormatterTest, plainStringFormatter) {
   PlainStringFormatter formatter("plain");
   Http::TestHeaderMapImpl header{{":method", "GET"}, {":path", "/"}};
@@ -372,6 +383,26 @@ TEST(AccessLogFormatterTest, CompositeFormatterSuccess) {
   }
 }
 
+TEST(AccessLogFormatterTest, CompositeFormatterAppends) {
+  NiceMock<RequestInfo::MockRequestInfo> request_info;
+  Http::TestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
+  Http::TestHeaderMapImpl response_header{{"second", "PUT"}};
+  EXPECT_CALL(request_info, bytesReceived()).WillRepeatedly(Return(123));
+  absl::optional<uint32_t> response_code{404};
+  EXPECT_CALL(request_info, responseCode()).WillRepeatedly(Return(response_code));
+
+  FormatterImpl formatter("%REQ(first):2% %RESPONSE_CODE% %BYTES_RECEIVED% %RESP(missing)%");
+  EXPECT_EQ("GE 404 123 -", formatter.format(request_header, response_header, request_info));
+
+  // formatTo() appends to what is already in the output, so a buffer can be reused.
+  std::string output = "line: ";
+  formatter.formatTo(request_header, response_header, request_info, output);
+  EXPECT_EQ("line: GE 404 123 -", output);
+  output.clear();
+  formatter.formatTo(request_header, response_header, request_info, output);
+  EXPECT_EQ("GE 404 123 -", output);
+}
+
 TEST(AccessLogFormatterTest, ParserFailures) {
   AccessLogFormatParser parser;
 
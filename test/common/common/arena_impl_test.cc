@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/common/arena_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+
+bool aligned(void* ptr, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(ArenaImplTest, NoHeapUntilUsed) {
+  ArenaImpl arena;
+  EXPECT_EQ(0U, arena.heapBytes());
+}
+
+TEST(ArenaImplTest, Alignment) {
+  ArenaImpl arena;
+  for (size_t alignment : {1, 2, 4, 8, 16}) {
+    arena.allocate(1, 1);
+    EXPECT_TRUE(aligned(arena.allocate(3, alignment), alignment));
+  }
+}
+
+TEST(ArenaImplTest, SmallAllocationsShareBlocks) {
+  ArenaImpl arena(1024);
+  char* first = static_cast<char*>(arena.allocate(16, 8));
+  char* second = static_cast<char*>(arena.allocate(16, 8));
+  EXPECT_EQ(first + 16, second);
+  const size_t heap_bytes = arena.heapBytes();
+  EXPECT_GE(heap_bytes, 1024U);
+
+  // Filling the first block obtains a second one of twice the size.
+  for (size_t i = 0; i < 62; i++) {
+    arena.allocate(16, 8);
+  }
+  EXPECT_EQ(heap_bytes, arena.heapBytes());
+  arena.allocate(16, 8);
+  EXPECT_GE(arena.heapBytes(), heap_bytes + 2048);
+}
+
+TEST(ArenaImplTest, LargeAllocationGetsOwnBlock) {
+  ArenaImpl arena(1024);
+  char* small = static_cast<char*>(arena.allocate(16, 8));
+  char* large = static_cast<char*>(arena.allocate(4096, 16));
+  EXPECT_TRUE(aligned(large, 16));
+  memset(large, 0, 4096);
+
+  // The space left in the first block is still used.
+  EXPECT_EQ(small + 16, arena.allocate(16, 8));
+}
+
+TEST(ArenaImplTest, BlocksStopGrowing) {
+  ArenaImpl arena(ArenaImpl::kMaxBlockSize);
+  arena.allocate(ArenaImpl::kMaxBlockSize / 2, 8);
+  const size_t heap_bytes = arena.heapBytes();
+  arena.allocate(ArenaImpl::kMaxBlockSize / 2 + 1, 8);
+  arena.allocate(16, 8);
+  EXPECT_LT(arena.heapBytes(), heap_bytes + 2 * ArenaImpl::kMaxBlockSize + 1024);
+}
+
+class Tracked {
+public:
+  Tracked(std::vector<std::string>& destroyed, const std::string& name)
+      : destroyed_(destroyed), name_(name) {}
+  ~Tracked() { destroyed_.push_back(name_); }
+
+private:
+  std::vector<std::string>& destroyed_;
+  const std::string name_;
+};
+
+TEST(ArenaImplTest, CreateDestroysInReverseOrder) {
+  std::vector<std::string> destroyed;
+  {
+    ArenaImpl arena;
+    arena.create<Tracked>(destroyed, "a");
+    uint64_t* value = arena.create<uint64_t>(5);
+    EXPECT_EQ(5U, *value);
+    arena.create<Tracked>(destroyed, "b");
+    EXPECT_TRUE(destroyed.empty());
+  }
+  EXPECT_EQ((std::vector<std::string>{"b", "a"}), destroyed);
+}
+
+} // namespace Envoy
@@ -0,0 +1,63 @@
+#include <atomic>
+#include <set>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/fmt.h"
+#include "common/common/thread.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Thread {
+
+TEST(ParallelForTest, CallsEachIndexOnce) {
+  std::vector<std::atomic<uint32_t>> calls(1000);
+  std::atomic<uint32_t> total{0};
+  parallelFor(4, calls.size(), 10, [&calls, &total](size_t i) {
+    calls[i]++;
+    total++;
+  });
+  EXPECT_EQ(1000, total);
+  for (const auto& count : calls) {
+    EXPECT_EQ(1, count);
+  }
+}
+
+TEST(ParallelForTest, ShortLoopOnCallingThread) {
+  const ThreadId calling_thread = Thread::currentThreadId();
+  std::set<ThreadId> threads;
+  parallelFor(4, 5, 10, [&threads](size_t) { threads.insert(Thread::currentThreadId()); });
+  EXPECT_EQ(std::set<ThreadId>({calling_thread}), threads);
+
+  threads.clear();
+  parallelFor(0, 100, 0, [&threads](size_t) { threads.insert(Thread::currentThreadId()); });
+  EXPECT_EQ(std::set<ThreadId>({calling_thread}), threads);
+}
+
+TEST(ParallelForTest, Empty) {
+  parallelFor(4, 0, 1, [](size_t) { FAIL(); });
+}
+
+// Whichever thread gets to its index first, the exception rethrown is that of the lowest index.
+TEST(ParallelForTest, RethrowsLowestIndexException) {
+  for (uint32_t concurrency : {1, 2, 8}) {
+    std::atomic<uint32_t> calls{0};
+    try {
+      parallelFor(concurrency, 1000, 1, [&calls](size_t i) {
+        calls++;
+        if (i == 900 || i == 300 || i == 600) {
+          throw EnvoyException(fmt::format("index {}", i));
+        }
+      });
+      FAIL();
+    } catch (const EnvoyException& e) {
+      EXPECT_STREQ("index 300", e.what());
+    }
+    EXPECT_LE(301, calls);
+  }
+}
+
+} // namespace Thread
+} // namespace Envoy
@@ -1,16 +1,21 @@
 #include <condition_variable>
 #include <functional>
 #include <mutex>
+#include <string>
 
 #include "common/common/thread.h"
 #include "common/event/dispatcher_impl.h"
+#include "common/event/dispatcher_stats_summary_impl.h"
+#include "common/stats/stats_impl.h"
 
 #include "test/mocks/common.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::HasSubstr;
 using testing::InSequence;
+using testing::Not;
 
 namespace Envoy {
 namespace Event {
@@ -54,6 +59,55 @@ TEST(DeferredDeleteTest, DeferredDelete) {
   dispatcher.clearDeferredDeleteList();
 }
 
+TEST(DispatcherStatsTest, RecordCallbackLatencies) {
+  Stats::IsolatedStoreImpl stats_store;
+  DispatcherImpl dispatcher;
+  DispatcherStatsSummaryConstSharedPtr summary = dispatcher.initializeStats(stats_store, "test.");
+  ReadyWatcher watcher;
+
+  TimerPtr timer = dispatcher.createTimer([&]() -> void {
+    dispatcher.post([&]() -> void {
+      watcher.ready();
+      dispatcher.exit();
+    });
+  });
+  timer->enableTimer(std::chrono::milliseconds(0));
+
+  EXPECT_CALL(watcher, ready());
+  dispatcher.run(Dispatcher::RunType::Block);
+
+  const std::string output = summary->format();
+  EXPECT_THAT(output, HasSubstr("test.timer_duration_us: count=1 "));
+  EXPECT_THAT(output, HasSubstr("test.post_duration_us: count=1 "));
+  EXPECT_THAT(output, HasSubstr("test.file_event_duration_us: count=0 "));
+  EXPECT_THAT(output, HasSubstr("test.deferred_delete_duration_us: count=0 "));
+  EXPECT_THAT(output, Not(HasSubstr("test.loop_duration_us: count=0 ")));
+  EXPECT_THAT(output, Not(HasSubstr("test.poll_delay_us: count=0 ")));
+}
+
+TEST(LatencyBucketsTest, Quantiles) {
+  LatencyBuckets buckets;
+  EXPECT_EQ(0, buckets.count());
+  EXPECT_EQ(0, buckets.quantile(0.5));
+
+  for (uint64_t i = 0; i < 98; i++) {
+    buckets.record(5);
+  }
+  buckets.record(100);
+  buckets.record(1000);
+  EXPECT_EQ(100, buckets.count());
+  EXPECT_EQ(1000, buckets.max());
+  // 5 is in [4, 8), 100 in [64, 128), and 1000 in [512, 1024).
+  EXPECT_EQ(7, buckets.quantile(0.5));
+  EXPECT_EQ(7, buckets.quantile(0.98));
+  EXPECT_EQ(127, buckets.quantile(0.99));
+  // The upper bound of the last bucket is capped at the largest latency.
+  EXPECT_EQ(1000, buckets.quantile(1));
+
+  buckets.record(0);
+  EXPECT_EQ(0, buckets.quantile(0));
+}
+
 class DispatcherImplTest : public ::testing::Test {
 protected:
   DispatcherImplTest() : dispatcher_(std::make_unique<DispatcherImpl>()), work_finished_(false) {
@@ -38,7 +38,7 @@ public:
 // UNAVAILABLE.
 TEST_F(EnvoyAsyncClientImplTest, StreamHttpStartFail) {
   MockAsyncStreamCallbacks<helloworld::HelloReply> grpc_callbacks;
-  ON_CALL(http_client_, start(_, _, false)).WillByDefault(Return(nullptr));
+  ON_CALL(http_client_, start(_, _, false, 0)).WillByDefault(Return(nullptr));
   EXPECT_CALL(grpc_callbacks, onRemoteClose(Status::GrpcStatus::Unavailable, ""));
   auto* grpc_stream = grpc_client_->start(*method_descriptor_, grpc_callbacks);
   EXPECT_EQ(grpc_stream, nullptr);
@@ -48,7 +48,7 @@ TEST_F(EnvoyAsyncClientImplTest, StreamHttpStartFail) {
 // UNAVAILABLE.
 TEST_F(EnvoyAsyncClientImplTest, RequestHttpStartFail) {
   MockAsyncRequestCallbacks<helloworld::HelloReply> grpc_callbacks;
-  ON_CALL(http_client_, start(_, _, true)).WillByDefault(Return(nullptr));
+  ON_CALL(http_client_, start(_, _, true, 0)).WillByDefault(Return(nullptr));
   EXPECT_CALL(grpc_callbacks, onFailure(Status::GrpcStatus::Unavailable, "", _));
   helloworld::HelloRequest request_msg;
 
@@ -74,10 +74,11 @@ TEST_F(EnvoyAsyncClientImplTest, StreamHttpSendHeadersFail) {
   MockAsyncStreamCallbacks<helloworld::HelloReply> grpc_callbacks;
   Http::AsyncClient::StreamCallbacks* http_callbacks;
   Http::MockAsyncClientStream http_stream;
-  EXPECT_CALL(http_client_, start(_, _, false))
+  EXPECT_CALL(http_client_, start(_, _, false, 0))
       .WillOnce(Invoke(
           [&http_callbacks, &http_stream](Http::AsyncClient::StreamCallbacks& callbacks,
-                                          const absl::optional<std::chrono::milliseconds>&, bool) {
+                                          const absl::optional<std::chrono::milliseconds>&, bool,
+                                          uint32_t) {
             http_callbacks = &callbacks;
             return &http_stream;
           }));
@@ -100,10 +101,11 @@ TEST_F(EnvoyAsyncClientImplTest, RequestHttpSendHeadersFail) {
   MockAsyncRequestCallbacks<helloworld::HelloReply> grpc_callbacks;
   Http::AsyncClient::StreamCallbacks* http_callbacks;
   Http::MockAsyncClientStream http_stream;
-  EXPECT_CALL(http_client_, start(_, _, true))
+  EXPECT_CALL(http_client_, start(_, _, true, 0))
       .WillOnce(Invoke(
           [&http_callbacks, &http_stream](Http::AsyncClient::StreamCallbacks& callbacks,
-                                          const absl::optional<std::chrono::milliseconds>&, bool) {
+                                          const absl::optional<std::chrono::milliseconds>&, bool,
+                                          uint32_t) {
             http_callbacks = &callbacks;
             return &http_stream;
           }));
@@ -805,9 +805,8 @@ public:
     Ssl::ServerContextConfigImpl cfg(tls_context);
 
     static Stats::Scope* upstream_stats_store = new Stats::IsolatedStoreImpl();
-    return std::make_unique<Ssl::ServerSslSocketFactory>(cfg, EMPTY_STRING,
-                                                         std::vector<std::string>{}, true,
-                                                         context_manager_, *upstream_stats_store);
+    return std::make_unique<Ssl::ServerSslSocketFactory>(
+        cfg, std::vector<std::string>{}, context_manager_, *upstream_stats_store);
   }
 
   bool use_client_cert_{};
@@ -98,7 +98,7 @@ TEST_F(AsyncClientImplTest, BasicStream) {
   EXPECT_CALL(stream_callbacks_, onData(BufferEqual(body.get()), true));
 
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream->sendHeaders(headers, false);
   stream->sendData(*body, true);
 
@@ -216,7 +216,7 @@ TEST_F(AsyncClientImplTest, RetryWithStream) {
 
   headers.insertEnvoyRetryOn().value(Headers::get().EnvoyRetryOnValues._5xx);
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), true);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), true, 0);
   stream->sendHeaders(headers, false);
   stream->sendData(*body, true);
 
@@ -264,7 +264,7 @@ TEST_F(AsyncClientImplTest, MultipleStreams) {
   EXPECT_CALL(stream_callbacks_, onData(BufferEqual(body.get()), true));
 
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream->sendHeaders(headers, false);
   stream->sendData(*body, true);
 
@@ -289,7 +289,7 @@ TEST_F(AsyncClientImplTest, MultipleStreams) {
   expectResponseHeaders(stream_callbacks2, 503, true);
 
   AsyncClient::Stream* stream2 =
-      client_.start(stream_callbacks2, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks2, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream2->sendHeaders(headers2, false);
   stream2->sendData(*body2, true);
 
@@ -389,7 +389,7 @@ TEST_F(AsyncClientImplTest, StreamAndRequest) {
   EXPECT_CALL(stream_callbacks_, onData(BufferEqual(body.get()), true));
 
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream->sendHeaders(headers, false);
   stream->sendData(*body, true);
 
@@ -429,7 +429,7 @@ TEST_F(AsyncClientImplTest, StreamWithTrailers) {
   EXPECT_CALL(stream_callbacks_, onTrailers_(HeaderMapEqualRef(&expected_trailers)));
 
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream->sendHeaders(headers, false);
   stream->sendData(*body, false);
   stream->sendTrailers(trailers);
@@ -508,7 +508,7 @@ TEST_F(AsyncClientImplTest, LocalResetAfterStreamStart) {
   EXPECT_CALL(stream_callbacks_, onReset());
 
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream->sendHeaders(headers, false);
   stream->sendData(*body, false);
 
@@ -540,7 +540,7 @@ TEST_F(AsyncClientImplTest, ResetInOnHeaders) {
   EXPECT_CALL(stream_encoder_, encodeData(BufferEqual(body.get()), false));
 
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
 
   TestHeaderMapImpl expected_headers{{":status", "200"}};
   EXPECT_CALL(stream_callbacks_, onHeaders_(HeaderMapEqualRef(&expected_headers), false))
@@ -582,7 +582,7 @@ TEST_F(AsyncClientImplTest, RemoteResetAfterStreamStart) {
   EXPECT_CALL(stream_callbacks_, onReset());
 
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream->sendHeaders(headers, false);
   stream->sendData(*body, false);
 
@@ -623,7 +623,7 @@ TEST_F(AsyncClientImplTest, ResetStream) {
   EXPECT_CALL(stream_callbacks_, onReset());
 
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream->sendHeaders(message_->headers(), true);
   stream->reset();
 }
@@ -656,7 +656,7 @@ TEST_F(AsyncClientImplTest, DestroyWithActiveStream) {
   EXPECT_CALL(stream_encoder_.stream_, resetStream(_));
   EXPECT_CALL(stream_callbacks_, onReset());
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream->sendHeaders(message_->headers(), false);
 }
 
@@ -728,7 +728,7 @@ TEST_F(AsyncClientImplTest, StreamTimeout) {
   EXPECT_CALL(stream_callbacks_, onData(_, true));
 
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, std::chrono::milliseconds(40), false);
+      client_.start(stream_callbacks_, std::chrono::milliseconds(40), false, 0);
   stream->sendHeaders(message_->headers(), true);
   timer_->callback_();
 
@@ -800,7 +800,7 @@ TEST_F(AsyncClientImplTest, DisableTimerWithStream) {
   EXPECT_CALL(stream_callbacks_, onReset());
 
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, std::chrono::milliseconds(40), false);
+      client_.start(stream_callbacks_, std::chrono::milliseconds(40), false, 0);
   stream->sendHeaders(message_->headers(), true);
   stream->reset();
 }
@@ -831,7 +831,7 @@ TEST_F(AsyncClientImplTest, MultipleDataStream) {
   EXPECT_CALL(stream_callbacks_, onData(BufferEqual(body.get()), false));
 
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream->sendHeaders(headers, false);
   stream->sendData(*body, false);
 
@@ -856,12 +856,18 @@ TEST_F(AsyncClientImplTest, WatermarkCallbacks) {
   TestHeaderMapImpl headers;
   HttpTestUtility::addDefaultHeaders(headers);
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream->sendHeaders(headers, false);
   Http::StreamDecoderFilterCallbacks* filter_callbacks =
       static_cast<Http::AsyncStreamImpl*>(stream);
+  EXPECT_FALSE(stream->isAboveWriteBufferHighWatermark());
   filter_callbacks->onDecoderFilterAboveWriteBufferHighWatermark();
+  EXPECT_TRUE(stream->isAboveWriteBufferHighWatermark());
+  filter_callbacks->onDecoderFilterAboveWriteBufferHighWatermark();
+  filter_callbacks->onDecoderFilterBelowWriteBufferLowWatermark();
+  EXPECT_TRUE(stream->isAboveWriteBufferHighWatermark());
   filter_callbacks->onDecoderFilterBelowWriteBufferLowWatermark();
+  EXPECT_FALSE(stream->isAboveWriteBufferHighWatermark());
   EXPECT_CALL(stream_callbacks_, onReset());
 }
 
@@ -869,7 +875,7 @@ TEST_F(AsyncClientImplTest, RdsGettersTest) {
   TestHeaderMapImpl headers;
   HttpTestUtility::addDefaultHeaders(headers);
   AsyncClient::Stream* stream =
-      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false);
+      client_.start(stream_callbacks_, absl::optional<std::chrono::milliseconds>(), false, 0);
   stream->sendHeaders(headers, false);
   Http::StreamDecoderFilterCallbacks* filter_callbacks =
       static_cast<Http::AsyncStreamImpl*>(stream);
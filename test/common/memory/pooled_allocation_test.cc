@@ -0,0 +1,91 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/memory/pooled_allocation.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Memory {
+
+namespace {
+
+class PooledObject : public Pooled<AllocationTag::Stream> {
+public:
+  virtual ~PooledObject() {}
+
+  char data_[56];
+};
+
+class LargerPooledObject : public PooledObject {
+public:
+  char more_data_[104];
+};
+
+} // namespace
+
+// The tests do nothing under address sanitizer, which disables pooling so that use after free is
+// still detected.
+TEST(PooledAllocationTest, ReuseFreedBlock) {
+  if (!AllocationPools::enabled()) {
+    return;
+  }
+  const uint64_t reused = AllocationPools::reusedAllocations(AllocationTag::Stream);
+  const uint64_t blocks = AllocationPools::pooledBlocks(AllocationTag::Stream);
+  const uint64_t allocations = TaggedAllocationStats::allocations(AllocationTag::Stream);
+
+  std::unique_ptr<PooledObject> object = std::make_unique<PooledObject>();
+  EXPECT_EQ(allocations + 1, TaggedAllocationStats::allocations(AllocationTag::Stream));
+  void* const address = object.get();
+  object.reset();
+  EXPECT_EQ(blocks + 1, AllocationPools::pooledBlocks(AllocationTag::Stream));
+  EXPECT_EQ(allocations, TaggedAllocationStats::allocations(AllocationTag::Stream));
+
+  object = std::make_unique<PooledObject>();
+  EXPECT_EQ(address, object.get());
+  EXPECT_EQ(reused + 1, AllocationPools::reusedAllocations(AllocationTag::Stream));
+  EXPECT_EQ(blocks, AllocationPools::pooledBlocks(AllocationTag::Stream));
+}
+
+// Subclasses of different sizes are pooled separately, by the size of the most derived type.
+TEST(PooledAllocationTest, PoolPerSize) {
+  if (!AllocationPools::enabled()) {
+    return;
+  }
+  const uint64_t bytes = AllocationPools::pooledBytes(AllocationTag::Stream);
+
+  std::unique_ptr<PooledObject> larger = std::make_unique<LargerPooledObject>();
+  void* const address = larger.get();
+  larger.reset();
+  EXPECT_EQ(bytes + sizeof(LargerPooledObject),
+            AllocationPools::pooledBytes(AllocationTag::Stream));
+
+  std::unique_ptr<PooledObject> object = std::make_unique<PooledObject>();
+  EXPECT_NE(address, object.get());
+  larger = std::make_unique<LargerPooledObject>();
+  EXPECT_EQ(address, larger.get());
+}
+
+// Each thread keeps at most MaxBlocksPerSize blocks per size, and returns them to the heap on exit.
+TEST(PooledAllocationTest, BoundedAndReleasedOnThreadExit) {
+  if (!AllocationPools::enabled()) {
+    return;
+  }
+  const uint64_t blocks = AllocationPools::pooledBlocks(AllocationTag::Stream);
+
+  std::thread thread([blocks]() {
+    std::vector<std::unique_ptr<PooledObject>> objects;
+    for (size_t i = 0; i < AllocationPools::MaxBlocksPerSize + 10; i++) {
+      objects.push_back(std::make_unique<PooledObject>());
+    }
+    objects.clear();
+    EXPECT_EQ(blocks + AllocationPools::MaxBlocksPerSize,
+              AllocationPools::pooledBlocks(AllocationTag::Stream));
+  });
+  thread.join();
+  EXPECT_EQ(blocks, AllocationPools::pooledBlocks(AllocationTag::Stream));
+}
+
+} // namespace Memory
+} // namespace Envoy
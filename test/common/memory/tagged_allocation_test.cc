@@ -0,0 +1,75 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/memory/tagged_allocation.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Memory {
+
+namespace {
+
+class TaggedObject : public Tagged<AllocationTag::Connection> {
+public:
+  virtual ~TaggedObject() {}
+
+  char data_[40];
+};
+
+class LargerTaggedObject : public TaggedObject {
+public:
+  char more_data_[88];
+};
+
+} // namespace
+
+TEST(TaggedAllocationTest, NewDelete) {
+  const uint64_t bytes = TaggedAllocationStats::allocatedBytes(AllocationTag::Connection);
+  const uint64_t allocations = TaggedAllocationStats::allocations(AllocationTag::Connection);
+
+  std::unique_ptr<TaggedObject> object = std::make_unique<TaggedObject>();
+  EXPECT_EQ(bytes + sizeof(TaggedObject),
+            TaggedAllocationStats::allocatedBytes(AllocationTag::Connection));
+  EXPECT_EQ(allocations + 1, TaggedAllocationStats::allocations(AllocationTag::Connection));
+
+  // Deleting through a base pointer releases the size of the most derived type.
+  std::unique_ptr<TaggedObject> larger = std::make_unique<LargerTaggedObject>();
+  EXPECT_EQ(bytes + sizeof(TaggedObject) + sizeof(LargerTaggedObject),
+            TaggedAllocationStats::allocatedBytes(AllocationTag::Connection));
+  larger.reset();
+  object.reset();
+  EXPECT_EQ(bytes, TaggedAllocationStats::allocatedBytes(AllocationTag::Connection));
+  EXPECT_EQ(allocations, TaggedAllocationStats::allocations(AllocationTag::Connection));
+}
+
+TEST(TaggedAllocationTest, FreedOnOtherThread) {
+  const uint64_t bytes = TaggedAllocationStats::allocatedBytes(AllocationTag::Connection);
+
+  std::vector<std::unique_ptr<TaggedObject>> objects;
+  std::thread allocator([&objects]() {
+    for (int i = 0; i < 100; i++) {
+      objects.push_back(std::make_unique<TaggedObject>());
+    }
+  });
+  allocator.join();
+  EXPECT_EQ(bytes + 100 * sizeof(TaggedObject),
+            TaggedAllocationStats::allocatedBytes(AllocationTag::Connection));
+
+  objects.clear();
+  EXPECT_EQ(bytes, TaggedAllocationStats::allocatedBytes(AllocationTag::Connection));
+}
+
+TEST(TaggedAllocationTest, TagNames) {
+  EXPECT_EQ("buffer", TaggedAllocationStats::tagName(AllocationTag::Buffer));
+  EXPECT_EQ("connection", TaggedAllocationStats::tagName(AllocationTag::Connection));
+  EXPECT_EQ("conn_pool", TaggedAllocationStats::tagName(AllocationTag::ConnPool));
+  EXPECT_EQ("header_map", TaggedAllocationStats::tagName(AllocationTag::HeaderMap));
+  EXPECT_EQ("http_codec", TaggedAllocationStats::tagName(AllocationTag::HttpCodec));
+  EXPECT_EQ("stats", TaggedAllocationStats::tagName(AllocationTag::Stats));
+  EXPECT_EQ("stream", TaggedAllocationStats::tagName(AllocationTag::Stream));
+}
+
+} // namespace Memory
+} // namespace Envoy
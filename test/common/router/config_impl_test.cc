@@ -1995,6 +1995,41 @@ TEST(RouteMatcherTest, Retry) {
                 .retryOn());
 }
 
+TEST(RouteMatcherTest, HedgeDelay) {
+  std::string yaml = R"EOF(
+name: foo
+virtual_hosts:
+  - name: www2
+    domains: ["www.lyft.com"]
+    routes:
+      - match: { prefix: "/foo" }
+        route:
+          cluster: www2
+          retry_policy:
+            hedge_delay: 0.025s
+      - match: { prefix: "/" }
+        route:
+          cluster: www2
+          retry_policy:
+            retry_on: 5xx
+  )EOF";
+
+  NiceMock<Runtime::MockLoader> runtime;
+  NiceMock<Upstream::MockClusterManager> cm;
+  ConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), runtime, cm, true);
+
+  EXPECT_EQ(std::chrono::milliseconds(25),
+            config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)
+                ->routeEntry()
+                ->retryPolicy()
+                .hedgeDelay());
+  EXPECT_EQ(std::chrono::milliseconds(0),
+            config.route(genHeaders("www.lyft.com", "/", "GET"), 0)
+                ->routeEntry()
+                ->retryPolicy()
+                .hedgeDelay());
+}
+
 TEST(RouteMatcherTest, GrpcRetry) {
   std::string json = R"EOF(
 {
@@ -1,68 +1,216 @@
 #include <chrono>
 #include <string>
 
+#include "common/buffer/buffer_impl.h"
+#include "common/http/async_client_impl.h"
 #include "common/http/headers.h"
-#include "common/http/message_impl.h"
 #include "common/router/shadow_writer_impl.h"
+#include "common/stats/stats_impl.h"
 
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/router/mocks.h"
+#include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
 using testing::_;
 
 namespace Envoy {
 namespace Router {
 
-void expectShadowWriter(absl::string_view host, absl::string_view shadowed_host) {
-  Upstream::MockClusterManager cm;
-  ShadowWriterImpl writer(cm);
-
-  // Success case
-  Http::MessagePtr message(new Http::RequestMessageImpl());
-  message->headers().insertHost().value(std::string(host));
-  EXPECT_CALL(cm, httpAsyncClientForCluster("foo")).WillOnce(ReturnRef(cm.async_client_));
-  Http::MockAsyncClientRequest request(&cm.async_client_);
-  Http::AsyncClient::Callbacks* callback;
-  EXPECT_CALL(cm.async_client_,
-              send_(_, _, absl::optional<std::chrono::milliseconds>(std::chrono::milliseconds(5))))
-      .WillOnce(Invoke(
-          [&](Http::MessagePtr& inner_message, Http::AsyncClient::Callbacks& callbacks,
-              const absl::optional<std::chrono::milliseconds>&) -> Http::AsyncClient::Request* {
-            EXPECT_EQ(message, inner_message);
-            EXPECT_EQ(shadowed_host, message->headers().Host()->value().c_str());
-            callback = &callbacks;
-            return &request;
-          }));
-  writer.shadow("foo", std::move(message), std::chrono::milliseconds(5));
-
-  Http::MessagePtr response(new Http::RequestMessageImpl());
-  callback->onSuccess(std::move(response));
-
-  // Failure case
-  message.reset(new Http::RequestMessageImpl());
-  message->headers().insertHost().value(std::string(host));
-  EXPECT_CALL(cm, httpAsyncClientForCluster("bar")).WillOnce(ReturnRef(cm.async_client_));
-  EXPECT_CALL(cm.async_client_,
-              send_(_, _, absl::optional<std::chrono::milliseconds>(std::chrono::milliseconds(10))))
-      .WillOnce(Invoke(
-          [&](Http::MessagePtr& inner_message, Http::AsyncClient::Callbacks& callbacks,
-              const absl::optional<std::chrono::milliseconds>&) -> Http::AsyncClient::Request* {
-            EXPECT_EQ(message, inner_message);
-            EXPECT_EQ(shadowed_host, message->headers().Host()->value().c_str());
-            callback = &callbacks;
-            return &request;
-          }));
-  writer.shadow("bar", std::move(message), std::chrono::milliseconds(10));
-  callback->onFailure(Http::AsyncClient::FailureReason::Reset);
+class ShadowWriterImplTest : public testing::Test {
+public:
+  ShadowStreamPtr streamShadow(const std::string& host, bool end_stream) {
+    Http::TestHeaderMapImpl headers{{":method", "POST"}, {":path", "/"}, {":authority", host}};
+    EXPECT_CALL(cm_, httpAsyncClientForCluster("foo"));
+    EXPECT_CALL(cm_.async_client_,
+                start(_, absl::optional<std::chrono::milliseconds>(std::chrono::milliseconds(5)),
+                      false, 1024))
+        .WillOnce(Invoke([this](Http::AsyncClient::StreamCallbacks& callbacks,
+                                const absl::optional<std::chrono::milliseconds>&, bool,
+                                uint32_t) -> Http::AsyncClient::Stream* {
+          callbacks_ = &callbacks;
+          return &stream_;
+        }));
+    EXPECT_CALL(stream_, sendHeaders(_, end_stream))
+        .WillOnce(Invoke([this](Http::HeaderMap& headers, bool) -> void {
+          shadowed_host_ = headers.Host()->value().c_str();
+        }));
+    return writer_.streamShadow("foo", headers, end_stream, std::chrono::milliseconds(5), 1024);
+  }
+
+  void expectReset() {
+    EXPECT_CALL(stream_, reset()).WillOnce(Invoke([this]() -> void { callbacks_->onReset(); }));
+    expectDeleted();
+  }
+
+  void expectDeleted() { EXPECT_CALL(cm_.async_client_.dispatcher_, deferredDelete_(_)); }
+
+  void respond() {
+    Http::HeaderMapPtr response_headers{new Http::TestHeaderMapImpl{{":status", "200"}}};
+    callbacks_->onHeaders(std::move(response_headers), true);
+  }
+
+  uint64_t abandoned() {
+    return cm_.thread_local_cluster_.cluster_.info_->stats().retry_or_shadow_abandoned_.value();
+  }
+
+  NiceMock<Upstream::MockClusterManager> cm_;
+  ShadowWriterImpl writer_{cm_};
+  NiceMock<Http::MockAsyncClientStream> stream_;
+  Http::AsyncClient::StreamCallbacks* callbacks_{};
+  std::string shadowed_host_;
+};
+
+TEST_F(ShadowWriterImplTest, HostRewrite) {
+  for (const auto& hosts : std::vector<std::pair<std::string, std::string>>{
+           {"cluster1", "cluster1-shadow"},
+           {"cluster1:8000", "cluster1-shadow:8000"},
+           {"cluster1:80", "cluster1-shadow:80"}}) {
+    ShadowStreamPtr stream = streamShadow(hosts.first, true);
+    ASSERT_NE(nullptr, stream);
+    EXPECT_EQ(hosts.second, shadowed_host_);
+
+    // The request is complete, so the response is waited for after the handle is gone.
+    stream.reset();
+    expectDeleted();
+    respond();
+  }
+}
+
+TEST_F(ShadowWriterImplTest, UnknownCluster) {
+  EXPECT_CALL(cm_, get("foo")).WillOnce(Return(nullptr));
+  EXPECT_CALL(cm_.async_client_, start(_, _, _, _)).Times(0);
+  Http::TestHeaderMapImpl headers{{":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  EXPECT_EQ(nullptr,
+            writer_.streamShadow("foo", headers, true, std::chrono::milliseconds(5), 1024).get());
+}
+
+TEST_F(ShadowWriterImplTest, StreamBodyAndTrailers) {
+  ShadowStreamPtr stream = streamShadow("cluster1", false);
+
+  Buffer::OwnedImpl data("hello");
+  EXPECT_CALL(stream_, sendData(BufferStringEqual("hello"), false))
+      .WillOnce(Invoke([](Buffer::Instance& data, bool) -> void { data.drain(data.length()); }));
+  stream->sendData(data, false);
+  // The caller's data is left alone, since it still goes to the primary upstream.
+  EXPECT_EQ("hello", TestUtility::bufferToString(data));
+
+  Http::TestHeaderMapImpl trailers{{"some", "trailer"}};
+  EXPECT_CALL(stream_, sendTrailers(HeaderMapEqualRef(&trailers)));
+  stream->sendTrailers(trailers);
+  stream.reset();
+
+  expectDeleted();
+  respond();
+  EXPECT_EQ(0U, abandoned());
+}
+
+TEST_F(ShadowWriterImplTest, ResponseBeforeHandleReleased) {
+  ShadowStreamPtr stream = streamShadow("cluster1", false);
+
+  Buffer::OwnedImpl data("hello");
+  EXPECT_CALL(stream_, sendData(_, true));
+  stream->sendData(data, true);
+
+  expectDeleted();
+  respond();
+  EXPECT_CALL(stream_, reset()).Times(0);
+  stream.reset();
 }
 
-TEST(ShadowWriterImplTest, All) {
-  expectShadowWriter("cluster1", "cluster1-shadow");
-  expectShadowWriter("cluster1:8000", "cluster1-shadow:8000");
-  expectShadowWriter("cluster1:80", "cluster1-shadow:80");
+TEST_F(ShadowWriterImplTest, AbandonedWhenHandleReleasedEarly) {
+  ShadowStreamPtr stream = streamShadow("cluster1", false);
+
+  expectReset();
+  stream.reset();
+  EXPECT_EQ(0U, abandoned());
+}
+
+TEST_F(ShadowWriterImplTest, AbandonedAboveHighWatermark) {
+  ShadowStreamPtr stream = streamShadow("cluster1", false);
+
+  Buffer::OwnedImpl data("hello");
+  EXPECT_CALL(stream_, sendData(_, false));
+  stream->sendData(data, false);
+
+  EXPECT_CALL(stream_, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  EXPECT_CALL(stream_, sendData(_, _)).Times(0);
+  expectReset();
+  stream->sendData(data, false);
+  EXPECT_EQ(1U, abandoned());
+
+  // The rest of the request is dropped.
+  EXPECT_CALL(stream_, sendTrailers(_)).Times(0);
+  Http::TestHeaderMapImpl trailers{{"some", "trailer"}};
+  stream->sendTrailers(trailers);
+  stream.reset();
+}
+
+// The body is queued by the async client while the shadow cluster is connecting, up to the buffer
+// limit the shadow was started with.
+TEST_F(ShadowWriterImplTest, AbandonedAboveBufferLimitWhileConnecting) {
+  Stats::IsolatedStoreImpl stats_store;
+  NiceMock<LocalInfo::MockLocalInfo> local_info;
+  NiceMock<Runtime::MockLoader> runtime;
+  NiceMock<Runtime::MockRandomGenerator> random;
+  Http::AsyncClientImpl client(*cm_.thread_local_cluster_.cluster_.info_, stats_store,
+                               cm_.async_client_.dispatcher_, local_info, cm_, runtime, random,
+                               ShadowWriterPtr{new NiceMock<MockShadowWriter>()});
+  EXPECT_CALL(cm_, httpAsyncClientForCluster("foo")).WillOnce(ReturnRef(client));
+  NiceMock<Http::ConnectionPool::MockCancellable> cancellable;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _)).WillOnce(Return(&cancellable));
+
+  Http::TestHeaderMapImpl headers{{":method", "POST"}, {":path", "/"}, {":authority", "host"}};
+  ShadowStreamPtr stream =
+      writer_.streamShadow("foo", headers, false, std::chrono::milliseconds(5), 4);
+  ASSERT_NE(nullptr, stream);
+
+  Buffer::OwnedImpl data("hello world");
+  stream->sendData(data, false);
+  EXPECT_EQ(1U, cm_.thread_local_cluster_.cluster_.info_->stats()
+                    .upstream_flow_control_backed_up_total_.value());
+  EXPECT_EQ(0U, abandoned());
+
+  // The queued body is released rather than sent on once the shadow cluster is connected.
+  EXPECT_CALL(cancellable, cancel());
+  stream->sendData(data, false);
+  EXPECT_EQ(1U, abandoned());
+  stream.reset();
+}
+
+TEST_F(ShadowWriterImplTest, AbandonedAfterEarlyResponse) {
+  ShadowStreamPtr stream = streamShadow("cluster1", false);
+  respond();
+
+  EXPECT_CALL(stream_, sendData(_, _)).Times(0);
+  expectReset();
+  Buffer::OwnedImpl data("hello");
+  stream->sendData(data, true);
+  EXPECT_EQ(0U, abandoned());
+  stream.reset();
+}
+
+TEST_F(ShadowWriterImplTest, StreamReset) {
+  ShadowStreamPtr stream = streamShadow("cluster1", false);
+
+  expectDeleted();
+  callbacks_->onReset();
+
+  EXPECT_CALL(stream_, sendData(_, _)).Times(0);
+  EXPECT_CALL(stream_, reset()).Times(0);
+  Buffer::OwnedImpl data("hello");
+  stream->sendData(data, true);
+  stream.reset();
 }
 
 } // namespace Router
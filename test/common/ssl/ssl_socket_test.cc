@@ -1,6 +1,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "common/buffer/buffer_impl.h"
 #include "common/common/empty_string.h"
@@ -53,7 +54,7 @@ void testUtil(const std::string& client_ctx_json, const std::string& server_ctx_
   Json::ObjectSharedPtr server_ctx_loader = TestEnvironment::jsonLoadFromString(server_ctx_json);
   ServerContextConfigImpl server_ctx_config(*server_ctx_loader);
   ContextManagerImpl manager(runtime);
-  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, "", {}, true, manager,
+  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, {}, manager,
                                                         stats_store);
 
   Event::DispatcherImpl dispatcher;
@@ -145,17 +146,39 @@ const std::string testUtilV2(const envoy::api::v2::Listener& server_proto,
   std::string new_session = EMPTY_STRING;
 
   std::vector<Network::TransportSocketFactoryPtr> server_transport_socket_factories;
+  std::unordered_map<std::string, Network::TransportSocketFactory*> server_names;
   for (const auto& filter_chain : server_proto.filter_chains()) {
     if (filter_chain.has_tls_context()) {
       std::vector<std::string> sni_domains(filter_chain.filter_chain_match().sni_domains().begin(),
                                            filter_chain.filter_chain_match().sni_domains().end());
       Ssl::ServerContextConfigImpl server_ctx_config(filter_chain.tls_context());
-      server_transport_socket_factories.emplace_back(new Ssl::ServerSslSocketFactory(
-          server_ctx_config, "test_listener", sni_domains, false, manager, stats_store));
+      server_transport_socket_factories.emplace_back(
+          new Ssl::ServerSslSocketFactory(server_ctx_config, sni_domains, manager, stats_store));
+      if (sni_domains.empty()) {
+        sni_domains.push_back(EMPTY_STRING);
+      }
+      for (const std::string& name : sni_domains) {
+        server_names[name] = server_transport_socket_factories.back().get();
+      }
     }
   }
   ASSERT(server_transport_socket_factories.size() >= 1);
 
+  // Pick the filter chain by the client's server name like the listener does: exact match, then
+  // the longest matching wildcard domain, then the filter chain without server names.
+  const std::string& server_name = client_ctx_proto.sni();
+  auto server_name_match = server_names.find(server_name);
+  for (size_t pos = server_name.find('.');
+       server_name_match == server_names.end() && pos != std::string::npos;
+       pos = server_name.find('.', pos + 1)) {
+    server_name_match = server_names.find("*" + server_name.substr(pos));
+  }
+  if (server_name_match == server_names.end()) {
+    server_name_match = server_names.find(EMPTY_STRING);
+  }
+  ASSERT(server_name_match != server_names.end());
+  Network::TransportSocketFactory& server_transport_socket_factory = *server_name_match->second;
+
   Event::DispatcherImpl dispatcher;
   Network::TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(version), nullptr,
                                   true);
@@ -187,7 +210,7 @@ const std::string testUtilV2(const envoy::api::v2::Listener& server_proto,
   EXPECT_CALL(callbacks, onAccept_(_, _))
       .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket, bool) -> void {
         Network::ConnectionPtr new_connection = dispatcher.createServerConnection(
-            std::move(socket), server_transport_socket_factories[0]->createTransportSocket());
+            std::move(socket), server_transport_socket_factory.createTransportSocket());
         callbacks.onNewConnection(std::move(new_connection));
       }));
   EXPECT_CALL(callbacks, onNewConnection_(_))
@@ -733,7 +756,7 @@ TEST_P(SslSocketTest, FlushCloseDuringHandshake) {
   Json::ObjectSharedPtr server_ctx_loader = TestEnvironment::jsonLoadFromString(server_ctx_json);
   ServerContextConfigImpl server_ctx_config(*server_ctx_loader);
   ContextManagerImpl manager(runtime);
-  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, "", {}, true, manager,
+  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, {}, manager,
                                                         stats_store);
 
   Event::DispatcherImpl dispatcher;
@@ -791,7 +814,7 @@ TEST_P(SslSocketTest, HalfClose) {
   Json::ObjectSharedPtr server_ctx_loader = TestEnvironment::jsonLoadFromString(server_ctx_json);
   ServerContextConfigImpl server_ctx_config(*server_ctx_loader);
   ContextManagerImpl manager(runtime);
-  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, "", {}, true, manager,
+  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, {}, manager,
                                                         stats_store);
 
   Event::DispatcherImpl dispatcher;
@@ -874,7 +897,7 @@ TEST_P(SslSocketTest, ClientAuthMultipleCAs) {
   Json::ObjectSharedPtr server_ctx_loader = TestEnvironment::jsonLoadFromString(server_ctx_json);
   ServerContextConfigImpl server_ctx_config(*server_ctx_loader);
   ContextManagerImpl manager(runtime);
-  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, "", {}, true, manager,
+  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, {}, manager,
                                                         stats_store);
 
   Event::DispatcherImpl dispatcher;
@@ -953,10 +976,10 @@ void testTicketSessionResumption(const std::string& server_ctx_json1,
   Json::ObjectSharedPtr server_ctx_loader2 = TestEnvironment::jsonLoadFromString(server_ctx_json2);
   ServerContextConfigImpl server_ctx_config1(*server_ctx_loader1);
   ServerContextConfigImpl server_ctx_config2(*server_ctx_loader2);
-  Ssl::ServerSslSocketFactory server_ssl_socket_factory1(server_ctx_config1, "server1", {}, false,
-                                                         manager, stats_store);
-  Ssl::ServerSslSocketFactory server_ssl_socket_factory2(server_ctx_config2, "server2", {}, false,
-                                                         manager, stats_store);
+  Ssl::ServerSslSocketFactory server_ssl_socket_factory1(server_ctx_config1, {}, manager,
+                                                         stats_store);
+  Ssl::ServerSslSocketFactory server_ssl_socket_factory2(server_ctx_config2, {}, manager,
+                                                         stats_store);
 
   Event::DispatcherImpl dispatcher;
   Network::TcpListenSocket socket1(Network::Test::getCanonicalLoopbackAddress(ip_version), nullptr,
@@ -1277,10 +1300,10 @@ TEST_P(SslSocketTest, ClientAuthCrossListenerSessionResumption) {
   Json::ObjectSharedPtr server2_ctx_loader = TestEnvironment::jsonLoadFromString(server2_ctx_json);
   ServerContextConfigImpl server2_ctx_config(*server2_ctx_loader);
   ContextManagerImpl manager(runtime);
-  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, "server1", {}, false,
-                                                        manager, stats_store);
-  Ssl::ServerSslSocketFactory server2_ssl_socket_factory(server2_ctx_config, "server2", {}, false,
-                                                         manager, stats_store);
+  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, {}, manager,
+                                                        stats_store);
+  Ssl::ServerSslSocketFactory server2_ssl_socket_factory(server2_ctx_config, {}, manager,
+                                                         stats_store);
 
   Event::DispatcherImpl dispatcher;
   Network::TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr,
@@ -1388,7 +1411,7 @@ TEST_P(SslSocketTest, SslError) {
   Json::ObjectSharedPtr server_ctx_loader = TestEnvironment::jsonLoadFromString(server_ctx_json);
   ServerContextConfigImpl server_ctx_config(*server_ctx_loader);
   ContextManagerImpl manager(runtime);
-  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, "", {}, true, manager,
+  Ssl::ServerSslSocketFactory server_ssl_socket_factory(server_ctx_config, {}, manager,
                                                         stats_store);
 
   Event::DispatcherImpl dispatcher;
@@ -1553,16 +1576,6 @@ TEST_P(SslSocketTest, SniCertificate) {
              "77b3c289abbded6ad508d9853ba0bd36a1f6a9680eaba01e0f32774c0676ebe8", "", "",
              "ssl.handshake", 2, GetParam());
 
-  // Connection without SNI fails, since there is no match.
-  client_ctx.clear_sni();
-  testUtilV2(listener, client_ctx, "", false, "", "", "", "", "ssl.fail_no_sni_match", 1,
-             GetParam());
-
-  // Connection to bar.foo.com fails, since there is no match.
-  client_ctx.set_sni("bar.foo.com");
-  testUtilV2(listener, client_ctx, "", false, "", "", "", "", "ssl.fail_no_sni_match", 1,
-             GetParam());
-
   // no_san_cert.pem: * (no SNI restrictions)
   envoy::api::v2::listener::FilterChain* filter_chain3 = listener.add_filter_chains();
   envoy::api::v2::auth::TlsCertificate* server_cert3 =
@@ -2029,7 +2042,7 @@ public:
     server_ctx_config_.reset(new ServerContextConfigImpl(*server_ctx_loader_));
     manager_.reset(new ContextManagerImpl(runtime_));
     server_ssl_socket_factory_.reset(
-        new ServerSslSocketFactory(*server_ctx_config_, "", {}, true, *manager_, stats_store_));
+        new ServerSslSocketFactory(*server_ctx_config_, {}, *manager_, stats_store_));
 
     listener_ = dispatcher_->createListener(socket_, listener_callbacks_, true, false);
 
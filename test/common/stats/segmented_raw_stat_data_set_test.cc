@@ -0,0 +1,174 @@
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/fmt.h"
+#include "common/stats/segmented_raw_stat_data_set.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+
+class SegmentedRawStatDataSetTest : public testing::Test {
+protected:
+  SegmentedRawStatDataSetTest() {
+    memset(&control_, 0, sizeof(control_));
+    options_.num_slots = 7;
+    options_.segment_size = 1024;
+    options_.max_segments = 4;
+  }
+
+  // Maps named regions to heap buffers, standing in for shared memory.
+  SegmentedRawStatDataSet::MapMemoryCb mapMemory() {
+    return [this](const std::string& name, uint64_t size, bool create) -> uint8_t* {
+      std::vector<uint64_t>& region = regions_[name];
+      if (create) {
+        EXPECT_TRUE(region.empty()) << name;
+        region.resize(size / sizeof(uint64_t) + 1);
+      } else if (region.empty()) {
+        return nullptr;
+      }
+      return reinterpret_cast<uint8_t*>(region.data());
+    };
+  }
+
+  std::unique_ptr<SegmentedRawStatDataSet> create() {
+    return std::make_unique<SegmentedRawStatDataSet>(control_, options_, true, mapMemory());
+  }
+
+  std::unique_ptr<SegmentedRawStatDataSet> attach() {
+    return std::make_unique<SegmentedRawStatDataSet>(control_, options_, false, mapMemory());
+  }
+
+  SegmentedRawStatDataSet::Control control_;
+  SegmentedRawStatDataSetOptions options_;
+  std::map<std::string, std::vector<uint64_t>> regions_;
+};
+
+TEST_F(SegmentedRawStatDataSetTest, InsertGetRemove) {
+  std::unique_ptr<SegmentedRawStatDataSet> set = create();
+  EXPECT_EQ(0, set->numSegments());
+
+  SegmentedRawStatDataSet::ValueCreatedPair abc = set->insert("abc");
+  ASSERT_NE(nullptr, abc.first);
+  EXPECT_TRUE(abc.second);
+  EXPECT_EQ("abc", abc.first->key());
+  EXPECT_EQ(1, abc.first->ref_count_);
+  EXPECT_EQ(0, abc.first->value_);
+  EXPECT_EQ(1, set->numSegments());
+
+  SegmentedRawStatDataSet::ValueCreatedPair abc_again = set->insert("abc");
+  EXPECT_EQ(abc.first, abc_again.first);
+  EXPECT_FALSE(abc_again.second);
+
+  SegmentedRawStatDataSet::ValueCreatedPair def = set->insert("def");
+  EXPECT_NE(abc.first, def.first);
+  EXPECT_TRUE(def.second);
+  EXPECT_EQ(2, set->size());
+  EXPECT_EQ(def.first, set->get("def"));
+
+  EXPECT_TRUE(set->remove("abc"));
+  EXPECT_FALSE(set->remove("abc"));
+  EXPECT_EQ(nullptr, set->get("abc"));
+  EXPECT_EQ(def.first, set->get("def"));
+  EXPECT_EQ(1, set->size());
+  set->sanityCheck();
+}
+
+// Each stat takes only as much memory as its name needs, and freed memory is reused by stats with
+// names of the same length.
+TEST_F(SegmentedRawStatDataSetTest, CompactNames) {
+  std::unique_ptr<SegmentedRawStatDataSet> set = create();
+
+  RawStatData* a = set->insert("a").first;
+  RawStatData* b = set->insert(std::string(100, 'b')).first;
+  RawStatData* c = set->insert("c").first;
+  const ptrdiff_t short_block = reinterpret_cast<uint8_t*>(b) - reinterpret_cast<uint8_t*>(a);
+  const ptrdiff_t long_block = reinterpret_cast<uint8_t*>(c) - reinterpret_cast<uint8_t*>(b);
+  EXPECT_LT(short_block, RawStatData::size());
+  EXPECT_LE(short_block + 100 - alignof(RawStatData), long_block);
+  EXPECT_GE(short_block + 100 + alignof(RawStatData), long_block);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(b) % alignof(RawStatData));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(c) % alignof(RawStatData));
+
+  a->value_ = 5;
+  EXPECT_TRUE(set->remove("a"));
+  SegmentedRawStatDataSet::ValueCreatedPair z = set->insert("z");
+  EXPECT_EQ(a, z.first);
+  EXPECT_TRUE(z.second);
+  EXPECT_EQ("z", z.first->key());
+  EXPECT_EQ(0, z.first->value_);
+}
+
+// The set grows a segment at a time, up to max_segments, instead of having a fixed capacity.
+TEST_F(SegmentedRawStatDataSetTest, AddSegments) {
+  std::unique_ptr<SegmentedRawStatDataSet> set = create();
+
+  std::vector<RawStatData*> stats;
+  for (uint64_t i = 0;; ++i) {
+    RawStatData* stat = set->insert(fmt::format("stat.{}", i)).first;
+    if (stat == nullptr) {
+      break;
+    }
+    stats.push_back(stat);
+  }
+  EXPECT_EQ(options_.max_segments, set->numSegments());
+  EXPECT_EQ(stats.size(), set->size());
+  // Far more stats than slots.
+  EXPECT_GT(stats.size(), 10 * options_.num_slots);
+
+  for (uint64_t i = 0; i < stats.size(); ++i) {
+    EXPECT_EQ(stats[i], set->get(fmt::format("stat.{}", i)));
+    EXPECT_EQ(fmt::format("stat.{}", i), stats[i]->key());
+  }
+  set->sanityCheck();
+
+  // Once full, a freed stat's memory can still be reused.
+  EXPECT_TRUE(set->remove("stat.7"));
+  EXPECT_EQ(stats[7], set->insert("stat.x").first);
+}
+
+// A second user of the set sees the stats of the first, including those in segments added after
+// it attached.
+TEST_F(SegmentedRawStatDataSetTest, Attach) {
+  std::unique_ptr<SegmentedRawStatDataSet> parent = create();
+  RawStatData* parent_stat = parent->insert("parent").first;
+  parent_stat->value_ = 42;
+
+  // The options of the attaching process do not matter.
+  options_.num_slots = 3;
+  options_.segment_size = 64;
+  std::unique_ptr<SegmentedRawStatDataSet> child = attach();
+  EXPECT_EQ(parent_stat, child->get("parent"));
+  EXPECT_EQ(1, child->numSegments());
+
+  std::vector<RawStatData*> stats;
+  for (uint64_t i = 0; parent->numSegments() < 3; ++i) {
+    stats.push_back(parent->insert(fmt::format("stat.{}", i)).first);
+  }
+  for (uint64_t i = 0; i < stats.size(); ++i) {
+    EXPECT_EQ(stats[i], child->insert(fmt::format("stat.{}", i)).first);
+  }
+  EXPECT_EQ(3, child->numSegments());
+
+  RawStatData* child_stat = child->insert("child").first;
+  EXPECT_EQ(child_stat, parent->get("child"));
+  EXPECT_TRUE(parent->remove("child"));
+  EXPECT_EQ(nullptr, child->get("child"));
+  child->sanityCheck();
+}
+
+TEST_F(SegmentedRawStatDataSetTest, AttachCorrupt) {
+  std::unique_ptr<SegmentedRawStatDataSet> set = create();
+  set->insert("abc");
+  control_.hash_signature_++;
+  EXPECT_THROW(attach(), EnvoyException);
+}
+
+} // namespace Stats
+} // namespace Envoy
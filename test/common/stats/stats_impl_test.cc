@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <chrono>
+#include <regex>
 #include <string>
 
 #include "envoy/config/metrics/v2/stats.pb.h"
@@ -418,6 +419,78 @@ TEST(TagExtractorTest, ExtractRegexPrefix) {
   EXPECT_EQ("", extractRegexPrefix("prefix(foo)"));
 }
 
+TEST(TokenTagMatcherTest, SupportedForms) {
+  auto supported = [](const std::string& regex) {
+    return TokenTagMatcher::create(regex) != nullptr;
+  };
+
+  EXPECT_TRUE(supported("^cluster\\.((.*?)\\.)"));
+  EXPECT_TRUE(supported("^auth\\.clientssl\\.((.*?)\\.)\\w+?$"));
+  EXPECT_TRUE(supported("^listener(?=\\.).*?\\.http\\.((.*?)\\.)"));
+  EXPECT_TRUE(supported("^vhost(?=\\.).*?\\.vcluster\\.((.*?)\\.)\\w+?$"));
+  EXPECT_TRUE(supported("_rq(_(\\d{3}))$"));
+  EXPECT_TRUE(supported("_rq_(\\d)xx$"));
+
+  EXPECT_FALSE(supported("^cluster\\.(.*)"));
+  EXPECT_FALSE(supported("^cluster((.*?)\\.)"));
+  EXPECT_FALSE(supported("^cluster\\.((.*?)\\.)foo"));
+  EXPECT_FALSE(supported("^listener(?=\\.).*?http\\.((.*?)\\.)"));
+  EXPECT_FALSE(supported("^listener\\.(((?:[_.[:digit:]]*))\\.)"));
+  EXPECT_FALSE(supported("_rq(_(\\d{3}))"));
+  EXPECT_FALSE(supported("_rq(_(\\d{0}))$"));
+  EXPECT_FALSE(supported("(\\d)xx$"));
+}
+
+// Verifies that for every default tag regex that can be matched without std::regex, the match is
+// identical to the one std::regex_search finds, over all names made up of up to three tokens.
+TEST(TokenTagMatcherTest, MatchesDefaultRegexes) {
+  const std::vector<std::string> tokens = {
+      "cluster", "listener", "http",  "grpc",     "vhost",           "vcluster",
+      "tcp",     "auth",     "mongo", "cmd",      "upstream_rq_200", "upstream_rq_5xx",
+      "x-y",     "",         "a",     "rq_2000"};
+  std::vector<std::string> names = {""};
+  for (size_t begin = 0, end = names.size(), depth = 0; depth < 3; ++depth) {
+    for (size_t i = begin; i < end; ++i) {
+      for (const std::string& token : tokens) {
+        names.push_back(names[i].empty() ? token : names[i] + "." + token);
+      }
+    }
+    begin = end;
+    end = names.size();
+  }
+
+  uint32_t num_matchers = 0;
+  for (const auto& desc : Config::TagNames::get().descriptorVec()) {
+    const auto matcher = TokenTagMatcher::create(desc.regex_);
+    if (matcher == nullptr) {
+      continue;
+    }
+    ++num_matchers;
+
+    const std::regex regex(desc.regex_);
+    for (const std::string& name : names) {
+      std::smatch match;
+      const bool regex_matched = std::regex_search(name, match, regex) && match.size() > 1;
+      size_t remove_start;
+      size_t remove_end;
+      absl::string_view value;
+      ASSERT_EQ(regex_matched, matcher->match(name, remove_start, remove_end, value))
+          << desc.regex_ << " " << name;
+      if (regex_matched) {
+        const auto& value_subexpr = match.size() > 2 ? match[2] : match[1];
+        EXPECT_EQ(static_cast<size_t>(match.position(1)), remove_start)
+            << desc.regex_ << " " << name;
+        EXPECT_EQ(static_cast<size_t>(match.position(1) + match.length(1)), remove_end)
+            << desc.regex_ << " " << name;
+        EXPECT_EQ(value_subexpr.str(), value) << desc.regex_ << " " << name;
+      }
+    }
+  }
+
+  // Most of the default extractors, including the cluster name extractor, avoid std::regex.
+  EXPECT_LT(Config::TagNames::get().descriptorVec().size() / 2, num_matchers);
+}
+
 TEST(TagExtractorTest, CreateTagExtractorNoRegex) {
   EXPECT_THROW_WITH_REGEX(TagExtractorImpl::createTagExtractor("no such default tag", ""),
                           EnvoyException, "^No regex specified for tag specifier and no default");
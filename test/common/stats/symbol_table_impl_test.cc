@@ -0,0 +1,94 @@
+#include <string>
+#include <vector>
+
+#include "common/stats/symbol_table_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+
+TEST(SymbolTableTest, EncodeDecode) {
+  SymbolTable table;
+  for (const std::string name : {"cluster.foo.upstream_rq_total", "a", "", ".", "a..b", ".a.b."}) {
+    const StatName stat_name = table.encode(name);
+    EXPECT_EQ(name, table.decode(stat_name));
+    table.free(stat_name);
+  }
+  EXPECT_EQ(0, table.numSymbols());
+}
+
+TEST(SymbolTableTest, SharedTokens) {
+  SymbolTable table;
+  const StatName name1 = table.encode("cluster.foo.upstream_rq_total");
+  const StatName name2 = table.encode("cluster.bar.upstream_rq_total");
+  const StatName name3 = table.encode("cluster.foo.upstream_rq_total");
+  EXPECT_EQ(4, table.numSymbols());
+  EXPECT_EQ(name1, name3);
+  EXPECT_NE(name1, name2);
+  EXPECT_EQ(3, name1.data().size());
+
+  table.free(name1);
+  EXPECT_EQ(4, table.numSymbols());
+  EXPECT_EQ("cluster.foo.upstream_rq_total", table.decode(name3));
+
+  table.free(name3);
+  EXPECT_EQ(3, table.numSymbols());
+  EXPECT_EQ("cluster.bar.upstream_rq_total", table.decode(name2));
+
+  table.free(name2);
+  EXPECT_EQ(0, table.numSymbols());
+}
+
+TEST(SymbolTableTest, Find) {
+  SymbolTable table;
+  EXPECT_FALSE(table.find("cluster.foo"));
+  const StatName stat_name = table.encode("cluster.foo");
+  EXPECT_EQ(stat_name, table.find("cluster.foo").value());
+  EXPECT_FALSE(table.find("cluster.bar"));
+  EXPECT_FALSE(table.find("cluster.foo.bar"));
+  EXPECT_EQ(2, table.numSymbols());
+
+  table.free(stat_name);
+  EXPECT_FALSE(table.find("cluster.foo"));
+  EXPECT_EQ(0, table.numSymbols());
+}
+
+TEST(SymbolTableTest, RepeatedTokens) {
+  SymbolTable table;
+  const StatName stat_name = table.encode("a.a.a");
+  EXPECT_EQ(1, table.numSymbols());
+  EXPECT_EQ("a.a.a", table.decode(stat_name));
+  table.free(stat_name);
+  EXPECT_EQ(0, table.numSymbols());
+}
+
+// Symbols above 127 take more than one byte, and freed symbols are reused.
+TEST(SymbolTableTest, ManySymbols) {
+  SymbolTable table;
+  std::vector<StatName> stat_names;
+  for (uint32_t i = 0; i < 20000; ++i) {
+    stat_names.push_back(table.encode("cluster." + std::to_string(i)));
+  }
+  EXPECT_EQ(20001, table.numSymbols());
+  EXPECT_EQ(4, stat_names.back().data().size());
+  for (uint32_t i = 0; i < stat_names.size(); ++i) {
+    EXPECT_EQ("cluster." + std::to_string(i), table.decode(stat_names[i]));
+  }
+
+  table.free(stat_names[1000]);
+  const StatName reused = table.encode("cluster.reused");
+  EXPECT_EQ(stat_names[1000], reused);
+  EXPECT_EQ("cluster.reused", table.decode(reused));
+
+  table.free(reused);
+  for (uint32_t i = 0; i < stat_names.size(); ++i) {
+    if (i != 1000) {
+      table.free(stat_names[i]);
+    }
+  }
+  EXPECT_EQ(0, table.numSymbols());
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,64 @@
+// Usage: bazel run //test/common/stats:thread_local_store_benchmark
+
+#include <memory>
+#include <vector>
+
+#include "envoy/config/metrics/v2/stats.pb.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/upstream/upstream.h"
+
+#include "common/stats/stats_impl.h"
+#include "common/stats/thread_local_store.h"
+
+#include "fmt/format.h"
+#include "testing/base/public/benchmark.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+// Creates the stats that cluster manager creates at startup for each of state.range(0) clusters,
+// including tag extraction with the default tag extractors. This is dominated by the tag extraction
+// regexes for configurations with many clusters.
+void BM_CreateClusterStats(benchmark::State& state) {
+  const uint64_t num_clusters = state.range(0);
+  for (auto _ : state) {
+    HeapRawStatDataAllocator alloc;
+    ThreadLocalStoreImpl store(alloc);
+    store.setTagProducer(
+        std::make_unique<TagProducerImpl>(envoy::config::metrics::v2::StatsConfig()));
+
+    std::vector<ScopePtr> scopes;
+    for (uint64_t i = 0; i < num_clusters; ++i) {
+      scopes.emplace_back(store.createScope(fmt::format("cluster.cluster_{}.", i)));
+      Scope& scope = *scopes.back();
+      Upstream::ClusterStats stats{
+          ALL_CLUSTER_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
+      benchmark::DoNotOptimize(stats);
+
+      // Response code stats, as created by the router on the first responses.
+      for (const char* code : {"200", "503"}) {
+        scope.counter(fmt::format("upstream_rq_{}", code));
+        scope.counter(fmt::format("upstream_rq_{}xx", code[0]));
+      }
+    }
+
+    scopes.clear();
+    store.shutdownThreading();
+  }
+}
+BENCHMARK(BM_CreateClusterStats)->Arg(1)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
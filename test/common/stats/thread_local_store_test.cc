@@ -343,5 +343,95 @@ TEST_F(StatsThreadLocalStoreTest, ShuttingDown) {
   EXPECT_CALL(*this, free(_)).Times(5);
 }
 
+TEST_F(StatsThreadLocalStoreTest, LatchChangedMetrics) {
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  EXPECT_CALL(*this, alloc(_)).Times(4);
+  Counter& c1 = store_->counter("c1");
+  Counter& c2 = store_->counter("c2");
+  Gauge& g1 = store_->gauge("g1");
+  store_->gauge("g2");
+
+  // Nothing has changed yet.
+  ChangedMetrics changed;
+  store_->latchChangedMetrics(changed);
+  EXPECT_TRUE(changed.counters_.empty());
+  EXPECT_TRUE(changed.gauges_.empty());
+
+  c1.add(3);
+  g1.set(5);
+  store_->latchChangedMetrics(changed);
+  ASSERT_EQ(1UL, changed.counters_.size());
+  EXPECT_EQ(&c1, changed.counters_[0].first.get());
+  EXPECT_EQ(3UL, changed.counters_[0].second);
+  ASSERT_EQ(1UL, changed.gauges_.size());
+  EXPECT_EQ(&g1, changed.gauges_[0].get());
+
+  // Metrics are only visited again once they change again.
+  store_->latchChangedMetrics(changed);
+  EXPECT_TRUE(changed.counters_.empty());
+  EXPECT_TRUE(changed.gauges_.empty());
+
+  c2.inc();
+  c2.inc();
+  g1.dec();
+  store_->latchChangedMetrics(changed);
+  ASSERT_EQ(1UL, changed.counters_.size());
+  EXPECT_EQ(&c2, changed.counters_[0].first.get());
+  EXPECT_EQ(2UL, changed.counters_[0].second);
+  ASSERT_EQ(1UL, changed.gauges_.size());
+  EXPECT_EQ(4UL, changed.gauges_[0]->value());
+  changed.clear();
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+
+  // Includes overflow stat.
+  EXPECT_CALL(*this, free(_)).Times(5);
+}
+
+TEST_F(StatsThreadLocalStoreTest, LatchChangedMetricsScopes) {
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  // Overlapping scopes share the backing storage, so increments through either counter are
+  // latched once.
+  ScopePtr scope1 = store_->createScope("scope1.");
+  ScopePtr scope2 = store_->createScope("scope1.");
+  EXPECT_CALL(*this, alloc(_)).Times(2);
+  scope1->counter("c").inc();
+  scope2->counter("c").inc();
+
+  ChangedMetrics changed;
+  store_->latchChangedMetrics(changed);
+  ASSERT_EQ(1UL, changed.counters_.size());
+  EXPECT_EQ("scope1.c", changed.counters_[0].first->name());
+  EXPECT_EQ(2UL, changed.counters_[0].second);
+  changed.clear();
+
+  // Metrics freed after they changed are skipped, and their slots are reused.
+  scope2->counter("c").inc();
+  EXPECT_CALL(*this, free(_)).Times(2);
+  scope1.reset();
+  scope2.reset();
+  store_->latchChangedMetrics(changed);
+  EXPECT_TRUE(changed.counters_.empty());
+
+  EXPECT_CALL(*this, alloc(_));
+  Counter& c = store_->counter("c");
+  store_->latchChangedMetrics(changed);
+  EXPECT_TRUE(changed.counters_.empty());
+  c.inc();
+  store_->latchChangedMetrics(changed);
+  ASSERT_EQ(1UL, changed.counters_.size());
+  EXPECT_EQ(&c, changed.counters_[0].first.get());
+  changed.clear();
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+
+  // Includes overflow stat.
+  EXPECT_CALL(*this, free(_)).Times(2);
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -0,0 +1,146 @@
+// Usage: bazel run //test/common/upstream:cluster_manager_benchmark
+
+#include <memory>
+
+#include "envoy/api/v2/cds.pb.validate.h"
+#include "envoy/api/v2/cluster/outlier_detection.pb.validate.h"
+#include "envoy/config/bootstrap/v2/bootstrap.pb.h"
+
+#include "common/common/assert.h"
+#include "common/protobuf/utility.h"
+#include "common/ssl/context_manager_impl.h"
+#include "common/stats/stats_impl.h"
+#include "common/upstream/cluster_manager_impl.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+
+#include "fmt/format.h"
+#include "testing/base/public/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+// Creates real clusters without connection pools or CDS, like ProdClusterManagerFactory does for
+// static clusters.
+class BenchmarkClusterManagerFactory : public ClusterManagerFactory {
+public:
+  ClusterManagerPtr clusterManagerFromProto(const envoy::config::bootstrap::v2::Bootstrap&,
+                                            Stats::Store&, ThreadLocal::Instance&,
+                                            Runtime::Loader&, Runtime::RandomGenerator&,
+                                            const LocalInfo::LocalInfo&,
+                                            AccessLog::AccessLogManager&) override {
+    NOT_REACHED;
+  }
+
+  Http::ConnectionPool::InstancePtr
+  allocateConnPool(Event::Dispatcher&, HostConstSharedPtr, ResourcePriority, Http::Protocol,
+                   const Network::ConnectionSocket::OptionsSharedPtr&) override {
+    NOT_REACHED;
+  }
+
+  ClusterSharedPtr clusterFromProto(const envoy::api::v2::Cluster& cluster, ClusterManager& cm,
+                                    Outlier::EventLoggerSharedPtr outlier_event_logger,
+                                    bool added_via_api) override {
+    return ClusterImplBase::create(cluster, cm, stats_, tls_, dns_resolver_, ssl_context_manager_,
+                                   runtime_, random_, dispatcher_, local_info_,
+                                   outlier_event_logger, added_via_api, nullptr);
+  }
+
+  CdsApiPtr createCds(const envoy::api::v2::core::ConfigSource&,
+                      const absl::optional<envoy::api::v2::core::ConfigSource>&,
+                      ClusterManager&) override {
+    NOT_REACHED;
+  }
+
+  Stats::IsolatedStoreImpl stats_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  std::shared_ptr<NiceMock<Network::MockDnsResolver>> dns_resolver_{
+      new NiceMock<Network::MockDnsResolver>};
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Runtime::MockRandomGenerator> random_;
+  Ssl::ContextManagerImpl ssl_context_manager_{runtime_};
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  NiceMock<AccessLog::MockAccessLogManager> log_manager_;
+};
+
+// A bootstrap with num_clusters static clusters of two hosts each, with enough settings that
+// hashing and validating them is representative of real configurations.
+envoy::config::bootstrap::v2::Bootstrap makeBootstrap(uint64_t num_clusters) {
+  envoy::config::bootstrap::v2::Bootstrap bootstrap;
+  for (uint64_t i = 0; i < num_clusters; ++i) {
+    envoy::api::v2::Cluster* cluster = bootstrap.mutable_static_resources()->add_clusters();
+    cluster->set_name(fmt::format("cluster_{}", i));
+    cluster->set_type(envoy::api::v2::Cluster::STATIC);
+    cluster->mutable_connect_timeout()->set_seconds(1);
+    cluster->mutable_max_requests_per_connection()->set_value(1000);
+    cluster->mutable_circuit_breakers()->add_thresholds()->mutable_max_connections()->set_value(
+        100);
+    cluster->mutable_outlier_detection()->mutable_consecutive_5xx()->set_value(10);
+    for (uint64_t j = 0; j < 2; ++j) {
+      envoy::api::v2::core::SocketAddress* address =
+          cluster->add_hosts()->mutable_socket_address();
+      address->set_address(fmt::format("10.{}.{}.{}", i / 256 % 256, i % 256, j));
+      address->set_port_value(80);
+    }
+  }
+  return bootstrap;
+}
+
+// Creates a cluster manager from a bootstrap with state.range(0) static clusters, as the server
+// does at startup.
+void BM_StaticClusters(benchmark::State& state) {
+  const envoy::config::bootstrap::v2::Bootstrap bootstrap = makeBootstrap(state.range(0));
+  for (auto _ : state) {
+    BenchmarkClusterManagerFactory factory;
+    ClusterManagerImpl cluster_manager(bootstrap, factory, factory.stats_, factory.tls_,
+                                       factory.runtime_, factory.random_, factory.local_info_,
+                                       factory.log_manager_, factory.dispatcher_);
+    benchmark::DoNotOptimize(cluster_manager.clusters());
+  }
+}
+BENCHMARK(BM_StaticClusters)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Validates and hashes state.range(0) clusters, which is what a CDS update does for every cluster
+// whether it changed or not.
+void BM_ValidateAndHashClusters(benchmark::State& state) {
+  const envoy::config::bootstrap::v2::Bootstrap bootstrap = makeBootstrap(state.range(0));
+  const auto& clusters = bootstrap.static_resources().clusters();
+  for (auto _ : state) {
+    MessageUtil::validate(clusters);
+    for (const auto& cluster : clusters) {
+      benchmark::DoNotOptimize(MessageUtil::hash(cluster));
+    }
+  }
+}
+BENCHMARK(BM_ValidateAndHashClusters)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  // Threads can only be created once logging is initialized.
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Registry::initialize(spdlog::level::warn,
+                                      Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
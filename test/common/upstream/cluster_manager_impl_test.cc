@@ -54,7 +54,8 @@ public:
                                   bool added_via_api) -> ClusterSharedPtr {
           return ClusterImplBase::create(cluster, cm, stats_, tls_, dns_resolver_,
                                          ssl_context_manager_, runtime_, random_, dispatcher_,
-                                         local_info_, outlier_event_logger, added_via_api);
+                                         local_info_, outlier_event_logger, added_via_api,
+                                         nullptr);
         }));
   }
 
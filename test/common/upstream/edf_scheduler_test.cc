@@ -7,47 +7,47 @@ namespace Upstream {
 namespace {
 
 TEST(EdfSchedulerTest, Empty) {
-  EdfScheduler<uint32_t> sched;
-  EXPECT_EQ(nullptr, sched.pick());
+  EdfScheduler sched;
+  EXPECT_TRUE(sched.empty());
+  EXPECT_FALSE(sched.pick().has_value());
 }
 
 // Validate we get regular RR behavior when all weights are the same.
 TEST(EdfSchedulerTest, Unweighted) {
-  EdfScheduler<uint32_t> sched;
+  EdfScheduler sched;
   constexpr uint32_t num_entries = 128;
-  std::shared_ptr<uint32_t> entries[num_entries];
 
   for (uint32_t i = 0; i < num_entries; ++i) {
-    entries[i] = std::make_shared<uint32_t>(i);
-    sched.add(1, entries[i]);
+    sched.add(1, i);
   }
 
   for (uint32_t rounds = 0; rounds < 128; ++rounds) {
     for (uint32_t i = 0; i < num_entries; ++i) {
       auto p = sched.pick();
-      EXPECT_EQ(i, *p);
-      sched.add(1, p);
+      ASSERT_TRUE(p.has_value());
+      EXPECT_EQ(i, p.value());
+      sched.add(1, p.value());
     }
   }
 }
 
 // Validate we get weighted RR behavior when weights are distinct.
 TEST(EdfSchedulerTest, Weighted) {
-  EdfScheduler<uint32_t> sched;
+  EdfScheduler sched;
   constexpr uint32_t num_entries = 128;
-  std::shared_ptr<uint32_t> entries[num_entries];
   uint32_t pick_count[num_entries];
 
+  sched.reserve(num_entries);
   for (uint32_t i = 0; i < num_entries; ++i) {
-    entries[i] = std::make_shared<uint32_t>(i);
-    sched.add(i + 1, entries[i]);
+    sched.add(i + 1, i);
     pick_count[i] = 0;
   }
 
   for (uint32_t i = 0; i < (num_entries * (1 + num_entries)) / 2; ++i) {
     auto p = sched.pick();
-    ++pick_count[*p];
-    sched.add(*p + 1, p);
+    ASSERT_TRUE(p.has_value());
+    ++pick_count[p.value()];
+    sched.add(p.value() + 1, p.value());
   }
 
   for (uint32_t i = 0; i < num_entries; ++i) {
@@ -55,20 +55,16 @@ TEST(EdfSchedulerTest, Weighted) {
   }
 }
 
-// Validate that expired entries are ignored.
-TEST(EdfSchedulerTest, Expired) {
-  EdfScheduler<uint32_t> sched;
+// Validate that picked entries are removed until they are added again.
+TEST(EdfSchedulerTest, PickRemoves) {
+  EdfScheduler sched;
+  sched.add(2, 37);
+  sched.add(1, 42);
 
-  auto second_entry = std::make_shared<uint32_t>(42);
-  {
-    auto first_entry = std::make_shared<uint32_t>(37);
-    sched.add(2, first_entry);
-    sched.add(1, second_entry);
-  }
-
-  auto p = sched.pick();
-  EXPECT_EQ(*second_entry, *p);
-  EXPECT_EQ(nullptr, sched.pick());
+  EXPECT_EQ(37, sched.pick().value());
+  EXPECT_EQ(42, sched.pick().value());
+  EXPECT_TRUE(sched.empty());
+  EXPECT_FALSE(sched.pick().has_value());
 }
 
 } // namespace
@@ -15,6 +15,7 @@
 
 using testing::Return;
 using testing::ReturnRef;
+using testing::_;
 
 namespace Envoy {
 namespace Upstream {
@@ -140,6 +141,79 @@ TEST_F(EdsTest, NoServiceNameOnSuccessConfigUpdate) {
   EXPECT_TRUE(initialized);
 }
 
+// Validate that the hosts of the parent process are used until the first EDS update.
+TEST_F(EdsTest, WarmHosts) {
+  envoy::api::v2::ClusterLoadAssignment warm_hosts;
+  warm_hosts.set_cluster_name("name");
+  auto* endpoints = warm_hosts.add_endpoints();
+  auto add_endpoint = [endpoints](int port, envoy::api::v2::core::HealthStatus health_status) {
+    auto* endpoint = endpoints->add_lb_endpoints();
+    auto* socket_address =
+        endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+    socket_address->set_address("1.2.3.4");
+    socket_address->set_port_value(port);
+    endpoint->set_health_status(health_status);
+  };
+  add_endpoint(80, envoy::api::v2::core::HealthStatus::HEALTHY);
+  add_endpoint(81, envoy::api::v2::core::HealthStatus::UNHEALTHY);
+  cluster_->setWarmHosts(warm_hosts);
+
+  bool initialized = false;
+  cluster_->initialize([&initialized] { initialized = true; });
+  EXPECT_TRUE(initialized);
+  {
+    auto& hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+    ASSERT_EQ(2UL, hosts.size());
+    EXPECT_EQ("1.2.3.4:80", hosts[0]->address()->asString());
+    EXPECT_TRUE(hosts[0]->healthy());
+    EXPECT_TRUE(hosts[1]->healthFlagGet(Host::HealthFlag::FAILED_EDS_HEALTH));
+    EXPECT_EQ(1UL, cluster_->prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
+  }
+
+  Protobuf::RepeatedPtrField<envoy::api::v2::ClusterLoadAssignment> resources;
+  auto* cluster_load_assignment = resources.Add();
+  cluster_load_assignment->set_cluster_name("fare");
+  auto* endpoint = cluster_load_assignment->add_endpoints()->add_lb_endpoints();
+  endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address()->set_address("1.2.3.4");
+  endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address()->set_port_value(81);
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate(resources));
+  {
+    auto& hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+    ASSERT_EQ(1UL, hosts.size());
+    EXPECT_EQ("1.2.3.4:81", hosts[0]->address()->asString());
+    EXPECT_TRUE(hosts[0]->healthy());
+  }
+}
+
+// Validate that the hosts of the parent process that were unhealthy wait for active health checks.
+TEST_F(EdsTest, WarmHostsHealthChecked) {
+  std::shared_ptr<MockHealthChecker> health_checker(new MockHealthChecker());
+  EXPECT_CALL(*health_checker, start());
+  EXPECT_CALL(*health_checker, addHostCheckCompleteCb(_)).Times(2);
+  cluster_->setHealthChecker(health_checker);
+
+  envoy::api::v2::ClusterLoadAssignment warm_hosts;
+  warm_hosts.set_cluster_name("name");
+  auto* endpoints = warm_hosts.add_endpoints();
+  for (int port : {80, 81}) {
+    auto* endpoint = endpoints->add_lb_endpoints();
+    auto* socket_address =
+        endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+    socket_address->set_address("1.2.3.4");
+    socket_address->set_port_value(port);
+    endpoint->set_health_status(port == 80 ? envoy::api::v2::core::HealthStatus::HEALTHY
+                                           : envoy::api::v2::core::HealthStatus::UNHEALTHY);
+  }
+  cluster_->setWarmHosts(warm_hosts);
+
+  cluster_->initialize([] {});
+  auto& hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+  ASSERT_EQ(2UL, hosts.size());
+  EXPECT_TRUE(hosts[0]->healthy());
+  EXPECT_TRUE(hosts[1]->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC));
+  EXPECT_FALSE(hosts[1]->healthFlagGet(Host::HealthFlag::FAILED_EDS_HEALTH));
+}
+
 // Validate that onConfigUpdate() updates the endpoint metadata.
 TEST_F(EdsTest, EndpointMetadata) {
   Protobuf::RepeatedPtrField<envoy::api::v2::ClusterLoadAssignment> resources;
@@ -296,6 +370,41 @@ TEST_F(EdsTest, EndpointHealthStatus) {
   }
 }
 
+// Validate that onConfigUpdate() with a change in endpoint weight only triggers a host set
+// membership update, so that load balancers rebuild their schedules.
+TEST_F(EdsTest, EndpointWeightChangeCausesRebuild) {
+  Protobuf::RepeatedPtrField<envoy::api::v2::ClusterLoadAssignment> resources;
+  auto* cluster_load_assignment = resources.Add();
+  cluster_load_assignment->set_cluster_name("fare");
+  auto* endpoints = cluster_load_assignment->add_endpoints();
+  auto* endpoint = endpoints->add_lb_endpoints();
+  auto* socket_address = endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+  socket_address->set_address("1.2.3.4");
+  socket_address->set_port_value(80);
+  endpoint->mutable_load_balancing_weight()->set_value(1);
+
+  bool initialized = false;
+  cluster_->initialize([&initialized] { initialized = true; });
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate(resources));
+  EXPECT_TRUE(initialized);
+
+  uint32_t member_updates = 0;
+  cluster_->prioritySet().addMemberUpdateCb(
+      [&member_updates](uint32_t, const HostVector&, const HostVector&) { ++member_updates; });
+
+  // No change, no update.
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate(resources));
+  EXPECT_EQ(0, member_updates);
+
+  // Weight change, update with the new weight.
+  endpoint->mutable_load_balancing_weight()->set_value(31);
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate(resources));
+  EXPECT_EQ(1, member_updates);
+  auto& hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+  EXPECT_EQ(1, hosts.size());
+  EXPECT_EQ(31, hosts[0]->weight());
+}
+
 // Validate that onConfigUpdate() updates the endpoint locality.
 TEST_F(EdsTest, EndpointLocality) {
   Protobuf::RepeatedPtrField<envoy::api::v2::ClusterLoadAssignment> resources;
@@ -31,5 +31,47 @@ TEST(HostUtilityTest, All) {
   EXPECT_EQ("/failed_outlier_check", HostUtility::healthFlagsToString(*host));
 }
 
+TEST(HostUtilityTest, ToClusterLoadAssignment) {
+  ClusterInfoConstSharedPtr cluster{new MockClusterInfo()};
+  HostSharedPtr healthy = makeTestHost(cluster, "tcp://127.0.0.1:80", 3);
+  HostSharedPtr unhealthy = makeTestHost(cluster, "tcp://127.0.0.2:80");
+  unhealthy->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  HostSharedPtr failover = makeTestHost(cluster, "tcp://127.0.0.3:81");
+
+  PrioritySetImpl priority_set;
+  HostVectorSharedPtr hosts(new HostVector({healthy, unhealthy}));
+  priority_set.getOrCreateHostSet(0).updateHosts(
+      hosts, HostVectorSharedPtr(new HostVector({healthy})), HostsPerLocalityImpl::empty(),
+      HostsPerLocalityImpl::empty(), {}, *hosts, {});
+  HostVectorSharedPtr failover_hosts(new HostVector({failover}));
+  priority_set.getOrCreateHostSet(1).updateHosts(failover_hosts, failover_hosts,
+                                                 HostsPerLocalityImpl::empty(),
+                                                 HostsPerLocalityImpl::empty(), {},
+                                                 *failover_hosts, {});
+
+  const envoy::api::v2::ClusterLoadAssignment cluster_load_assignment =
+      HostUtility::toClusterLoadAssignment("name", priority_set);
+  EXPECT_EQ("name", cluster_load_assignment.cluster_name());
+  ASSERT_EQ(2, cluster_load_assignment.endpoints_size());
+
+  const auto& primary = cluster_load_assignment.endpoints(0);
+  EXPECT_EQ(0, primary.priority());
+  ASSERT_EQ(2, primary.lb_endpoints_size());
+  EXPECT_EQ("127.0.0.1",
+            primary.lb_endpoints(0).endpoint().address().socket_address().address());
+  EXPECT_EQ(80, primary.lb_endpoints(0).endpoint().address().socket_address().port_value());
+  EXPECT_EQ(envoy::api::v2::core::HealthStatus::HEALTHY, primary.lb_endpoints(0).health_status());
+  EXPECT_EQ(3, primary.lb_endpoints(0).load_balancing_weight().value());
+  EXPECT_EQ("127.0.0.2",
+            primary.lb_endpoints(1).endpoint().address().socket_address().address());
+  EXPECT_EQ(envoy::api::v2::core::HealthStatus::UNHEALTHY,
+            primary.lb_endpoints(1).health_status());
+
+  const auto& secondary = cluster_load_assignment.endpoints(1);
+  EXPECT_EQ(1, secondary.priority());
+  ASSERT_EQ(1, secondary.lb_endpoints_size());
+  EXPECT_EQ(81, secondary.lb_endpoints(0).endpoint().address().socket_address().port_value());
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -1,6 +1,7 @@
 // Usage: bazel run //test/common/upstream:load_balancer_benchmark
 
 #include "common/runtime/runtime_impl.h"
+#include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/maglev_lb.h"
 #include "common/upstream/ring_hash_lb.h"
 #include "common/upstream/upstream_impl.h"
@@ -55,6 +56,22 @@ public:
   envoy::api::v2::Cluster::CommonLbConfig common_config_;
 };
 
+class RoundRobinTester : public BaseTester {
+public:
+  RoundRobinTester(uint64_t num_hosts, uint32_t weighted_subset_percent, uint32_t weight)
+      : BaseTester(num_hosts, weighted_subset_percent, weight) {
+    round_robin_lb_.reset(new RoundRobinLoadBalancer{priority_set_, nullptr, stats_, runtime_,
+                                                     random_, common_config_});
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterStats stats_{ClusterInfoImpl::generateStats(stats_store_)};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Runtime::RandomGeneratorImpl random_;
+  envoy::api::v2::Cluster::CommonLbConfig common_config_;
+  std::unique_ptr<RoundRobinLoadBalancer> round_robin_lb_;
+};
+
 uint64_t hashInt(uint64_t i) {
   // Hack to hash an integer.
   return HashUtil::xxHash64(absl::string_view(reinterpret_cast<const char*>(&i), sizeof(i)));
@@ -197,6 +214,26 @@ BENCHMARK(BM_MaglevLoadBalancerChooseHost)
     ->Args({500, 100000})
     ->Unit(benchmark::kMillisecond);
 
+void BM_RoundRobinLoadBalancerChooseHost(benchmark::State& state) {
+  // Do not time the creation of the schedule.
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t weighted_subset_percent = state.range(1);
+  const uint64_t weight = state.range(2);
+  RoundRobinTester tester(num_hosts, weighted_subset_percent, weight);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tester.round_robin_lb_->chooseHost(nullptr));
+  }
+}
+BENCHMARK(BM_RoundRobinLoadBalancerChooseHost)
+    ->Args({100, 0, 1})
+    ->Args({500, 0, 1})
+    ->Args({100, 50, 2})
+    ->Args({500, 50, 2})
+    ->Args({100, 5, 127})
+    ->Args({500, 5, 127})
+    ->Args({500, 95, 127});
+
 void BM_RingHashLoadBalancerHostLoss(benchmark::State& state) {
   for (auto _ : state) {
     const uint64_t num_hosts = state.range(0);
@@ -2,6 +2,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "envoy/common/time.h"
@@ -715,6 +716,101 @@ TEST_F(OutlierDetectorImplTest, CrossThreadFailRace) {
   EXPECT_EQ(1UL, cluster_.info_->stats_store_.gauge("outlier_detection.ejections_active").value());
 }
 
+TEST_F(OutlierDetectorImplTest, ConsecutiveErrorsBatchedWhilePostPending) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({"tcp://127.0.0.1:80"});
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, empty_outlier_detection_, dispatcher_, runtime_, time_source_, event_logger_));
+  detector->addChangedStateCb([&](HostSharedPtr host) -> void { checker_.check(host); });
+
+  // Successes with no errors to reset do not need the main thread.
+  EXPECT_CALL(dispatcher_, post(_)).Times(0);
+  loadRq(hosts_[0], 10, 200);
+
+  // All responses up to the time the post runs are charged by it.
+  Event::PostCb post_cb;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  loadRq(hosts_[0], 3, 500);
+  loadRq(hosts_[0], 1, 200);
+  loadRq(hosts_[0], 5, 500);
+
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(0))));
+  EXPECT_CALL(checker_, check(hosts_[0]));
+  EXPECT_CALL(*event_logger_, logEject(std::static_pointer_cast<const HostDescription>(hosts_[0]),
+                                       _, EjectionType::Consecutive5xx, true));
+  post_cb();
+  EXPECT_TRUE(hosts_[0]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_EQ(1UL, cluster_.info_->stats_store_.gauge("outlier_detection.ejections_active").value());
+}
+
+TEST_F(OutlierDetectorImplTest, ConsecutiveErrorsSplitAcrossPosts) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({"tcp://127.0.0.1:80"});
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, empty_outlier_detection_, dispatcher_, runtime_, time_source_, event_logger_));
+  detector->addChangedStateCb([&](HostSharedPtr host) -> void { checker_.check(host); });
+
+  // The errors of the second batch extend the count left by the first.
+  Event::PostCb post_cb;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  loadRq(hosts_[0], 1, 200);
+  loadRq(hosts_[0], 3, 500);
+  post_cb();
+  EXPECT_FALSE(hosts_[0]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  loadRq(hosts_[0], 2, 500);
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(0))));
+  EXPECT_CALL(checker_, check(hosts_[0]));
+  EXPECT_CALL(*event_logger_, logEject(std::static_pointer_cast<const HostDescription>(hosts_[0]),
+                                       _, EjectionType::Consecutive5xx, true));
+  post_cb();
+  EXPECT_TRUE(hosts_[0]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+}
+
+TEST_F(OutlierDetectorImplTest, SuccessRateFromMultipleThreads) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+      "tcp://127.0.0.1:84",
+  });
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, empty_outlier_detection_, dispatcher_, runtime_, time_source_, event_logger_));
+
+  // Each thread charges its share of the requests to its own accumulators.
+  for (int i = 0; i < 4; i++) {
+    std::thread thread([this]() -> void { loadRq(hosts_, 50, 200); });
+    thread.join();
+  }
+  loadRq(hosts_[4], 200, 200);
+
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(10000))));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  interval_timer_->callback_();
+  EXPECT_EQ(100, hosts_[0]->outlierDetector().successRate());
+  EXPECT_EQ(100, hosts_[4]->outlierDetector().successRate());
+  EXPECT_EQ(100, detector->successRateAverage());
+
+  // The next window only counts the requests charged since the last interval.
+  std::thread thread([this]() -> void { loadRq(hosts_, 50, 200); });
+  thread.join();
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(20000))));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  interval_timer_->callback_();
+  EXPECT_EQ(-1, hosts_[0]->outlierDetector().successRate());
+  EXPECT_EQ(-1, detector->successRateAverage());
+}
+
 TEST_F(OutlierDetectorImplTest, Consecutive5xxAlreadyEjected) {
   EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
   addHosts({"tcp://127.0.0.1:80"});
@@ -739,6 +835,45 @@ TEST_F(OutlierDetectorImplTest, Consecutive5xxAlreadyEjected) {
   loadRq(hosts_[0], 5, 500);
 }
 
+TEST(ConsecutiveErrorRunTest, Apply) {
+  {
+    ConsecutiveErrorRun run;
+    run.putError();
+    run.putError();
+    uint32_t count = 2;
+    EXPECT_FALSE(run.apply(count, 5));
+    EXPECT_EQ(4U, count);
+    EXPECT_TRUE(run.apply(count, 5));
+    EXPECT_EQ(6U, count);
+    // Past the threshold, the count does not reach it again.
+    EXPECT_FALSE(run.apply(count, 5));
+    EXPECT_EQ(8U, count);
+  }
+
+  {
+    ConsecutiveErrorRun run;
+    run.putError();
+    run.putReset();
+    run.putError();
+    run.putError();
+    run.putError();
+    run.putReset();
+    run.putError();
+    uint32_t count = 3;
+    EXPECT_FALSE(run.apply(count, 5));
+    EXPECT_EQ(1U, count);
+    count = 4;
+    EXPECT_TRUE(run.apply(count, 5));
+    EXPECT_EQ(1U, count);
+    count = 0;
+    EXPECT_TRUE(run.apply(count, 3));
+    EXPECT_EQ(1U, count);
+    // A threshold of zero is never reached.
+    count = 0;
+    EXPECT_FALSE(run.apply(count, 0));
+  }
+}
+
 TEST(DetectorHostMonitorNullImplTest, All) {
   DetectorHostMonitorNullImpl null_sink;
 
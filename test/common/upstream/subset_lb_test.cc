@@ -78,8 +78,16 @@ public:
     return matches_;
   }
 
+  uint64_t id() const override { return id_; }
+
 private:
+  static uint64_t nextId() {
+    static uint64_t next_id = 0;
+    return ++next_id;
+  }
+
   std::vector<Router::MetadataMatchCriterionConstSharedPtr> matches_;
+  const uint64_t id_{nextId()};
 };
 
 class TestLoadBalancerContext : public LoadBalancerContext {
@@ -513,6 +521,42 @@ TEST_P(SubsetLoadBalancerTest, BalancesSubsetAfterUpdate) {
   EXPECT_EQ(3U, stats_.lb_subsets_created_.value());
 }
 
+// Test that a subset lookup which previously found no subset is re-resolved once the subset is
+// created by a host update.
+TEST_P(SubsetLoadBalancerTest, CachedLookupResolvesNewSubset) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
+
+  std::vector<std::set<std::string>> subset_keys = {{"version"}};
+  EXPECT_CALL(subset_info_, subsetKeys()).WillRepeatedly(ReturnRef(subset_keys));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}}},
+  });
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_12({{"version", "1.2"}});
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  EXPECT_TRUE(nullptr == lb_->chooseHost(&context_12).get());
+  EXPECT_TRUE(nullptr == lb_->chooseHost(&context_12).get());
+
+  modifyHosts({makeHost("tcp://127.0.0.1:8000", {{"version", "1.2"}})}, {});
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_12));
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_12));
+  EXPECT_EQ(4U, stats_.lb_subsets_selected_.value());
+  EXPECT_EQ(2U, stats_.lb_subsets_created_.value());
+
+  // Removing the subset's only host deactivates it without invalidating the cached lookup.
+  modifyHosts({}, {host_set_.hosts_[1]});
+
+  EXPECT_TRUE(nullptr == lb_->chooseHost(&context_12).get());
+  EXPECT_EQ(1U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(1U, stats_.lb_subsets_removed_.value());
+}
+
 // Test that adding backends to a failover group causes no problems.
 TEST_P(SubsetLoadBalancerTest, UpdateFailover) {
   EXPECT_CALL(subset_info_, fallbackPolicy())
@@ -169,6 +169,68 @@ TEST(StrictDnsClusterImplTest, ZeroHostsHealthChecker) {
   EXPECT_EQ(0UL, cluster.prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
 }
 
+// The hosts of the parent process are served until every DNS name has resolved once.
+TEST(StrictDnsClusterImplTest, WarmHosts) {
+  Stats::IsolatedStoreImpl stats;
+  Ssl::MockContextManager ssl_context_manager;
+  auto dns_resolver = std::make_shared<NiceMock<Network::MockDnsResolver>>();
+  NiceMock<Event::MockDispatcher> dispatcher;
+  NiceMock<Runtime::MockLoader> runtime;
+  NiceMock<MockClusterManager> cm;
+  ReadyWatcher initialized;
+
+  // gmock matches in LIFO order which is why these are swapped.
+  ResolverData resolver2(*dns_resolver, dispatcher);
+  ResolverData resolver1(*dns_resolver, dispatcher);
+
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    hosts:
+    - { socket_address: { address: localhost1, port_value: 11001 }}
+    - { socket_address: { address: localhost2, port_value: 11002 }}
+  )EOF";
+
+  envoy::api::v2::ClusterLoadAssignment warm_hosts;
+  warm_hosts.set_cluster_name("name");
+  auto* endpoints = warm_hosts.add_endpoints();
+  for (const std::string& address : {"127.0.0.1", "127.0.0.3"}) {
+    auto* socket_address = endpoints->add_lb_endpoints()
+                               ->mutable_endpoint()
+                               ->mutable_address()
+                               ->mutable_socket_address();
+    socket_address->set_address(address);
+    socket_address->set_port_value(11001);
+  }
+
+  StrictDnsClusterImpl cluster(parseClusterFromV2Yaml(yaml), runtime, stats, ssl_context_manager,
+                               dns_resolver, cm, dispatcher, false);
+  cluster.setWarmHosts(warm_hosts);
+  EXPECT_CALL(initialized, ready());
+  cluster.initialize([&]() -> void { initialized.ready(); });
+  EXPECT_THAT(
+      std::list<std::string>({"127.0.0.1:11001", "127.0.0.3:11001"}),
+      ContainerEq(hostListToAddresses(cluster.prioritySet().hostSetsPerPriority()[0]->hosts())));
+  EXPECT_EQ(2UL, cluster.prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
+
+  // A warm host is replaced when its address is resolved.
+  EXPECT_CALL(*resolver1.timer_, enableTimer(_));
+  resolver1.dns_callback_(TestUtility::makeDnsResponse({"127.0.0.1", "127.0.0.2"}));
+  EXPECT_THAT(
+      std::list<std::string>({"127.0.0.1:11001", "127.0.0.2:11001", "127.0.0.3:11001"}),
+      ContainerEq(hostListToAddresses(cluster.prioritySet().hostSetsPerPriority()[0]->hosts())));
+  EXPECT_EQ("localhost1", cluster.prioritySet().hostSetsPerPriority()[0]->hosts()[0]->hostname());
+
+  // The remaining warm hosts are dropped once every name has resolved, even to nothing.
+  EXPECT_CALL(*resolver2.timer_, enableTimer(_));
+  resolver2.dns_callback_({});
+  EXPECT_THAT(
+      std::list<std::string>({"127.0.0.1:11001", "127.0.0.2:11001"}),
+      ContainerEq(hostListToAddresses(cluster.prioritySet().hostSetsPerPriority()[0]->hosts())));
+}
+
 TEST(StrictDnsClusterImplTest, Basic) {
   Stats::IsolatedStoreImpl stats;
   Ssl::MockContextManager ssl_context_manager;
@@ -0,0 +1,80 @@
+#include "common/upstream/wrr_schedule.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+std::vector<uint32_t> pickRound(WrrSchedule& schedule) {
+  std::vector<uint32_t> picks;
+  for (size_t i = 0; i < schedule.size(); ++i) {
+    picks.push_back(schedule.pick());
+  }
+  return picks;
+}
+
+TEST(WrrScheduleTest, Empty) {
+  WrrSchedule schedule;
+  EXPECT_TRUE(schedule.empty());
+  EXPECT_FALSE(schedule.build({}));
+  EXPECT_TRUE(schedule.empty());
+}
+
+// Validate that each index appears in proportion to its weight and that picks wrap around.
+TEST(WrrScheduleTest, Weighted) {
+  WrrSchedule schedule;
+  EXPECT_TRUE(schedule.build({1, 2}));
+  EXPECT_EQ(3, schedule.size());
+  EXPECT_EQ(std::vector<uint32_t>({1, 0, 1}), pickRound(schedule));
+  EXPECT_EQ(std::vector<uint32_t>({1, 0, 1}), pickRound(schedule));
+}
+
+// Validate that weights sharing a common divisor are reduced.
+TEST(WrrScheduleTest, GcdReduced) {
+  WrrSchedule schedule;
+  EXPECT_TRUE(schedule.build({20, 40, 60}));
+  EXPECT_EQ(6, schedule.size());
+  EXPECT_EQ(std::vector<uint32_t>({2, 1, 0, 2, 1, 2}), pickRound(schedule));
+}
+
+// Validate that a heavy index is interleaved with light ones rather than bunched together.
+TEST(WrrScheduleTest, Smooth) {
+  WrrSchedule schedule;
+  EXPECT_TRUE(schedule.build({5, 1, 1}));
+  EXPECT_EQ(std::vector<uint32_t>({0, 0, 1, 2, 0, 0, 0}), pickRound(schedule));
+}
+
+// Validate that pick counts match weights exactly over a round, for many distinct weights.
+TEST(WrrScheduleTest, ExactCounts) {
+  WrrSchedule schedule;
+  constexpr uint32_t num_entries = 128;
+  std::vector<uint32_t> weights;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    weights.push_back(i + 1);
+  }
+  EXPECT_TRUE(schedule.build(weights));
+  EXPECT_EQ((num_entries * (1 + num_entries)) / 2, schedule.size());
+
+  std::vector<uint32_t> pick_count(num_entries);
+  for (const uint32_t index : pickRound(schedule)) {
+    ++pick_count[index];
+  }
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    EXPECT_EQ(i + 1, pick_count[i]);
+  }
+}
+
+// Validate that we decline to build schedules larger than kMaxScheduleSize.
+TEST(WrrScheduleTest, TooLarge) {
+  WrrSchedule schedule;
+  EXPECT_TRUE(schedule.build({1, 2}));
+  std::vector<uint32_t> weights(WrrSchedule::kMaxScheduleSize / 2, 2);
+  weights[0] = 3;
+  EXPECT_FALSE(schedule.build(weights));
+  EXPECT_TRUE(schedule.empty());
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -1,8 +1,10 @@
 #include "common/network/address_impl.h"
+#include "common/stats/stats_impl.h"
 
 #include "extensions/access_loggers/http_grpc/grpc_access_log_impl.h"
 
 #include "test/mocks/access_log/mocks.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/grpc/mocks.h"
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/request_info/mocks.h"
@@ -103,11 +105,31 @@ TEST_F(GrpcAccessLogStreamerImplTest, StreamFailure) {
   streamer_->send(message_log1, "log1");
 }
 
+// Test that the write buffer state of the per-log stream is reported.
+TEST_F(GrpcAccessLogStreamerImplTest, WriteBufferHighWatermark) {
+  EXPECT_FALSE(streamer_->isAboveWriteBufferHighWatermark("log1"));
+
+  MockAccessLogStream stream1;
+  AccessLogCallbacks* callbacks1;
+  expectStreamStart(stream1, &callbacks1);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream1, sendMessage(_, false));
+  envoy::service::accesslog::v2::StreamAccessLogsMessage message_log1;
+  streamer_->send(message_log1, "log1");
+
+  EXPECT_CALL(stream1, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  EXPECT_TRUE(streamer_->isAboveWriteBufferHighWatermark("log1"));
+  EXPECT_CALL(stream1, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_FALSE(streamer_->isAboveWriteBufferHighWatermark("log1"));
+  EXPECT_FALSE(streamer_->isAboveWriteBufferHighWatermark("log2"));
+}
+
 class MockGrpcAccessLogStreamer : public GrpcAccessLogStreamer {
 public:
   // GrpcAccessLogStreamer
   MOCK_METHOD2(send, void(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
                           const std::string& log_name));
+  MOCK_METHOD1(isAboveWriteBufferHighWatermark, bool(const std::string& log_name));
 };
 
 class HttpGrpcAccessLogTest : public testing::Test {
@@ -115,7 +137,8 @@ public:
   void init() {
     ON_CALL(*filter_, evaluate(_, _)).WillByDefault(Return(true));
     config_.mutable_common_config()->set_log_name("hello_log");
-    access_log_.reset(new HttpGrpcAccessLog(AccessLog::FilterPtr{filter_}, config_, streamer_));
+    access_log_.reset(new HttpGrpcAccessLog(AccessLog::FilterPtr{filter_}, config_, streamer_,
+                                            tls_, stats_store_));
   }
 
   void expectLog(const std::string& expected_request_msg_yaml) {
@@ -135,7 +158,9 @@ public:
 
   AccessLog::MockFilter* filter_{new NiceMock<AccessLog::MockFilter>()};
   envoy::config::accesslog::v2::HttpGrpcAccessLogConfig config_;
-  std::shared_ptr<MockGrpcAccessLogStreamer> streamer_{new MockGrpcAccessLogStreamer()};
+  std::shared_ptr<MockGrpcAccessLogStreamer> streamer_{new NiceMock<MockGrpcAccessLogStreamer>()};
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Stats::IsolatedStoreImpl stats_store_;
   std::unique_ptr<HttpGrpcAccessLog> access_log_;
 };
 
@@ -398,6 +423,75 @@ http_logs:
   }
 }
 
+// Test that entries are batched until the entry limit is hit, and that the batch message is reused.
+TEST_F(HttpGrpcAccessLogTest, BatchByEntries) {
+  config_.mutable_common_config()->mutable_buffer_max_entries()->set_value(3);
+  Event::MockTimer* timer = new Event::MockTimer(&tls_.dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(1000)));
+  init();
+
+  NiceMock<RequestInfo::MockRequestInfo> request_info;
+  request_info.host_ = nullptr;
+  EXPECT_CALL(*streamer_, send(_, "hello_log"))
+      .Times(2)
+      .WillRepeatedly(Invoke([](envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+                                const std::string&) {
+        EXPECT_EQ(3, message.http_logs().log_entry_size());
+      }));
+  for (int i = 0; i < 7; i++) {
+    access_log_->log(nullptr, nullptr, request_info);
+  }
+  EXPECT_EQ(6UL, access_log_->stats().logs_written_.value());
+  EXPECT_EQ(2UL, access_log_->stats().batches_sent_.value());
+
+  // The timer flushes the remaining entry.
+  EXPECT_CALL(*streamer_, send(_, "hello_log"))
+      .WillOnce(Invoke([](envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+                          const std::string&) {
+        EXPECT_EQ(1, message.http_logs().log_entry_size());
+      }));
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(1000)));
+  timer->callback_();
+  EXPECT_EQ(7UL, access_log_->stats().logs_written_.value());
+
+  // Nothing is sent for an empty batch.
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(1000)));
+  timer->callback_();
+}
+
+// Test that entries are held while the stream is backed up and dropped past the pending bound.
+TEST_F(HttpGrpcAccessLogTest, DropWhenStreamBackedUp) {
+  config_.mutable_common_config()->mutable_buffer_size_bytes()->set_value(1);
+  config_.mutable_common_config()->mutable_max_pending_bytes()->set_value(1);
+  init();
+
+  NiceMock<RequestInfo::MockRequestInfo> request_info;
+  request_info.host_ = nullptr;
+  EXPECT_CALL(*streamer_, isAboveWriteBufferHighWatermark("hello_log"))
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(*streamer_, send(_, _)).Times(0);
+  access_log_->log(nullptr, nullptr, request_info);
+  access_log_->log(nullptr, nullptr, request_info);
+  EXPECT_EQ(0UL, access_log_->stats().logs_written_.value());
+  EXPECT_EQ(1UL, access_log_->stats().logs_dropped_.value());
+
+  // Once the stream drains, the held entry is sent with the next one.
+  EXPECT_CALL(*streamer_, isAboveWriteBufferHighWatermark("hello_log"))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(*streamer_, send(_, "hello_log"))
+      .WillOnce(Invoke([](envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+                          const std::string&) {
+        EXPECT_EQ(1, message.http_logs().log_entry_size());
+      }))
+      .WillOnce(Invoke([](envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+                          const std::string&) {
+        EXPECT_EQ(1, message.http_logs().log_entry_size());
+      }));
+  access_log_->log(nullptr, nullptr, request_info);
+  EXPECT_EQ(2UL, access_log_->stats().logs_written_.value());
+  EXPECT_EQ(1UL, access_log_->stats().logs_dropped_.value());
+}
+
 TEST(responseFlagsToAccessLogResponseFlagsTest, All) {
   NiceMock<RequestInfo::MockRequestInfo> request_info;
   ON_CALL(request_info, getResponseFlag(_)).WillByDefault(Return(true));
@@ -35,8 +35,8 @@ class LuaTest : public testing::Test {
 public:
   LuaTest() : yield_callback_([this]() { on_yield_.ready(); }) {}
 
-  void setup(const std::string& code) {
-    state_.reset(new ThreadLocalState(code, tls_));
+  void setup(const std::string& code, uint64_t instruction_budget = 0) {
+    state_.reset(new ThreadLocalState(code, tls_, instruction_budget));
     state_->registerType<TestObject>();
   }
 
@@ -152,6 +152,103 @@ TEST_F(LuaTest, MarkDead) {
   lua_gc(cr1->luaState(), LUA_GCCOLLECT, 0);
 }
 
+// Threads of coroutines that finish cleanly are reused. Threads of coroutines that error or are
+// still suspended are not.
+TEST_F(LuaTest, CoroutineThreadReuse) {
+  const std::string SCRIPT{R"EOF(
+    function finish()
+    end
+
+    function fail()
+      error("bad")
+    end
+
+    function suspend()
+      coroutine.yield()
+    end
+  )EOF"};
+
+  setup(SCRIPT);
+  const uint64_t finish_slot = state_->registerGlobal("finish");
+  const uint64_t fail_slot = state_->registerGlobal("fail");
+  const uint64_t suspend_slot = state_->registerGlobal("suspend");
+
+  CoroutinePtr cr(state_->createCoroutine());
+  lua_State* finished_thread = cr->luaState();
+  cr->start(state_->getGlobalRef(finish_slot), 0, yield_callback_);
+  EXPECT_EQ(cr->state(), Coroutine::State::Finished);
+  cr.reset();
+
+  cr = state_->createCoroutine();
+  EXPECT_EQ(finished_thread, cr->luaState());
+  EXPECT_THROW(cr->start(state_->getGlobalRef(fail_slot), 0, yield_callback_), LuaException);
+  cr.reset();
+
+  cr = state_->createCoroutine();
+  EXPECT_NE(finished_thread, cr->luaState());
+  lua_State* suspended_thread = cr->luaState();
+  EXPECT_CALL(on_yield_, ready());
+  cr->start(state_->getGlobalRef(suspend_slot), 0, yield_callback_);
+  EXPECT_EQ(cr->state(), Coroutine::State::Yielded);
+  cr.reset();
+
+  cr = state_->createCoroutine();
+  EXPECT_NE(suspended_thread, cr->luaState());
+  cr->start(state_->getGlobalRef(finish_slot), 0, yield_callback_);
+  EXPECT_EQ(cr->state(), Coroutine::State::Finished);
+}
+
+// A coroutine that runs past the instruction budget is aborted. Each coroutine gets its own
+// budget.
+TEST_F(LuaTest, InstructionBudget) {
+  const std::string SCRIPT{R"EOF(
+    function spin()
+      while true do
+      end
+    end
+
+    function count(n)
+      local total = 0
+      for i = 1, n do
+        total = total + i
+      end
+      return total
+    end
+  )EOF"};
+
+  setup(SCRIPT, 100000);
+  const uint64_t spin_slot = state_->registerGlobal("spin");
+  const uint64_t count_slot = state_->registerGlobal("count");
+
+  CoroutinePtr cr1(state_->createCoroutine());
+  EXPECT_THROW_WITH_REGEX(cr1->start(state_->getGlobalRef(spin_slot), 0, yield_callback_),
+                          LuaException, "instruction budget exceeded");
+  EXPECT_TRUE(cr1->instructionBudgetExceeded());
+
+  CoroutinePtr cr2(state_->createCoroutine());
+  lua_pushnumber(cr2->luaState(), 100);
+  cr2->start(state_->getGlobalRef(count_slot), 1, yield_callback_);
+  EXPECT_EQ(cr2->state(), Coroutine::State::Finished);
+  EXPECT_FALSE(cr2->instructionBudgetExceeded());
+  EXPECT_EQ(5050, lua_tonumber(cr2->luaState(), -1));
+}
+
+// Scripts are loaded on workers from precompiled bytecode. Errors still refer to the original
+// source.
+TEST_F(LuaTest, BytecodeErrorLocation) {
+  const std::string SCRIPT{R"EOF(
+    function callMe()
+      error("bad")
+    end
+  )EOF"};
+
+  setup(SCRIPT);
+  CoroutinePtr cr(state_->createCoroutine());
+  EXPECT_THROW_WITH_MESSAGE(
+      cr->start(state_->getGlobalRef(state_->registerGlobal("callMe")), 0, yield_callback_),
+      LuaException, "[string \"...\"]:3: bad");
+}
+
 } // namespace Lua
 } // namespace Common
 } // namespace Filters
@@ -16,7 +16,7 @@ template <class T> class LuaWrappersTestBase : public testing::Test {
 public:
   virtual void setup(const std::string& code) {
     coroutine_.reset();
-    state_.reset(new ThreadLocalState(code, tls_));
+    state_.reset(new ThreadLocalState(code, tls_, 0));
     state_->registerType<T>();
     coroutine_ = state_->createCoroutine();
     lua_pushlightuserdata(coroutine_->luaState(), this);
@@ -0,0 +1,221 @@
+#include <memory>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+#include "common/stats/stats_impl.h"
+
+#include "extensions/filters/http/cache/cache_filter.h"
+
+#include "test/mocks/common.h"
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/printers.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::ReturnPointee;
+using testing::_;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+class CacheFilterTest : public testing::Test {
+public:
+  CacheFilterTest()
+      : config_(std::make_shared<CacheFilterConfig>(1024 * 1024, 1024, "", store_, time_source_)) {
+    ON_CALL(time_source_, currentTime()).WillByDefault(ReturnPointee(&now_));
+  }
+
+  struct Stream {
+    std::shared_ptr<CacheFilter> filter_;
+    NiceMock<Http::MockStreamDecoderFilterCallbacks> callbacks_;
+  };
+
+  std::unique_ptr<Stream> makeStream() {
+    std::unique_ptr<Stream> stream(new Stream());
+    stream->filter_ = std::make_shared<CacheFilter>(config_);
+    stream->filter_->setDecoderFilterCallbacks(stream->callbacks_);
+    return stream;
+  }
+
+  // Sends a response through a stream that missed, which fills the cache.
+  void respond(Stream& stream, Http::HeaderMap& response_headers, const std::string& body) {
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              stream.filter_->encodeHeaders(response_headers, false));
+    Buffer::OwnedImpl data(body);
+    EXPECT_EQ(Http::FilterDataStatus::Continue, stream.filter_->encodeData(data, true));
+    stream.filter_->onDestroy();
+  }
+
+  void expectServed(Stream& stream, const std::string& body) {
+    EXPECT_CALL(stream.callbacks_, encodeHeaders_(_, false))
+        .WillOnce(Invoke([](Http::HeaderMap& headers, bool) -> void {
+          EXPECT_STREQ("200", headers.Status()->value().c_str());
+          EXPECT_STREQ("0", headers.get(Http::Headers::get().Age)->value().c_str());
+        }));
+    EXPECT_CALL(stream.callbacks_, encodeData(_, true))
+        .WillOnce(Invoke([body](Buffer::Instance& data, bool) -> void {
+          EXPECT_EQ(body, TestUtility::bufferToString(data));
+        }));
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  MonotonicTime now_;
+  NiceMock<MockMonotonicTimeSource> time_source_;
+  CacheFilterConfigSharedPtr config_;
+  Http::TestHeaderMapImpl request_headers_{
+      {":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  Http::TestHeaderMapImpl response_headers_{{":status", "200"},
+                                            {"cache-control", "public, max-age=60"},
+                                            {"etag", "\"abc\""},
+                                            {"transfer-encoding", "chunked"}};
+};
+
+TEST_F(CacheFilterTest, MissFillHit) {
+  std::unique_ptr<Stream> miss = makeStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            miss->filter_->decodeHeaders(request_headers_, true));
+  respond(*miss, response_headers_, "hello");
+  EXPECT_EQ(1UL, store_.counter("cache.miss").value());
+  EXPECT_EQ(1UL, store_.counter("cache.insert").value());
+
+  now_ += std::chrono::seconds(5);
+  std::unique_ptr<Stream> hit = makeStream();
+  EXPECT_CALL(hit->callbacks_, encodeHeaders_(_, false))
+      .WillOnce(Invoke([](Http::HeaderMap& headers, bool) -> void {
+        EXPECT_STREQ("5", headers.get(Http::Headers::get().Age)->value().c_str());
+        EXPECT_STREQ("5", headers.ContentLength()->value().c_str());
+        EXPECT_TRUE(nullptr == headers.TransferEncoding());
+      }));
+  EXPECT_CALL(hit->callbacks_, encodeData(_, true))
+      .WillOnce(Invoke([](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ("hello", TestUtility::bufferToString(data));
+      }));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            hit->filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(1UL, store_.counter("cache.hit").value());
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestServedFromFill) {
+  std::unique_ptr<Stream> miss = makeStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            miss->filter_->decodeHeaders(request_headers_, true));
+
+  std::unique_ptr<Stream> waiting = makeStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            waiting->filter_->decodeHeaders(request_headers_, true));
+  EXPECT_EQ(1UL, store_.counter("cache.coalesced").value());
+
+  expectServed(*waiting, "hello");
+  EXPECT_CALL(waiting->callbacks_, continueDecoding()).Times(0);
+  respond(*miss, response_headers_, "hello");
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestContinuesWhenUncacheable) {
+  std::unique_ptr<Stream> miss = makeStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            miss->filter_->decodeHeaders(request_headers_, true));
+
+  std::unique_ptr<Stream> waiting = makeStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            waiting->filter_->decodeHeaders(request_headers_, true));
+
+  Http::TestHeaderMapImpl response_headers{{":status", "200"}, {"cache-control", "private"}};
+  EXPECT_CALL(waiting->callbacks_, encodeHeaders_(_, _)).Times(0);
+  EXPECT_CALL(waiting->callbacks_, continueDecoding());
+  respond(*miss, response_headers, "hello");
+  EXPECT_EQ(1UL, store_.counter("cache.uncacheable").value());
+  EXPECT_EQ(0UL, store_.counter("cache.insert").value());
+}
+
+TEST_F(CacheFilterTest, DestroyedFillWakesWaiters) {
+  std::unique_ptr<Stream> miss = makeStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            miss->filter_->decodeHeaders(request_headers_, true));
+
+  std::unique_ptr<Stream> waiting = makeStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            waiting->filter_->decodeHeaders(request_headers_, true));
+
+  EXPECT_CALL(waiting->callbacks_, continueDecoding());
+  miss->filter_->onDestroy();
+}
+
+TEST_F(CacheFilterTest, BodyTooLarge) {
+  std::unique_ptr<Stream> miss = makeStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            miss->filter_->decodeHeaders(request_headers_, true));
+  respond(*miss, response_headers_, std::string(2048, 'a'));
+  EXPECT_EQ(1UL, store_.counter("cache.uncacheable").value());
+  EXPECT_EQ(0UL, config_->cache().sizeBytes());
+}
+
+TEST_F(CacheFilterTest, IfNoneMatch) {
+  std::unique_ptr<Stream> miss = makeStream();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            miss->filter_->decodeHeaders(request_headers_, true));
+  respond(*miss, response_headers_, "hello");
+
+  std::unique_ptr<Stream> conditional = makeStream();
+  Http::TestHeaderMapImpl request_headers{{":method", "GET"},
+                                          {":path", "/"},
+                                          {":authority", "host"},
+                                          {"if-none-match", "\"xyz\", W/\"abc\""}};
+  EXPECT_CALL(conditional->callbacks_, encodeHeaders_(_, true))
+      .WillOnce(Invoke([](Http::HeaderMap& headers, bool) -> void {
+        EXPECT_STREQ("304", headers.Status()->value().c_str());
+        EXPECT_STREQ("\"abc\"", headers.Etag()->value().c_str());
+        EXPECT_STREQ("public, max-age=60", headers.CacheControl()->value().c_str());
+      }));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            conditional->filter_->decodeHeaders(request_headers, true));
+  EXPECT_EQ(1UL, store_.counter("cache.not_modified").value());
+}
+
+TEST_F(CacheFilterTest, ConditionalMissDoesNotFill) {
+  std::unique_ptr<Stream> conditional = makeStream();
+  Http::TestHeaderMapImpl request_headers{
+      {":method", "GET"}, {":path", "/"}, {":authority", "host"}, {"if-none-match", "\"abc\""}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            conditional->filter_->decodeHeaders(request_headers, true));
+  respond(*conditional, response_headers_, "hello");
+  EXPECT_EQ(0UL, store_.counter("cache.insert").value());
+}
+
+TEST(CacheFilterCacheabilityTest, Request) {
+  EXPECT_TRUE(CacheFilter::isCacheableRequest(
+      Http::TestHeaderMapImpl{{":method", "GET"}, {":path", "/"}, {":authority", "host"}}));
+  EXPECT_FALSE(CacheFilter::isCacheableRequest(
+      Http::TestHeaderMapImpl{{":method", "POST"}, {":path", "/"}, {":authority", "host"}}));
+  EXPECT_FALSE(CacheFilter::isCacheableRequest(Http::TestHeaderMapImpl{
+      {":method", "GET"}, {":path", "/"}, {":authority", "host"}, {"authorization", "x"}}));
+  EXPECT_FALSE(CacheFilter::isCacheableRequest(Http::TestHeaderMapImpl{
+      {":method", "GET"}, {":path", "/"}, {":authority", "host"}, {"cache-control", "no-cache"}}));
+}
+
+TEST(CacheFilterCacheabilityTest, Response) {
+  EXPECT_TRUE(CacheFilter::isCacheableResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=1"}}));
+  EXPECT_FALSE(CacheFilter::isCacheableResponse(Http::TestHeaderMapImpl{{":status", "200"}}));
+  EXPECT_FALSE(CacheFilter::isCacheableResponse(
+      Http::TestHeaderMapImpl{{":status", "404"}, {"cache-control", "max-age=1"}}));
+  EXPECT_FALSE(CacheFilter::isCacheableResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=0"}}));
+  EXPECT_FALSE(CacheFilter::isCacheableResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=1, no-store"}}));
+  EXPECT_FALSE(CacheFilter::isCacheableResponse(Http::TestHeaderMapImpl{
+      {":status", "200"}, {"cache-control", "max-age=1"}, {"set-cookie", "a=b"}}));
+  EXPECT_FALSE(CacheFilter::isCacheableResponse(
+      Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "max-age=1"}, {"vary", "*"}}));
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
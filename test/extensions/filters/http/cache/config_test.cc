@@ -0,0 +1,54 @@
+#include "envoy/config/filter/http/cache/v2alpha/cache.pb.validate.h"
+
+#include "extensions/filters/http/cache/config.h"
+
+#include "test/mocks/server/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::_;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+TEST(CacheFilterFactoryTest, CorrectProto) {
+  envoy::config::filter::http::cache::v2alpha::Cache config;
+  config.mutable_max_size_bytes()->set_value(1024 * 1024);
+  config.mutable_max_body_bytes()->set_value(1024);
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  CacheFilterFactory factory;
+  Server::Configuration::HttpFilterFactoryCb cb =
+      factory.createFilterFactoryFromProto(config, "stats", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+TEST(CacheFilterFactoryTest, EmptyProto) {
+  CacheFilterFactory factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  Server::Configuration::HttpFilterFactoryCb cb =
+      factory.createFilterFactoryFromProto(*factory.createEmptyConfigProto(), "stats", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+TEST(CacheFilterFactoryTest, ValidateFail) {
+  envoy::config::filter::http::cache::v2alpha::Cache config;
+  config.mutable_max_size_bytes()->set_value(0);
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_THROW(CacheFilterFactory().createFilterFactoryFromProto(config, "stats", context),
+               ProtoValidationException);
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,206 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "common/common/hash.h"
+#include "common/http/header_map_impl.h"
+#include "common/stats/stats_impl.h"
+
+#include "extensions/filters/http/cache/http_cache.h"
+
+#include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::ReturnPointee;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+TEST(CacheControlTest, Parse) {
+  {
+    CacheControl cache_control = CacheControl::parse("");
+    EXPECT_FALSE(cache_control.no_cache_);
+    EXPECT_FALSE(cache_control.no_store_);
+    EXPECT_FALSE(cache_control.private_);
+    EXPECT_FALSE(cache_control.max_age_);
+  }
+
+  {
+    CacheControl cache_control = CacheControl::parse("public, max-age=60");
+    EXPECT_FALSE(cache_control.private_);
+    EXPECT_EQ(std::chrono::seconds(60), cache_control.max_age_.value());
+  }
+
+  {
+    CacheControl cache_control = CacheControl::parse("Max-Age=60 , s-maxage=10,No-Cache");
+    EXPECT_TRUE(cache_control.no_cache_);
+    EXPECT_EQ(std::chrono::seconds(10), cache_control.max_age_.value());
+  }
+
+  {
+    CacheControl cache_control = CacheControl::parse("private, no-store, max-age=abc");
+    EXPECT_TRUE(cache_control.private_);
+    EXPECT_TRUE(cache_control.no_store_);
+    EXPECT_FALSE(cache_control.max_age_);
+  }
+}
+
+class TestWaiter : public CacheFillWaiter {
+public:
+  MOCK_METHOD0(onFillComplete, void());
+};
+
+class HttpCacheTest : public testing::Test {
+public:
+  HttpCacheTest() : cache_(HttpCache::kNumShards * 1024, time_source_, stats_) {
+    ON_CALL(time_source_, currentTime()).WillByDefault(ReturnPointee(&now_));
+  }
+
+  CachedResponseConstSharedPtr makeResponse(const std::string& body,
+                                            std::chrono::seconds max_age) {
+    std::shared_ptr<CachedResponse> response = std::make_shared<CachedResponse>();
+    response->headers_.reset(new Http::TestHeaderMapImpl{{":status", "200"}});
+    response->body_ = body;
+    response->response_time_ = now_;
+    response->max_age_ = max_age;
+    return response;
+  }
+
+  HttpCache::LookupStatus lookup(const std::string& key) {
+    return cache_.lookup(key, request_headers_, dispatcher_, waiter_).status_;
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  CacheFilterStats stats_{ALL_CACHE_FILTER_STATS(POOL_COUNTER_PREFIX(store_, "cache."))};
+  MonotonicTime now_;
+  NiceMock<MockMonotonicTimeSource> time_source_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  std::shared_ptr<TestWaiter> waiter_{std::make_shared<TestWaiter>()};
+  Http::TestHeaderMapImpl request_headers_;
+  HttpCache cache_;
+};
+
+TEST_F(HttpCacheTest, MissInsertHit) {
+  EXPECT_EQ(HttpCache::LookupStatus::Miss, lookup("a"));
+  cache_.insert("a", makeResponse("hello", std::chrono::seconds(10)));
+  EXPECT_EQ(1UL, stats_.insert_.value());
+
+  HttpCache::LookupResult result = cache_.lookup("a", request_headers_, dispatcher_, waiter_);
+  EXPECT_EQ(HttpCache::LookupStatus::Hit, result.status_);
+  EXPECT_EQ("hello", result.response_->body_);
+  EXPECT_EQ("hello", cache_.find("a", request_headers_)->body_);
+  EXPECT_TRUE(nullptr == cache_.find("b", request_headers_).get());
+}
+
+TEST_F(HttpCacheTest, CoalescedWaitersNotified) {
+  EXPECT_EQ(HttpCache::LookupStatus::Miss, lookup("a"));
+  EXPECT_EQ(HttpCache::LookupStatus::Coalesced, lookup("a"));
+  EXPECT_EQ(HttpCache::LookupStatus::Coalesced, lookup("a"));
+
+  // Waiters that went away are skipped.
+  std::shared_ptr<TestWaiter> gone_waiter = std::make_shared<TestWaiter>();
+  EXPECT_EQ(HttpCache::LookupStatus::Coalesced,
+            cache_.lookup("a", request_headers_, dispatcher_, gone_waiter).status_);
+  gone_waiter.reset();
+
+  EXPECT_CALL(dispatcher_, post(_)).Times(3);
+  EXPECT_CALL(*waiter_, onFillComplete()).Times(2);
+  cache_.insert("a", makeResponse("hello", std::chrono::seconds(10)));
+}
+
+TEST_F(HttpCacheTest, AbandonFill) {
+  EXPECT_EQ(HttpCache::LookupStatus::Miss, lookup("a"));
+  EXPECT_EQ(HttpCache::LookupStatus::Coalesced, lookup("a"));
+
+  EXPECT_CALL(*waiter_, onFillComplete());
+  cache_.abandonFill("a");
+  EXPECT_TRUE(nullptr == cache_.find("a", request_headers_).get());
+
+  // The next miss fills again.
+  EXPECT_EQ(HttpCache::LookupStatus::Miss, lookup("a"));
+}
+
+TEST_F(HttpCacheTest, Expiry) {
+  EXPECT_EQ(HttpCache::LookupStatus::Miss, lookup("a"));
+  cache_.insert("a", makeResponse("hello", std::chrono::seconds(10)));
+
+  now_ += std::chrono::seconds(9);
+  EXPECT_EQ(HttpCache::LookupStatus::Hit, lookup("a"));
+
+  now_ += std::chrono::seconds(1);
+  EXPECT_EQ(HttpCache::LookupStatus::Miss, lookup("a"));
+  EXPECT_EQ(0UL, cache_.sizeBytes());
+}
+
+TEST_F(HttpCacheTest, Vary) {
+  std::shared_ptr<CachedResponse> response = std::make_shared<CachedResponse>();
+  response->headers_.reset(new Http::TestHeaderMapImpl{{":status", "200"}});
+  response->response_time_ = now_;
+  response->max_age_ = std::chrono::seconds(10);
+  response->vary_headers_.emplace_back(Http::LowerCaseString("accept-encoding"), "gzip");
+  response->vary_headers_.emplace_back(Http::LowerCaseString("accept-language"),
+                                       absl::optional<std::string>());
+  EXPECT_EQ(HttpCache::LookupStatus::Miss, lookup("a"));
+  cache_.insert("a", response);
+
+  EXPECT_TRUE(nullptr == cache_.find("a", request_headers_).get());
+  EXPECT_TRUE(nullptr !=
+              cache_.find("a", Http::TestHeaderMapImpl{{"accept-encoding", "gzip"}}).get());
+  EXPECT_TRUE(nullptr ==
+              cache_.find("a", Http::TestHeaderMapImpl{{"accept-encoding", "br"}}).get());
+  EXPECT_TRUE(nullptr == cache_
+                             .find("a", Http::TestHeaderMapImpl{{"accept-encoding", "gzip"},
+                                                                {"accept-language", "en"}})
+                             .get());
+}
+
+TEST_F(HttpCacheTest, EvictLeastRecentlyUsed) {
+  // Keys that land in the same shard, so that they compete for its space.
+  std::vector<std::string> keys;
+  const size_t shard_of_first = HashUtil::xxHash64("key0") % HttpCache::kNumShards;
+  for (uint32_t i = 0; keys.size() < 3; i++) {
+    const std::string key = "key" + std::to_string(i);
+    if (HashUtil::xxHash64(key) % HttpCache::kNumShards == shard_of_first) {
+      keys.push_back(key);
+    }
+  }
+
+  const std::string body(400, 'a');
+  for (const std::string& key : {keys[0], keys[1]}) {
+    EXPECT_EQ(HttpCache::LookupStatus::Miss, lookup(key));
+    cache_.insert(key, makeResponse(body, std::chrono::seconds(10)));
+  }
+
+  // Touch the first key, so that the second is evicted by the third.
+  EXPECT_EQ(HttpCache::LookupStatus::Hit, lookup(keys[0]));
+  EXPECT_EQ(HttpCache::LookupStatus::Miss, lookup(keys[2]));
+  cache_.insert(keys[2], makeResponse(body, std::chrono::seconds(10)));
+
+  EXPECT_EQ(1UL, stats_.eviction_.value());
+  EXPECT_TRUE(nullptr != cache_.find(keys[0], request_headers_).get());
+  EXPECT_TRUE(nullptr == cache_.find(keys[1], request_headers_).get());
+  EXPECT_TRUE(nullptr != cache_.find(keys[2], request_headers_).get());
+}
+
+TEST_F(HttpCacheTest, TooLargeNotInserted) {
+  EXPECT_EQ(HttpCache::LookupStatus::Miss, lookup("a"));
+  EXPECT_EQ(HttpCache::LookupStatus::Coalesced, lookup("a"));
+
+  EXPECT_CALL(*waiter_, onFillComplete());
+  cache_.insert("a", makeResponse(std::string(2048, 'a'), std::chrono::seconds(10)));
+  EXPECT_EQ(0UL, stats_.insert_.value());
+  EXPECT_EQ(0UL, cache_.sizeBytes());
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
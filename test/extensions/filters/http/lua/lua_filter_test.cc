@@ -1,5 +1,6 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/http/message_impl.h"
+#include "common/stats/stats_impl.h"
 
 #include "extensions/filters/http/lua/lua_filter.h"
 
@@ -59,8 +60,9 @@ public:
 
   ~LuaHttpFilterTest() { filter_->onDestroy(); }
 
-  void setup(const std::string& lua_code) {
-    config_.reset(new FilterConfig(lua_code, tls_, cluster_manager_));
+  void setup(const std::string& lua_code, uint64_t instruction_budget = 0) {
+    config_.reset(new FilterConfig(lua_code, instruction_budget, tls_, cluster_manager_, "test.",
+                                   stats_store_));
     filter_.reset(new TestFilter(config_));
     filter_->setDecoderFilterCallbacks(decoder_callbacks_);
     filter_->setEncoderFilterCallbacks(encoder_callbacks_);
@@ -74,6 +76,7 @@ public:
 
   NiceMock<ThreadLocal::MockInstance> tls_;
   Upstream::MockClusterManager cluster_manager_;
+  Stats::IsolatedStoreImpl stats_store_;
   std::shared_ptr<FilterConfig> config_;
   std::unique_ptr<TestFilter> filter_;
   Http::MockStreamDecoderFilterCallbacks decoder_callbacks_;
@@ -166,7 +169,8 @@ TEST(LuaHttpFilterConfigTest, BadCode) {
 
   NiceMock<ThreadLocal::MockInstance> tls;
   NiceMock<Upstream::MockClusterManager> cluster_manager;
-  EXPECT_THROW_WITH_MESSAGE(FilterConfig(SCRIPT, tls, cluster_manager),
+  Stats::IsolatedStoreImpl stats_store;
+  EXPECT_THROW_WITH_MESSAGE(FilterConfig(SCRIPT, 0, tls, cluster_manager, "test.", stats_store),
                             Filters::Common::Lua::LuaException,
                             "script load error: [string \"...\"]:3: '=' expected near '<eof>'");
 }
@@ -525,6 +529,7 @@ TEST_F(LuaHttpFilterTest, ScriptErrorHeadersRequestBodyTrailers) {
               scriptLog(spdlog::level::err,
                         StrEq("[string \"...\"]:4: attempt to index local 'foo' (a nil value)")));
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(1UL, stats_store_.counter("test.lua.errors").value());
 
   Buffer::OwnedImpl data("hello");
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(data, false));
@@ -1460,6 +1465,34 @@ TEST_F(LuaHttpFilterTest, GetMetadataFromHandleNoLuaMetadata) {
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
 }
 
+// Script that runs past the instruction budget.
+TEST_F(LuaHttpFilterTest, InstructionBudgetExceeded) {
+  const std::string SCRIPT{R"EOF(
+    function envoy_on_request(request_handle)
+      request_handle:logTrace("start")
+      while true do
+      end
+    end
+  )EOF"};
+
+  InSequence s;
+  setup(SCRIPT, 10000);
+
+  Http::TestHeaderMapImpl request_headers{{":path", "/"}};
+  EXPECT_CALL(*filter_, scriptLog(spdlog::level::trace, StrEq("start")));
+  EXPECT_CALL(*filter_, scriptLog(spdlog::level::err, testing::HasSubstr("instruction budget")));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  EXPECT_EQ(1UL, stats_store_.counter("test.lua.errors").value());
+  EXPECT_EQ(1UL, stats_store_.counter("test.lua.instruction_budget_exceeded").value());
+
+  // A new request gets a fresh budget.
+  TestFilter filter2(config_);
+  EXPECT_CALL(filter2, scriptLog(spdlog::level::trace, StrEq("start")));
+  EXPECT_CALL(filter2, scriptLog(spdlog::level::err, testing::HasSubstr("instruction budget")));
+  filter2.decodeHeaders(request_headers, true);
+  EXPECT_EQ(2UL, stats_store_.counter("test.lua.instruction_budget_exceeded").value());
+}
+
 } // namespace Lua
 } // namespace HttpFilters
 } // namespace Extensions
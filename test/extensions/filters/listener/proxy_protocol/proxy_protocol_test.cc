@@ -6,7 +6,6 @@
 #include "common/event/dispatcher_impl.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/listener_impl.h"
-#include "common/network/raw_buffer_socket.h"
 #include "common/network/utility.h"
 #include "common/stats/stats_impl.h"
 
@@ -40,6 +39,7 @@ namespace ProxyProtocol {
 
 class ProxyProtocolTest : public testing::TestWithParam<Network::Address::IpVersion>,
                           public Network::ListenerConfig,
+                          public Network::FilterChainManager,
                           protected Logger::Loggable<Logger::Id::main> {
 public:
   ProxyProtocolTest()
@@ -54,18 +54,24 @@ public:
   }
 
   // Listener
+  Network::FilterChainManager& filterChainManager() override { return *this; }
   Network::FilterChainFactory& filterChainFactory() override { return factory_; }
   Network::Socket& socket() override { return socket_; }
-  Network::TransportSocketFactory& transportSocketFactory() override {
-    return transport_socket_factory_;
-  }
+  Network::ConnectionBalancer* connectionBalancer() override { return nullptr; }
   bool bindToPort() override { return true; }
   bool handOffRestoredDestinationConnections() const override { return false; }
   uint32_t perConnectionBufferLimitBytes() override { return 0; }
+  std::chrono::milliseconds listenerFiltersTimeout() const override { return {}; }
+  bool continueOnListenerFiltersTimeout() const override { return false; }
   Stats::Scope& listenerScope() override { return stats_store_; }
   uint64_t listenerTag() const override { return 1; }
   const std::string& name() const override { return name_; }
 
+  // Network::FilterChainManager
+  const Network::FilterChain* findFilterChain(const Network::ConnectionSocket&) const override {
+    return filter_chain_.get();
+  }
+
   void connect(bool read = true) {
     EXPECT_CALL(factory_, createListenerFilterChain(_))
         .WillOnce(Invoke([&](Network::ListenerFilterManager& filter_manager) -> bool {
@@ -76,8 +82,9 @@ public:
     conn_->connect();
     if (read) {
       read_filter_.reset(new NiceMock<Network::MockReadFilter>());
-      EXPECT_CALL(factory_, createNetworkFilterChain(_))
-          .WillOnce(Invoke([&](Network::Connection& connection) -> bool {
+      EXPECT_CALL(factory_, createNetworkFilterChain(_, _))
+          .WillOnce(Invoke([&](Network::Connection& connection,
+                               const std::vector<Network::FilterFactoryCb>&) -> bool {
             server_connection_ = &connection;
             connection.addConnectionCallbacks(server_callbacks_);
             connection.addReadFilter(read_filter_);
@@ -128,7 +135,8 @@ public:
 
   Event::DispatcherImpl dispatcher_;
   Network::TcpListenSocket socket_;
-  Network::RawBufferSocketFactory transport_socket_factory_;
+  const Network::FilterChainSharedPtr filter_chain_{
+      Network::Test::createEmptyFilterChainWithRawBufferSockets()};
   Stats::IsolatedStoreImpl stats_store_;
   Network::ConnectionHandlerPtr connection_handler_;
   Network::MockFilterChainFactory factory_;
@@ -313,7 +321,7 @@ TEST_P(ProxyProtocolTest, Closed) {
 TEST_P(ProxyProtocolTest, ClosedEmpty) {
   // We may or may not get these, depending on the operating system timing.
   EXPECT_CALL(factory_, createListenerFilterChain(_)).Times(AtLeast(0));
-  EXPECT_CALL(factory_, createNetworkFilterChain(_)).Times(AtLeast(0));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).Times(AtLeast(0));
   conn_->connect();
   conn_->close(Network::ConnectionCloseType::NoFlush);
   dispatcher_.run(Event::Dispatcher::RunType::NonBlock);
@@ -321,6 +329,7 @@ TEST_P(ProxyProtocolTest, ClosedEmpty) {
 
 class WildcardProxyProtocolTest : public testing::TestWithParam<Network::Address::IpVersion>,
                                   public Network::ListenerConfig,
+                                  public Network::FilterChainManager,
                                   protected Logger::Loggable<Logger::Id::main> {
 public:
   WildcardProxyProtocolTest()
@@ -345,23 +354,30 @@ public:
   }
 
   // Network::ListenerConfig
+  Network::FilterChainManager& filterChainManager() override { return *this; }
   Network::FilterChainFactory& filterChainFactory() override { return factory_; }
   Network::Socket& socket() override { return socket_; }
-  Network::TransportSocketFactory& transportSocketFactory() override {
-    return transport_socket_factory_;
-  }
+  Network::ConnectionBalancer* connectionBalancer() override { return nullptr; }
   bool bindToPort() override { return true; }
   bool handOffRestoredDestinationConnections() const override { return false; }
   uint32_t perConnectionBufferLimitBytes() override { return 0; }
+  std::chrono::milliseconds listenerFiltersTimeout() const override { return {}; }
+  bool continueOnListenerFiltersTimeout() const override { return false; }
   Stats::Scope& listenerScope() override { return stats_store_; }
   uint64_t listenerTag() const override { return 1; }
   const std::string& name() const override { return name_; }
 
+  // Network::FilterChainManager
+  const Network::FilterChain* findFilterChain(const Network::ConnectionSocket&) const override {
+    return filter_chain_.get();
+  }
+
   void connect() {
     conn_->connect();
     read_filter_.reset(new NiceMock<Network::MockReadFilter>());
-    EXPECT_CALL(factory_, createNetworkFilterChain(_))
-        .WillOnce(Invoke([&](Network::Connection& connection) -> bool {
+    EXPECT_CALL(factory_, createNetworkFilterChain(_, _))
+        .WillOnce(Invoke([&](Network::Connection& connection,
+                             const std::vector<Network::FilterFactoryCb>&) -> bool {
           server_connection_ = &connection;
           connection.addConnectionCallbacks(server_callbacks_);
           connection.addReadFilter(read_filter_);
@@ -401,7 +417,8 @@ public:
 
   Event::DispatcherImpl dispatcher_;
   Network::TcpListenSocket socket_;
-  Network::RawBufferSocketFactory transport_socket_factory_;
+  const Network::FilterChainSharedPtr filter_chain_{
+      Network::Test::createEmptyFilterChainWithRawBufferSockets()};
   Network::Address::InstanceConstSharedPtr local_dst_address_;
   Stats::IsolatedStoreImpl stats_store_;
   Network::ConnectionHandlerPtr connection_handler_;
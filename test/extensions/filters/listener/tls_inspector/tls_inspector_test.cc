@@ -0,0 +1,184 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "common/stats/stats_impl.h"
+
+#include "extensions/filters/listener/tls_inspector/tls_inspector.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+using testing::DoAll;
+using testing::InSequence;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+using testing::SaveArg;
+using testing::_;
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace TlsInspector {
+namespace {
+
+// Generates the ClientHello a client sends for the given SNI and ALPN, either of which may be
+// empty to leave the extension out.
+std::vector<uint8_t> generateClientHello(const std::string& sni, const std::string& alpn) {
+  bssl::UniquePtr<SSL_CTX> ctx(SSL_CTX_new(TLS_with_buffers_method()));
+  if (!alpn.empty()) {
+    SSL_CTX_set_alpn_protos(ctx.get(), reinterpret_cast<const uint8_t*>(alpn.data()),
+                            alpn.size());
+  }
+  bssl::UniquePtr<SSL> ssl(SSL_new(ctx.get()));
+  if (!sni.empty()) {
+    SSL_set_tlsext_host_name(ssl.get(), sni.c_str());
+  }
+
+  // The ClientHello is written to a memory BIO, and the handshake then waits for the server.
+  bssl::UniquePtr<BIO> out(BIO_new(BIO_s_mem()));
+  BIO* in = BIO_new(BIO_s_mem());
+  BIO_set_mem_eof_return(in, -1);
+  BIO_up_ref(out.get());
+  SSL_set_bio(ssl.get(), in, out.get());
+  SSL_set_connect_state(ssl.get());
+  EXPECT_EQ(SSL_ERROR_WANT_READ, SSL_get_error(ssl.get(), SSL_do_handshake(ssl.get())));
+
+  const uint8_t* data;
+  size_t len;
+  BIO_mem_contents(out.get(), &data, &len);
+  return std::vector<uint8_t>(data, data + len);
+}
+
+class TlsInspectorTest : public testing::Test {
+public:
+  TlsInspectorTest() : cfg_(std::make_shared<Config>(store_)) {
+    int fds[2];
+    RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+    client_fd_ = fds[0];
+    server_fd_ = fds[1];
+  }
+
+  ~TlsInspectorTest() {
+    close(client_fd_);
+    close(server_fd_);
+  }
+
+  void init() {
+    filter_ = std::make_unique<Filter>(cfg_);
+    EXPECT_CALL(cb_, socket()).WillRepeatedly(ReturnRef(socket_));
+    EXPECT_CALL(cb_, dispatcher()).WillRepeatedly(ReturnRef(dispatcher_));
+    EXPECT_CALL(socket_, fd()).WillRepeatedly(Return(server_fd_));
+    EXPECT_CALL(dispatcher_, createFileEvent_(server_fd_, _, Event::FileTriggerType::Edge,
+                                              Event::FileReadyType::Read |
+                                                  Event::FileReadyType::Closed))
+        .WillOnce(DoAll(SaveArg<1>(&file_event_callback_),
+                        Return(new NiceMock<Event::MockFileEvent>)));
+    filter_->onAccept(cb_);
+  }
+
+  void write(const std::vector<uint8_t>& data) {
+    ASSERT_EQ(static_cast<ssize_t>(data.size()), ::write(client_fd_, data.data(), data.size()));
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  ConfigSharedPtr cfg_;
+  std::unique_ptr<Filter> filter_;
+  Network::MockListenerFilterCallbacks cb_;
+  Network::MockConnectionSocket socket_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Event::FileReadyCb file_event_callback_;
+  int client_fd_;
+  int server_fd_;
+};
+
+// Test that the filter sets the SNI and ALPN of a TLS connection.
+TEST_F(TlsInspectorTest, SniAndAlpn) {
+  init();
+  write(generateClientHello("example.com", std::string("\x02h2\x08http/1.1", 12)));
+  const std::vector<std::string> alpn{"h2", "http/1.1"};
+  EXPECT_CALL(socket_, setRequestedServerName(absl::string_view("example.com")));
+  EXPECT_CALL(socket_, setRequestedApplicationProtocols(alpn));
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_found_.value());
+  EXPECT_EQ(1, cfg_->stats().sni_found_.value());
+  EXPECT_EQ(1, cfg_->stats().alpn_found_.value());
+}
+
+// Test that a ClientHello without SNI or ALPN is still let through.
+TEST_F(TlsInspectorTest, NoExtensions) {
+  init();
+  write(generateClientHello("", ""));
+  EXPECT_CALL(socket_, setRequestedServerName(_)).Times(0);
+  EXPECT_CALL(socket_, setRequestedApplicationProtocols(_)).Times(0);
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_found_.value());
+  EXPECT_EQ(1, cfg_->stats().sni_not_found_.value());
+  EXPECT_EQ(1, cfg_->stats().alpn_not_found_.value());
+}
+
+// Test that a ClientHello arriving a byte at a time is only parsed once complete.
+TEST_F(TlsInspectorTest, ClientHelloInPieces) {
+  init();
+  const std::vector<uint8_t> client_hello = generateClientHello("example.com", "");
+  {
+    InSequence s;
+    EXPECT_CALL(cb_, continueFilterChain(_)).Times(0);
+    for (size_t i = 0; i + 1 < client_hello.size(); ++i) {
+      write(std::vector<uint8_t>{client_hello[i]});
+      file_event_callback_(Event::FileReadyType::Read);
+    }
+  }
+  EXPECT_CALL(socket_, setRequestedServerName(absl::string_view("example.com")));
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  write(std::vector<uint8_t>{client_hello.back()});
+  file_event_callback_(Event::FileReadyType::Read);
+}
+
+// Test that a connection which doesn't start with a TLS handshake is let through unchanged.
+TEST_F(TlsInspectorTest, NotSsl) {
+  init();
+  const std::string request = "GET / HTTP/1.1\r\nHost: example.com\r\n\r\n";
+  write(std::vector<uint8_t>(request.begin(), request.end()));
+  EXPECT_CALL(socket_, setRequestedServerName(_)).Times(0);
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_not_found_.value());
+}
+
+// Test that a ClientHello too large for the buffer fails the connection.
+TEST_F(TlsInspectorTest, ClientHelloTooLarge) {
+  init();
+  std::vector<uint8_t> client_hello = generateClientHello("example.com", "");
+  // Claim a record far larger than the one sent, and pad it out to fill the buffer.
+  client_hello[3] = 0x40;
+  client_hello[4] = 0x00;
+  client_hello.resize(Config::TLS_MAX_CLIENT_HELLO);
+  write(client_hello);
+  EXPECT_CALL(cb_, continueFilterChain(false));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().client_hello_too_large_.value());
+}
+
+// Test that the connection closing before the ClientHello is complete fails the connection.
+TEST_F(TlsInspectorTest, ConnectionClosed) {
+  init();
+  EXPECT_CALL(cb_, continueFilterChain(false));
+  file_event_callback_(Event::FileReadyType::Closed);
+  EXPECT_EQ(1, cfg_->stats().connection_closed_.value());
+}
+
+} // namespace
+} // namespace TlsInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1,10 +1,12 @@
 #include <chrono>
 
+#include "common/common/utility.h"
 #include "common/network/address_impl.h"
 #include "common/network/utility.h"
 
 #include "extensions/stat_sinks/common/statsd/statsd.h"
 
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/stats/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
@@ -15,7 +17,9 @@
 #include "gtest/gtest.h"
 #include "spdlog/spdlog.h"
 
+using testing::InSequence;
 using testing::NiceMock;
+using testing::_;
 
 namespace Envoy {
 namespace Extensions {
@@ -26,6 +30,13 @@ namespace Statsd {
 class MockWriter : public Writer {
 public:
   MOCK_METHOD1(write, void(const std::string& message));
+
+  // Expand batches so that tests can set expectations on each datagram.
+  void writeBatch(const std::vector<absl::string_view>& datagrams) override {
+    for (const absl::string_view datagram : datagrams) {
+      write(std::string(datagram));
+    }
+  }
 };
 
 class UdpStatsdSinkTest : public testing::TestWithParam<Network::Address::IpVersion> {};
@@ -112,25 +123,31 @@ TEST_P(UdpStatsdSinkWithTagsTest, InitWithIpAddress) {
 TEST(UdpStatsdSinkTest, CheckActualStats) {
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
   NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::MockTimer* flush_timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
   UdpStatsdSink sink(tls_, writer_ptr, false);
 
   NiceMock<Stats::MockCounter> counter;
   counter.name_ = "test_counter";
   EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr),
               write("envoy.test_counter:1|c"));
+  sink.beginFlush();
   sink.flushCounter(counter, 1);
+  sink.endFlush();
 
   NiceMock<Stats::MockGauge> gauge;
   gauge.name_ = "test_gauge";
   EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr),
               write("envoy.test_gauge:1|g"));
+  sink.beginFlush();
   sink.flushGauge(gauge, 1);
+  sink.endFlush();
 
   NiceMock<Stats::MockHistogram> timer;
   timer.name_ = "test_timer";
   EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr),
               write("envoy.test_timer:5|ms"));
   sink.onHistogramComplete(timer, 5);
+  flush_timer->callback_();
 
   tls_.shutdownThread();
 }
@@ -138,6 +155,7 @@ TEST(UdpStatsdSinkTest, CheckActualStats) {
 TEST(UdpStatsdSinkWithTagsTest, CheckActualStats) {
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
   NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::MockTimer* flush_timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
   UdpStatsdSink sink(tls_, writer_ptr, true);
 
   std::vector<Stats::Tag> tags = {Stats::Tag{"key1", "value1"}, Stats::Tag{"key2", "value2"}};
@@ -146,14 +164,18 @@ TEST(UdpStatsdSinkWithTagsTest, CheckActualStats) {
   counter.tags_ = tags;
   EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr),
               write("envoy.test_counter:1|c|#key1:value1,key2:value2"));
+  sink.beginFlush();
   sink.flushCounter(counter, 1);
+  sink.endFlush();
 
   NiceMock<Stats::MockGauge> gauge;
   gauge.name_ = "test_gauge";
   gauge.tags_ = tags;
   EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr),
               write("envoy.test_gauge:1|g|#key1:value1,key2:value2"));
+  sink.beginFlush();
   sink.flushGauge(gauge, 1);
+  sink.endFlush();
 
   NiceMock<Stats::MockHistogram> timer;
   timer.name_ = "test_timer";
@@ -161,7 +183,107 @@ TEST(UdpStatsdSinkWithTagsTest, CheckActualStats) {
   EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr),
               write("envoy.test_timer:5|ms|#key1:value1,key2:value2"));
   sink.onHistogramComplete(timer, 5);
+  flush_timer->callback_();
+
+  tls_.shutdownThread();
+}
+
+// Lines flushed together are packed, newline separated, into as few datagrams as possible.
+TEST(UdpStatsdSinkTest, PackLinesIntoDatagrams) {
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false);
+
+  NiceMock<Stats::MockCounter> counter;
+  counter.name_ = "test_counter";
+  NiceMock<Stats::MockGauge> gauge;
+  gauge.name_ = "test_gauge";
+
+  EXPECT_CALL(*writer_ptr, write(_)).Times(0);
+  sink.beginFlush();
+  sink.flushCounter(counter, 1);
+  sink.flushGauge(gauge, 2);
+  sink.flushCounter(counter, 3);
+
+  EXPECT_CALL(*writer_ptr, write("envoy.test_counter:1|c\n"
+                                 "envoy.test_gauge:2|g\n"
+                                 "envoy.test_counter:3|c"));
+  sink.endFlush();
+
+  // Nothing is left over for the next flush.
+  EXPECT_CALL(*writer_ptr, write(_)).Times(0);
+  sink.beginFlush();
+  sink.endFlush();
+
+  tls_.shutdownThread();
+}
+
+// A line that would push a datagram past MAX_DATAGRAM_BYTES starts the next datagram instead, and
+// a line that is too long on its own is still sent.
+TEST(UdpStatsdSinkTest, SplitDatagramsAtMaxSize) {
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false);
+
+  // Each line is "envoy." + name + ":1|c", 100 bytes in total.
+  NiceMock<Stats::MockCounter> counter;
+  counter.name_ = std::string(90, 'a');
+  const std::string line = "envoy." + counter.name_ + ":1|c";
+  ASSERT_EQ(100U, line.size());
+  const size_t lines_per_datagram = (UdpStatsdSink::MAX_DATAGRAM_BYTES + 1) / (line.size() + 1);
+
+  NiceMock<Stats::MockCounter> huge_counter;
+  huge_counter.name_ = std::string(UdpStatsdSink::MAX_DATAGRAM_BYTES, 'b');
+
+  std::vector<std::string> full_datagram_lines(lines_per_datagram, line);
+  const std::string full_datagram = StringUtil::join(full_datagram_lines, "\n");
+  ASSERT_LE(full_datagram.size(), UdpStatsdSink::MAX_DATAGRAM_BYTES);
+
+  {
+    InSequence s;
+    EXPECT_CALL(*writer_ptr, write(full_datagram));
+    EXPECT_CALL(*writer_ptr, write(line));
+    EXPECT_CALL(*writer_ptr, write("envoy." + huge_counter.name_ + ":1|c"));
+    EXPECT_CALL(*writer_ptr, write(line));
+  }
+  sink.beginFlush();
+  for (size_t i = 0; i < lines_per_datagram + 1; i++) {
+    sink.flushCounter(counter, 1);
+  }
+  sink.flushCounter(huge_counter, 1);
+  sink.flushCounter(counter, 1);
+  sink.endFlush();
+
+  tls_.shutdownThread();
+}
+
+// Histogram lines are buffered on each thread and sent when the flush timer fires.
+TEST(UdpStatsdSinkTest, BatchHistograms) {
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::MockTimer* flush_timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  UdpStatsdSink sink(tls_, writer_ptr, false);
+
+  NiceMock<Stats::MockHistogram> timer;
+  timer.name_ = "test_timer";
+
+  EXPECT_CALL(*writer_ptr, write(_)).Times(0);
+  EXPECT_CALL(*flush_timer, enableTimer(UdpStatsdSink::HISTOGRAM_FLUSH_INTERVAL));
+  sink.onHistogramComplete(timer, 5);
+  sink.onHistogramComplete(timer, 6);
+
+  EXPECT_CALL(*writer_ptr, write("envoy.test_timer:5|ms\nenvoy.test_timer:6|ms"));
+  flush_timer->callback_();
+
+  // The timer is only enabled again once there is something new to send.
+  EXPECT_CALL(*writer_ptr, write(_)).Times(0);
+  flush_timer->callback_();
+
+  EXPECT_CALL(*flush_timer, enableTimer(UdpStatsdSink::HISTOGRAM_FLUSH_INTERVAL));
+  sink.onHistogramComplete(timer, 7);
 
+  // Buffered lines are sent when the thread shuts down.
+  EXPECT_CALL(*writer_ptr, write("envoy.test_timer:7|ms"));
   tls_.shutdownThread();
 }
 
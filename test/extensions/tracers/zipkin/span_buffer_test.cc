@@ -1,5 +1,9 @@
+#include "common/buffer/buffer_impl.h"
+
 #include "extensions/tracers/zipkin/span_buffer.h"
 
+#include "test/test_common/utility.h"
+
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -104,6 +108,54 @@ TEST(ZipkinSpanBufferTest, sizeConstructorEndtoEnd) {
   EXPECT_EQ("[]", buffer.toStringifiedJsonArray());
 }
 
+TEST(ZipkinSpanBufferTest, fullBufferRejectsSpans) {
+  SpanBuffer buffer(1);
+
+  EXPECT_TRUE(buffer.addSpan(Span()));
+  EXPECT_FALSE(buffer.addSpan(Span()));
+  EXPECT_EQ(1ULL, buffer.pendingSpans());
+}
+
+TEST(ZipkinSpanBufferTest, drainToJson) {
+  SpanBuffer buffer(SpanEncoding::Json, 2);
+  buffer.addSpan(Span());
+  buffer.addSpan(Span());
+  const std::string expected_json_array_string = buffer.toStringifiedJsonArray();
+
+  Buffer::OwnedImpl body;
+  buffer.drainTo(body);
+  EXPECT_EQ(expected_json_array_string, TestUtility::bufferToString(body));
+  EXPECT_EQ(0ULL, buffer.pendingSpans());
+  EXPECT_TRUE(buffer.addSpan(Span()));
+}
+
+TEST(ZipkinSpanBufferTest, drainToThrift) {
+  SpanBuffer buffer(SpanEncoding::Thrift, 2);
+  buffer.addSpan(Span());
+  EXPECT_EQ(1ULL, buffer.pendingSpans());
+
+  Buffer::OwnedImpl body;
+  buffer.drainTo(body);
+  const std::string expected_thrift(
+      // list<Span> with one element.
+      "\x0c\x00\x00\x00\x01"
+      // trace_id
+      "\x0a\x00\x01\x00\x00\x00\x00\x00\x00\x00\x00"
+      // name
+      "\x0b\x00\x03\x00\x00\x00\x00"
+      // id
+      "\x0a\x00\x04\x00\x00\x00\x00\x00\x00\x00\x00"
+      // annotations
+      "\x0f\x00\x06\x0c\x00\x00\x00\x00"
+      // binary_annotations
+      "\x0f\x00\x08\x0c\x00\x00\x00\x00"
+      // stop
+      "\x00",
+      51);
+  EXPECT_EQ(expected_thrift, TestUtility::bufferToString(body));
+  EXPECT_EQ(0ULL, buffer.pendingSpans());
+}
+
 } // namespace Zipkin
 } // namespace Tracers
 } // namespace Extensions
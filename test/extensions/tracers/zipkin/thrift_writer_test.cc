@@ -0,0 +1,54 @@
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/tracers/zipkin/thrift_writer.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Zipkin {
+
+TEST(ZipkinThriftWriterTest, Values) {
+  Buffer::OwnedImpl buffer;
+  ThriftWriter writer(buffer);
+
+  writer.writeBool(true);
+  writer.writeI16(-2);
+  writer.writeI32(0x01020304);
+  writer.writeI64(0x0102030405060708);
+  writer.writeString("ab");
+
+  EXPECT_EQ(std::string("\x01"
+                        "\xff\xfe"
+                        "\x01\x02\x03\x04"
+                        "\x01\x02\x03\x04\x05\x06\x07\x08"
+                        "\x00\x00\x00\x02"
+                        "ab",
+                        21),
+            TestUtility::bufferToString(buffer));
+}
+
+TEST(ZipkinThriftWriterTest, FieldsAndLists) {
+  Buffer::OwnedImpl buffer;
+  ThriftWriter writer(buffer);
+
+  writer.writeFieldBegin(ThriftType::List, 6);
+  writer.writeListBegin(ThriftType::Struct, 3);
+  writer.writeFieldStop();
+
+  EXPECT_EQ(std::string("\x0f\x00\x06"
+                        "\x0c\x00\x00\x00\x03"
+                        "\x00",
+                        9),
+            TestUtility::bufferToString(buffer));
+}
+
+} // namespace Zipkin
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
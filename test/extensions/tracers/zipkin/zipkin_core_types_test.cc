@@ -1,3 +1,4 @@
+#include "common/buffer/buffer_impl.h"
 #include "common/common/utility.h"
 #include "common/network/address_impl.h"
 #include "common/network/utility.h"
@@ -5,6 +6,8 @@
 #include "extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "extensions/tracers/zipkin/zipkin_core_types.h"
 
+#include "test/test_common/utility.h"
+
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -36,6 +39,29 @@ TEST(ZipkinCoreTypesEndpointTest, defaultConstructor) {
       ep.toJson());
 }
 
+TEST(ZipkinCoreTypesEndpointTest, toThrift) {
+  Endpoint ep(std::string("svc"), Network::Utility::parseInternetAddressAndPort("127.0.0.1:3306"));
+  Buffer::OwnedImpl buffer;
+  ThriftWriter writer(buffer);
+  ep.toThrift(writer);
+  EXPECT_EQ(std::string("\x08\x00\x01\x7f\x00\x00\x01"
+                        "\x06\x00\x02\x0c\xea"
+                        "\x0b\x00\x03\x00\x00\x00\x03"
+                        "svc"
+                        "\x00",
+                        23),
+            TestUtility::bufferToString(buffer));
+
+  buffer.drain(buffer.length());
+  ep.setAddress(Network::Utility::parseInternetAddressAndPort("[::1]:80"));
+  ep.toThrift(writer);
+  const std::string thrift = TestUtility::bufferToString(buffer);
+  // The ipv4 field is zero and the address is written as the ipv6 field.
+  EXPECT_EQ(std::string("\x08\x00\x01\x00\x00\x00\x00", 7), thrift.substr(0, 7));
+  EXPECT_EQ(std::string("\x0b\x00\x04\x00\x00\x00\x10", 7), thrift.substr(22, 7));
+  EXPECT_EQ(std::string(15, '\0') + "\x01" + std::string(1, '\0'), thrift.substr(29));
+}
+
 TEST(ZipkinCoreTypesEndpointTest, customConstructor) {
   Network::Address::InstanceConstSharedPtr addr =
       Network::Utility::parseInternetAddressAndPort("127.0.0.1:3306");
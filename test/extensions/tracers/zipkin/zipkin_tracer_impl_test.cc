@@ -154,6 +154,8 @@ TEST_F(ZipkinDriverTest, FlushSeveralSpans) {
   EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.min_flush_spans", 5))
       .Times(2)
       .WillRepeatedly(Return(2));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.max_pending_reports", 8U))
+      .WillOnce(Return(8U));
   EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.request_timeout", 5000U))
       .WillOnce(Return(5000U));
 
@@ -201,6 +203,8 @@ TEST_F(ZipkinDriverTest, FlushOneSpanReportFailure) {
           }));
   EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.min_flush_spans", 5))
       .WillOnce(Return(1));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.max_pending_reports", 8U))
+      .WillOnce(Return(8U));
   EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.request_timeout", 5000U))
       .WillOnce(Return(5000U));
 
@@ -235,6 +239,8 @@ TEST_F(ZipkinDriverTest, FlushSpansTimer) {
 
   // Timer should be re-enabled.
   EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(5000)));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.max_pending_reports", 8U))
+      .WillOnce(Return(8U));
   EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.request_timeout", 5000U))
       .WillOnce(Return(5000U));
   EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.flush_interval_ms", 5000U))
@@ -246,6 +252,84 @@ TEST_F(ZipkinDriverTest, FlushSpansTimer) {
   EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_sent").value());
 }
 
+TEST_F(ZipkinDriverTest, FlushSpansThrift) {
+  EXPECT_CALL(cm_, get("fake_cluster")).WillRepeatedly(Return(&cm_.thread_local_cluster_));
+  std::string thrift_config = R"EOF(
+    {
+     "collector_cluster": "fake_cluster",
+     "collector_endpoint": "/api/v1/spans",
+     "collector_encoding": "THRIFT"
+     }
+  )EOF";
+  Json::ObjectSharedPtr loader = Json::Factory::loadFromString(thrift_config);
+  setup(*loader, true);
+
+  EXPECT_CALL(cm_.async_client_, send_(_, _, _))
+      .WillOnce(Invoke([&](Http::MessagePtr& message, Http::AsyncClient::Callbacks&,
+                           const absl::optional<std::chrono::milliseconds>&)
+                           -> Http::AsyncClient::Request* {
+        EXPECT_STREQ("application/x-thrift", message->headers().ContentType()->value().c_str());
+        // A list of one struct.
+        const std::string body = TestUtility::bufferToString(*message->body());
+        EXPECT_EQ(std::string("\x0c\x00\x00\x00\x01", 5), body.substr(0, 5));
+        return nullptr;
+      }));
+  ON_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.min_flush_spans", 5))
+      .WillByDefault(Return(1));
+
+  Tracing::SpanPtr span = driver_->startSpan(config_, request_headers_, operation_name_,
+                                             start_time_, {Tracing::Reason::Sampling, true});
+  span->finishSpan();
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_sent").value());
+}
+
+TEST_F(ZipkinDriverTest, UnknownEncoding) {
+  EXPECT_CALL(cm_, get("fake_cluster")).WillRepeatedly(Return(&cm_.thread_local_cluster_));
+  std::string bad_config = R"EOF(
+    {
+     "collector_cluster": "fake_cluster",
+     "collector_encoding": "XML"
+     }
+  )EOF";
+  Json::ObjectSharedPtr loader = Json::Factory::loadFromString(bad_config);
+  EXPECT_THROW_WITH_MESSAGE(setup(*loader, false), EnvoyException,
+                            "unknown zipkin collector encoding 'XML'");
+}
+
+TEST_F(ZipkinDriverTest, FlushSpansThrottledWhenCollectorSlow) {
+  setupValidDriver();
+
+  Http::MockAsyncClientRequest request(&cm_.async_client_);
+  Http::AsyncClient::Callbacks* callback;
+  EXPECT_CALL(cm_.async_client_, send_(_, _, _))
+      .WillOnce(Invoke([&](Http::MessagePtr&, Http::AsyncClient::Callbacks& callbacks,
+                           const absl::optional<std::chrono::milliseconds>&)
+                           -> Http::AsyncClient::Request* {
+        callback = &callbacks;
+        return &request;
+      }));
+  ON_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.min_flush_spans", 5))
+      .WillByDefault(Return(1));
+  ON_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.max_pending_reports", 8U))
+      .WillByDefault(Return(1));
+
+  Tracing::SpanPtr first_span = driver_->startSpan(config_, request_headers_, operation_name_,
+                                                   start_time_, {Tracing::Reason::Sampling, true});
+  first_span->finishSpan();
+  EXPECT_EQ(1U, stats_.gauge("tracing.zipkin.reports_pending").value());
+
+  // The first report is still in flight, so the second span is dropped.
+  Tracing::SpanPtr second_span = driver_->startSpan(config_, request_headers_, operation_name_,
+                                                    start_time_, {Tracing::Reason::Sampling, true});
+  second_span->finishSpan();
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_sent").value());
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_dropped").value());
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.reports_throttled").value());
+
+  callback->onFailure(Http::AsyncClient::FailureReason::Reset);
+  EXPECT_EQ(0U, stats_.gauge("tracing.zipkin.reports_pending").value());
+}
+
 TEST_F(ZipkinDriverTest, NoB3ContextSampledTrue) {
   setupValidDriver();
 
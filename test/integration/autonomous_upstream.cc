@@ -67,7 +67,8 @@ AutonomousUpstream::~AutonomousUpstream() {
   http_connections_.clear();
 }
 
-bool AutonomousUpstream::createNetworkFilterChain(Network::Connection& connection) {
+bool AutonomousUpstream::createNetworkFilterChain(Network::Connection& connection,
+                                                  const std::vector<Network::FilterFactoryCb>&) {
   AutonomousHttpConnectionPtr http_connection(new AutonomousHttpConnection(
       QueuedConnectionWrapperPtr{new QueuedConnectionWrapper(connection, true)}, stats_store_,
       http_type_, *this));
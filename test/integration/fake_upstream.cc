@@ -295,7 +295,8 @@ FakeUpstream::FakeUpstream(Network::TransportSocketFactoryPtr&& transport_socket
 FakeUpstream::FakeUpstream(Network::TransportSocketFactoryPtr&& transport_socket_factory,
                            Network::SocketPtr&& listen_socket, FakeHttpConnection::Type type,
                            bool enable_half_close)
-    : http_type_(type), transport_socket_factory_(std::move(transport_socket_factory)),
+    : http_type_(type),
+      filter_chain_(Network::Test::createEmptyFilterChain(std::move(transport_socket_factory))),
       socket_(std::move(listen_socket)), api_(new Api::Impl(std::chrono::milliseconds(10000))),
       dispatcher_(api_->allocateDispatcher()),
       handler_(new Server::ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher_)),
@@ -315,7 +316,8 @@ void FakeUpstream::cleanUp() {
   }
 }
 
-bool FakeUpstream::createNetworkFilterChain(Network::Connection& connection) {
+bool FakeUpstream::createNetworkFilterChain(Network::Connection& connection,
+                                            const std::vector<Network::FilterFactoryCb>&) {
   std::unique_lock<std::mutex> lock(lock_);
   connection.readDisable(true);
   new_connections_.emplace_back(
@@ -285,7 +285,9 @@ typedef std::unique_ptr<FakeRawConnection> FakeRawConnectionPtr;
 /**
  * Provides a fake upstream server for integration testing.
  */
-class FakeUpstream : Logger::Loggable<Logger::Id::testing>, public Network::FilterChainFactory {
+class FakeUpstream : Logger::Loggable<Logger::Id::testing>,
+                     public Network::FilterChainManager,
+                     public Network::FilterChainFactory {
 public:
   FakeUpstream(const std::string& uds_path, FakeHttpConnection::Type type);
   FakeUpstream(uint32_t port, FakeHttpConnection::Type type, Network::Address::IpVersion version,
@@ -304,8 +306,15 @@ public:
   waitForHttpConnection(Event::Dispatcher& client_dispatcher,
                         std::vector<std::unique_ptr<FakeUpstream>>& upstreams);
 
+  // Network::FilterChainManager
+  const Network::FilterChain* findFilterChain(const Network::ConnectionSocket&) const override {
+    return filter_chain_.get();
+  }
+
   // Network::FilterChainFactory
-  bool createNetworkFilterChain(Network::Connection& connection) override;
+  bool createNetworkFilterChain(
+      Network::Connection& connection,
+      const std::vector<Network::FilterFactoryCb>& filter_factories) override;
   bool createListenerFilterChain(Network::ListenerFilterManager& listener) override;
   void set_allow_unexpected_disconnects(bool value) { allow_unexpected_disconnects_ = value; }
 
@@ -325,14 +334,15 @@ private:
 
   private:
     // Network::ListenerConfig
+    Network::FilterChainManager& filterChainManager() override { return parent_; }
     Network::FilterChainFactory& filterChainFactory() override { return parent_; }
     Network::Socket& socket() override { return *parent_.socket_; }
-    Network::TransportSocketFactory& transportSocketFactory() override {
-      return *parent_.transport_socket_factory_;
-    }
+    Network::ConnectionBalancer* connectionBalancer() override { return nullptr; }
     bool bindToPort() override { return true; }
     bool handOffRestoredDestinationConnections() const override { return false; }
     uint32_t perConnectionBufferLimitBytes() override { return 0; }
+    std::chrono::milliseconds listenerFiltersTimeout() const override { return {}; }
+    bool continueOnListenerFiltersTimeout() const override { return false; }
     Stats::Scope& listenerScope() override { return parent_.stats_store_; }
     uint64_t listenerTag() const override { return 0; }
     const std::string& name() const override { return name_; }
@@ -343,7 +353,7 @@ private:
 
   void threadRoutine();
 
-  Network::TransportSocketFactoryPtr transport_socket_factory_;
+  const Network::FilterChainSharedPtr filter_chain_;
   Network::SocketPtr socket_;
   ConditionalInitializer server_initialized_;
   // Guards any objects which can be altered both in the upstream thread and the
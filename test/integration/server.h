@@ -179,6 +179,21 @@ public:
   // Stats::StoreRoot
   void addSink(Sink&) override {}
   void setTagProducer(TagProducerPtr&&) override {}
+  void latchChangedMetrics(ChangedMetrics& changed) override {
+    std::unique_lock<std::mutex> lock(lock_);
+    changed.clear();
+    for (const CounterSharedPtr& counter : store_.counters()) {
+      const uint64_t delta = counter->latch();
+      if (delta > 0) {
+        changed.counters_.emplace_back(counter, delta);
+      }
+    }
+    for (const GaugeSharedPtr& gauge : store_.gauges()) {
+      if (gauge->used()) {
+        changed.gauges_.push_back(gauge);
+      }
+    }
+  }
   void initializeThreading(Event::Dispatcher&, ThreadLocal::Instance&) override {}
   void shutdownThreading() override {}
 
@@ -97,6 +97,8 @@ public:
   MOCK_METHOD1(createTimer_, Timer*(TimerCb cb));
   MOCK_METHOD1(deferredDelete_, void(DeferredDeletable* to_delete));
   MOCK_METHOD0(exit, void());
+  MOCK_METHOD2(initializeStats, DispatcherStatsSummaryConstSharedPtr(Stats::Scope& scope,
+                                                                     const std::string& prefix));
   MOCK_METHOD2(listenForSignal_, SignalEvent*(int signal_num, SignalCb cb));
   MOCK_METHOD1(post, void(std::function<void()> callback));
   MOCK_METHOD1(run, void(RunType type));
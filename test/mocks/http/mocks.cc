@@ -68,6 +68,7 @@ template <class T> static void initializeMockStreamFilterCallbacks(T& callbacks)
   ON_CALL(callbacks, dispatcher()).WillByDefault(ReturnRef(callbacks.dispatcher_));
   ON_CALL(callbacks, requestInfo()).WillByDefault(ReturnRef(callbacks.request_info_));
   ON_CALL(callbacks, route()).WillByDefault(Return(callbacks.route_));
+  ON_CALL(callbacks, arena()).WillByDefault(ReturnRef(callbacks.arena_));
 }
 
 MockStreamDecoderFilterCallbacks::MockStreamDecoderFilterCallbacks() {
@@ -14,6 +14,8 @@
 #include "envoy/http/filter.h"
 #include "envoy/ssl/connection.h"
 
+#include "common/common/arena_impl.h"
+
 #include "test/mocks/common.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/request_info/mocks.h"
@@ -166,6 +168,7 @@ public:
 
 class MockStreamFilterCallbacksBase {
 public:
+  ArenaImpl arena_;
   Event::MockDispatcher dispatcher_;
   testing::NiceMock<RequestInfo::MockRequestInfo> request_info_;
   std::shared_ptr<Router::MockRoute> route_;
@@ -187,6 +190,7 @@ public:
   MOCK_METHOD0(requestInfo, RequestInfo::RequestInfo&());
   MOCK_METHOD0(activeSpan, Tracing::Span&());
   MOCK_METHOD0(tracingConfig, Tracing::Config&());
+  MOCK_METHOD0(arena, Arena&());
   MOCK_METHOD0(onDecoderFilterAboveWriteBufferHighWatermark, void());
   MOCK_METHOD0(onDecoderFilterBelowWriteBufferLowWatermark, void());
   MOCK_METHOD1(addDownstreamWatermarkCallbacks, void(DownstreamWatermarkCallbacks&));
@@ -233,6 +237,7 @@ public:
   MOCK_METHOD0(requestInfo, RequestInfo::RequestInfo&());
   MOCK_METHOD0(activeSpan, Tracing::Span&());
   MOCK_METHOD0(tracingConfig, Tracing::Config&());
+  MOCK_METHOD0(arena, Arena&());
   MOCK_METHOD0(onEncoderFilterAboveWriteBufferHighWatermark, void());
   MOCK_METHOD0(onEncoderFilterBelowWriteBufferLowWatermark, void());
   MOCK_METHOD1(setEncoderBufferLimit, void(uint32_t));
@@ -324,9 +329,9 @@ public:
   MOCK_METHOD3(send_, Request*(MessagePtr& request, Callbacks& callbacks,
                                const absl::optional<std::chrono::milliseconds>& timeout));
 
-  MOCK_METHOD3(start, Stream*(StreamCallbacks& callbacks,
+  MOCK_METHOD4(start, Stream*(StreamCallbacks& callbacks,
                               const absl::optional<std::chrono::milliseconds>& timeout,
-                              bool buffer_body_for_retry));
+                              bool buffer_body_for_retry, uint32_t buffer_limit));
 
   MOCK_METHOD0(dispatcher, Event::Dispatcher&());
 
@@ -380,6 +385,7 @@ public:
   MOCK_METHOD2(sendData, void(Buffer::Instance& data, bool end_stream));
   MOCK_METHOD1(sendTrailers, void(HeaderMap& trailers));
   MOCK_METHOD0(reset, void());
+  MOCK_CONST_METHOD0(isAboveWriteBufferHighWatermark, bool());
 };
 
 class MockFilterChainFactoryCallbacks : public Http::FilterChainFactoryCallbacks {
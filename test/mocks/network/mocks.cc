@@ -25,6 +25,7 @@ namespace Network {
 
 MockListenerConfig::MockListenerConfig() {
   ON_CALL(*this, filterChainFactory()).WillByDefault(ReturnRef(filter_chain_factory_));
+  ON_CALL(*this, filterChainManager()).WillByDefault(ReturnRef(filter_chain_manager_));
   ON_CALL(*this, socket()).WillByDefault(ReturnRef(socket_));
   ON_CALL(*this, listenerScope()).WillByDefault(ReturnRef(scope_));
   ON_CALL(*this, name()).WillByDefault(ReturnRef(name_));
@@ -171,6 +172,14 @@ MockFilterChainFactory::MockFilterChainFactory() {
 }
 MockFilterChainFactory::~MockFilterChainFactory() {}
 
+MockFilterChain::MockFilterChain() {
+  ON_CALL(*this, networkFilterFactories()).WillByDefault(ReturnRef(network_filter_factories_));
+}
+MockFilterChain::~MockFilterChain() {}
+
+MockFilterChainManager::MockFilterChainManager() {}
+MockFilterChainManager::~MockFilterChainManager() {}
+
 MockListenSocket::MockListenSocket() : local_address_(new Address::Ipv4Instance(80)) {
   ON_CALL(*this, localAddress()).WillByDefault(ReturnRef(local_address_));
   ON_CALL(*this, options()).WillByDefault(ReturnRef(options_));
@@ -186,6 +195,8 @@ MockSocketOption::~MockSocketOption() {}
 
 MockConnectionSocket::MockConnectionSocket() : local_address_(new Address::Ipv4Instance(80)) {
   ON_CALL(*this, localAddress()).WillByDefault(ReturnRef(local_address_));
+  ON_CALL(*this, requestedApplicationProtocols())
+      .WillByDefault(ReturnRef(application_protocols_));
 }
 
 MockConnectionSocket::~MockConnectionSocket() {}
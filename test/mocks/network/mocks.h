@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "envoy/api/v2/core/address.pb.h"
 #include "envoy/network/connection.h"
@@ -261,10 +262,30 @@ public:
   MockFilterChainFactory();
   ~MockFilterChainFactory();
 
-  MOCK_METHOD1(createNetworkFilterChain, bool(Connection& connection));
+  MOCK_METHOD2(createNetworkFilterChain,
+               bool(Connection& connection, const std::vector<FilterFactoryCb>& filter_factories));
   MOCK_METHOD1(createListenerFilterChain, bool(ListenerFilterManager& listener));
 };
 
+class MockFilterChain : public FilterChain {
+public:
+  MockFilterChain();
+  ~MockFilterChain();
+
+  MOCK_CONST_METHOD0(transportSocketFactory, const TransportSocketFactory&());
+  MOCK_CONST_METHOD0(networkFilterFactories, const std::vector<FilterFactoryCb>&());
+
+  std::vector<FilterFactoryCb> network_filter_factories_;
+};
+
+class MockFilterChainManager : public FilterChainManager {
+public:
+  MockFilterChainManager();
+  ~MockFilterChainManager();
+
+  MOCK_CONST_METHOD1(findFilterChain, const FilterChain*(const ConnectionSocket& socket));
+};
+
 class MockListenSocket : public Socket {
 public:
   MockListenSocket();
@@ -307,8 +328,13 @@ public:
   MOCK_CONST_METHOD0(options, const Network::ConnectionSocket::OptionsSharedPtr&());
   MOCK_CONST_METHOD0(fd, int());
   MOCK_METHOD0(close, void());
+  MOCK_METHOD1(setRequestedServerName, void(absl::string_view));
+  MOCK_CONST_METHOD0(requestedServerName, absl::string_view());
+  MOCK_METHOD1(setRequestedApplicationProtocols, void(const std::vector<std::string>&));
+  MOCK_CONST_METHOD0(requestedApplicationProtocols, const std::vector<std::string>&());
 
   Address::InstanceConstSharedPtr local_address_;
+  std::vector<std::string> application_protocols_;
 };
 
 class MockListenerConfig : public ListenerConfig {
@@ -318,15 +344,19 @@ public:
 
   MOCK_METHOD0(filterChainFactory, FilterChainFactory&());
   MOCK_METHOD0(socket, Socket&());
-  MOCK_METHOD0(transportSocketFactory, TransportSocketFactory&());
+  MOCK_METHOD0(filterChainManager, FilterChainManager&());
+  MOCK_METHOD0(connectionBalancer, ConnectionBalancer*());
   MOCK_METHOD0(bindToPort, bool());
   MOCK_CONST_METHOD0(handOffRestoredDestinationConnections, bool());
   MOCK_METHOD0(perConnectionBufferLimitBytes, uint32_t());
+  MOCK_CONST_METHOD0(listenerFiltersTimeout, std::chrono::milliseconds());
+  MOCK_CONST_METHOD0(continueOnListenerFiltersTimeout, bool());
   MOCK_METHOD0(listenerScope, Stats::Scope&());
   MOCK_CONST_METHOD0(listenerTag, uint64_t());
   MOCK_CONST_METHOD0(name, const std::string&());
 
   testing::NiceMock<MockFilterChainFactory> filter_chain_factory_;
+  testing::NiceMock<MockFilterChainManager> filter_chain_manager_;
   testing::NiceMock<MockListenSocket> socket_;
   Stats::IsolatedStoreImpl scope_;
   std::string name_;
@@ -338,6 +368,8 @@ public:
   ~MockListener();
 
   MOCK_METHOD0(onDestroy, void());
+  MOCK_METHOD0(disable, void());
+  MOCK_METHOD0(enable, void());
 };
 
 class MockConnectionHandler : public ConnectionHandler {
@@ -352,6 +384,9 @@ public:
   MOCK_METHOD1(removeListeners, void(uint64_t listener_tag));
   MOCK_METHOD1(stopListeners, void(uint64_t listener_tag));
   MOCK_METHOD0(stopListeners, void());
+  MOCK_METHOD0(disableListeners, void());
+  MOCK_METHOD0(enableListeners, void());
+  MOCK_METHOD1(setPerConnectionBufferLimitCap, void(uint32_t limit));
 };
 
 class MockResolvedAddress : public Address::Instance {
@@ -67,10 +67,12 @@ public:
   std::chrono::milliseconds perTryTimeout() const override { return per_try_timeout_; }
   uint32_t numRetries() const override { return num_retries_; }
   uint32_t retryOn() const override { return retry_on_; }
+  std::chrono::milliseconds hedgeDelay() const override { return hedge_delay_; }
 
   std::chrono::milliseconds per_try_timeout_{0};
   uint32_t num_retries_{};
   uint32_t retry_on_{};
+  std::chrono::milliseconds hedge_delay_{0};
 };
 
 class MockRetryState : public RetryState {
@@ -130,19 +132,32 @@ public:
   std::string runtime_key_;
 };
 
+class MockShadowStream : public ShadowStream {
+public:
+  MockShadowStream();
+  ~MockShadowStream();
+
+  // Router::ShadowStream
+  MOCK_METHOD2(sendData, void(const Buffer::Instance& data, bool end_stream));
+  MOCK_METHOD1(sendTrailers, void(const Http::HeaderMap& trailers));
+};
+
 class MockShadowWriter : public ShadowWriter {
 public:
   MockShadowWriter();
   ~MockShadowWriter();
 
   // Router::ShadowWriter
-  void shadow(const std::string& cluster, Http::MessagePtr&& request,
-              std::chrono::milliseconds timeout) override {
-    shadow_(cluster, request, timeout);
+  ShadowStreamPtr streamShadow(const std::string& cluster, const Http::HeaderMap& headers,
+                               bool end_stream, std::chrono::milliseconds timeout,
+                               uint32_t buffer_limit) override {
+    return ShadowStreamPtr{streamShadow_(cluster, headers, end_stream, timeout, buffer_limit)};
   }
 
-  MOCK_METHOD3(shadow_, void(const std::string& cluster, Http::MessagePtr& request,
-                             std::chrono::milliseconds timeout));
+  MOCK_METHOD5(streamShadow_,
+               ShadowStream*(const std::string& cluster, const Http::HeaderMap& headers,
+                             bool end_stream, std::chrono::milliseconds timeout,
+                             uint32_t buffer_limit));
 };
 
 class TestVirtualCluster : public VirtualCluster {
@@ -189,6 +204,7 @@ public:
   // Router::MetadataMatchCriteria
   MOCK_CONST_METHOD0(metadataMatchCriteria,
                      const std::vector<MetadataMatchCriterionConstSharedPtr>&());
+  MOCK_CONST_METHOD0(id, uint64_t());
 };
 
 class MockPathMatchCriterion : public PathMatchCriterion {
@@ -12,6 +12,7 @@
 #include "envoy/server/health_checker_config.h"
 #include "envoy/server/instance.h"
 #include "envoy/server/options.h"
+#include "envoy/server/overload_manager.h"
 #include "envoy/server/transport_socket_config.h"
 #include "envoy/server/worker.h"
 #include "envoy/ssl/context_manager.h"
@@ -150,6 +151,7 @@ public:
   MOCK_METHOD0(drainParentListeners, void());
   MOCK_METHOD1(duplicateParentListenSocket, int(const std::string& address));
   MOCK_METHOD1(getParentStats, void(GetParentStatsInfo& info));
+  MOCK_METHOD1(getParentClusterHosts, void(Upstream::ClusterHostsMap& cluster_hosts));
   MOCK_METHOD2(initialize, void(Event::Dispatcher& dispatcher, Server::Instance& server));
   MOCK_METHOD1(shutdownParentAdmin, void(ShutdownParentAdminInfo& info));
   MOCK_METHOD0(terminateParent, void());
@@ -212,7 +214,7 @@ public:
   ~MockWorkerFactory();
 
   // Server::WorkerFactory
-  WorkerPtr createWorker() override { return WorkerPtr{createWorker_()}; }
+  WorkerPtr createWorker(OverloadManager&) override { return WorkerPtr{createWorker_()}; }
 
   MOCK_METHOD0(createWorker_, Worker*());
 };
@@ -249,6 +251,31 @@ public:
   std::function<void()> remove_listener_completion_;
 };
 
+class MockThreadLocalOverloadState : public ThreadLocalOverloadState {
+public:
+  MockThreadLocalOverloadState();
+  ~MockThreadLocalOverloadState();
+
+  // Server::ThreadLocalOverloadState
+  MOCK_METHOD1(getState, const OverloadActionState&(const std::string& action));
+
+  OverloadActionState inactive_{OverloadActionState::Inactive};
+};
+
+class MockOverloadManager : public OverloadManager {
+public:
+  MockOverloadManager();
+  ~MockOverloadManager();
+
+  // Server::OverloadManager
+  MOCK_METHOD0(start, void());
+  MOCK_METHOD3(registerForAction, bool(const std::string& action, Event::Dispatcher& dispatcher,
+                                       OverloadActionCb callback));
+  MOCK_METHOD0(getThreadLocalOverloadState, ThreadLocalOverloadState&());
+
+  testing::NiceMock<MockThreadLocalOverloadState> overload_state_;
+};
+
 class MockInstance : public Instance {
 public:
   MockInstance();
@@ -275,6 +302,7 @@ public:
   MOCK_METHOD0(initManager, Init::Manager&());
   MOCK_METHOD0(listenerManager, ListenerManager&());
   MOCK_METHOD0(options, Options&());
+  MOCK_METHOD0(overloadManager, OverloadManager&());
   MOCK_METHOD0(random, Runtime::RandomGenerator&());
   MOCK_METHOD0(rateLimitClient_, RateLimit::Client*());
   MOCK_METHOD0(runtime, Runtime::Loader&());
@@ -308,6 +336,7 @@ public:
   testing::NiceMock<LocalInfo::MockLocalInfo> local_info_;
   testing::NiceMock<Init::MockManager> init_manager_;
   testing::NiceMock<MockListenerManager> listener_manager_;
+  testing::NiceMock<MockOverloadManager> overload_manager_;
   Singleton::ManagerPtr singleton_manager_;
 };
 
@@ -351,6 +380,7 @@ public:
   MOCK_METHOD0(httpTracer, Tracing::HttpTracer&());
   MOCK_METHOD0(initManager, Init::Manager&());
   MOCK_METHOD0(localInfo, const LocalInfo::LocalInfo&());
+  MOCK_METHOD0(overloadManager, OverloadManager&());
   MOCK_METHOD0(random, Envoy::Runtime::RandomGenerator&());
   MOCK_METHOD0(rateLimitClient_, RateLimit::Client*());
   MOCK_METHOD0(runtime, Envoy::Runtime::Loader&());
@@ -375,6 +405,7 @@ public:
   Singleton::ManagerPtr singleton_manager_;
   testing::NiceMock<MockAdmin> admin_;
   Stats::IsolatedStoreImpl listener_scope_;
+  testing::NiceMock<MockOverloadManager> overload_manager_;
 };
 
 class MockTransportSocketFactoryContext : public TransportSocketFactoryContext {
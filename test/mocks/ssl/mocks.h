@@ -24,21 +24,17 @@ public:
     return ClientContextPtr{createSslClientContext_(scope, config)};
   }
 
-  ServerContextPtr createSslServerContext(const std::string& listener_name,
-                                          const std::vector<std::string>& server_names,
-                                          Stats::Scope& scope, const ServerContextConfig& config,
-                                          bool skip_context_update) override {
-    return ServerContextPtr{
-        createSslServerContext_(listener_name, server_names, scope, config, skip_context_update)};
+  ServerContextPtr createSslServerContext(const std::vector<std::string>& server_names,
+                                          Stats::Scope& scope,
+                                          const ServerContextConfig& config) override {
+    return ServerContextPtr{createSslServerContext_(server_names, scope, config)};
   }
 
   MOCK_METHOD2(createSslClientContext_,
                ClientContext*(Stats::Scope& scope, const ClientContextConfig& config));
-  MOCK_METHOD5(createSslServerContext_,
-               ServerContext*(const std::string& listener_name,
-                              const std::vector<std::string>& server_names, Stats::Scope& stats,
-                              const ServerContextConfig& config, bool skip_context_update));
-  MOCK_CONST_METHOD2(findSslServerContext, ServerContext*(const std::string&, const std::string&));
+  MOCK_METHOD3(createSslServerContext_,
+               ServerContext*(const std::vector<std::string>& server_names, Stats::Scope& stats,
+                              const ServerContextConfig& config));
   MOCK_CONST_METHOD0(daysUntilFirstCertExpires, size_t());
   MOCK_METHOD1(iterateContexts, void(std::function<void(const Context&)> callback));
 };
@@ -45,7 +45,7 @@ TEST(ValidationClusterManagerTest, MockedMethods) {
   Http::AsyncClient& client = cluster_manager->httpAsyncClientForCluster("cluster");
   Http::MockAsyncClientStreamCallbacks stream_callbacks;
   EXPECT_EQ(nullptr,
-            client.start(stream_callbacks, absl::optional<std::chrono::milliseconds>(), false));
+            client.start(stream_callbacks, absl::optional<std::chrono::milliseconds>(), false, 0));
 }
 
 } // namespace Upstream
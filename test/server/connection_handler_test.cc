@@ -1,13 +1,15 @@
 #include "common/common/utility.h"
 #include "common/network/address_impl.h"
-#include "common/network/raw_buffer_socket.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/utility.h"
 #include "common/stats/stats_impl.h"
 
 #include "server/connection_handler_impl.h"
 
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
+#include "test/test_common/network_utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -25,7 +27,11 @@ namespace Server {
 
 class ConnectionHandlerTest : public testing::Test, protected Logger::Loggable<Logger::Id::main> {
 public:
-  ConnectionHandlerTest() : handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher_)) {}
+  ConnectionHandlerTest()
+      : handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher_)),
+        filter_chain_(Network::Test::createEmptyFilterChainWithRawBufferSockets()) {
+    ON_CALL(manager_, findFilterChain(_)).WillByDefault(Return(filter_chain_.get()));
+  }
 
   // Listener
   class TestListener : public Network::ListenerConfig, public LinkedObject<TestListener> {
@@ -36,27 +42,34 @@ public:
           hand_off_restored_destination_connections_(hand_off_restored_destination_connections),
           name_(name) {}
 
+    Network::FilterChainManager& filterChainManager() override { return parent_.manager_; }
     Network::FilterChainFactory& filterChainFactory() override { return parent_.factory_; }
     Network::Socket& socket() override { return socket_; }
-    Network::TransportSocketFactory& transportSocketFactory() override {
-      return transport_socket_factory_;
-    }
+    Network::ConnectionBalancer* connectionBalancer() override { return balancer_; }
     bool bindToPort() override { return bind_to_port_; }
     bool handOffRestoredDestinationConnections() const override {
       return hand_off_restored_destination_connections_;
     }
     uint32_t perConnectionBufferLimitBytes() override { return 0; }
+    std::chrono::milliseconds listenerFiltersTimeout() const override {
+      return listener_filters_timeout_;
+    }
+    bool continueOnListenerFiltersTimeout() const override {
+      return continue_on_listener_filters_timeout_;
+    }
     Stats::Scope& listenerScope() override { return parent_.stats_store_; }
     uint64_t listenerTag() const override { return tag_; }
     const std::string& name() const override { return name_; }
 
     ConnectionHandlerTest& parent_;
     Network::MockListenSocket socket_;
-    Network::RawBufferSocketFactory transport_socket_factory_;
     uint64_t tag_;
     bool bind_to_port_;
     const bool hand_off_restored_destination_connections_;
     const std::string name_;
+    Network::ConnectionBalancer* balancer_{};
+    std::chrono::milliseconds listener_filters_timeout_{};
+    bool continue_on_listener_filters_timeout_{};
   };
 
   typedef std::unique_ptr<TestListener> TestListenerPtr;
@@ -73,7 +86,9 @@ public:
   Stats::IsolatedStoreImpl stats_store_;
   NiceMock<Event::MockDispatcher> dispatcher_;
   Network::ConnectionHandlerPtr handler_;
+  NiceMock<Network::MockFilterChainManager> manager_;
   NiceMock<Network::MockFilterChainFactory> factory_;
+  const Network::FilterChainSharedPtr filter_chain_;
   std::list<TestListenerPtr> listeners_;
 };
 
@@ -94,7 +109,6 @@ TEST_F(ConnectionHandlerTest, RemoveListener) {
   handler_->addListener(*test_listener);
 
   Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
-  EXPECT_CALL(factory_, createNetworkFilterChain(_)).WillOnce(Return(true));
   listener_callbacks->onNewConnection(Network::ConnectionPtr{connection});
   EXPECT_EQ(1UL, handler_->numConnections());
 
@@ -132,7 +146,6 @@ TEST_F(ConnectionHandlerTest, DestroyCloseConnections) {
   handler_->addListener(*test_listener);
 
   Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
-  EXPECT_CALL(factory_, createNetworkFilterChain(_)).WillOnce(Return(true));
   listener_callbacks->onNewConnection(Network::ConnectionPtr{connection});
   EXPECT_EQ(1UL, handler_->numConnections());
 
@@ -142,6 +155,34 @@ TEST_F(ConnectionHandlerTest, DestroyCloseConnections) {
   handler_.reset();
 }
 
+TEST_F(ConnectionHandlerTest, DisableEnableListeners) {
+  Network::MockListener* listener1 = new NiceMock<Network::MockListener>();
+  Network::MockListener* listener2 = new NiceMock<Network::MockListener>();
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Return(listener1))
+      .WillOnce(Return(listener2));
+
+  TestListener* test_listener1 = addListener(1, true, false, "test_listener1");
+  EXPECT_CALL(test_listener1->socket_, localAddress());
+  handler_->addListener(*test_listener1);
+
+  EXPECT_CALL(*listener1, disable());
+  handler_->disableListeners();
+
+  // Listeners added while disabled start out disabled.
+  TestListener* test_listener2 = addListener(2, true, false, "test_listener2");
+  EXPECT_CALL(test_listener2->socket_, localAddress());
+  EXPECT_CALL(*listener2, disable());
+  handler_->addListener(*test_listener2);
+
+  EXPECT_CALL(*listener1, enable());
+  EXPECT_CALL(*listener2, enable());
+  handler_->enableListeners();
+
+  EXPECT_CALL(*listener1, onDestroy());
+  EXPECT_CALL(*listener2, onDestroy());
+}
+
 TEST_F(ConnectionHandlerTest, CloseDuringFilterChainCreate) {
   InSequence s;
 
@@ -158,11 +199,19 @@ TEST_F(ConnectionHandlerTest, CloseDuringFilterChainCreate) {
   EXPECT_CALL(test_listener->socket_, localAddress());
   handler_->addListener(*test_listener);
 
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
   Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
-  EXPECT_CALL(factory_, createNetworkFilterChain(_));
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _))
+      .WillOnce(Invoke([&](Network::Connection& new_connection,
+                           const std::vector<Network::FilterFactoryCb>&) -> bool {
+        new_connection.close(Network::ConnectionCloseType::NoFlush);
+        return true;
+      }));
   EXPECT_CALL(*connection, state()).WillOnce(Return(Network::Connection::State::Closed));
   EXPECT_CALL(*connection, addConnectionCallbacks(_)).Times(0);
-  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection});
+  Network::MockConnectionSocket* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
   EXPECT_EQ(0UL, handler_->numConnections());
 
   EXPECT_CALL(*listener, onDestroy());
@@ -184,15 +233,286 @@ TEST_F(ConnectionHandlerTest, CloseConnectionOnEmptyFilterChain) {
   EXPECT_CALL(test_listener->socket_, localAddress());
   handler_->addListener(*test_listener);
 
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
   Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
-  EXPECT_CALL(factory_, createNetworkFilterChain(_)).WillOnce(Return(false));
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(false));
   EXPECT_CALL(*connection, close(Network::ConnectionCloseType::NoFlush));
-  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection});
+  Network::MockConnectionSocket* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
+  EXPECT_EQ(0UL, handler_->numConnections());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
+TEST_F(ConnectionHandlerTest, NoFilterChainMatch) {
+  InSequence s;
+
+  Network::MockListener* listener = new Network::MockListener();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+
+          }));
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  Network::MockConnectionSocket* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(nullptr));
+  EXPECT_CALL(*accepted_socket, close());
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).Times(0);
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
   EXPECT_EQ(0UL, handler_->numConnections());
+  EXPECT_EQ(1UL, stats_store_.counter("no_filter_chain_match").value());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
+// A socket whose listener filters don't finish in time is closed and counted.
+TEST_F(ConnectionHandlerTest, ListenerFilterTimeout) {
+  InSequence s;
+
+  Network::MockListener* listener = new Network::MockListener();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  test_listener->listener_filters_timeout_ = std::chrono::milliseconds(15000);
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  Network::MockListenerFilter* test_filter = new Network::MockListenerFilter();
+  EXPECT_CALL(factory_, createListenerFilterChain(_))
+      .WillOnce(Invoke([&](Network::ListenerFilterManager& manager) -> bool {
+        manager.addAcceptFilter(Network::ListenerFilterPtr{test_filter});
+        return true;
+      }));
+  EXPECT_CALL(*test_filter, onAccept(_)).WillOnce(Return(Network::FilterStatus::StopIteration));
+  Event::MockTimer* timeout = new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*timeout, enableTimer(std::chrono::milliseconds(15000)));
+  Network::MockConnectionSocket* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
+  EXPECT_EQ(1UL, stats_store_.gauge("downstream_pre_cx_active").value());
+
+  EXPECT_CALL(*accepted_socket, close());
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).Times(0);
+  EXPECT_CALL(*timeout, disableTimer());
+  timeout->callback_();
+  EXPECT_EQ(0UL, handler_->numConnections());
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_pre_cx_timeout").value());
+  EXPECT_EQ(0UL, stats_store_.gauge("downstream_pre_cx_active").value());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
+// A socket whose listener filters don't finish in time can still be given a connection.
+TEST_F(ConnectionHandlerTest, ContinueOnListenerFilterTimeout) {
+  InSequence s;
+
+  Network::MockListener* listener = new Network::MockListener();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  test_listener->listener_filters_timeout_ = std::chrono::milliseconds(15000);
+  test_listener->continue_on_listener_filters_timeout_ = true;
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  Network::MockListenerFilter* test_filter = new Network::MockListenerFilter();
+  EXPECT_CALL(factory_, createListenerFilterChain(_))
+      .WillOnce(Invoke([&](Network::ListenerFilterManager& manager) -> bool {
+        manager.addAcceptFilter(Network::ListenerFilterPtr{test_filter});
+        return true;
+      }));
+  EXPECT_CALL(*test_filter, onAccept(_)).WillOnce(Return(Network::FilterStatus::StopIteration));
+  Event::MockTimer* timeout = new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*timeout, enableTimer(std::chrono::milliseconds(15000)));
+  Network::MockConnectionSocket* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
+
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
+  EXPECT_CALL(*timeout, disableTimer());
+  timeout->callback_();
+  EXPECT_EQ(1UL, handler_->numConnections());
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_pre_cx_timeout").value());
+  EXPECT_EQ(0UL, stats_store_.gauge("downstream_pre_cx_active").value());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
+// The timeout is disabled once the listener filters are done with the socket.
+TEST_F(ConnectionHandlerTest, ListenerFilterDoneBeforeTimeout) {
+  InSequence s;
+
+  Network::MockListener* listener = new Network::MockListener();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  test_listener->listener_filters_timeout_ = std::chrono::milliseconds(15000);
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  Network::MockListenerFilter* test_filter = new Network::MockListenerFilter();
+  Network::ListenerFilterCallbacks* filter_callbacks;
+  EXPECT_CALL(factory_, createListenerFilterChain(_))
+      .WillOnce(Invoke([&](Network::ListenerFilterManager& manager) -> bool {
+        manager.addAcceptFilter(Network::ListenerFilterPtr{test_filter});
+        return true;
+      }));
+  EXPECT_CALL(*test_filter, onAccept(_))
+      .WillOnce(Invoke([&](Network::ListenerFilterCallbacks& cb) -> Network::FilterStatus {
+        filter_callbacks = &cb;
+        return Network::FilterStatus::StopIteration;
+      }));
+  Event::MockTimer* timeout = new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*timeout, enableTimer(std::chrono::milliseconds(15000)));
+  Network::MockConnectionSocket* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
+
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
+  EXPECT_CALL(*timeout, disableTimer());
+  filter_callbacks->continueFilterChain(true);
+  EXPECT_EQ(1UL, handler_->numConnections());
+  EXPECT_EQ(0UL, stats_store_.counter("downstream_pre_cx_timeout").value());
+  EXPECT_EQ(0UL, stats_store_.gauge("downstream_pre_cx_active").value());
 
   EXPECT_CALL(*listener, onDestroy());
 }
 
+// With a connection balancer, each connection goes to the worker with the fewest connections of
+// the listener, preferring the worker that accepted it.
+TEST_F(ConnectionHandlerTest, BalanceConnections) {
+  Network::ExactConnectionBalancerImpl balancer;
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  test_listener->balancer_ = &balancer;
+  EXPECT_CALL(test_listener->socket_, localAddress()).Times(2);
+
+  NiceMock<Event::MockDispatcher> dispatcher0;
+  NiceMock<Event::MockDispatcher> dispatcher1;
+  ConnectionHandlerImpl handler0(ENVOY_LOGGER(), dispatcher0, "worker_0.");
+  ConnectionHandlerImpl handler1(ENVOY_LOGGER(), dispatcher1, "worker_1.");
+  Network::ListenerCallbacks* listener_callbacks0;
+  Network::ListenerCallbacks* listener_callbacks1;
+  EXPECT_CALL(dispatcher0, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks0 = &cb;
+            return new NiceMock<Network::MockListener>();
+          }));
+  EXPECT_CALL(dispatcher1, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks1 = &cb;
+            return new NiceMock<Network::MockListener>();
+          }));
+  handler0.addListener(*test_listener);
+  handler1.addListener(*test_listener);
+  ON_CALL(factory_, createNetworkFilterChain(_, _)).WillByDefault(Return(true));
+
+  // Both workers have no connections, so the first one stays on the accepting worker.
+  Network::MockConnection* connection0 = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher0, createServerConnection_(_, _)).WillOnce(Return(connection0));
+  listener_callbacks0->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, false);
+  EXPECT_EQ(1UL, handler0.numConnections());
+  EXPECT_EQ(1UL, stats_store_.gauge("worker_0.downstream_cx_balanced").value());
+
+  // The second one is handed to the other worker.
+  Network::MockConnection* connection1 = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher1, post(_));
+  EXPECT_CALL(dispatcher1, createServerConnection_(_, _)).WillOnce(Return(connection1));
+  listener_callbacks0->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, false);
+  EXPECT_EQ(1UL, handler0.numConnections());
+  EXPECT_EQ(1UL, handler1.numConnections());
+  EXPECT_EQ(1UL, stats_store_.counter("worker_0.downstream_cx_rebalanced_out").value());
+  EXPECT_EQ(1UL, stats_store_.counter("worker_1.downstream_cx_rebalanced_in").value());
+  EXPECT_EQ(1UL, stats_store_.gauge("worker_1.downstream_cx_balanced").value());
+
+  // Once a connection is closed, its worker gets the next one.
+  connection1->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_EQ(0UL, stats_store_.gauge("worker_1.downstream_cx_balanced").value());
+  Network::MockConnection* connection2 = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher1, post(_));
+  EXPECT_CALL(dispatcher1, createServerConnection_(_, _)).WillOnce(Return(connection2));
+  listener_callbacks0->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, false);
+  EXPECT_EQ(2UL, stats_store_.counter("worker_1.downstream_cx_rebalanced_in").value());
+
+  // Sockets that do not become connections are no longer counted.
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(nullptr));
+  EXPECT_CALL(dispatcher1, post(_)).Times(0);
+  listener_callbacks1->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, false);
+  EXPECT_EQ(1UL, stats_store_.gauge("worker_0.downstream_cx_balanced").value());
+  EXPECT_EQ(1UL, stats_store_.gauge("worker_1.downstream_cx_balanced").value());
+}
+
+// A socket handed to a worker that has removed the listener in the meantime is dropped.
+TEST_F(ConnectionHandlerTest, BalanceConnectionsToRemovedListener) {
+  Network::ExactConnectionBalancerImpl balancer;
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  test_listener->balancer_ = &balancer;
+  EXPECT_CALL(test_listener->socket_, localAddress()).Times(2);
+
+  NiceMock<Event::MockDispatcher> dispatcher0;
+  NiceMock<Event::MockDispatcher> dispatcher1;
+  ConnectionHandlerImpl handler0(ENVOY_LOGGER(), dispatcher0, "worker_0.");
+  ConnectionHandlerImpl handler1(ENVOY_LOGGER(), dispatcher1, "worker_1.");
+  Network::ListenerCallbacks* listener_callbacks0;
+  EXPECT_CALL(dispatcher0, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks0 = &cb;
+            return new NiceMock<Network::MockListener>();
+          }));
+  EXPECT_CALL(dispatcher1, createListener_(_, _, _, _))
+      .WillOnce(Return(new NiceMock<Network::MockListener>()));
+  handler0.addListener(*test_listener);
+  handler1.addListener(*test_listener);
+  ON_CALL(factory_, createNetworkFilterChain(_, _)).WillByDefault(Return(true));
+
+  EXPECT_CALL(dispatcher0, createServerConnection_(_, _))
+      .WillOnce(Return(new NiceMock<Network::MockConnection>()));
+  listener_callbacks0->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, false);
+
+  std::function<void()> post_cb;
+  EXPECT_CALL(dispatcher1, post(_)).WillOnce(testing::SaveArg<0>(&post_cb));
+  listener_callbacks0->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, false);
+
+  handler1.removeListeners(1);
+  EXPECT_CALL(dispatcher1, createServerConnection_(_, _)).Times(0);
+  post_cb();
+  EXPECT_EQ(0UL, handler1.numConnections());
+  EXPECT_EQ(0UL, stats_store_.counter("worker_1.downstream_cx_rebalanced_in").value());
+}
+
 TEST_F(ConnectionHandlerTest, FindListenerByAddress) {
   TestListener* test_listener1 = addListener(1, true, true, "test_listener1");
   Network::Address::InstanceConstSharedPtr alt_address(
@@ -293,7 +613,7 @@ TEST_F(ConnectionHandlerTest, NormalRedirect) {
   EXPECT_CALL(*accepted_socket, localAddressRestored()).WillOnce(Return(true));
   EXPECT_CALL(*accepted_socket, localAddress()).WillRepeatedly(ReturnRef(alt_address));
   Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
-  EXPECT_CALL(factory_, createNetworkFilterChain(_)).WillOnce(Return(true));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
   EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
   listener_callbacks1->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
   EXPECT_EQ(1UL, handler_->numConnections());
@@ -354,7 +674,7 @@ TEST_F(ConnectionHandlerTest, FallbackToWildcardListener) {
   EXPECT_CALL(*accepted_socket, localAddressRestored()).WillOnce(Return(true));
   EXPECT_CALL(*accepted_socket, localAddress()).WillRepeatedly(ReturnRef(alt_address));
   Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
-  EXPECT_CALL(factory_, createNetworkFilterChain(_)).WillOnce(Return(true));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
   EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
   listener_callbacks1->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
   EXPECT_EQ(1UL, handler_->numConnections());
@@ -400,7 +720,7 @@ TEST_F(ConnectionHandlerTest, WildcardListenerWithOriginalDst) {
   EXPECT_CALL(*accepted_socket, localAddressRestored()).WillOnce(Return(true));
   EXPECT_CALL(*accepted_socket, localAddress()).WillRepeatedly(ReturnRef(original_dst_address));
   Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
-  EXPECT_CALL(factory_, createNetworkFilterChain(_)).WillOnce(Return(true));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
   EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
   listener_callbacks1->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
   EXPECT_EQ(1UL, handler_->numConnections());
@@ -437,7 +757,7 @@ TEST_F(ConnectionHandlerTest, WildcardListenerWithNoOriginalDst) {
   EXPECT_CALL(*accepted_socket, localAddressRestored()).WillOnce(Return(false));
   EXPECT_CALL(*accepted_socket, localAddress()).WillRepeatedly(ReturnRef(normal_address));
   Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
-  EXPECT_CALL(factory_, createNetworkFilterChain(_)).WillOnce(Return(true));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
   EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
   listener_callbacks1->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
   EXPECT_EQ(1UL, handler_->numConnections());
@@ -10,6 +10,7 @@
 #include "server/guarddog_impl.h"
 
 #include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/stats/mocks.h"
 
@@ -263,6 +264,40 @@ TEST(WatchDogBasicTest, ThreadIdTest) {
   gd.stopWatching(watched_dog);
 }
 
+TEST(WatchDogBasicTest, TouchDelayTest) {
+  NiceMock<Stats::MockStore> stats;
+  NiceMock<Configuration::MockMain> config(100, 90, 1000, 500);
+  NiceMock<MockMonotonicTimeSource> time_source;
+  std::atomic<uint64_t> mock_time(0);
+  ON_CALL(time_source, currentTime()).WillByDefault(testing::Invoke([&mock_time]() {
+    return std::chrono::steady_clock::time_point(std::chrono::milliseconds(mock_time));
+  }));
+  GuardDogImpl gd(stats, config, time_source);
+  ASSERT_EQ(1, stats.histograms_.size());
+  Stats::MockHistogram& touch_delay = *stats.histograms_[0];
+  EXPECT_EQ("server.watchdog_touch_delay_ms", touch_delay.name());
+
+  // The dog is touched every 45ms, half of the 90ms loop interval.
+  auto watched_dog = gd.createWatchDog(0);
+  NiceMock<Event::MockDispatcher> dispatcher;
+  Event::MockTimer* timer = new Event::MockTimer(&dispatcher);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(45))).Times(3);
+  watched_dog->startWatchdog(dispatcher);
+
+  // A timer firing on time is not delayed.
+  mock_time += 45;
+  EXPECT_CALL(touch_delay, recordValue(0));
+  timer->callback_();
+  EXPECT_EQ(std::chrono::milliseconds(45), watched_dog->lastTouchTime().time_since_epoch());
+
+  // A busy thread runs the timer late.
+  mock_time += 245;
+  EXPECT_CALL(touch_delay, recordValue(200));
+  timer->callback_();
+  EXPECT_EQ(std::chrono::milliseconds(290), watched_dog->lastTouchTime().time_since_epoch());
+  gd.stopWatching(watched_dog);
+}
+
 // If this test fails it is because the std::chrono::steady_clock::duration type has become
 // nontrivial or we are compiling under a compiler and library combo that makes
 // std::chrono::steady_clock::duration require a lock to be atomicly modified.
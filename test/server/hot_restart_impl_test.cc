@@ -1,3 +1,10 @@
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
 #include "common/api/os_sys_calls_impl.h"
 #include "common/stats/stats_impl.h"
 
@@ -12,7 +19,6 @@
 #include "gtest/gtest.h"
 
 using testing::Invoke;
-using testing::InvokeWithoutArgs;
 using testing::Return;
 using testing::WithArg;
 using testing::_;
@@ -22,18 +28,37 @@ namespace Server {
 
 class HotRestartImplTest : public testing::Test {
 public:
-  void setup() {
-    EXPECT_CALL(os_sys_calls_, shmUnlink(_));
-    EXPECT_CALL(os_sys_calls_, shmOpen(_, _, _));
-    EXPECT_CALL(os_sys_calls_, ftruncate(_, _)).WillOnce(WithArg<1>(Invoke([this](off_t size) {
-      buffer_.resize(size);
-      return 0;
-    })));
-    EXPECT_CALL(os_sys_calls_, mmap(_, _, _, _, _, _)).WillOnce(InvokeWithoutArgs([this]() {
-      return buffer_.data();
-    }));
-    EXPECT_CALL(os_sys_calls_, bind(_, _, _));
+  HotRestartImplTest() {
+    // Each shared memory region is backed by a buffer that outlives the HotRestartImpl which
+    // created it, so that a HotRestartImpl for the next restart epoch can attach to it.
+    EXPECT_CALL(os_sys_calls_, shmUnlink(_))
+        .WillRepeatedly(WithArg<0>(Invoke([this](const char* name) -> int {
+          unlinked_names_.push_back(name);
+          return 0;
+        })));
+    EXPECT_CALL(os_sys_calls_, shmOpen(_, _, _))
+        .WillRepeatedly(WithArg<0>(Invoke([this](const char* name) -> int {
+          if (fail_shm_open_ && absl::StrContains(name, "segment")) {
+            return -1;
+          }
+          shm_names_.push_back(name);
+          return shm_names_.size() - 1;
+        })));
+    EXPECT_CALL(os_sys_calls_, ftruncate(_, _))
+        .WillRepeatedly(Invoke([this](int fd, off_t size) -> int {
+          shared_memory_[shm_names_[fd]].assign(size / sizeof(uint64_t) + 1, 0);
+          return 0;
+        }));
+    EXPECT_CALL(os_sys_calls_, mmap(_, _, _, _, _, _))
+        .WillRepeatedly(WithArg<4>(Invoke([this](int fd) -> void* {
+          std::vector<uint64_t>& memory = shared_memory_[shm_names_[fd]];
+          return memory.empty() ? MAP_FAILED : memory.data();
+        })));
+    EXPECT_CALL(os_sys_calls_, close(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(os_sys_calls_, bind(_, _, _)).WillRepeatedly(Return(0));
+  }
 
+  void setup() {
     Stats::RawStatData::configureForTestsOnly(options_);
 
     // Test we match the correct stat with empty-slots before, after, or both.
@@ -51,7 +76,10 @@ public:
   Api::MockOsSysCalls os_sys_calls_;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls{&os_sys_calls_};
   NiceMock<MockOptions> options_;
-  std::vector<uint8_t> buffer_;
+  std::vector<std::string> shm_names_;
+  std::vector<std::string> unlinked_names_;
+  std::map<std::string, std::vector<uint64_t>> shared_memory_;
+  bool fail_shm_open_{};
   std::unique_ptr<HotRestartImpl> hot_restart_;
 };
 
@@ -80,7 +108,8 @@ TEST_F(HotRestartImplTest, versionString) {
   {
     ON_CALL(options_, maxStats()).WillByDefault(Return(2 * max_stats));
     setup();
-    EXPECT_NE(version, hot_restart_->version()) << "Version changes when options change";
+    EXPECT_EQ(version, hot_restart_->version()) << "Version doesn't depend on the stats options";
+    EXPECT_EQ(version, HotRestartImpl::hotRestartVersion());
     // TearDown is called automatically at end of test.
   }
 }
@@ -99,9 +128,6 @@ TEST_F(HotRestartImplTest, crossAlloc) {
   stat4 = nullptr;
 
   EXPECT_CALL(options_, restartEpoch()).WillRepeatedly(Return(1));
-  EXPECT_CALL(os_sys_calls_, shmOpen(_, _, _));
-  EXPECT_CALL(os_sys_calls_, mmap(_, _, _, _, _, _)).WillOnce(Return(buffer_.data()));
-  EXPECT_CALL(os_sys_calls_, bind(_, _, _));
   HotRestartImpl hot_restart2(options_);
   Stats::RawStatData* stat1_prime = hot_restart2.alloc("stat1");
   Stats::RawStatData* stat3_prime = hot_restart2.alloc("stat3");
@@ -121,7 +147,8 @@ TEST_F(HotRestartImplTest, truncateKey) {
   EXPECT_EQ(stat1, stat2);
 }
 
-TEST_F(HotRestartImplTest, allocFail) {
+// max_stats only sizes the hash table, it doesn't limit the number of stats.
+TEST_F(HotRestartImplTest, allocBeyondMaxStats) {
   EXPECT_CALL(options_, maxStats()).WillRepeatedly(Return(2));
   setup();
 
@@ -130,7 +157,54 @@ TEST_F(HotRestartImplTest, allocFail) {
   Stats::RawStatData* s3 = hot_restart_->alloc("3");
   EXPECT_NE(s1, nullptr);
   EXPECT_NE(s2, nullptr);
-  EXPECT_EQ(s3, nullptr);
+  EXPECT_NE(s3, nullptr);
+  EXPECT_NE(s1, s3);
+  EXPECT_NE(s2, s3);
+}
+
+// The child process sees stats in shared memory regions added after it attached.
+TEST_F(HotRestartImplTest, crossAllocNewRegions) {
+  setup();
+  Stats::RawStatData* s1 = hot_restart_->alloc("1");
+
+  EXPECT_CALL(options_, restartEpoch()).WillRepeatedly(Return(1));
+  HotRestartImpl hot_restart2(options_);
+
+  const std::string second_segment =
+      fmt::format("/envoy_shared_memory_{}_stats_segment_1", options_.baseId());
+  std::vector<Stats::RawStatData*> stats;
+  while (shared_memory_.find(second_segment) == shared_memory_.end()) {
+    stats.push_back(hot_restart_->alloc(fmt::format("stat.{}", stats.size())));
+    ASSERT_NE(stats.back(), nullptr);
+  }
+  EXPECT_EQ(s1, hot_restart2.alloc("1"));
+  EXPECT_EQ(stats.back(), hot_restart2.alloc(fmt::format("stat.{}", stats.size() - 1)));
+}
+
+// The first envoy removes every stats segment an earlier envoy may have left behind, while the
+// child of a hot restart keeps the segments of its parent.
+TEST_F(HotRestartImplTest, unlinkStaleSegments) {
+  setup();
+  const std::string last_segment = fmt::format("/envoy_shared_memory_{}_stats_segment_{}",
+                                               options_.baseId(),
+                                               HotRestartImpl::MAX_STATS_SEGMENTS - 1);
+  EXPECT_NE(std::find(unlinked_names_.begin(), unlinked_names_.end(), last_segment),
+            unlinked_names_.end());
+
+  unlinked_names_.clear();
+  EXPECT_CALL(options_, restartEpoch()).WillRepeatedly(Return(1));
+  HotRestartImpl hot_restart2(options_);
+  for (const std::string& name : unlinked_names_) {
+    EXPECT_FALSE(absl::StrContains(name, "segment")) << name;
+  }
+}
+
+// Stats are allocated on the heap instead if shared memory can't be added.
+TEST_F(HotRestartImplTest, allocFail) {
+  setup();
+
+  fail_shm_open_ = true;
+  EXPECT_EQ(nullptr, hot_restart_->alloc("1"));
 }
 
 // Because the shared memory is managed manually, make sure it meets
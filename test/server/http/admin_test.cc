@@ -131,8 +131,48 @@ TEST_P(AdminInstanceTest, AdminProfiler) {
   EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
 }
 
+TEST_P(AdminInstanceTest, AdminHeapProfiler) {
+  Buffer::OwnedImpl data;
+  Http::HeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, postCallback("/heapprofiler?enable=y", header_map, data));
+  EXPECT_TRUE(Profiler::Heap::profilerEnabled());
+  EXPECT_EQ(Http::Code::OK, postCallback("/heapprofiler?enable=n", header_map, data));
+  EXPECT_FALSE(Profiler::Heap::profilerEnabled());
+}
+
 #endif
 
+TEST_P(AdminInstanceTest, AdminHeapProfilerBadParams) {
+  Buffer::OwnedImpl data;
+  Http::HeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/heapprofiler", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/heapprofiler?enable=x", header_map, data));
+  EXPECT_FALSE(Profiler::Heap::profilerEnabled());
+}
+
+TEST_P(AdminInstanceTest, Memory) {
+  Http::HeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  auto live_buffer = std::make_unique<Buffer::OwnedImpl>();
+  EXPECT_EQ(Http::Code::OK, getCallback("/memory", header_map, response));
+  EXPECT_EQ("application/json", std::string(header_map.ContentType()->value().c_str()));
+
+  Json::ObjectSharedPtr json = Json::Factory::loadFromString(TestUtility::bufferToString(response));
+  EXPECT_FALSE(json->getBoolean("heap_profiler_enabled"));
+  Json::ObjectSharedPtr tagged = json->getObject("tagged");
+  for (const std::string& name :
+       {"buffer", "connection", "conn_pool", "header_map", "http_codec", "stats", "stream"}) {
+    Json::ObjectSharedPtr tag = tagged->getObject(name);
+    EXPECT_TRUE(tag->hasObject("allocated_bytes"));
+    EXPECT_TRUE(tag->hasObject("allocations"));
+    EXPECT_TRUE(tag->hasObject("pooled_bytes"));
+    EXPECT_TRUE(tag->hasObject("pooled_blocks"));
+    EXPECT_TRUE(tag->hasObject("reused_allocations"));
+  }
+  // At least the heap allocated buffer above is live.
+  EXPECT_LE(1, tagged->getObject("buffer")->getInteger("allocations"));
+}
+
 TEST_P(AdminInstanceTest, MutatesWarnWithGet) {
   Buffer::OwnedImpl data;
   Http::HeaderMapImpl header_map;
@@ -4,6 +4,7 @@
 #include "common/api/os_sys_calls_impl.h"
 #include "common/config/metadata.h"
 #include "common/network/address_impl.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/socket_option_impl.h"
 #include "common/network/utility.h"
@@ -167,6 +168,67 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, SetListenerPerConnectionBufferLim
   EXPECT_EQ(8192U, manager_->listeners().back().get().perConnectionBufferLimitBytes());
 }
 
+TEST_F(ListenerManagerImplWithRealFiltersTest, NoConnectionBalancerByDefault) {
+  const std::string yaml = R"EOF(
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    filter_chains:
+    - filters: []
+  )EOF";
+
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, true));
+  manager_->addOrUpdateListener(parseListenerFromV2Yaml(yaml), true);
+  EXPECT_EQ(nullptr, manager_->listeners().back().get().connectionBalancer());
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, ExactConnectionBalancer) {
+  const std::string yaml = R"EOF(
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    filter_chains:
+    - filters: []
+    connection_balance_config:
+      exact_balance: {}
+  )EOF";
+
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, true));
+  manager_->addOrUpdateListener(parseListenerFromV2Yaml(yaml), true);
+  EXPECT_NE(nullptr, dynamic_cast<Network::ExactConnectionBalancerImpl*>(
+                         manager_->listeners().back().get().connectionBalancer()));
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, DefaultListenerFiltersTimeout) {
+  const std::string yaml = R"EOF(
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    filter_chains:
+    - filters: []
+  )EOF";
+
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, true));
+  manager_->addOrUpdateListener(parseListenerFromV2Yaml(yaml), true);
+  EXPECT_EQ(std::chrono::milliseconds(15000),
+            manager_->listeners().back().get().listenerFiltersTimeout());
+  EXPECT_FALSE(manager_->listeners().back().get().continueOnListenerFiltersTimeout());
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, SetListenerFiltersTimeout) {
+  const std::string yaml = R"EOF(
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    filter_chains:
+    - filters: []
+    listener_filters_timeout: 0.5s
+    continue_on_listener_filters_timeout: true
+  )EOF";
+
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, true));
+  manager_->addOrUpdateListener(parseListenerFromV2Yaml(yaml), true);
+  EXPECT_EQ(std::chrono::milliseconds(500),
+            manager_->listeners().back().get().listenerFiltersTimeout());
+  EXPECT_TRUE(manager_->listeners().back().get().continueOnListenerFiltersTimeout());
+}
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, SslContext) {
   const std::string json = TestEnvironment::substitute(R"EOF(
   {
@@ -186,8 +248,11 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, SslContext) {
 
   EXPECT_CALL(listener_factory_, createListenSocket(_, _, true));
   manager_->addOrUpdateListener(parseListenerFromJson(json), true);
-  EXPECT_TRUE(
-      manager_->listeners().back().get().transportSocketFactory().implementsSecureTransport());
+  NiceMock<Network::MockConnectionSocket> socket;
+  const Network::FilterChain* filter_chain =
+      manager_->listeners().back().get().filterChainManager().findFilterChain(socket);
+  ASSERT_NE(nullptr, filter_chain);
+  EXPECT_TRUE(filter_chain->transportSocketFactory().implementsSecureTransport());
 }
 
 TEST_F(ListenerManagerImplWithRealFiltersTest, BadListenerConfig) {
@@ -1059,10 +1124,208 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, SniWithTwoDifferentFilterChains)
   )EOF",
                                                        Network::Address::IpVersion::v4);
 
+  EXPECT_CALL(server_.random_, uuid());
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, true));
+  manager_->addOrUpdateListener(parseListenerFromV2Yaml(yaml), true);
+  EXPECT_EQ(1U, manager_->listeners().size());
+}
+
+/**
+ * Tests filter chain matching, with the network filter factories of each filter chain standing in
+ * for the filter chain: the n-th filter chain of a listener has n of them.
+ */
+class ListenerManagerImplFilterChainMatchTest : public ListenerManagerImplWithRealFiltersTest {
+public:
+  ListenerManagerImplFilterChainMatchTest() {
+    ON_CALL(listener_factory_, createNetworkFilterFactoryList(_, _))
+        .WillByDefault(
+            Invoke([this](const Protobuf::RepeatedPtrField<envoy::api::v2::listener::Filter>&,
+                          Configuration::FactoryContext&)
+                       -> std::vector<Configuration::NetworkFilterFactoryCb> {
+              return std::vector<Configuration::NetworkFilterFactoryCb>(
+                  ++num_filter_chains_, [](Network::FilterManager&) -> void {});
+            }));
+  }
+
+  void addListener(const std::string& yaml) {
+    manager_->addOrUpdateListener(parseListenerFromV2Yaml(yaml), true);
+    EXPECT_EQ(1U, manager_->listeners().size());
+  }
+
+  /**
+   * @return the index, starting from 1, of the filter chain a connection is matched to, or 0 if
+   *         it matches none.
+   */
+  uint64_t findFilterChain(const std::string& destination_address, uint32_t destination_port,
+                           const std::string& server_name,
+                           const std::vector<std::string>& application_protocols) {
+    const Network::Address::InstanceConstSharedPtr local_address =
+        Network::Utility::parseInternetAddress(destination_address, destination_port);
+    NiceMock<Network::MockConnectionSocket> socket;
+    ON_CALL(socket, localAddress()).WillByDefault(ReturnRef(local_address));
+    ON_CALL(socket, requestedServerName()).WillByDefault(Return(absl::string_view(server_name)));
+    ON_CALL(socket, requestedApplicationProtocols())
+        .WillByDefault(ReturnRef(application_protocols));
+    const Network::FilterChain* filter_chain =
+        manager_->listeners().back().get().filterChainManager().findFilterChain(socket);
+    return filter_chain != nullptr ? filter_chain->networkFilterFactories().size() : 0;
+  }
+
+  uint64_t num_filter_chains_{};
+};
+
+TEST_F(ListenerManagerImplFilterChainMatchTest, SingleFilterChain) {
+  addListener(R"EOF(
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    filter_chains:
+    - filter_chain_match: {}
+  )EOF");
+
+  EXPECT_EQ(1, findFilterChain("127.0.0.1", 1234, "", {}));
+  EXPECT_EQ(1, findFilterChain("10.0.0.1", 80, "www.example.com", {"h2"}));
+}
+
+TEST_F(ListenerManagerImplFilterChainMatchTest, DestinationPort) {
+  addListener(R"EOF(
+    address:
+      socket_address: { address: 0.0.0.0, port_value: 1234 }
+    filter_chains:
+    - filter_chain_match:
+        destination_port: 8080
+    - filter_chain_match: {}
+  )EOF");
+
+  EXPECT_EQ(1, findFilterChain("127.0.0.1", 8080, "", {}));
+  EXPECT_EQ(2, findFilterChain("127.0.0.1", 8081, "", {}));
+  EXPECT_EQ(2, findFilterChain("127.0.0.1", 1234, "", {}));
+}
+
+TEST_F(ListenerManagerImplFilterChainMatchTest, DestinationPortWithoutCatchAll) {
+  addListener(R"EOF(
+    address:
+      socket_address: { address: 0.0.0.0, port_value: 1234 }
+    filter_chains:
+    - filter_chain_match:
+        destination_port: 8080
+  )EOF");
+
+  EXPECT_EQ(1, findFilterChain("127.0.0.1", 8080, "", {}));
+  EXPECT_EQ(0, findFilterChain("127.0.0.1", 8081, "", {}));
+}
+
+TEST_F(ListenerManagerImplFilterChainMatchTest, DestinationIp) {
+  addListener(R"EOF(
+    address:
+      socket_address: { address: 0.0.0.0, port_value: 1234 }
+    filter_chains:
+    - filter_chain_match:
+        prefix_ranges: { address_prefix: 10.0.0.0, prefix_len: 8 }
+    - filter_chain_match:
+        prefix_ranges:
+        - { address_prefix: 10.1.0.0, prefix_len: 16 }
+        - { address_prefix: "2001:db8::", prefix_len: 32 }
+    - filter_chain_match: {}
+  )EOF");
+
+  // The longest matching prefix wins.
+  EXPECT_EQ(1, findFilterChain("10.2.0.1", 1234, "", {}));
+  EXPECT_EQ(2, findFilterChain("10.1.2.3", 1234, "", {}));
+  EXPECT_EQ(2, findFilterChain("2001:db8::1", 1234, "", {}));
+  EXPECT_EQ(3, findFilterChain("192.168.0.1", 1234, "", {}));
+  EXPECT_EQ(3, findFilterChain("::1", 1234, "", {}));
+}
+
+TEST_F(ListenerManagerImplFilterChainMatchTest, ServerName) {
+  addListener(R"EOF(
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    filter_chains:
+    - filter_chain_match:
+        sni_domains: "example.com"
+    - filter_chain_match:
+        sni_domains: "*.example.com"
+    - filter_chain_match:
+        sni_domains: "*.com"
+    - filter_chain_match: {}
+  )EOF");
+
+  EXPECT_EQ(1, findFilterChain("127.0.0.1", 1234, "example.com", {}));
+  EXPECT_EQ(2, findFilterChain("127.0.0.1", 1234, "www.example.com", {}));
+  EXPECT_EQ(3, findFilterChain("127.0.0.1", 1234, "example2.com", {}));
+  // Wildcards only cover a single label.
+  EXPECT_EQ(4, findFilterChain("127.0.0.1", 1234, "a.b.example.com", {}));
+  EXPECT_EQ(4, findFilterChain("127.0.0.1", 1234, "example.net.com", {}));
+  EXPECT_EQ(4, findFilterChain("127.0.0.1", 1234, ".example.com", {}));
+  EXPECT_EQ(4, findFilterChain("127.0.0.1", 1234, "example.org", {}));
+  EXPECT_EQ(4, findFilterChain("127.0.0.1", 1234, "", {}));
+
+  // The TLS inspector is added to find out the server name of connections.
+  Network::MockListenerFilterManager filter_manager;
+  EXPECT_CALL(filter_manager, addAcceptFilter_(_));
+  Network::FilterChainFactory& filter_chain_factory =
+      manager_->listeners().back().get().filterChainFactory();
+  EXPECT_TRUE(filter_chain_factory.createListenerFilterChain(filter_manager));
+}
+
+TEST_F(ListenerManagerImplFilterChainMatchTest, ApplicationProtocols) {
+  addListener(R"EOF(
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    filter_chains:
+    - filter_chain_match:
+        application_protocols: "h2"
+    - filter_chain_match:
+        application_protocols: ["http/1.1", "http/1.0"]
+    - filter_chain_match: {}
+  )EOF");
+
+  // The client's most preferred protocol matching any filter chain wins.
+  EXPECT_EQ(1, findFilterChain("127.0.0.1", 1234, "", {"h2", "http/1.1"}));
+  EXPECT_EQ(2, findFilterChain("127.0.0.1", 1234, "", {"http/1.1", "h2"}));
+  EXPECT_EQ(2, findFilterChain("127.0.0.1", 1234, "", {"spdy/3", "http/1.0"}));
+  EXPECT_EQ(3, findFilterChain("127.0.0.1", 1234, "", {"spdy/3"}));
+  EXPECT_EQ(3, findFilterChain("127.0.0.1", 1234, "", {}));
+}
+
+// Less specific filter chains are only used when no more specific one matches the criteria being
+// matched, even if a more specific one doesn't match later criteria.
+TEST_F(ListenerManagerImplFilterChainMatchTest, MostSpecificCriteriaFirst) {
+  addListener(R"EOF(
+    address:
+      socket_address: { address: 0.0.0.0, port_value: 1234 }
+    filter_chains:
+    - filter_chain_match:
+        destination_port: 1234
+        sni_domains: "example.com"
+    - filter_chain_match:
+        prefix_ranges: { address_prefix: 10.0.0.0, prefix_len: 8 }
+        application_protocols: "h2"
+    - filter_chain_match: {}
+  )EOF");
+
+  EXPECT_EQ(1, findFilterChain("127.0.0.1", 1234, "example.com", {}));
+  EXPECT_EQ(0, findFilterChain("127.0.0.1", 1234, "example.org", {}));
+  EXPECT_EQ(2, findFilterChain("10.0.0.1", 443, "example.com", {"h2"}));
+  EXPECT_EQ(0, findFilterChain("10.0.0.1", 443, "example.com", {"http/1.1"}));
+  EXPECT_EQ(3, findFilterChain("127.0.0.1", 443, "example.com", {"h2"}));
+}
+
+TEST_F(ListenerManagerImplFilterChainMatchTest, DuplicateMatch) {
+  const std::string yaml = R"EOF(
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    filter_chains:
+    - filter_chain_match:
+        sni_domains: ["example.com", "www.example.com"]
+    - filter_chain_match:
+        sni_domains: "www.example.com"
+  )EOF";
+
   EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(yaml), true),
                             EnvoyException,
-                            "error adding listener '127.0.0.1:1234': use of different filter "
-                            "chains is currently not supported");
+                            "error adding listener '127.0.0.1:1234': multiple filter chains with "
+                            "the same matching rules are defined");
 }
 
 TEST_F(ListenerManagerImplWithRealFiltersTest, TlsCertificateInline) {
@@ -26,9 +26,8 @@ std::unique_ptr<OptionsImpl> createOptionsImpl(const std::string& args) {
   for (const std::string& s : words) {
     argv.push_back(s.c_str());
   }
-  return std::unique_ptr<OptionsImpl>(new OptionsImpl(argv.size(), const_cast<char**>(&argv[0]),
-                                                      [](uint64_t, uint64_t, bool) { return "1"; },
-                                                      spdlog::level::warn));
+  return std::unique_ptr<OptionsImpl>(new OptionsImpl(
+      argv.size(), const_cast<char**>(&argv[0]), [](bool) { return "1"; }, spdlog::level::warn));
 }
 
 TEST(OptionsImplTest, HotRestartVersion) {
@@ -0,0 +1,206 @@
+#include "envoy/config/overload/v2alpha/overload.pb.h"
+
+#include "common/protobuf/utility.h"
+#include "common/stats/stats_impl.h"
+
+#include "server/overload_manager_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::_;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+class FakeResourceMonitor : public ResourceMonitor {
+public:
+  FakeResourceMonitor(double& pressure, bool& fail) : pressure_(pressure), fail_(fail) {}
+
+  // Server::ResourceMonitor
+  double pressure() override {
+    if (fail_) {
+      throw EnvoyException("failed to sample");
+    }
+    return pressure_;
+  }
+
+private:
+  double& pressure_;
+  bool& fail_;
+};
+
+class OverloadManagerImplTest : public testing::Test {
+public:
+  std::unique_ptr<OverloadManagerImpl> createOverloadManager(const std::string& yaml) {
+    envoy::config::overload::v2alpha::OverloadManager config;
+    MessageUtil::loadFromYaml(yaml, config);
+    return std::make_unique<OverloadManagerImpl>(
+        dispatcher_, stats_, thread_local_, config,
+        [this](const envoy::config::overload::v2alpha::ResourceMonitor& monitor_config) {
+          double& pressure = monitor_config.name() == "heap" ? heap_pressure_ : fd_pressure_;
+          return ResourceMonitorPtr{new FakeResourceMonitor(pressure, fail_updates_)};
+        });
+  }
+
+  const std::string config_ = R"EOF(
+    refresh_interval:
+      seconds: 1
+    resource_monitors:
+      - name: heap
+        resource: HEAP
+        max: 1000
+      - name: fds
+        resource: FILE_DESCRIPTORS
+    actions:
+      - name: envoy.overload_actions.stop_accepting_requests
+        triggers:
+          - name: heap
+            threshold:
+              value: 0.9
+          - name: fds
+            threshold:
+              value: 0.95
+      - name: envoy.overload_actions.disable_http_keepalive
+        triggers:
+          - name: heap
+            threshold:
+              value: 0.8
+  )EOF";
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Event::MockTimer* timer_{};
+  NiceMock<ThreadLocal::MockInstance> thread_local_;
+  Stats::IsolatedStoreImpl stats_;
+  double heap_pressure_{};
+  double fd_pressure_{};
+  bool fail_updates_{};
+};
+
+TEST_F(OverloadManagerImplTest, CallbacksAndThreadLocalState) {
+  auto manager = createOverloadManager(config_);
+
+  std::vector<OverloadActionState> states;
+  EXPECT_TRUE(manager->registerForAction(
+      OverloadActionNames::get().StopAcceptingRequests, dispatcher_,
+      [&states](OverloadActionState state) -> void { states.push_back(state); }));
+  EXPECT_FALSE(manager->registerForAction(OverloadActionNames::get().StopAcceptingConnections,
+                                          dispatcher_, [](OverloadActionState) -> void {}));
+
+  timer_ = new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(1000))).Times(testing::AtLeast(1));
+  manager->start();
+
+  const OverloadActionState& stop_accepting_requests =
+      manager->getThreadLocalOverloadState().getState(
+          OverloadActionNames::get().StopAcceptingRequests);
+  const OverloadActionState& disable_keepalive =
+      manager->getThreadLocalOverloadState().getState(
+          OverloadActionNames::get().DisableHttpKeepAlive);
+  EXPECT_EQ(OverloadActionState::Inactive, stop_accepting_requests);
+  EXPECT_EQ(OverloadActionState::Inactive,
+            manager->getThreadLocalOverloadState().getState("envoy.overload_actions.unknown"));
+
+  // Callbacks are posted to the registered dispatcher.
+  EXPECT_CALL(dispatcher_, post(_)).WillRepeatedly(Invoke([](Event::PostCb cb) -> void { cb(); }));
+
+  // Only the lower threshold fires.
+  heap_pressure_ = 0.85;
+  timer_->callback_();
+  EXPECT_EQ(OverloadActionState::Active, disable_keepalive);
+  EXPECT_EQ(OverloadActionState::Inactive, stop_accepting_requests);
+  EXPECT_TRUE(states.empty());
+  EXPECT_EQ(85U, stats_.gauge("overload.heap.pressure").value());
+  EXPECT_EQ(1U, stats_.gauge("overload.envoy.overload_actions.disable_http_keepalive.active")
+                    .value());
+
+  heap_pressure_ = 0.95;
+  timer_->callback_();
+  EXPECT_EQ(OverloadActionState::Active, stop_accepting_requests);
+  EXPECT_EQ(std::vector<OverloadActionState>{OverloadActionState::Active}, states);
+
+  // A second trigger firing does not change the state of an active action.
+  fd_pressure_ = 0.99;
+  timer_->callback_();
+  EXPECT_EQ(1U, states.size());
+
+  // The action stays active until all of its triggers stop firing.
+  heap_pressure_ = 0.5;
+  timer_->callback_();
+  EXPECT_EQ(OverloadActionState::Active, stop_accepting_requests);
+  EXPECT_EQ(OverloadActionState::Inactive, disable_keepalive);
+
+  fd_pressure_ = 0.5;
+  timer_->callback_();
+  EXPECT_EQ(OverloadActionState::Inactive, stop_accepting_requests);
+  EXPECT_EQ(2U, states.size());
+  EXPECT_EQ(OverloadActionState::Inactive, states.back());
+  EXPECT_EQ(0U, stats_.gauge("overload.envoy.overload_actions.stop_accepting_requests.active")
+                    .value());
+}
+
+TEST_F(OverloadManagerImplTest, FailedUpdates) {
+  auto manager = createOverloadManager(config_);
+  timer_ = new NiceMock<Event::MockTimer>(&dispatcher_);
+  manager->start();
+
+  fail_updates_ = true;
+  timer_->callback_();
+  EXPECT_EQ(1U, stats_.counter("overload.heap.failed_updates").value());
+  EXPECT_EQ(1U, stats_.counter("overload.fds.failed_updates").value());
+}
+
+TEST_F(OverloadManagerImplTest, DuplicateResourceMonitor) {
+  const std::string config = R"EOF(
+    resource_monitors:
+      - name: heap
+        resource: HEAP
+        max: 1000
+      - name: heap
+        resource: HEAP
+        max: 1000
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(createOverloadManager(config), EnvoyException,
+                            "Duplicate resource monitor heap");
+}
+
+TEST_F(OverloadManagerImplTest, UnknownTriggerResource) {
+  const std::string config = R"EOF(
+    resource_monitors:
+      - name: heap
+        resource: HEAP
+        max: 1000
+    actions:
+      - name: envoy.overload_actions.stop_accepting_requests
+        triggers:
+          - name: connections
+            threshold:
+              value: 0.9
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(
+      createOverloadManager(config), EnvoyException,
+      "Unknown trigger resource connections for overload action "
+      "envoy.overload_actions.stop_accepting_requests");
+}
+
+TEST_F(OverloadManagerImplTest, NoResourceMonitors) {
+  auto manager = createOverloadManager("{}");
+  EXPECT_CALL(dispatcher_, createTimer_(_)).Times(0);
+  manager->start();
+  EXPECT_EQ(OverloadActionState::Inactive,
+            manager->getThreadLocalOverloadState().getState(
+                OverloadActionNames::get().StopAcceptingRequests));
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,62 @@
+#include "envoy/config/overload/v2alpha/overload.pb.h"
+
+#include "common/memory/stats.h"
+#include "common/protobuf/utility.h"
+
+#include "server/resource_monitor_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+ResourceMonitorPtr createResourceMonitor(const std::string& yaml) {
+  envoy::config::overload::v2alpha::ResourceMonitor config;
+  MessageUtil::loadFromYaml(yaml, config);
+  return ResourceMonitorUtility::createResourceMonitor(config, []() -> uint64_t { return 50; });
+}
+
+TEST(ResourceMonitorUtilityTest, Heap) {
+  const std::string yaml = R"EOF(
+    name: heap
+    resource: HEAP
+    max: 1000000000
+  )EOF";
+
+  // Without tcmalloc the heap size is not known, so the overload actions triggered by it could
+  // never fire.
+  if (!Memory::Stats::available()) {
+    EXPECT_THROW_WITH_MESSAGE(createResourceMonitor(yaml), EnvoyException,
+                              "resource monitor heap: HEAP is only supported in builds with "
+                              "tcmalloc");
+    return;
+  }
+  EXPECT_GT(createResourceMonitor(yaml)->pressure(), 0);
+}
+
+TEST(ResourceMonitorUtilityTest, HeapWithoutMax) {
+  const std::string yaml = R"EOF(
+    name: heap
+    resource: HEAP
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(createResourceMonitor(yaml), EnvoyException,
+                            "resource monitor heap: max must be set for HEAP");
+}
+
+TEST(ResourceMonitorUtilityTest, Connections) {
+  const std::string yaml = R"EOF(
+    name: connections
+    resource: CONNECTIONS
+    max: 100
+  )EOF";
+
+  EXPECT_EQ(0.5, createResourceMonitor(yaml)->pressure());
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
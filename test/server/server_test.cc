@@ -15,6 +15,7 @@
 using testing::HasSubstr;
 using testing::InSequence;
 using testing::Property;
+using testing::Return;
 using testing::SaveArg;
 using testing::StrictMock;
 using testing::_;
@@ -30,13 +31,58 @@ TEST(ServerInstanceUtil, flushHelper) {
   store.gauge("world").set(5);
   std::unique_ptr<Stats::MockSink> sink(new StrictMock<Stats::MockSink>());
   EXPECT_CALL(*sink, beginFlush());
+  EXPECT_CALL(*sink, wantsChangedOnly()).WillOnce(Return(true));
   EXPECT_CALL(*sink, flushCounter(Property(&Stats::Metric::name, "hello"), 1));
   EXPECT_CALL(*sink, flushGauge(Property(&Stats::Metric::name, "world"), 5));
   EXPECT_CALL(*sink, endFlush());
 
   std::list<Stats::SinkPtr> sinks;
   sinks.emplace_back(std::move(sink));
-  InstanceUtil::flushCountersAndGaugesToSinks(sinks, store);
+  Stats::ChangedMetrics changed;
+  changed.counters_.emplace_back(TestUtility::findCounter(store, "hello"), 1);
+  changed.gauges_.push_back(TestUtility::findGauge(store, "world"));
+  InstanceUtil::flushCountersAndGaugesToSinks(sinks, store, changed);
+}
+
+// A gauge left unchanged across two flushes is only sent again to the sinks that want snapshots.
+TEST(ServerInstanceUtil, flushHelperSnapshotSink) {
+  InSequence s;
+
+  Stats::IsolatedStoreImpl store;
+  store.counter("hello").inc();
+  store.gauge("world").set(5);
+  Stats::MockSink* changed_sink = new StrictMock<Stats::MockSink>();
+  Stats::MockSink* snapshot_sink = new StrictMock<Stats::MockSink>();
+  std::list<Stats::SinkPtr> sinks;
+  sinks.emplace_back(changed_sink);
+  sinks.emplace_back(snapshot_sink);
+
+  EXPECT_CALL(*changed_sink, beginFlush());
+  EXPECT_CALL(*changed_sink, wantsChangedOnly()).WillOnce(Return(true));
+  EXPECT_CALL(*snapshot_sink, beginFlush());
+  EXPECT_CALL(*snapshot_sink, wantsChangedOnly()).WillOnce(Return(false));
+  EXPECT_CALL(*changed_sink, flushCounter(Property(&Stats::Metric::name, "hello"), 1));
+  EXPECT_CALL(*changed_sink, flushGauge(Property(&Stats::Metric::name, "world"), 5));
+  EXPECT_CALL(*snapshot_sink, flushCounter(Property(&Stats::Metric::name, "hello"), 1));
+  EXPECT_CALL(*snapshot_sink, flushGauge(Property(&Stats::Metric::name, "world"), 5));
+  EXPECT_CALL(*changed_sink, endFlush());
+  EXPECT_CALL(*snapshot_sink, endFlush());
+
+  Stats::ChangedMetrics changed;
+  changed.counters_.emplace_back(TestUtility::findCounter(store, "hello"), 1);
+  changed.gauges_.push_back(TestUtility::findGauge(store, "world"));
+  InstanceUtil::flushCountersAndGaugesToSinks(sinks, store, changed);
+
+  EXPECT_CALL(*changed_sink, beginFlush());
+  EXPECT_CALL(*changed_sink, wantsChangedOnly()).WillOnce(Return(true));
+  EXPECT_CALL(*snapshot_sink, beginFlush());
+  EXPECT_CALL(*snapshot_sink, wantsChangedOnly()).WillOnce(Return(false));
+  EXPECT_CALL(*snapshot_sink, flushCounter(Property(&Stats::Metric::name, "hello"), 0));
+  EXPECT_CALL(*snapshot_sink, flushGauge(Property(&Stats::Metric::name, "world"), 5));
+  EXPECT_CALL(*changed_sink, endFlush());
+  EXPECT_CALL(*snapshot_sink, endFlush());
+
+  InstanceUtil::flushCountersAndGaugesToSinks(sinks, store, Stats::ChangedMetrics());
 }
 
 class RunHelperTest : public testing::Test {
@@ -172,6 +218,19 @@ TEST_P(ServerInstanceImplTest, BootstrapNodeWithOptionsOverride) {
   EXPECT_EQ(VersionInfo::version(), server_->localInfo().node().build_version());
 }
 
+// Event loop stats and their admin endpoint are only set up when enabled in the bootstrap.
+TEST_P(ServerInstanceImplTest, DispatcherStatsDisabledByDefault) {
+  initialize("test/server/node_bootstrap.yaml");
+  EXPECT_FALSE(server_->admin().removeHandler("/event_loop"));
+}
+
+TEST_P(ServerInstanceImplTest, DispatcherStatsEnabled) {
+  options_.service_cluster_name_ = "some_cluster_name";
+  options_.service_node_name_ = "some_node_name";
+  initialize("test/server/dispatcher_stats_bootstrap.yaml");
+  EXPECT_TRUE(server_->admin().removeHandler("/event_loop"));
+}
+
 // Negative test for protoc-gen-validate constraints.
 TEST_P(ServerInstanceImplTest, ValidateFail) {
   options_.service_cluster_name_ = "some_cluster_name";
@@ -9,11 +9,13 @@
 
 #include "gtest/gtest.h"
 
+using testing::DoAll;
 using testing::InSequence;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
 using testing::NiceMock;
 using testing::Return;
+using testing::SaveArg;
 using testing::Throw;
 using testing::_;
 
@@ -32,9 +34,10 @@ public:
   Event::DispatcherImpl* dispatcher_ = new Event::DispatcherImpl();
   Network::MockConnectionHandler* handler_ = new Network::MockConnectionHandler();
   NiceMock<MockGuardDog> guard_dog_;
+  NiceMock<MockOverloadManager> overload_manager_;
   DefaultTestHooks hooks_;
   WorkerImpl worker_{tls_, hooks_, Event::DispatcherPtr{dispatcher_},
-                     Network::ConnectionHandlerPtr{handler_}};
+                     Network::ConnectionHandlerPtr{handler_}, overload_manager_};
   Event::TimerPtr no_exit_timer_ = dispatcher_->createTimer([]() -> void {});
 };
 
@@ -130,5 +133,30 @@ TEST_F(WorkerImplTest, ListenerException) {
   worker_.stop();
 }
 
+TEST_F(WorkerImplTest, OverloadActions) {
+  OverloadActionCb stop_accepting_cb;
+  OverloadActionCb shrink_buffers_cb;
+  EXPECT_CALL(overload_manager_,
+              registerForAction(OverloadActionNames::get().StopAcceptingConnections, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&stop_accepting_cb), Return(true)));
+  EXPECT_CALL(overload_manager_,
+              registerForAction(OverloadActionNames::get().ShrinkBufferLimits, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&shrink_buffers_cb), Return(true)));
+
+  Network::MockConnectionHandler* handler = new Network::MockConnectionHandler();
+  WorkerImpl worker(tls_, hooks_, Event::DispatcherPtr{new Event::DispatcherImpl()},
+                    Network::ConnectionHandlerPtr{handler}, overload_manager_);
+
+  EXPECT_CALL(*handler, disableListeners());
+  stop_accepting_cb(OverloadActionState::Active);
+  EXPECT_CALL(*handler, enableListeners());
+  stop_accepting_cb(OverloadActionState::Inactive);
+
+  EXPECT_CALL(*handler, setPerConnectionBufferLimitCap(16 * 1024));
+  shrink_buffers_cb(OverloadActionState::Active);
+  EXPECT_CALL(*handler, setPerConnectionBufferLimitCap(0));
+  shrink_buffers_cb(OverloadActionState::Inactive);
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -87,8 +87,8 @@ std::vector<Network::Address::IpVersion> TestEnvironment::getIpVersionsForTest()
 }
 
 Server::Options& TestEnvironment::getOptions() {
-  static OptionsImpl* options = new OptionsImpl(
-      argc_, argv_, [](uint64_t, uint64_t, bool) { return "1"; }, spdlog::level::err);
+  static OptionsImpl* options =
+      new OptionsImpl(argc_, argv_, [](bool) { return "1"; }, spdlog::level::err);
   return *options;
 }
 
@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
@@ -188,6 +189,36 @@ TransportSocketPtr createRawBufferSocket() { return std::make_unique<RawBufferSo
 TransportSocketFactoryPtr createRawBufferSocketFactory() {
   return std::make_unique<RawBufferSocketFactory>();
 };
+
+namespace {
+
+class EmptyFilterChain : public FilterChain {
+public:
+  EmptyFilterChain(TransportSocketFactoryPtr&& transport_socket_factory)
+      : transport_socket_factory_(std::move(transport_socket_factory)) {}
+
+  // Network::FilterChain
+  const TransportSocketFactory& transportSocketFactory() const override {
+    return *transport_socket_factory_;
+  }
+  const std::vector<FilterFactoryCb>& networkFilterFactories() const override {
+    return empty_network_filter_factory_;
+  }
+
+private:
+  const TransportSocketFactoryPtr transport_socket_factory_;
+  const std::vector<FilterFactoryCb> empty_network_filter_factory_{};
+};
+
+} // namespace
+
+FilterChainSharedPtr createEmptyFilterChain(TransportSocketFactoryPtr&& transport_socket_factory) {
+  return std::make_shared<EmptyFilterChain>(std::move(transport_socket_factory));
+}
+
+FilterChainSharedPtr createEmptyFilterChainWithRawBufferSockets() {
+  return createEmptyFilterChain(createRawBufferSocketFactory());
+}
 } // namespace Test
 } // namespace Network
 } // namespace Envoy
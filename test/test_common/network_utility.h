@@ -3,6 +3,7 @@
 #include <string>
 
 #include "envoy/network/address.h"
+#include "envoy/network/filter.h"
 #include "envoy/network/transport_socket.h"
 
 namespace Envoy {
@@ -114,6 +115,20 @@ TransportSocketPtr createRawBufferSocket();
  */
 TransportSocketFactoryPtr createRawBufferSocketFactory();
 
+/**
+ * Create a filter chain without network filters for testing purposes.
+ * @param transport_socket_factory supplies the transport socket factory of the filter chain.
+ * @return FilterChainSharedPtr the filter chain to return from a filter chain manager.
+ */
+FilterChainSharedPtr createEmptyFilterChain(TransportSocketFactoryPtr&& transport_socket_factory);
+
+/**
+ * Create a filter chain without network filters and with raw buffer transport sockets for testing
+ * purposes.
+ * @return FilterChainSharedPtr the filter chain to return from a filter chain manager.
+ */
+FilterChainSharedPtr createEmptyFilterChainWithRawBufferSockets();
+
 } // namespace Test
 } // namespace Network
 } // namespace Envoy